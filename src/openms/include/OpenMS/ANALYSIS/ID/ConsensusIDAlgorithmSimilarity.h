@@ -37,6 +37,8 @@
 
 #include <OpenMS/ANALYSIS/ID/ConsensusIDAlgorithm.h>
 
+#include <boost/unordered_map.hpp>
+
 namespace OpenMS
 {
   /**
@@ -48,6 +50,8 @@ namespace OpenMS
 
     Derived classes should implement getSimilarity_(), which defines how similarity of two peptide sequences is quantified.
 
+    Peptide sequences are mapped to integer IDs, and computed similarities are cached (in a hash table keyed by pairs of IDs) across calls to apply(), as the same peptides usually occur in many spectra.
+
     @htmlinclude OpenMS_ConsensusIDAlgorithmSimilarity.parameters
     
     @ingroup Analysis_ID
@@ -59,21 +63,30 @@ namespace OpenMS
     /// Default constructor
     ConsensusIDAlgorithmSimilarity();
 
-    /// Mapping: pair of peptide sequences -> sequence similarity
-    typedef std::map<std::pair<AASequence, AASequence>, double> SimilarityCache;
+    /// Mapping: pair of sequence IDs (lower ID first) -> sequence similarity
+    typedef boost::unordered_map<std::pair<Size, Size>, double> SimilarityCache;
 
     /// Cache for already computed sequence similarities
     SimilarityCache similarities_;
 
+    /// Mapping: peptide sequence (string representation) -> sequence ID
+    boost::unordered_map<String, Size> sequence_ids_;
+
     /**
        @brief Sequence similarity calculation (to be implemented by subclasses).
 
-       Implementations should use/update the cache of previously computed similarities.
+       Results are cached by getCachedSimilarity_(), so implementations do not need to do this themselves. The calculation has to be symmetric.
 
        @return Similarity between two sequences in the range [0, 1]
     */
     virtual double getSimilarity_(AASequence seq1, AASequence seq2) = 0;
 
+    /// Returns the ID of a peptide sequence (a new one if the sequence was not seen before)
+    Size getSequenceID_(const AASequence& seq);
+
+    /// Sequence similarity look-up based on sequence IDs (calls getSimilarity_() if the similarity was not computed before)
+    double getCachedSimilarity_(Size id1, const AASequence& seq1, Size id2, const AASequence& seq2);
+
   private:
     /// Not implemented
     ConsensusIDAlgorithmSimilarity(const ConsensusIDAlgorithmSimilarity&);
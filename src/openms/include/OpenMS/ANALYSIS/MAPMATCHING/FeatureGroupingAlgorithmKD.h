@@ -235,11 +235,11 @@ private:
     /// Run the actual clustering algorithm
     void runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out);
 
-    /// Update maximum possible sizes of potential consensus features for indices specified in @p update_these
+    /// Update maximum possible sizes of potential consensus features for indices specified in @p update_these (computed in parallel)
     void updateClusterProxies_(std::set<ClusterProxyKD>& potential_clusters, std::vector<ClusterProxyKD>& cluster_for_idx, const std::set<Size>& update_these, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data);
 
-    /// Compute the current best cluster with center index @p i (mutates @p proxy and @p cf_indices)
-    ClusterProxyKD computeBestClusterForCenter_(Size i, std::vector<Size>& cf_indices, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data) const;
+    /// Compute the current best cluster with center index @p i (mutates @p proxy and @p cf_indices), using @p feature_distance (which is not thread-safe)
+    ClusterProxyKD computeBestClusterForCenter_(Size i, std::vector<Size>& cf_indices, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance) const;
 
     /// Construct consensus feature and add to out map
     void addConsensusFeature_(const std::vector<Size>& indices, const KDTreeFeatureMaps& kd_data, ConsensusMap& out) const;
@@ -45,6 +45,7 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 
+#include <algorithm>
 #include <cmath> // for "abs"
 #include <limits> // for "max"
 #include <map>
@@ -124,15 +125,26 @@ public:
 
       // one set of RT data for each input map, except reference (if any):
       std::vector<SeqToList> rt_data(data.size() - use_internal_reference);
-      bool all_sorted = true;
-      for (Size i = 0, j = 0; i < data.size(); ++i)
+      std::vector<Size> data_index; // input map for each set of RT data
+      for (Size i = 0; i < data.size(); ++i)
       {
         if ((reference_index >= 0) && (i == Size(reference_index)))
         {
           continue; // skip reference map, if any
         }
-        all_sorted &= getRetentionTimes_(data[i], rt_data[j++]);
+        data_index.push_back(i);
       }
+      // runs are independent - collect their RT data concurrently:
+      std::vector<char> sorted(rt_data.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for (SignedSize j = 0; j < (SignedSize)rt_data.size(); ++j)
+      {
+        sorted[j] = getRetentionTimes_(data[data_index[j]], rt_data[j]);
+      }
+      bool all_sorted = (std::find(sorted.begin(), sorted.end(), false) ==
+                         sorted.end());
       setProgress(1);
 
       computeTransformations_(rt_data, transformations, all_sorted);
@@ -63,6 +63,16 @@ namespace OpenMS
                                         const TransformationDescription& trafo,
                                         bool store_original_rt = false);
 
+    /// Applies the given transformation to a single spectrum (e.g. while streaming a file)
+    static void transformRetentionTimes(MSSpectrum& spectrum,
+                                        const TransformationDescription& trafo,
+                                        bool store_original_rt = false);
+
+    /// Applies the given transformation to a single chromatogram (e.g. while streaming a file)
+    static void transformRetentionTimes(MSChromatogram& chromatogram,
+                                        const TransformationDescription& trafo,
+                                        bool store_original_rt = false);
+
     /// Applies the given transformation to a feature map
     static void transformRetentionTimes(
       FeatureMap& fmap, const TransformationDescription& trafo,
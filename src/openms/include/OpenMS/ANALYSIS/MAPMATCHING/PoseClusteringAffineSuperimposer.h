@@ -101,6 +101,16 @@ public:
     /// Perform alignment on vector of 1D peaks
     virtual void run(const std::vector<Peak2D> & map_model, const std::vector<Peak2D> & map_scene, TransformationDescription & transformation);
 
+    /**
+      @brief Reduces @p map to at most @p num_used_points elements.
+
+      Without @p stratified, the most abundant elements are kept.  Otherwise,
+      the elements are ranked by intensity and every n-th element is kept, so
+      that all intensity ranges contribute (the most abundant element is
+      always included).  The order of the remaining elements is unspecified.
+    */
+    static void selectPoints(std::vector<Peak2D> & map, const Size num_used_points, const bool stratified);
+
     /// Returns an instance of this class
     static BaseSuperimposer * create()
     {
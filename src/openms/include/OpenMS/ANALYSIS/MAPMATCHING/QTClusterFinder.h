@@ -117,6 +117,19 @@ private:
 
     typedef HashGrid<OpenMS::GridFeature*> Grid;
 
+    /// Orders (quality, cluster index) pairs by decreasing quality, ties by increasing index
+    struct ClusterQualityGreater_
+    {
+      bool operator()(const std::pair<double, Size>& left, const std::pair<double, Size>& right) const
+      {
+        if (left.first != right.first) return left.first > right.first;
+        return left.second < right.second;
+      }
+    };
+
+    /// Valid clusters (indices into the clustering) ordered by quality, best first
+    typedef std::set<std::pair<double, Size>, ClusterQualityGreater_> ClusterQueue;
+
     /// Number of input maps
     Size num_maps_;
 
@@ -140,20 +153,28 @@ private:
 
     /**
        @brief Calculates the distance between two grid features.
+
+       @note @p feature_distance caches values during computation, so every thread needs its own instance.
     */
     double getDistance_(const OpenMS::GridFeature* left, const
-        OpenMS::GridFeature* right);
+        OpenMS::GridFeature* right, FeatureDistance& feature_distance) const;
 
     /// Sets algorithm parameters
     void setParameters_(double max_intensity, double max_mz);
 
-    /// Generates a consensus feature from the best cluster and updates the clustering
-    void makeConsensusFeature_(std::list<QTCluster>& clustering,
+    /**
+       @brief Generates a consensus feature from the best cluster and updates the clustering
+
+       Only the clusters affected by the removal of the new feature's elements
+       are updated and re-inserted into @p queue.
+    */
+    void makeConsensusFeature_(std::vector<QTCluster>& clustering,
+                               ClusterQueue& queue,
                                ConsensusFeature& feature,
                                ElementMapping& element_mapping, Grid&);
 
-    /// Computes an initial QT clustering of the points in the hash grid
-    void computeClustering_(Grid& grid, std::list<QTCluster>& clustering);
+    /// Computes an initial QT clustering of the points in the hash grid (in parallel)
+    void computeClustering_(Grid& grid, std::vector<QTCluster>& clustering);
 
     /// Runs the algorithm on feature maps or consensus maps
     template <typename MapType>
@@ -166,7 +187,7 @@ private:
 
     /// Adds elements to the cluster based on the elements hashed in the grid
     void addClusterElements_(int x, int y, const Grid& grid, QTCluster& cluster,
-      const OpenMS::GridFeature* center_feature);
+      const OpenMS::GridFeature* center_feature, FeatureDistance& feature_distance) const;
 
 protected:
 
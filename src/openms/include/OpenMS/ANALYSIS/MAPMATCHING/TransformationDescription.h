@@ -92,6 +92,16 @@ public:
     */
     double apply(double value) const;
 
+    /**
+      @brief Applies the transformation to all @p values (in place).
+
+      Gives the same results as calling apply() for each value, but evaluates the
+      model in one go. This is much faster for values sorted in ascending order
+      (e.g. retention times of spectra or chromatogram points), since
+      interpolating models then walk through their knots instead of searching them.
+    */
+    void apply(std::vector<double>& values) const;
+
     /// Gets the type of the fitted model
     const String& getModelType() const;
 
@@ -100,6 +100,15 @@ namespace OpenMS
 
     /// Evaluates the model at the given value
     virtual double evaluate(double value) const;
+
+    /**
+      @brief Evaluates the model at all given @p values (in place)
+
+      The results are identical to calling evaluate() for each value. Derived
+      models can evaluate much faster if @p values are sorted in ascending
+      order (unsorted input is allowed, though).
+    */
+    virtual void evaluateSorted(std::vector<double>& values) const;
     
     /**
     @brief Weight the data by the given weight function
@@ -46,6 +46,11 @@ namespace OpenMS
   /**
     @brief B-spline (non-linear) model for transformations
 
+    This model does not override evaluateSorted(): the B-spline nodes are
+    equidistant, so evaluate() finds the relevant basis functions by direct
+    indexing in constant time. Sorted input offers no search to amortize, and
+    the default per-value loop is already optimal.
+
     @ingroup MapAlignment
   */
   class OPENMS_DLLAPI TransformationModelBSpline :
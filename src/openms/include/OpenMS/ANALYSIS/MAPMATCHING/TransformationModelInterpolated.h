@@ -94,6 +94,17 @@ public:
      */
     double evaluate(double value) const override;
 
+    /**
+     * @brief Evaluate the interpolation model at all given values (in place)
+     *
+     * Runs of values within the data range are handed to the interpolator
+     * at once, which walks the knots monotonically for ascending values
+     * instead of searching them anew for every value.
+     *
+     * @param values The positions where the interpolation should be evaluated.
+     */
+    void evaluateSorted(std::vector<double>& values) const override;
+
     /// Gets the default parameters
     static void getDefaultParameters(Param& params);
 
@@ -125,6 +136,17 @@ public:
        */
       virtual double eval(const double& x) const = 0;
 
+      /**
+       * @brief Evaluate the underlying interpolation at all positions in [first, last) (in place).
+       *
+       * The default implementation calls eval() for each position; derived classes
+       * may use the order of (ascending) positions to avoid repeated searches.
+       */
+      virtual void evalSorted(std::vector<double>::iterator first, std::vector<double>::iterator last) const
+      {
+        for (; first != last; ++first) *first = eval(*first);
+      }
+
       /**
        * @brief d'tor.
        */
@@ -73,6 +73,9 @@ public:
     /// Evaluates the model at the given value
     double evaluate(double value) const override;
 
+    /// Evaluates the model at all given values (vectorizable if no weighting is used)
+    void evaluateSorted(std::vector<double>& values) const override;
+
     using TransformationModel::getParameters;
 
     /// Gets the "real" parameters
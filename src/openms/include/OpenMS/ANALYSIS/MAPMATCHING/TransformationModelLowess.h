@@ -67,6 +67,12 @@ public:
       return model_->evaluate(value);
     }
 
+    /// Evaluates the model at all given values (see TransformationModelInterpolated::evaluateSorted)
+    void evaluateSorted(std::vector<double>& values) const override
+    {
+      model_->evaluateSorted(values);
+    }
+
     using TransformationModel::getParameters;
 
     /// Gets the default parameters
@@ -44,11 +44,26 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include <deque>
+
 namespace OpenMS
 {
   /**
     @brief An implementation of the OpenSWATH Spectrum Access interface using OpenMS
 
+    The peak data of a spectrum (chromatogram) is converted into the columnar
+    OpenSwath format on first access only. The converted data is kept and
+    shared between this instance and all of its light clones, so repeated
+    access to the same scan (as is common during chromatogram extraction and
+    scoring) returns the same object without copying the peaks again. At most
+    MAX_CONVERTED_SCANS spectra and chromatograms are kept (the oldest
+    conversion is dropped first), so only a bounded part of the map is
+    duplicated. This implies that the underlying MSExperiment must not be
+    modified after it has been accessed and that the returned data must be
+    treated as read-only: it may be shared with other callers and threads
+    (see e.g. SpectrumAccessQuadMZTransforming, which copies before
+    transforming).
+
   */
   class OPENMS_DLLAPI SpectrumAccessOpenMS :
     public OpenSwath::ISpectrumAccess
@@ -58,6 +73,9 @@ public:
     typedef OpenMS::MSSpectrum MSSpectrumType;
     typedef OpenMS::MSChromatogram MSChromatogramType;
 
+    /// maximum number of converted spectra (and, separately, chromatograms) that are kept
+    static const Size MAX_CONVERTED_SCANS;
+
     /// Constructor
     explicit SpectrumAccessOpenMS(boost::shared_ptr<MSExperimentType> ms_experiment);
 
@@ -106,8 +124,23 @@ public:
     std::string getChromatogramNativeID(int id) const override;
 
 private:
+
+    /// Peak data already converted into OpenSwath format (null if not yet converted)
+    struct ConvertedData_
+    {
+      std::vector<OpenSwath::SpectrumPtr> spectra;
+      std::vector<OpenSwath::ChromatogramPtr> chromatograms;
+      /// ids of the converted spectra, in order of conversion
+      std::deque<int> spectra_order;
+      /// ids of the converted chromatograms, in order of conversion
+      std::deque<int> chromatograms_order;
+    };
+
     boost::shared_ptr<MSExperimentType> ms_experiment_;
 
+    /// Converted data, shared with all light clones
+    boost::shared_ptr<ConvertedData_> converted_;
+
   };
 } //end namespace OpenMS
 
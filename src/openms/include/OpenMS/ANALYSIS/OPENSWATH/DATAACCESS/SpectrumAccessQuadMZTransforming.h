@@ -49,6 +49,10 @@ namespace OpenMS
    * This can be used to implement an on-line mass correction for TOF
    * instruments (for example).
    *
+   * The spectra of the underlying access are not modified, each call returns
+   * a new spectrum with a transformed copy of the m/z array (all other data
+   * arrays are shared with the original spectrum).
+   *
    */
   class OPENMS_DLLAPI SpectrumAccessQuadMZTransforming :
     public SpectrumAccessTransforming
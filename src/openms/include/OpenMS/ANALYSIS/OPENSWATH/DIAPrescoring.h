@@ -91,6 +91,36 @@ public:
                double& dotprod,
                double& manhattan);
 
+    /**
+      @brief Simulate the theoretical spectrum of a transition group as used by score()
+
+      The theoretical spectrum only depends on the transitions and can be
+      reused for all spectra scored against the same transition group.
+
+      @param lt Transitions of the group
+      @param theo_mz m/z positions of the theoretical spectrum
+      @param theo_int Intensities normalized to sum one (manhattan distance)
+      @param theo_int_normed Intensities normalized to unit length (dot product)
+    */
+    void getTheoreticalSpectrum(const std::vector<OpenSwath::LightTransition>& lt,
+                                std::vector<double>& theo_mz,
+                                std::vector<double>& theo_int,
+                                std::vector<double>& theo_int_normed) const;
+
+    /**
+      @brief Score a spectrum against a precomputed theoretical spectrum (see getTheoreticalSpectrum)
+
+      @a int_exp and @a mz_exp are used as workspace and are overwritten.
+    */
+    void score(OpenSwath::SpectrumPtr spec,
+               const std::vector<double>& theo_mz,
+               const std::vector<double>& theo_int,
+               const std::vector<double>& theo_int_normed,
+               std::vector<double>& int_exp,
+               std::vector<double>& mz_exp,
+               double& dotprod,
+               double& manhattan) const;
+
     /**
       @brief Compute manhattan and dotprod score for all spectra which can be accessed by
       the SpectrumAccessPtr for all transitions groups in the LightTargetedExperiment.
@@ -47,6 +47,7 @@
 namespace OpenMS
 {
   class TheoreticalSpectrumGenerator;
+  class DiaPrescore;
 
   /**
     @brief Scoring of an spectrum at the peak apex of an chromatographic elution peak.
@@ -78,6 +79,12 @@ namespace OpenMS
     interface. Transitions are expected to be in the light transition format
     (defined in OPENSWATHALGO/DATAACCESS/TransitionExperiment.h).
 
+    All theoretical values (isotope patterns, b/y series, theoretical
+    spectrum) only depend on the assay and are kept for the transition group
+    (peptide) scored last. Scoring all peak groups of one transition group in
+    a row thus computes them only once; an instance should therefore not be
+    shared between threads.
+
   @htmlinclude OpenMS_DIAScoring.parameters
 
   */
@@ -155,16 +162,19 @@ private:
 
     /// Subfunction of dia_isotope_scores
     void diaIsotopeScoresSub_(const std::vector<TransitionType>& transitions,
-                                SpectrumPtrType spectrum, std::map<std::string, double>& intensities,
+                                SpectrumPtrType spectrum, const std::vector<double>& intensities,
                                 double& isotope_corr, double& isotope_overlap);
 
     /// retrieves intensities from MRMFeature
-    /// computes a vector of relative intensities for each feature (output to intensities)
+    /// computes a vector of relative intensities for each transition (output to intensities, same order as transitions)
     void getFirstIsotopeRelativeIntensities_(const std::vector<TransitionType>& transitions,
                                             OpenSwath::IMRMFeature* mrmfeature,
-                                            std::map<std::string, double>& intensities //experimental intensities of transitions
+                                            std::vector<double>& intensities //experimental intensities of transitions
                                             );
 
+    /// Compute the theoretical values of @p transitions, unless they are already present in assay_
+    void prepareAssay_(const std::vector<TransitionType>& transitions);
+
 private:
 
     /**
@@ -195,6 +205,35 @@ private:
     double scoreIsotopePattern_(double product_mz, const std::vector<double>& isotopes_int, 
                                 int putative_fragment_charge, std::string sum_formula = "");
 
+    /// Pearson correlation of experimental isotope intensities with a theoretical pattern (0 if undefined)
+    double scoreIsotopePattern_(const std::vector<double>& isotopes_int, const std::vector<double>& theoretical_pattern) const;
+
+    /**
+      @brief Compute the theoretical isotope pattern (scaled to a maximum of 1)
+
+      The pattern is computed from @p sum_formula if given, otherwise using an
+      averagine model for the given m/z and charge.
+    */
+    void getTheoreticalIsotopePattern_(double product_mz, int putative_fragment_charge,
+                                       const std::string& sum_formula, std::vector<double>& pattern) const;
+
+    /// Theoretical values of the transition group scored last
+    struct AssayTables_
+    {
+      /// key: the transition properties the tables were computed from
+      std::vector<double> product_mz;
+      std::vector<int> fragment_charge;
+      std::vector<double> library_intensity;
+
+      /// theoretical isotope pattern of each transition
+      std::vector<std::vector<double> > isotope_patterns;
+
+      /// theoretical spectrum for the dotproduct / manhattan score (see DiaPrescore)
+      std::vector<double> theo_mz;
+      std::vector<double> theo_int;
+      std::vector<double> theo_int_normed;
+    };
+
     // Parameters
     double dia_extract_window_;
     double dia_centroided_;
@@ -206,6 +245,30 @@ private:
     bool dia_extraction_ppm_;
 
     TheoreticalSpectrumGenerator * generator;
+
+    /// Scorer for the dotproduct / manhattan score (synchronized with the parameters)
+    DiaPrescore * prescore_;
+
+    /// Theoretical values of the current assay
+    AssayTables_ assay_;
+
+    /// b/y series of the peptide scored last
+    AASequence by_sequence_;
+    int by_charge_;
+    std::vector<double> bseries_;
+    std::vector<double> yseries_;
+
+    /// Theoretical precursor isotope pattern of the precursor scored last
+    double ms1_pattern_mz_;
+    size_t ms1_pattern_charge_;
+    std::string ms1_pattern_formula_;
+    std::vector<double> ms1_pattern_;
+
+    /// Workspace, reused across calls to avoid allocations
+    std::vector<double> isotopes_int_;
+    std::vector<double> rel_intensities_;
+    std::vector<double> int_exp_;
+    std::vector<double> mz_exp_;
   };
 }
 
@@ -558,7 +558,7 @@ var_yseries_score   -0.0327896378737766
     */
     void calculateDIAScores(OpenSwath::IMRMFeature* imrmfeature, 
         const std::vector<TransitionType> & transitions,
-        std::vector<OpenSwath::SwathMap> swath_maps,
+        const std::vector<OpenSwath::SwathMap>& swath_maps,
         OpenSwath::SpectrumAccessPtr ms1_map,
         OpenMS::DIAScoring & diascoring,
         const CompoundType& compound,
@@ -595,7 +595,7 @@ var_yseries_score   -0.0327896378737766
     */
     void calculateDIAIdScores(OpenSwath::IMRMFeature* imrmfeature,
         const TransitionType & transition,
-        std::vector<OpenSwath::SwathMap> swath_maps,
+        const std::vector<OpenSwath::SwathMap>& swath_maps,
         OpenMS::DIAScoring & diascoring,
         OpenSwath_Scores & scores);
 
@@ -636,7 +636,7 @@ var_yseries_score   -0.0327896378737766
      * @param nr_spectra_to_add How many spectra to add up
      *
     */
-    OpenSwath::SpectrumPtr getAddedSpectra_(std::vector<OpenSwath::SwathMap> swath_maps,
+    OpenSwath::SpectrumPtr getAddedSpectra_(const std::vector<OpenSwath::SwathMap>& swath_maps,
                                             double RT, int nr_spectra_to_add);
 
   };
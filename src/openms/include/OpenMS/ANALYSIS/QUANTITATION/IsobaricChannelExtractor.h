@@ -39,6 +39,10 @@
 #include <OpenMS/KERNEL/Peak2D.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/KERNEL/RangeUtils.h>
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+
+#include <boost/shared_ptr.hpp>
 
 namespace OpenMS
 {
@@ -63,6 +67,11 @@ namespace OpenMS
     for improvement of protein identification and accuracy of isobaric mass tag quantification on Orbitrap-type mass
     spectrometers. Analytical chemistry 83: 8959-67. http://www.ncbi.nlm.nih.gov/pubmed/22017476
 
+    Extraction runs in three stages: a cheap serial pass assigns each quantitation scan its MS1 precursor
+    and follow-up scans, purity computation and reporter ion extraction then run in parallel, and the
+    results are appended to the output map in scan order. Use IsobaricChannelExtractionConsumer to
+    extract channels while reading an mzML file, without holding the whole experiment in memory.
+
     @note Centroided MS and MS/MS data is required.
 
     @htmlinclude OpenMS_IsobaricChannelExtractor.parameters
@@ -93,45 +102,44 @@ public:
     void extractChannels(const PeakMap& ms_exp_data, ConsensusMap& consensus_map);
 
 private:
+    friend class IsobaricChannelExtractionConsumer;
+
     /**
-      @brief Small struct to capture the current state of the purity computation.
+      @brief A single quantitation scan scheduled for reporter ion extraction.
 
-      It basically contains two iterators pointing to the current potential
-      MS1 precursor scan of an MS2 scan and the MS1 scan immediately
-      following the current MS2 scan.
+      Holds the quantitation scan together with the MS1 scans needed for the
+      purity computation. The result members are filled by processJob_(),
+      which does not touch any shared state and can thus run in parallel.
     */
-    struct PuritySate_
+    struct ExtractionJob_
     {
-      /// Iterator pointing to the potential MS1 precursor scan
-      PeakMap::ConstIterator precursorScan;
-      /// Iterator pointing to the potential follow up MS1 scan
-      PeakMap::ConstIterator followUpScan;
-
-      /// Indicates if a follow up scan was found
-      bool hasFollowUpScan;
-      /// reference to the experiment to analyze
-      const PeakMap& baseExperiment;
-
-      /**
-        @brief C'tor taking the experiment that will be analyzed.
-
-        @param targetExp The experiment that will be analyzed.
-      */
-      PuritySate_(const PeakMap& targetExp);
-
-      /**
-        @brief Searches the experiment for the next MS1 spectrum with a retention time bigger then @p rt.
-
-        @param rt The next follow up scan should have a retention bigger then this value.
-      */
-      void advanceFollowUp(const double rt);
-
-      /**
-        @brief Check if the currently selected follow up scan has a retention time bigger then the given value.
-
-        @param rt The retention time to check.
-      */
-      bool followUpValid(const double rt);
+      /// The quantitation scan (may be trimmed to the reporter ion region)
+      boost::shared_ptr<const MSSpectrum> spectrum;
+      /// The last MS1 scan preceding the quantitation scan (null if there is none)
+      boost::shared_ptr<const MSSpectrum> precursor_scan;
+      /// The first MS1 scan following the quantitation scan (null if there is none)
+      boost::shared_ptr<const MSSpectrum> follow_up_scan;
+      /// Indicates if an MS2 scan precedes the quantitation scan (always true for MS2 quantitation)
+      bool has_ms2;
+      /// RT of the MS2 scan which selected the precursor
+      double ms2_rt;
+      /// m/z of the first precursor of the MS2 scan
+      double ms2_mz;
+
+      /// Precursor purity, or -1 if no precursor scan was available
+      double purity;
+      /// Indicates if the precursor purity is below the threshold (no channels are extracted then)
+      bool low_purity;
+      /// Intensity per channel (already filtered by the minimum reporter intensity)
+      std::vector<Peak2D::IntensityType> intensities;
+      /// m/z distance between expected and closest observed reporter ion per channel
+      std::vector<double> mz_deltas;
+      /// Indicates per channel if a reporter ion was found within the QC window (i.e., if mz_deltas is valid)
+      std::vector<char> found;
+      /// Indicates per channel if more than one peak was found within the allowed mass shift
+      std::vector<char> not_unique;
+
+      ExtractionJob_();
     };
 
     /// The used quantitation method (itraq4plex, tmt6plex,..).
@@ -165,7 +173,22 @@ private:
     bool interpolate_precursor_purity_;
 
     /// add channel information to the map after it has been filled
-    void registerChannelsInOutputMap_(ConsensusMap& consensus_map);
+    void registerChannelsInOutputMap_(ConsensusMap& consensus_map) const;
+
+    /**
+      @brief Computes the precursor purity and extracts the reporter ions of a single job.
+
+      Only the result members of @p job are modified, so different jobs can be processed concurrently.
+    */
+    void processJob_(ExtractionJob_& job) const;
+
+    /**
+      @brief Prints statistics about the m/z calibration and the presence of signal in each channel.
+
+      @param mz_deltas The observed m/z deltas per channel.
+      @param signal_not_unique Number of spectra with more than one peak within the allowed mass shift per channel.
+    */
+    void printChannelQC_(std::vector<std::vector<double> >& mz_deltas, const std::vector<int>& signal_not_unique) const;
 
     /**
       @brief Checks if the given precursor fulfills all constraints for extractions.
@@ -184,22 +207,23 @@ private:
     bool hasLowIntensityReporter_(const ConsensusFeature& cf) const;
 
     /**
-      @brief Computes the purity of the precursor given an iterator pointing to the MS/MS spectrum and one to the precursor spectrum.
+      @brief Computes the purity of the precursor of an MS/MS spectrum, interpolated between the precursor and follow-up scan if requested.
 
-      @param ms2_spec Iterator pointing to the MS2 spectrum.
-      @param precursor Iterator pointing to the precursor spectrum of ms2_spec.
+      @param ms2_spec The MS/MS spectrum.
+      @param precursor_spec The precursor spectrum of @p ms2_spec.
+      @param follow_up_spec The first MS1 spectrum after @p ms2_spec, or null if there is none.
       @return Fraction of the total intensity in the isolation window of the precursor spectrum that was assigned to the precursor.
     */
-    double computePrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PuritySate_& pState) const;
+    double computePrecursorPurity_(const MSSpectrum& ms2_spec, const MSSpectrum& precursor_spec, const MSSpectrum* follow_up_spec) const;
 
     /**
-      @brief Computes the purity of the precursor given an iterator pointing to the MS/MS spectrum and a reference to the potential precursor spectrum.
+      @brief Computes the purity of the precursor of an MS/MS spectrum in a single MS1 spectrum.
 
-      @param ms2_spec Iterator pointing to the MS2 spectrum.
-      @param precursor Iterator pointing to the precursor spectrum of ms2_spec.
+      @param ms2_spec The MS/MS spectrum.
+      @param precursor_spec The (potential) precursor spectrum of @p ms2_spec.
       @return Fraction of the total intensity in the isolation window of the precursor spectrum that was assigned to the precursor.
     */
-    double computeSingleScanPrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const;
+    double computeSingleScanPrecursorPurity_(const MSSpectrum& ms2_spec, const MSSpectrum& precursor_spec) const;
 
     /**
       @brief Get the first (of potentially many) activation methods (HCD,CID,...) of this spectrum.
@@ -224,6 +248,111 @@ protected:
     /// implemented for DefaultParamHandler
     void updateMembers_() override;
   };
+
+  /**
+    @brief Consumer extracting isobaric channels from spectra as they are read, e.g. by MzMLFile::transform().
+
+    Only the MS1 scans required for the precursor purity computation (a rolling window around the
+    pending quantitation scans) and the reporter ion region of the pending quantitation scans are kept
+    in memory. Pending scans are processed in parallel batches as soon as their follow-up MS1 scan
+    has been seen. The result is identical to IsobaricChannelExtractor::extractChannels().
+
+    Since the MS level used for quantification is not known in advance, the highest MS level with a
+    valid activation method seen so far is used; results of lower levels are discarded once a
+    higher level shows up (e.g. MS2 results are replaced when the first MS3 scan is encountered).
+
+    @note finish() has to be called after the last spectrum has been consumed.
+  */
+  class OPENMS_DLLAPI IsobaricChannelExtractionConsumer :
+    public Interfaces::IMSDataConsumer
+  {
+public:
+    /**
+      @brief Constructor
+
+      @param extractor The (configured) channel extractor to use; a copy is stored.
+      @param consensus_map Output map, filled as the spectra are consumed and completed by finish().
+      @param quant_ms_level MS level used for quantification, or 0 to use the highest level present.
+    */
+    IsobaricChannelExtractionConsumer(const IsobaricChannelExtractor& extractor, ConsensusMap& consensus_map, UInt quant_ms_level = 0);
+
+    void consumeSpectrum(SpectrumType& s) override;
+
+    /// Chromatograms are ignored
+    void consumeChromatogram(ChromatogramType&) override {}
+
+    void setExpectedSize(Size, Size) override {}
+
+    void setExperimentalSettings(const ExperimentalSettings& exp) override;
+
+    /// Returns the experimental settings of the consumed data (if provided)
+    const ExperimentalSettings& getExperimentalSettings() const;
+
+    /**
+      @brief Processes the remaining scans, reports statistics and registers the channels in the output map.
+
+      @exception Exception::MissingInformation if no spectra were consumed
+    */
+    void finish();
+
+protected:
+    friend class IsobaricChannelExtractor;
+
+    /**
+      @brief Consumes a spectrum which may be shared with the caller.
+
+      @param s The spectrum.
+      @param shared Non-owning handle to @p s if it outlives the consumer (no copies are made then), or null.
+    */
+    void consume_(const MSSpectrum& s, const boost::shared_ptr<const MSSpectrum>& shared);
+
+    /// Processes the first @p count pending jobs in parallel and appends their results to the output map
+    void processPending_(Size count);
+
+    /// Appends the result of a processed job to the output map
+    void commitJob_(const IsobaricChannelExtractor::ExtractionJob_& job);
+
+    /// Number of resolved jobs which triggers the processing of a batch
+    static const Size BATCH_SIZE;
+
+    IsobaricChannelExtractor extractor_;
+    ConsensusMap& consensus_map_;
+    ExperimentalSettings settings_;
+    /// Predicate selecting scans with the requested activation method
+    HasActivationMethod<MSSpectrum> is_valid_activation_;
+
+    /// MS level used for quantification (0 if no quantitation scan was seen yet)
+    UInt quant_ms_level_;
+    /// If true, the quantitation level is fixed (i.e., given in the constructor)
+    bool fixed_ms_level_;
+
+    /// m/z range of the quantitation scans needed for reporter ion extraction
+    double min_reporter_mz_;
+    double max_reporter_mz_;
+
+    /// Number of consumed spectra
+    Size spectra_count_;
+    /// RT of the last consumed spectrum (to check for sorted input)
+    double last_rt_;
+    /// The last MS1 scan
+    boost::shared_ptr<const MSSpectrum> last_ms1_;
+    /// Indicates if an MS2 scan was seen after the last MS1 scan
+    bool has_last_ms2_;
+    double last_ms2_rt_;
+    double last_ms2_mz_;
+
+    /// Quantitation scans in the order of the input
+    std::vector<IsobaricChannelExtractor::ExtractionJob_> pending_;
+    /// Number of pending jobs (at the front) whose follow-up scan is known
+    Size resolved_;
+
+    /// the tandem-scans in the order they appear in the experiment
+    UInt64 element_index_;
+    std::map<UInt, UInt> ms_level_counts_;
+    std::map<String, int> activation_modes_;
+    std::vector<std::vector<double> > mz_deltas_;
+    std::vector<int> signal_not_unique_;
+  };
 } // namespace
 
 #endif // OPENMS_ANALYSIS_QUANTITATION_ISOBARICCHANNELEXTRACTOR_H
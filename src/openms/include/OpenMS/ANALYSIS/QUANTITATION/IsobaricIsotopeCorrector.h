@@ -75,7 +75,7 @@ private:
                                  const ConsensusMap& cm);
 
     /**
-     @brief
+     @brief Solves the NNLS problems for all columns of @p m_b (one per ConsensusFeature) at once.
      */
     static void solveNNLS_(const Matrix<double>& correction_matrix,
                            const Matrix<double>& m_b, Matrix<double>& m_x);
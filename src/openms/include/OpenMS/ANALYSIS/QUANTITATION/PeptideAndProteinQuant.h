@@ -192,6 +192,9 @@ private:
     /// Protein quantification data
     ProteinQuant prot_quant_;
 
+    /// Hash-based lookup of peptide data by sequence (used while reading data; defined in the implementation)
+    class PeptideIndex_;
+
 
     /**
          @brief Get the "canonical" annotation (a single peptide hit) of a feature/consensus feature from the associated list of peptide identifications.
@@ -206,7 +209,8 @@ private:
 
          Store quantitative information from @p feature in member @p pep_quant_, based on the peptide annotation in @p hit. If @p hit is empty ("ambiguous/no annotation"), nothing is stored.
     */
-    void quantifyFeature_(const FeatureHandle& feature, const PeptideHit& hit);
+    void quantifyFeature_(const FeatureHandle& feature, const PeptideHit& hit,
+                          PeptideIndex_& pep_index);
 
     /**
          @brief Order keys (charges/peptides for peptide/protein quantification) according to how many samples they allow to quantify, breaking ties by total abundance.
@@ -265,7 +269,8 @@ private:
 
          The peptide hits in @p peptides are sorted by score in the process.
     */
-    void countPeptides_(std::vector<PeptideIdentification>& peptides);
+    void countPeptides_(std::vector<PeptideIdentification>& peptides,
+                        PeptideIndex_& pep_index);
 
     /// Clear all data when parameters are set
     void updateMembers_() override;
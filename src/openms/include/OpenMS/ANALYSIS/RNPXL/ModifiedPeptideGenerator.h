@@ -58,12 +58,99 @@ namespace OpenMS
     // Applies variable modifications to a single peptide. If keep_original is set the original (e.g. unmodified version) is also returned
     static void applyVariableModifications(const std::vector<ResidueModification>::const_iterator& var_mods_begin, const std::vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, Size max_variable_mods_per_peptide, std::vector<AASequence>& all_modified_peptides, bool keep_original=true);
 
+    /**
+      @brief Enumerates the variable modification variants of a peptide without creating an AASequence for each of them
+
+      A variant is represented by the base peptide, the set of modified sites and the chosen modification per site.
+      Its mass is computed from precomputed mass differences, so the (expensive) AASequence only needs to be created
+      via getSequence() for variants that pass e.g. a precursor mass filter:
+
+      @code
+      ModifiedPeptideGenerator::VariantEnumerator variants(var_mods.begin(), var_mods.end(), peptide, 3);
+      while (variants.next())
+      {
+        if (!matchesPrecursor(variants.getMonoWeight())) continue;
+        AASequence candidate = variants.getSequence();
+        ...
+      }
+      @endcode
+
+      The variants are the same and come in the same order as those of applyVariableModifications(), which uses this class.
+      The modifications are referenced, not copied: the range [@p var_mods_begin, @p var_mods_end) and @p peptide must outlive the enumerator.
+
+      @note Like AASequence::setModification(), the constructor and getSequence() access ResidueDB, which creates modified residues on demand.
+    */
+    class OPENMS_DLLAPI VariantEnumerator
+    {
+    public:
+      /// Constructor
+      VariantEnumerator(const std::vector<ResidueModification>::const_iterator& var_mods_begin, const std::vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, Size max_variable_mods_per_peptide, bool keep_original = true);
+
+      /// Advances to the next variant (must be called before accessing the first one). Returns false if all variants have been enumerated (also on all further calls).
+      bool next();
+
+      /// Returns the monoisotopic mass (uncharged, full peptide) of the current variant
+      double getMonoWeight() const;
+
+      /// Returns the number of variable modifications of the current variant
+      Size getNumberOfModifications() const;
+
+      /// Creates the AASequence of the current variant
+      AASequence getSequence() const;
+
+    protected:
+      /// A modifiable site (residue index, or N-/C-terminus) with its compatible modifications
+      struct Site_
+      {
+        int index;
+        std::vector<const ResidueModification*> mods;
+        std::vector<double> mass_deltas;
+      };
+
+      /// Enumeration state
+      enum State_
+      {
+        NOT_STARTED, ///< next() has not been called yet
+        ORIGINAL, ///< the current variant is the original peptide
+        ENUMERATING, ///< the current variant has variable modifications
+        DONE ///< all variants have been enumerated
+      };
+
+      /// Selects the first subset of @p n_mods sites; returns false (and finishes the enumeration) if more sites are requested than allowed/available
+      bool startPlacements_(Size n_mods);
+      /// Sets up selected_ and choices_ for the current subset_mask_
+      void startSubset_();
+      /// Sums up the mass difference of the current variant to the original peptide
+      void updateMass_();
+
+      const AASequence& peptide_;
+      std::vector<Site_> sites_;
+      Size max_placements_;
+      bool keep_original_;
+      State_ state_;
+      /// Mass of the original peptide (computed on first use, negative if not yet known)
+      mutable double base_mass_;
+
+      /// Sites modified in the current variant (in the order of sites_)
+      std::vector<bool> subset_mask_;
+      /// Indices (into sites_) of the modified sites
+      std::vector<Size> selected_;
+      /// Chosen modification for each modified site
+      std::vector<Size> choices_;
+      /// Mass difference of the current variant to the original peptide
+      double mass_delta_;
+    };
+
   protected:
-    // Recursively generate all combinatoric placements at compatible sites
-    static void recurseAndGenerateVariableModifiedPeptides_(const std::vector<int>& subset_indices, const std::map<int, std::vector<ResidueModification> >& map_compatibility, int depth, const AASequence& current_peptide, std::vector<AASequence>& modified_peptides);
+    // Magic constants to distinguish N_TERM/C_TERM only modifications from ANYWHERE modifications placed at the terminal residues
+    static const int N_TERM_MODIFICATION_INDEX;
+    static const int C_TERM_MODIFICATION_INDEX;
+
+    // Builds the compatibility mapping describing which site (peptide index or terminus) is compatible with which modification
+    static void getCompatibleSites_(const std::vector<ResidueModification>::const_iterator& var_mods_begin, const std::vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, std::map<int, std::vector<const ResidueModification*> >& map_compatibility);
 
-    // Fast implementation of modification placement. No combinatoric placement is needed in this case - just every site is modified once by each compatible modification. Already modified residues are skipped
-    static void applyAtMostOneVariableModification_(const std::vector<ResidueModification>::const_iterator& var_mods_begin, const std::vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, std::vector<AASequence>& all_modified_peptides, bool keep_original=true);
+    // Compatibility mapping for at most one modification per peptide. No combinatoric placement is needed in this case - just every site is modified once by each compatible modification (terminal ones at the terminal residue). Already modified residues are skipped
+    static void getSingleModificationSites_(const std::vector<ResidueModification>::const_iterator& var_mods_begin, const std::vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, std::map<int, std::vector<const ResidueModification*> >& map_compatibility);
 
   };
 }
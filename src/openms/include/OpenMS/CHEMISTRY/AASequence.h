@@ -41,8 +41,10 @@
 #include <OpenMS/CONCEPT/Types.h>
 #include <OpenMS/CHEMISTRY/Residue.h>
 
-#include <vector>
+#include <atomic>
 #include <iosfwd>
+#include <memory>
+#include <vector>
 
 namespace OpenMS
 {
@@ -103,6 +105,14 @@ namespace OpenMS
       no formula for them).  However, they have an influence on getMonoWeight()
       and getAverageWeight()!
 
+      Parsing sequences with modifications requires look-ups in the
+      ModificationsDB, so fromString() caches the results for such strings
+      (unmodified sequences are parsed directly). The summed mass and formula
+      of the residues are memoized on the first call to getMonoWeight() and
+      getFormula(), respectively, and reset when the residues change. The memos
+      are updated atomically, so const member functions of the same object may
+      be called from several threads concurrently.
+
       @ingroup Chemistry
   */
   class OPENMS_DLLAPI AASequence
@@ -589,6 +599,15 @@ protected:
 
     const ResidueModification* c_term_mod_;
 
+    /// memoized sum of the internal mono isotopic weights of all residues (NaN if not computed yet)
+    mutable std::atomic<double> residue_mono_weight_;
+
+    /// memoized sum of the internal formulas of all residues (null if not computed yet, access only via std::atomic_load/atomic_store)
+    mutable std::shared_ptr<const EmpiricalFormula> residue_formula_;
+
+    /// resets the memoized residue weight and formula (call whenever the residues change)
+    void resetMemo_();
+
     /** 
       @brief Parses modifications in round brackets (an identifier)
 
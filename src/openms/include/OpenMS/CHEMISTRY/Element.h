@@ -97,12 +97,19 @@ public:
     /// returns the mono isotopic weight of the element
     double getMonoWeight() const;
 
-    /// sets the isotope distribution of the element
+    /// sets the isotope distribution of the element (increments getIsotopeDistributionVersion())
     void setIsotopeDistribution(const IsotopeDistribution & isotopes);
 
     /// returns the isotope distribution of the element
     const IsotopeDistribution & getIsotopeDistribution() const;
 
+    /**
+      @brief returns a counter which is incremented whenever the isotope distribution of any element is changed
+
+      Caches of isotope patterns (e.g. IsotopePatternGenerator) compare it to detect stale entries.
+    */
+    static Size getIsotopeDistributionVersion();
+
     /// set the name of the element
     void setName(const String & name);
 
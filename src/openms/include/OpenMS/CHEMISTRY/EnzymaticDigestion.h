@@ -40,6 +40,7 @@
 
 #include <boost/regex.hpp>
 
+#include <bitset>
 #include <string>
 #include <vector>
 #include <functional>
@@ -194,10 +195,51 @@ protected:
     /// Number of missed cleavages
     Size missed_cleavages_;
 
+    /**
+      @brief Cleavage rule compiled from the enzyme's regular expression
+
+      Covers the regular expressions used by the enzymes in ProteaseDB and RNaseDB: alternatives ('|') of
+      single-character look-behind, look-ahead and negative look-ahead assertions, e.g. "(?<=[KR])(?!P)" or "(?=D)".
+      A position between two residues is a cleavage site if all assertions of at least one alternative hold.
+    */
+    struct CleavageRule_
+    {
+      /// A single alternative of the rule
+      struct Alternative
+      {
+        Alternative();
+
+        bool has_lookbehind;
+        bool has_lookahead;
+        bool has_negative_lookahead;
+        /// residues allowed before the site
+        std::bitset<256> lookbehind;
+        /// residues required after the site
+        std::bitset<256> lookahead;
+        /// residues forbidden after the site
+        std::bitset<256> negative_lookahead;
+      };
+
+      /// Compiles @p regex; returns false (and leaves the rule empty) if the expression is not supported
+      bool compile(const String& regex);
+
+      /// Is there a cleavage site before position @p pos of the range [@p begin, @p end)?
+      bool isCleavageSite(const char* begin, const char* pos, const char* end) const;
+
+      std::vector<Alternative> alternatives;
+    };
+
+    /// Sets up the cleavage rule and regular expression for the current enzyme (called by setEnzyme())
+    void compileCleavageRule_();
+
     /// Used enzyme
     const DigestionEnzyme* enzyme_;
     /// Regex for tokenizing (huge speedup by making this a member instead of stack object in tokenize_())
     boost::regex re_;
+    /// Compiled cleavage rule, replaces @p re_ in tokenize_() whenever the enzyme's regex is supported
+    CleavageRule_ rule_;
+    /// Is @p rule_ valid for the current enzyme?
+    bool use_rule_;
 
     /// specificity of enzyme
     Specificity specificity_;
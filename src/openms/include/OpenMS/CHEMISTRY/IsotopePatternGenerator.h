@@ -0,0 +1,196 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#ifndef OPENMS_CHEMISTRY_ISOTOPEPATTERNGENERATOR_H
+#define OPENMS_CHEMISTRY_ISOTOPEPATTERNGENERATOR_H
+
+#include <OpenMS/CHEMISTRY/IsotopeDistribution.h>
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+  class Element;
+
+  /**
+    @ingroup Chemistry
+
+    @brief Fast computation of fine-structure and coarse isotope patterns with a result cache
+
+    Fine-structure patterns resolve the individual isotopologues of a molecule (e.g. the
+    @f$^{13}C@f$ and @f$^{15}N@f$ peaks at nominal offset +1 are reported separately).
+    They are computed with a multinomial threshold method: for each element, only the
+    isotope compositions above the probability threshold are enumerated (starting at the
+    mode of each conditional binomial), and the element patterns are combined while
+    discarding products below the threshold. Isotopologues closer than the requested
+    resolution are merged into a single peak at their probability-weighted mean mass.
+
+    Coarse patterns aggregate to nominal mass offsets and are identical to
+    EmpiricalFormula::getIsotopeDistribution().
+
+    All results are memoized. The cache is keyed by the formula (or the averagine model and
+    its estimated formula) and by the resolution or number of isotopes, respectively. Each
+    cache holds at most MAX_CACHE_SIZE patterns and is cleared when it is full. It is also
+    cleared when the isotope abundances of an element were changed since the last access
+    (see Element::getIsotopeDistributionVersion()). All const member functions can be called
+    from multiple threads concurrently, but every cache access is serialized; hot loops should
+    precompute the patterns they need instead.
+
+    Use getInstance() to share a cache between algorithms.
+  */
+  class OPENMS_DLLAPI IsotopePatternGenerator
+  {
+public:
+    /// fine-structure pattern: pairs of exact mass and probability, sorted by mass
+    typedef std::vector<std::pair<double, double> > FineStructure;
+
+    /// maximum number of entries of each cache (fine-structure and coarse)
+    static const Size MAX_CACHE_SIZE;
+
+    /**
+      @brief Constructor
+
+      @param probability_threshold Isotopologues with a lower probability are not reported by getFineStructure().
+    */
+    explicit IsotopePatternGenerator(double probability_threshold = 1e-6);
+
+    /// Destructor
+    virtual ~IsotopePatternGenerator();
+
+    /// returns a shared instance (with the default probability threshold)
+    static IsotopePatternGenerator* getInstance();
+
+    /// returns the probability threshold for fine-structure patterns
+    double getProbabilityThreshold() const;
+
+    /**
+      @brief Returns the fine-structure isotope pattern of a neutral molecule
+
+      @param formula Sum formula
+      @param resolution Isotopologues closer than @p resolution (in Da) are merged. With 0, all isotopologues are reported separately.
+
+      @throw Exception::IllegalArgument if the formula contains negative element counts
+    */
+    FineStructure getFineStructure(const EmpiricalFormula& formula, double resolution = 0.0) const;
+
+    /**
+      @brief Returns the coarse (nominal mass) isotope distribution of a molecule
+
+      Same result as EmpiricalFormula::getIsotopeDistribution(max_isotope).
+    */
+    IsotopeDistribution getCoarseDistribution(const EmpiricalFormula& formula, Size max_isotope) const;
+
+    /**
+      @brief Returns the coarse isotope distribution of an averagine molecule
+
+      Same result as IsotopeDistribution::estimateFromPeptideWeight(), estimateFromRNAWeight() or
+      estimateFromDNAWeight() with max. isotope @p max_isotope.
+
+      @param average_weight Average weight of the molecule
+      @param max_isotope Number of isotopes
+      @param type Averagine model ("peptide", "RNA" or "DNA")
+
+      @throw Exception::InvalidParameter if @p type is unknown
+    */
+    IsotopeDistribution getAveragineDistribution(double average_weight, Size max_isotope, const String& type = "peptide") const;
+
+    /**
+      @brief Batch version of getAveragineDistribution()
+
+      The distributions are computed in parallel (if OpenMP is enabled).
+      Averagine formulas are rounded to whole atoms, hence many weights share a cached result.
+
+      @throw Exception::InvalidParameter if @p type is unknown
+    */
+    std::vector<IsotopeDistribution> getAveragineDistributions(const std::vector<double>& average_weights, Size max_isotope, const String& type = "peptide") const;
+
+    /// Batch version of getAveragineDistribution() for weights from @p weight_min to @p weight_max (inclusive) with step size @p weight_step
+    std::vector<IsotopeDistribution> getAveragineDistributions(double weight_min, double weight_max, double weight_step, Size max_isotope, const String& type = "peptide") const;
+
+    /**
+      @brief Returns the averagine formula (rounded to whole atoms) for the given average weight
+
+      All weights with the same averagine formula have the same averagine isotope distribution.
+
+      @throw Exception::InvalidParameter if @p type is unknown
+    */
+    static EmpiricalFormula getAveragineFormula(double average_weight, const String& type = "peptide");
+
+    /// returns the number of cached patterns
+    Size getCacheSize() const;
+
+    /// removes all cached patterns
+    void clearCache();
+
+protected:
+    /// isotope pattern of a single element: pairs of mass and probability
+    typedef std::vector<std::pair<double, double> > ElementPattern_;
+
+    /// computes the fine-structure pattern of @p count atoms of @p element
+    void computeElementPattern_(const Element* element, SignedSize count, ElementPattern_& result) const;
+
+    /// computes the (uncached) fine-structure pattern
+    void computeFineStructure_(const EmpiricalFormula& formula, double resolution, FineStructure& result) const;
+
+    /// clears the caches if the element isotope distributions changed (call only inside the cache critical section)
+    void validateCache_() const;
+
+    /// probability threshold for fine-structure patterns
+    double probability_threshold_;
+
+    /// cache for fine-structure patterns (key: formula and resolution)
+    mutable std::map<std::pair<String, double>, FineStructure> fine_cache_;
+
+    /// cache for coarse distributions (key: formula and number of isotopes)
+    mutable std::map<std::pair<String, Size>, IsotopeDistribution> coarse_cache_;
+
+    /// value of Element::getIsotopeDistributionVersion() the cached patterns were computed with
+    mutable Size cache_version_;
+
+private:
+    /// not implemented
+    IsotopePatternGenerator(const IsotopePatternGenerator&);
+
+    /// not implemented
+    IsotopePatternGenerator& operator=(const IsotopePatternGenerator&);
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_CHEMISTRY_ISOTOPEPATTERNGENERATOR_H
@@ -57,6 +57,11 @@ namespace OpenMS
       By default no modified residues are stored in an instance. However, if one
       queries the instance with getModifiedResidue, a new modified residue is
       added.
+
+      Adding residues is not thread-safe. Multi-threaded code should register
+      all modifications it uses with registerModifications() up front: lookups
+      of registered modified residues only read from precomputed tables and
+      can then be done concurrently without locking.
   */
   class OPENMS_DLLAPI ResidueDB
   {
@@ -120,6 +125,17 @@ public:
     */
     const Residue* getModifiedResidue(const Residue* residue, const String& name);
 
+    /**
+       @brief Creates the modified residues for the given modifications (names as accepted by ModificationsDB)
+
+       A modification is registered for its residue of origin, or for all residues if it can occur at any residue ('X').
+       Modifications which cannot be applied to a residue (e.g. pure terminal modifications) are skipped.
+
+       Call this before a parallel section: afterwards, getModifiedResidue() with one of the given names
+       (or any other name or ID of the modification) does not modify the database.
+    */
+    void registerModifications(const std::vector<String>& modifications);
+
     /**
        @brief returns a set of all residues stored in this residue db
 
@@ -214,6 +230,8 @@ protected:
 
     // fast lookup table for residues
     Residue* residue_by_one_letter_code_[256];
+    /// modified residues by one letter code of the unmodified residue and by any name/ID of the modification (read-only after registration)
+    boost::unordered_map<String, const Residue*> modified_residue_by_one_letter_code_[256];
 
     Map<String, Map<String, Residue*> > residue_mod_names_;
 
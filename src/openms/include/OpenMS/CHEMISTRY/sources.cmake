@@ -15,6 +15,7 @@ DigestionEnzymeProtein.h
 DigestionEnzymeRNA.h
 DigestionEnzymeDB.h
 IsotopeDistribution.h
+IsotopePatternGenerator.h
 ModificationDefinition.h
 ModificationDefinitionsSet.h
 ModificationsDB.h
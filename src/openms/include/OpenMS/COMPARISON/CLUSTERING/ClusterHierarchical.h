@@ -68,6 +68,48 @@ private:
     /// the threshold given to the ClusterFunctor
     double threshold_;
 
+    /**
+        @brief Fills @p distance with the pairwise distances (1 - similarity) of the elements in @p data
+
+        Blocks of rows are computed in parallel. Within a block, the columns
+        are processed in tiles, so that the compared objects are reused while
+        they are in cache. The rows of the distance matrix are written with
+        unit stride.
+
+        @note @p comparator is called concurrently and must therefore be thread-safe.
+        @pre @p distance must have the size of @p data
+    */
+    template <typename Data, typename SimilarityComparator>
+    static void fillDistanceMatrix_(const std::vector<Data> & data,
+      const SimilarityComparator & comparator,
+      DistanceMatrix<float> & distance)
+    {
+      const SignedSize block_size = 64;
+      const SignedSize num_blocks = (data.size() + block_size - 1) / block_size;
+      // (later blocks contain longer rows, so start with those)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for (SignedSize block = num_blocks - 1; block >= 0; --block)
+      {
+        const Size row_begin = block * block_size;
+        const Size row_end = std::min(data.size(), Size(row_begin + block_size));
+        for (Size col_begin = 0; col_begin < row_end; col_begin += block_size)
+        {
+          for (Size i = std::max(row_begin, col_begin + 1); i < row_end; ++i)
+          {
+            float* row = distance.getRow(i);
+            const Size col_end = std::min(i, col_begin + block_size);
+            for (Size j = col_begin; j < col_end; ++j)
+            {
+              // distance value is 1-similarity value, since similarity is in range of [0,1]
+              row[j] = 1 - comparator(data[i], data[j]);
+            }
+          }
+        }
+      }
+    }
+
 public:
     /// default constructor
     ClusterHierarchical() :
@@ -121,14 +163,7 @@ public:
         // create distance matrix for data using comparator
         original_distance.clear();
         original_distance.resize(data.size(), 1);
-        for (Size i = 0; i < data.size(); i++)
-        {
-          for (Size j = 0; j < i; j++)
-          {
-            // distance value is 1-similarity value, since similarity is in range of [0,1]
-            original_distance.setValueQuick(i, j, 1 - comparator(data[i], data[j]));
-          }
-        }
+        fillDistanceMatrix_(data, comparator, original_distance);
       }
 
       // create clustering with ClusterMethod, DistanceMatrix and Data
@@ -167,15 +202,8 @@ public:
       //create distancematrix for data with comparator
       original_distance.clear();
       original_distance.resize(data.size(), 1);
-
-      for (Size i = 0; i < binned_data.size(); i++)
-      {
-        for (Size j = 0; j < i; j++)
-        {
-          //distance value is 1-similarity value, since similarity is in range of [0,1]
-          original_distance.setValue(i, j, 1 - comparator(binned_data[i], binned_data[j]));
-        }
-      }
+      fillDistanceMatrix_(binned_data, comparator, original_distance);
+      original_distance.updateMinElement();
 
       // create Clustering with ClusterMethod, DistanceMatrix and Data
       clusterer(original_distance, cluster_tree, threshold_);
@@ -40,10 +40,14 @@
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/config.h>
 
+#include <boost/iostreams/device/mapped_file.hpp>
+
 #include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <new>
+#include <string>
 
 namespace OpenMS
 {
@@ -62,6 +66,11 @@ namespace OpenMS
     of OpenMS::DistanceMatrix::updateMinElement, see the respective methods
     documentation.
 
+    The lower triangle is stored row by row in one contiguous block of
+    memory: row @em i holds the @em i elements (i,0) ... (i,i-1), see
+    getRow. For very large matrices, the block can be placed in a
+    memory-mapped file instead of the heap (see setBackingFile).
+
     @ingroup Datastructures
   */
   template <typename Value>
@@ -84,7 +93,7 @@ public:
 
     */
     DistanceMatrix() :
-      matrix_(nullptr), init_size_(0), dimensionsize_(0), min_element_(0, 0)
+      matrix_(nullptr), init_size_(0), dimensionsize_(0), min_element_(0, 0), backing_file_(), mapped_file_(nullptr)
     {
     }
 
@@ -96,89 +105,31 @@ public:
       @throw Exception::OutOfMemory if requested dimensionsize is to big to fit into memory
     */
     DistanceMatrix(SizeType dimensionsize, Value value = Value()) :
-      matrix_(new ValueType*[dimensionsize]), init_size_(dimensionsize), dimensionsize_(dimensionsize), min_element_(0, 0)
+      matrix_(nullptr), init_size_(0), dimensionsize_(0), min_element_(0, 0), backing_file_(), mapped_file_(nullptr)
     {
-      matrix_[0] = NULL;
-      SizeType i = 1;
-      for (i = 1; i < dimensionsize; ++i)
-      {
-        matrix_[i] = new ValueType[i];
-        if (matrix_[i] == NULL)
-        {
-          SizeType j = i;
-          for (i = 1; i < j; i++)
-          {
-            delete[] matrix_[i];
-          }
-          delete[] matrix_;
-          matrix_ = NULL;
-          dimensionsize_ = 0;
-          init_size_ = 0;
-          throw Exception::OutOfMemory(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, (UInt)((((dimensionsize - 2) * (dimensionsize - 1)) / 2) * sizeof(ValueType)));
-        }
-      }
-      if (matrix_ != NULL)
-      {
-        for (i = 1; i < dimensionsize; ++i)
-        {
-          for (SizeType j = 0; j < i; ++j)
-          {
-            matrix_[i][j] = value;
-          }
-        }
-        min_element_ = std::make_pair(1, 0);
-      }
+      resize(dimensionsize, value);
     }
 
     /**
       @brief copy constructor
 
+      The copy is always held on the heap, also if @p source is file-backed.
+
       @param source  this DistanceMatrix will be copied
       @throw Exception::OutOfMemory if requested dimensionsize is to big to fit into memory
     */
     DistanceMatrix(const DistanceMatrix& source) :
-      matrix_(new ValueType*[source.dimensionsize_]),
-      init_size_(source.dimensionsize_),
-      dimensionsize_(source.dimensionsize_),
-      min_element_(source.min_element_)
+      matrix_(nullptr), init_size_(0), dimensionsize_(0), min_element_(0, 0), backing_file_(), mapped_file_(nullptr)
     {
-      matrix_[0] = NULL;
-      SizeType i = 1;
-      for (i = 1; i < dimensionsize_; ++i)
-      {
-        matrix_[i] = new ValueType[i];
-        if (matrix_[i] == NULL)
-        {
-          SizeType j = i;
-          for (i = 1; i < j; i++)
-          {
-            delete[] matrix_[i];
-          }
-          delete[] matrix_;
-          matrix_ = NULL;
-          dimensionsize_ = 0;
-          init_size_ = 0;
-          min_element_ = std::make_pair(0, 0);
-          throw Exception::OutOfMemory(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, (UInt)((((dimensionsize_ - 2) * (dimensionsize_ - 1)) / 2) * sizeof(ValueType)));
-        }
-      }
-      if (matrix_ != NULL)
-      {
-        for (i = 1; i < dimensionsize_; ++i)
-        {
-          std::copy(source.matrix_[i], source.matrix_[i] + i, matrix_[i]);
-        }
-      }
+      allocate_(source.dimensionsize_);
+      std::copy(source.matrix_, source.matrix_ + numElements_(dimensionsize_), matrix_);
+      min_element_ = source.min_element_;
     }
 
     /// destructor
     ~DistanceMatrix()
     {
-      for (SizeType i = 1; i < init_size_; i++)
-      {
-        delete[] matrix_[i];
-      }
-      delete[] matrix_;
+      deallocate_();
     }
 
     /**
@@ -225,7 +176,7 @@ public:
       {
         std::swap(i, j);
       }
-      return (const ValueType)(matrix_[i][j]);
+      return (const ValueType)(matrix_[offset_(i) + j]);
     }
 
     /**
@@ -250,7 +201,44 @@ public:
       {
         std::swap(i, j);
       }
-      return matrix_[i][j];
+      return matrix_[offset_(i) + j];
+    }
+
+    /**
+      @brief gets the stored part of a row, i.e. the @p i elements (i,0) ... (i,i-1)
+
+      The elements are contiguous in memory, so a row can be scanned with unit
+      stride. Row 0 contains no elements.
+
+      @param i the i-th row
+      @throw Exception::OutOfRange if @p i is out of range
+
+      @note The pointer is invalidated by resize, clear and reduce.
+    */
+    const ValueType* getRow(SizeType i) const
+    {
+      if (i >= dimensionsize_)
+      {
+        throw Exception::OutOfRange(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+      }
+      return matrix_ + offset_(i);
+    }
+
+    /**
+      @brief gets the stored part of a row for writing, i.e. the @p i elements (i,0) ... (i,i-1)
+
+      @param i the i-th row
+      @throw Exception::OutOfRange if @p i is out of range
+
+      possible invalidation of min_element_ - make sure to update before further usage of matrix
+    */
+    ValueType* getRow(SizeType i)
+    {
+      if (i >= dimensionsize_)
+      {
+        throw Exception::OutOfRange(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+      }
+      return matrix_ + offset_(i);
     }
 
     /**
@@ -274,23 +262,24 @@ public:
         {
           std::swap(i, j);
         }
+        ValueType& min_value = matrix_[offset_(min_element_.first) + min_element_.second];
         if (i != min_element_.first && j != min_element_.second)
         {
-          matrix_[i][j] = value;
-          if (value < matrix_[min_element_.first][min_element_.second]) // keep min_element_ up-to-date
+          matrix_[offset_(i) + j] = value;
+          if (value < min_value) // keep min_element_ up-to-date
           {
             min_element_ = std::make_pair(i, j);
           }
         }
         else
         {
-          if (value <= matrix_[min_element_.first][min_element_.second])
+          if (value <= min_value)
           {
-            matrix_[i][j] = value;
+            matrix_[offset_(i) + j] = value;
           }
           else
           {
-            matrix_[i][j] = value;
+            matrix_[offset_(i) + j] = value;
             updateMinElement();
           }
         }
@@ -320,22 +309,15 @@ public:
         {
           std::swap(i, j);
         }
-        matrix_[i][j] = value;
+        matrix_[offset_(i) + j] = value;
       }
     }
 
     /// reset all
     void clear()
     {
-      for (SizeType i = 1; i < init_size_; i++)
-      {
-        delete[] matrix_[i];
-      }
-      delete[] matrix_;
-      matrix_ = nullptr;
+      deallocate_();
       min_element_ = std::make_pair(0, 0);
-      dimensionsize_ = 0;
-      init_size_ = 0;
     }
 
     /**
@@ -349,42 +331,31 @@ public:
     */
     void resize(SizeType dimensionsize, Value value = Value())
     {
-      for (SizeType j = 1; j < init_size_; j++)
-      {
-        delete[] matrix_[j];
-      }
-      delete[] matrix_;
-      dimensionsize_ = dimensionsize;
-      init_size_ = dimensionsize;
+      deallocate_();
       min_element_ = std::make_pair(0, 0);
-      matrix_ = new ValueType*[dimensionsize_];
-      for (SizeType j = 1; j < dimensionsize_; ++j)
-      {
-        matrix_[j] = new ValueType[j];
-        if (matrix_[j] == nullptr)
-        {
-          for (SizeType k = 1; k < j; ++k)
-          {
-            delete[] matrix_[k];
-          }
-          delete[] matrix_;
-          matrix_ = nullptr;
-          dimensionsize_ = 0;
-          init_size_ = 0;
-          throw Exception::OutOfMemory(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, (UInt)((((dimensionsize_ - 2) * (dimensionsize_ - 1)) / 2) * sizeof(Value)));
-        }
-      }
-      if (matrix_ != nullptr)
-      {
-        for (SizeType j = 0; j < dimensionsize; ++j)
-        {
-          for (SizeType k = 0; k < j; ++k)
-          {
-            matrix_[j][k] = value;
-          }
-        }
-        min_element_ = std::make_pair(1, 0);
-      }
+      allocate_(dimensionsize);
+      std::fill(matrix_, matrix_ + numElements_(dimensionsize_), value);
+      min_element_ = std::make_pair(1, 0);
+    }
+
+    /**
+      @brief places the matrix in a memory-mapped file from the next resize on
+
+      Useful if the matrix does not fit into main memory. The file is
+      created (or overwritten) with the required size and is not removed
+      afterwards. An empty name restores the default (heap memory).
+
+      @param filename the name of the file to map
+    */
+    void setBackingFile(const std::string& filename)
+    {
+      backing_file_ = filename;
+    }
+
+    /// returns the name of the backing file (empty if the matrix is kept on the heap)
+    const std::string& getBackingFile() const
+    {
+      return backing_file_;
     }
 
     /**
@@ -401,17 +372,15 @@ public:
       {
         throw Exception::OutOfRange(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
       }
-      //delete row j and therefor overwrite with row j+1 and iterate like this to last row
-      SizeType i = j + 1;
-      while (i < dimensionsize_ && matrix_[i] != nullptr)
+      // delete row j and therefore overwrite with row j+1 and iterate like this
+      // to the last row; the rows move towards the front of the block, so the
+      // copies never overwrite data that is still to be read
+      for (SizeType i = j + 1; i < dimensionsize_; ++i)
       {
-        //left out in the copy is each rows jth element, pointer working here as iterators just fine
-        std::copy(matrix_[i] + j + 1, matrix_[i] + i, std::copy(matrix_[i], matrix_[i] + j, matrix_[i - 1]));
-        ++i;
+        // left out in the copy is each rows jth element
+        ValueType* row = matrix_ + offset_(i);
+        std::copy(row + j + 1, row + i, std::copy(row, row + j, matrix_ + offset_(i - 1)));
       }
-      //last row is freed and the pointer set to NULL (outer array's size is not changed)
-      delete[] matrix_[i - 1];
-      matrix_[i - 1] = nullptr;
       --dimensionsize_;
     }
 
@@ -436,15 +405,15 @@ public:
       }
       if (dimensionsize_ != 1) //else matrix has one element: (1,0)
       {
-        ValueType* row_min_;
-        for (SizeType r = 2; r < dimensionsize_ && matrix_[r] != nullptr; ++r)
+        // rows are stored consecutively, so the first minimum in storage order
+        // is the first minimum row by row
+        SizeType pos = std::min_element(matrix_, matrix_ + numElements_(dimensionsize_)) - matrix_;
+        SizeType row = 1;
+        while (offset_(row + 1) <= pos)
         {
-          row_min_ = std::min_element(matrix_[r], matrix_[r] + r);
-          if (*row_min_ < matrix_[min_element_.first][min_element_.second])
-          {
-            min_element_ = std::make_pair(r, row_min_ - matrix_[r]);
-          }
+          ++row;
         }
+        min_element_ = std::make_pair(row, pos - offset_(row));
       }
     }
 
@@ -456,17 +425,7 @@ public:
     bool operator==(DistanceMatrix<ValueType> const& rhs) const
     {
       OPENMS_PRECONDITION(dimensionsize_ == rhs.dimensionsize_, "DistanceMatrices have different sizes.");
-      for (Size i = 1; i < rhs.dimensionsize(); ++i)
-      {
-        for (Size j = 0; j < i; ++j)
-        {
-          if (matrix_[i][j] != rhs.matrix_[i][j])
-          {
-            return false;
-          }
-        }
-      }
-      return true;
+      return std::equal(matrix_, matrix_ + numElements_(rhs.dimensionsize()), rhs.matrix_);
     }
 
     /**
@@ -484,14 +443,80 @@ public:
     }
 
 protected:
-    /// sparse element not to be included in base container
-    ValueType** matrix_;
-    /// number of actually stored rows
-    SizeType init_size_; // actual size of outer array
+    /// lower triangle (without main diagonal), stored row by row
+    ValueType* matrix_;
+    /// number of allocated rows
+    SizeType init_size_; // actual size of the block: ((init_size_-1)*(init_size_))/2
     /// number of accessibly stored rows (i.e. number of columns)
     SizeType dimensionsize_; //number of virtual elements: ((dimensionsize-1)*(dimensionsize))/2
     /// index of minimal element(i.e. number in underlying SparseVector)
     std::pair<SizeType, SizeType> min_element_;
+    /// file to map the matrix to (empty: use heap memory)
+    std::string backing_file_;
+    /// memory-mapped file holding the matrix (null if on the heap)
+    boost::iostreams::mapped_file_sink* mapped_file_;
+
+    /// position of the first element of row @p i in the block
+    static SizeType offset_(SizeType i)
+    {
+      return i < 1 ? 0 : (i * (i - 1)) / 2;
+    }
+
+    /// number of stored elements for @p dimensionsize rows
+    static SizeType numElements_(SizeType dimensionsize)
+    {
+      return offset_(dimensionsize);
+    }
+
+    /// allocates an (uninitialized) block for @p dimensionsize rows, on the heap or in the backing file
+    void allocate_(SizeType dimensionsize)
+    {
+      const SizeType num_elements = numElements_(dimensionsize);
+      try
+      {
+        if (backing_file_.empty() || num_elements == 0)
+        {
+          matrix_ = new ValueType[num_elements];
+        }
+        else
+        {
+          boost::iostreams::mapped_file_params params(backing_file_);
+          params.new_file_size = num_elements * sizeof(ValueType);
+          params.flags = boost::iostreams::mapped_file::readwrite;
+          mapped_file_ = new boost::iostreams::mapped_file_sink(params);
+          matrix_ = reinterpret_cast<ValueType*>(mapped_file_->data());
+        }
+      }
+      catch (std::exception&)
+      {
+        delete mapped_file_;
+        mapped_file_ = nullptr;
+        matrix_ = nullptr;
+        dimensionsize_ = 0;
+        init_size_ = 0;
+        throw Exception::OutOfMemory(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, num_elements * sizeof(ValueType));
+      }
+      dimensionsize_ = dimensionsize;
+      init_size_ = dimensionsize;
+    }
+
+    /// releases the block (heap memory or memory-mapped file)
+    void deallocate_()
+    {
+      if (mapped_file_ != nullptr)
+      {
+        mapped_file_->close();
+        delete mapped_file_;
+        mapped_file_ = nullptr;
+      }
+      else
+      {
+        delete[] matrix_;
+      }
+      matrix_ = nullptr;
+      dimensionsize_ = 0;
+      init_size_ = 0;
+    }
 
 private:
     /// assignment operator (unsafe)
@@ -501,6 +526,8 @@ private:
       init_size_ = rhs.init_size_;
       dimensionsize_ = rhs.dimensionsize_;
       min_element_ = rhs.min_element_;
+      backing_file_ = rhs.backing_file_;
+      mapped_file_ = rhs.mapped_file_;
 
       return *this;
     }
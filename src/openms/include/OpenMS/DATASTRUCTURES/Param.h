@@ -42,6 +42,7 @@
 #include <OpenMS/OpenMSConfig.h>
 
 #include <iosfwd>
+#include <memory>
 #include <set>
 
 namespace OpenMS
@@ -617,11 +618,32 @@ protected:
     */
     ParamEntry& getEntry_(const String& key) const;
 
+    /**
+      @brief Looks up a parameter entry by its full key (nullptr if it does not exist).
+
+      Uses the flat key index (built on demand) and falls back to a tree search
+      if the index is outdated. Safe to call concurrently on a const Param.
+    */
+    ParamEntry* findEntry_(const String& key) const;
+
     /// Constructor from a node which is used as root node
     Param(const Param::ParamNode& node);
 
     /// Invisible root node that stores all the data
     mutable Param::ParamNode root_;
+
+    /// Flat index from full keys to the position of the entry in the tree (defined in the implementation)
+    struct KeyIndex_;
+
+    /**
+      @brief Key index of @p root_ (built lazily, nullptr if not built yet)
+
+      The index stores positions (not pointers) and is immutable once built, so copies of
+      a Param share it until the tree structure changes. Positions are validated on
+      every lookup, thus an outdated index is never harmful, only rebuilt.
+      Const member functions access it only via std::atomic_load/atomic_store (no global lock).
+    */
+    mutable std::shared_ptr<const KeyIndex_> index_;
   };
 
   /// Output of Param to a stream.
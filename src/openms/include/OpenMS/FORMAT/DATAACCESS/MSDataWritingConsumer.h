@@ -71,11 +71,15 @@ namespace OpenMS
       consumer->consumeSpectrum(spec);
       consumer->consumeChromatogram(chrom);
       [...]
+      consumer->close(); // reports write errors
       delete consumer;
       @endcode
 
       @note The first usage of consumeChromatogram or consumeSpectrum will start
-      writing of the mzML header to disk (and the first element).
+      writing of the mzML header to disk. Spectra and chromatograms are
+      collected in small blocks which are encoded in parallel (if OpenMP is
+      available) and written in the order they were consumed; the output is
+      identical to writing them one by one.
 
       @note Currently it is not possible to add spectra after having already added
       chromatograms since this could lead to a situation with multiple
@@ -85,6 +89,10 @@ namespace OpenMS
       inconsistent mzML if the count attribute of spectrumList or
       chromatogramList is incorrect.
 
+      @note Call close() once all data was consumed. The destructor closes the
+      file as well, but it cannot throw, so errors while writing the remaining
+      data are only logged there.
+
     */
     class OPENMS_DLLAPI MSDataWritingConsumer : 
       public Internal::MzMLHandler,
@@ -170,6 +178,15 @@ namespace OpenMS
       */
       virtual Size getNrChromatogramsWritten();
 
+      /**
+        @brief Writes the remaining data and the end of the file, then closes the file.
+
+        Further calls have no effect.
+
+        @exception Exception::UnableToCreateFile is thrown if the file could not be written
+      */
+      virtual void close();
+
     private:
 
       /// @name Data Processing using the template method pattern
@@ -192,10 +209,16 @@ namespace OpenMS
       /**
         @brief Cleanup function called by the destructor.
 
-        Will write the last tags to the file and close the file stream.
+        Will close the file (see close()) unless this was done before; errors are logged.
       */
       virtual void doCleanup_();
 
+      /// Write all buffered spectra to disk (encoded in parallel, in consumption order)
+      void flushSpectra_();
+
+      /// Write all buffered chromatograms to disk (encoded in parallel, in consumption order)
+      void flushChromatograms_();
+
     protected:
 
       /// File stream (to write mzML)
@@ -203,13 +226,15 @@ namespace OpenMS
 
       /// Stores whether we have already started writing any data
       bool started_writing_;
+      /// Stores whether the file was closed already
+      bool closed_;
       /// Stores whether we are currently writing spectra
       bool writing_spectra_;
       /// Stores whether we are currently writing chromatograms
       bool writing_chromatograms_;
-      /// Number of spectra written
+      /// Number of spectra written (including those still in the buffer)
       Size spectra_written_;
-      /// Number of chromatograms written
+      /// Number of chromatograms written (including those still in the buffer)
       Size chromatograms_written_;
       /// Number of spectra expected
       Size spectra_expected_;
@@ -227,6 +252,13 @@ namespace OpenMS
       std::vector<std::vector< ConstDataProcessingPtr > > dps_;
       /// The dataprocessing to be added to each spectrum/chromatogram
       DataProcessingPtr additional_dataprocessing_;
+
+      /// Processed spectra waiting to be written
+      std::vector<SpectrumType> spectra_buffer_;
+      /// Processed chromatograms waiting to be written
+      std::vector<ChromatogramType> chromatograms_buffer_;
+      /// Number of elements collected before they are written as one block
+      Size buffer_size_;
     };
 
     /**
@@ -265,6 +297,7 @@ namespace OpenMS
       void setExperimentalSettings(const ExperimentalSettings& /* exp */) override {}
       void consumeSpectrum(SpectrumType & /* s */) override {}
       void consumeChromatogram(ChromatogramType & /* c */) override {}
+      void close() override {}
 
     private:
 
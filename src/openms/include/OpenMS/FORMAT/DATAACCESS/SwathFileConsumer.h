@@ -636,6 +636,15 @@ protected:
 
     void ensureMapsAreFilled_() override
     {
+      // close the files explicitly, so that write errors are reported
+      for (Size i = 0; i < swath_consumers_.size(); ++i)
+      {
+        swath_consumers_[i]->close();
+      }
+      if (ms1_consumer_ != nullptr)
+      {
+        ms1_consumer_->close();
+      }
       deleteSetNull_();
     }
 
@@ -0,0 +1,115 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_FORMAT_DIGESTIONCACHEFILE_H
+#define OPENMS_FORMAT_DIGESTIONCACHEFILE_H
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <vector>
+
+#define DIGESTION_CACHE_FILE_IDENTIFIER 8094
+#define DIGESTION_CACHE_FILE_VERSION 1
+
+namespace OpenMS
+{
+  class EnzymaticDigestion;
+
+  /**
+    @brief On-disk cache of the digestion products of a sequence database
+
+    Search engines digest the whole database on every run, although it rarely
+    changes between runs. This class stores the (unmodified) digestion products
+    of every protein in a binary file, so a repeated search with the same
+    database and digestion settings can load them instead.
+
+    A cache file is identified by a key (see computeKey()) made of the SHA1
+    checksum of the FASTA file and all parameters which influence the result of
+    the digestion. The key is stored in the file and checked when loading, so a
+    stale or foreign cache file is never used. getCacheFileName() derives the
+    file name from the key, hence one cache directory can hold the digests of
+    several databases and settings.
+
+    The file format is a plain memory dump and is only meant to be read on the
+    machine (architecture) it was written on.
+  */
+  class OPENMS_DLLAPI DigestionCacheFile
+  {
+public:
+    /// digestion products of all proteins, in database order
+    typedef std::vector<std::vector<String> > Digests;
+
+    /// Default constructor
+    DigestionCacheFile();
+
+    /// Destructor
+    virtual ~DigestionCacheFile();
+
+    /**
+      @brief Returns the key identifying the digest of a database
+
+      @param fasta_file The FASTA file (its SHA1 checksum is part of the key)
+      @param digestion The digestion settings (enzyme, missed cleavages and specificity are part of the key)
+      @param min_length Minimum length of the digestion products
+      @param max_length Maximum length of the digestion products
+
+      @exception Exception::FileNotFound is thrown if @p fasta_file does not exist
+    */
+    static String computeKey(const String& fasta_file, const EnzymaticDigestion& digestion, Size min_length, Size max_length);
+
+    /// Returns the name of the cache file for @p key in directory @p cache_dir
+    static String getCacheFileName(const String& cache_dir, const String& key);
+
+    /**
+      @brief Loads the digestion products from a cache file
+
+      @return false (and leaves @p digests empty) if the file does not exist, was written for a different key or is damaged
+    */
+    bool load(const String& filename, const String& key, Digests& digests) const;
+
+    /**
+      @brief Stores the digestion products in a cache file
+
+      The data is written to a temporary file first, which then replaces @p filename,
+      so concurrent readers never see a partially written cache.
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be written
+    */
+    void store(const String& filename, const String& key, const Digests& digests) const;
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_FORMAT_DIGESTIONCACHEFILE_H
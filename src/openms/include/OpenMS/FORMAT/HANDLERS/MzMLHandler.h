@@ -204,6 +204,47 @@ protected:
 
       void writeChromatogram_(std::ostream& os, const ChromatogramType& chromatogram, Size c, Internal::MzMLValidator& validator);
 
+      /**
+          @brief Writes the spectrum element of a single spectrum (without recording its index offset)
+
+          @note Does not modify any internal state variables of the class, so
+          multiple spectra can be written to independent streams in parallel.
+      */
+      void writeSpectrumElement_(std::ostream& os, const SpectrumType& spec, const String& native_id, Size s,
+                                 Internal::MzMLValidator& validator,
+                                 const std::vector<std::vector< ConstDataProcessingPtr > >& dps);
+
+      /**
+          @brief Writes the chromatogram element of a single chromatogram (without recording its index offset)
+
+          @note Does not modify any internal state variables of the class, so
+          multiple chromatograms can be written to independent streams in parallel.
+      */
+      void writeChromatogramElement_(std::ostream& os, const ChromatogramType& chromatogram, Size c, Internal::MzMLValidator& validator);
+
+      /**
+          @brief Writes a block of spectra, using multiple threads if available
+
+          Each spectrum is formatted and encoded (numpress, zlib, base64) into
+          its own buffer by one of the threads, while the buffers are appended
+          to @p os strictly in order and the offsets for the index are recorded
+          on the fly. The output is identical to calling writeSpectrum_ for
+          each spectrum.
+
+          @param first_index Index of the first spectrum of the block in the file
+          @param log_progress Report progress (starting at @p progress_offset) via the logger
+      */
+      void writeSpectra_(std::ostream& os, const std::vector<SpectrumType>& spectra, Size first_index,
+                         Internal::MzMLValidator& validator, bool renew_native_ids,
+                         const std::vector<std::vector< ConstDataProcessingPtr > >& dps,
+                         bool log_progress = false, Size progress_offset = 0);
+
+      /**
+          @brief Writes a block of chromatograms, using multiple threads if available (see writeSpectra_)
+      */
+      void writeChromatograms_(std::ostream& os, const std::vector<ChromatogramType>& chromatograms, Size first_index,
+                               Internal::MzMLValidator& validator, bool log_progress = false, Size progress_offset = 0);
+
       template <typename ContainerT>
       void writeContainerData(std::ostream& os, const PeakFileOptions& pf_options_, const ContainerT& container, String array_type);
 
@@ -110,6 +110,7 @@ namespace OpenMS
         MSChromatogram c = exp.getChromatogram(i);
         consumer.consumeChromatogram(c);
       }
+      consumer.close();
     }
 
     /**
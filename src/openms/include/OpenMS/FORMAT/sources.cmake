@@ -31,6 +31,7 @@ ControlledVocabulary.h
 CsvFile.h
 DTA2DFile.h
 DTAFile.h
+DigestionCacheFile.h
 EDTAFile.h
 FASTAFile.h
 FastaIterator.h
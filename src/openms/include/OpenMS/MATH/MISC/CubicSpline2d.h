@@ -88,6 +88,17 @@ public:
      */
     double eval(double x) const;
 
+    /**
+     * @brief evaluates the spline at all positions in [first, last) (in place)
+     *
+     * Gives the same results as eval(), but walks the knots instead of searching
+     * them for each position if the positions are in ascending order.
+     *
+     * @param first begin of the x-positions
+     * @param last end of the x-positions
+     */
+    void evalSorted(std::vector<double>::iterator first, std::vector<double>::iterator last) const;
+
     /**
      * @brief evaluates derivative of spline at position x
      *
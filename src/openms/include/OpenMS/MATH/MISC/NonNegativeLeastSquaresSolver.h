@@ -65,6 +65,31 @@ public:
         @throws Exception::InvalidParameters if Matrix dimensions do not fit
     */
     static Int solve(const Matrix<double> & A, const Matrix<double> & b, Matrix<double> & x);
+
+    /**
+        @brief Solves the non-negative least square problem Ax=b for many right-hand sides b sharing the same matrix A
+
+        The matrix A is converted and factorized (QR) only once. Whenever the unconstrained least squares solution
+        of a right-hand side is non-negative, it is also the solution of the NNLS problem and no NNLS iterations are
+        needed; all other right-hand sides are passed to the NNLS solver. Right-hand sides are solved in parallel
+        if OpenMP is enabled.
+
+        The least squares solutions are not bit-identical to those of solve(), which always runs the NNLS
+        iterations. For well-conditioned matrices (such as isotope correction matrices) they agree within a
+        relative difference of 1e-9.
+
+        @param A Input matrix A of size mxn
+        @param B Input matrix of size mxk, each column is a right-hand side b
+        @param X Output matrix of size nxk, column i holds the non-negative least square solution for column i of @p B
+        @return NonNegativeLeastSquaresSolver::SOLVED if all problems were solved, NonNegativeLeastSquaresSolver::ITERATION_EXCEEDED otherwise
+
+        @throws Exception::InvalidParameters if Matrix dimensions do not fit
+    */
+    static Int solveBatch(const Matrix<double> & A, const Matrix<double> & B, Matrix<double> & X);
+
+private:
+    /// Solves all columns of @p B; the least squares shortcut of solveBatch() is only used if @p use_least_squares is set
+    static Int solve_(const Matrix<double> & A, const Matrix<double> & B, Matrix<double> & X, bool use_least_squares);
   };
 
 } // namespace OpenMS
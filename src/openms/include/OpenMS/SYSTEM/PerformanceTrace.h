@@ -0,0 +1,184 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_SYSTEM_PERFORMANCETRACE_H
+#define OPENMS_SYSTEM_PERFORMANCETRACE_H
+
+#include <OpenMS/config.h>
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <iosfwd>
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Collects timing, counter and memory events of annotated processing stages
+
+    Stages are annotated with the OPENMS_TRACE_SCOPE macro (a Scope object
+    which measures the time from its construction to the end of the enclosing
+    block) and OPENMS_TRACE_COUNTER. Tracing is disabled by default; a
+    disabled trace costs one branch per annotation and does not allocate.
+
+    When enabled (e.g. via the '-trace_out' option of every TOPP tool), each
+    finished scope is stored together with the id of the OpenMP thread it ran
+    on. Querying the memory usage of the process is expensive compared to short
+    scopes, so it is only sampled at the end of top-level phases: the outermost
+    scope and the scopes directly inside it (e.g. the TOPP tool and its
+    loading, processing and storing stages), if they are outside of OpenMP
+    parallel regions. The collected events can be written in the Chrome trace
+    event format (JSON), which can be inspected with chrome://tracing or
+    https://ui.perfetto.dev.
+
+    Recording is thread-safe. Scopes should only annotate coarse stages (file
+    loading, algorithm steps, per-chunk work), not inner loops.
+
+    @ingroup System
+  */
+  class OPENMS_DLLAPI PerformanceTrace
+  {
+public:
+
+    /// A single recorded event
+    struct OPENMS_DLLAPI Event
+    {
+      /// Type of the event
+      enum Type
+      {
+        SCOPE,   ///< a timed scope (start and duration)
+        COUNTER  ///< a counter value at a point in time
+      };
+
+      Type type;
+      String name;
+      String category;
+      /// start of the event in microseconds since the trace was enabled
+      double start;
+      /// duration in microseconds (0 for counters)
+      double duration;
+      /// counter value (0 for scopes)
+      double value;
+      /// OpenMP thread the event was recorded on
+      Size thread;
+      /// memory usage of the process in KB at the end of a top-level phase (0 if not sampled or unknown)
+      Size memory;
+    };
+
+    /**
+      @brief Measures the lifetime of a block and records it on destruction
+
+      Does nothing if the trace is disabled at construction time.
+    */
+    class OPENMS_DLLAPI Scope
+    {
+public:
+      /// Starts timing the stage @p name (the string must outlive the Scope, e.g. a literal)
+      explicit Scope(const char* name, const char* category = "OpenMS");
+      /// Records the stage if the trace was enabled at construction time
+      ~Scope();
+
+private:
+      Scope(const Scope&);
+      Scope& operator=(const Scope&);
+
+      const char* name_;
+      const char* category_;
+      double start_;
+      bool active_;
+      /// whether the scope started outside of a parallel region (and hence counts towards the nesting depth)
+      bool serial_;
+      /// whether the scope is a top-level phase (memory is sampled at its end)
+      bool top_level_;
+    };
+
+    /// Enables or disables recording; enabling resets the time origin, but keeps previously recorded events
+    static void setEnabled(bool enabled);
+
+    /// Returns true if events are recorded
+    static bool isEnabled()
+    {
+      return enabled_;
+    }
+
+    /// Returns the time in microseconds since the trace was enabled
+    static double now();
+
+    /// Records a finished scope (usually called by Scope); the memory usage is only queried if @p sample_memory is set
+    static void addScope(const String& name, const String& category, double start, double duration, bool sample_memory = false);
+
+    /// Records a counter value (e.g. number of spectra or features processed)
+    static void addCounter(const String& name, double value, const String& category = "OpenMS");
+
+    /// Returns a copy of all events recorded so far
+    static std::vector<Event> getEvents();
+
+    /// Removes all recorded events
+    static void clear();
+
+    /// Writes the recorded events as Chrome trace event JSON to @p os
+    static void write(std::ostream& os);
+
+    /**
+      @brief Writes the recorded events as Chrome trace event JSON to the file @p filename
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be created
+    */
+    static void store(const String& filename);
+
+private:
+    /// records @p event (thread-safe)
+    static void add_(Event& event);
+
+    /// nesting depth of the active scopes outside of parallel regions
+    static Size depth_;
+
+    static bool enabled_;
+  };
+
+} // namespace OpenMS
+
+#define OPENMS_TRACE_CONCAT_IMPL_(a, b) a ## b
+#define OPENMS_TRACE_CONCAT_(a, b) OPENMS_TRACE_CONCAT_IMPL_(a, b)
+
+/// Records the time spent in the enclosing block as stage @p name (see PerformanceTrace)
+#define OPENMS_TRACE_SCOPE(name) \
+  OpenMS::PerformanceTrace::Scope OPENMS_TRACE_CONCAT_(openms_trace_scope_, __LINE__)(name)
+
+/// Records the counter @p name with value @p value (see PerformanceTrace)
+#define OPENMS_TRACE_COUNTER(name, value) \
+  do { if (OpenMS::PerformanceTrace::isEnabled()) OpenMS::PerformanceTrace::addCounter(name, static_cast<double>(value)); } while (0)
+
+#endif // OPENMS_SYSTEM_PERFORMANCETRACE_H
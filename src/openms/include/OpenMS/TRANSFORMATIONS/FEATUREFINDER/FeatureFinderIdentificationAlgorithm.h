@@ -114,6 +114,7 @@ protected:
 
   double isotope_pmin_; //< min. isotope probability for peptide assay
   Size n_isotopes_; //< number of isotopes for peptide assay
+  Size batch_size_; //< number of assays per batch for extraction/peak picking
 
   double rt_quantile_;
 
@@ -234,6 +235,9 @@ protected:
   /// annotate identified features with m/z, isotope probabilities, etc.
   void annotateFeatures_(FeatureMap& features, PeptideRefRTMap& ref_rt_map);
 
+  /// extract chromatograms for all assays in the library and detect features in them, in (parallel) batches of assays
+  void extractAndDetectFeatures_(FeatureMap& features);
+
   void ensureConvexHulls_(Feature& feature);
 
   void postProcess_(FeatureMap& features, bool with_external_ids);
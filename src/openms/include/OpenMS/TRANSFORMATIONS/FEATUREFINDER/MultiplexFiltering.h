@@ -37,6 +37,7 @@
 
 #include <OpenMS/KERNEL/BaseFeature.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexIsotopicPeakPattern.h>
@@ -102,6 +103,23 @@ public:
       int black_exception_mz_position;
     };
 
+    /**
+     * @brief structure for a peak which passed all filters
+     *
+     * Peaks of a block of spectra are filtered concurrently. The peaks passing
+     * all filters are buffered in this structure until they are blacklisted
+     * and added to the filter result in their original order.
+     */
+    struct PeakCandidate
+    {
+      int peak; // index of the peak in the spectrum
+      int peaks_found_in_all_peptides; // number of isotopic peaks seen for each peptide (used for blacklisting)
+      std::vector<double> mz_shifts_actual;
+      std::vector<int> mz_shifts_actual_indices;
+      std::vector<double> intensities_actual;
+      std::vector<MultiplexFilterResultRaw> results_raw;
+    };
+
     /**
      * @brief constructor
      *
@@ -210,6 +228,32 @@ protected:
      */
     void blacklistPeaks_(const MultiplexIsotopicPeakPattern& pattern, int spectrum, const std::vector<int>& mz_shifts_actual_indices, int peaks_found_in_all_peptides_spline);
 
+    /**
+     * @brief checks if the blacklist entries of the peaks matching a pattern changed
+     *
+     * Peaks of a block of spectra are filtered concurrently against the blacklist as it
+     * was at the start of the block. Blacklisting during the ordered commit of the block
+     * can invalidate such a result. It is the case only if one of the peaks at the
+     * expected m/z positions of the pattern got blacklisted in the meantime.
+     *
+     * @param pattern    pattern of isotopic peaks to be searched for
+     * @param spectrum    index of the spectrum in exp_picked_ and boundaries_
+     * @param peak_position    m/z positions of the peaks in spectrum
+     * @param peak    index of the peak in peak_position
+     * @param black_before    blacklist flags of the spectrum at the start of the block
+     *
+     * @return true if the peak needs to be filtered again
+     */
+    bool blacklistChanged_(const MultiplexIsotopicPeakPattern& pattern, int spectrum, const std::vector<double>& peak_position, int peak, const std::vector<char>& black_before) const;
+
+    /**
+     * @brief returns the blacklist flags of a spectrum
+     *
+     * @param spectrum    index of the spectrum in exp_picked_ and boundaries_
+     * @param black    output for the blacklist flags of the peaks
+     */
+    void getBlacklistFlags_(int spectrum, std::vector<char>& black) const;
+
     /**
      * @brief returns the index of a peak at m/z
      * (finds not only a valid peak, i.e. within certain m/z deviation, but the best of the valid peaks)
@@ -237,6 +281,10 @@ protected:
     /**
      * @brief returns similarity of an isotope pattern and an averagine pattern at mass m
      *
+     * The averagine pattern only depends on the averagine formula at mass m (rounded to whole atoms).
+     * It is looked up by this formula in averagine_patterns_, or calculated on the fly if the formula
+     * was not precomputed. Either way the result is the same as with a freshly calculated pattern.
+     *
      * @param pattern   isotope pattern
      * @param m    mass at which the averagine distribution is calculated
      *
@@ -245,6 +293,31 @@ protected:
 
     double getAveragineSimilarity_(const std::vector<double>& pattern, double m) const;
 
+    /**
+     * @brief calculates the isotope pattern (relative intensities of the first @p isotopes peaks) of an averagine formula
+     */
+    std::vector<double> calculateAveraginePattern_(const EmpiricalFormula& formula, Size isotopes) const;
+
+    /**
+     * @brief averagine formulas occurring in a mass bin, each with its isotope patterns for 1 to peaks_per_peptide_max_ isotopes
+     */
+    typedef std::vector<std::pair<EmpiricalFormula, std::vector<std::vector<double> > > > AveragineBin_;
+
+    /**
+     * @brief width of the mass bins of averagine_patterns_ (in Da)
+     */
+    static const double averagine_bin_width_;
+
+    /**
+     * @brief number of equidistant masses per bin at which the averagine formulas are collected
+     */
+    static const int averagine_samples_per_bin_;
+
+    /**
+     * @brief number of spectra filtered concurrently before their results are committed
+     */
+    static const int block_size_;
+
     /**
     * @brief centroided experimental data
     */
@@ -311,6 +384,14 @@ protected:
      */
     String averagine_type_;
 
+    /**
+     * @brief averagine formulas and patterns of consecutive mass bins
+     *
+     * Precomputed in the constructor for all masses up to the largest m/z times the largest charge,
+     * read-only afterwards (i.e. shared by all threads without locking).
+     */
+    std::vector<AveragineBin_> averagine_patterns_;
+
   };
 
 }
@@ -89,11 +89,32 @@ public:
      * @brief filter for patterns
      * (generates a filter result for each of the patterns)
      *
+     * Spectra are filtered in parallel (OpenMP) in blocks of consecutive spectra.
+     * The result does not depend on the number of threads.
+     *
      * @see MultiplexIsotopicPeakPattern, MultiplexFilterResult
      */
     std::vector<MultiplexFilterResult> filter();
 
 private:
+    /**
+     * @brief filters a single peak (filters 1 to 6)
+     *
+     * @param pattern    pattern of isotopic peaks to be searched for
+     * @param spectrum    index of the spectrum in exp_picked_
+     * @param peak_position    m/z positions of the peaks in spectrum
+     * @param peak    index of the peak in peak_position
+     * @param candidate    output for the pattern details of the peak
+     *
+     * @return true if the peak passed all filters
+     */
+    bool filterPeak_(const MultiplexIsotopicPeakPattern& pattern, int spectrum, const std::vector<double>& peak_position, int peak, PeakCandidate& candidate) const;
+
+    /**
+     * @brief returns the m/z positions of the peaks in a spectrum
+     */
+    void getPeakPositions_(int spectrum, std::vector<double>& peak_position) const;
+
     /**
      * @brief non-local intensity filter
      *
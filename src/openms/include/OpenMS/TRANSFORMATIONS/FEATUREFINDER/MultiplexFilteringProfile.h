@@ -95,6 +95,9 @@ public:
      * @brief filter for patterns
      * (generates a filter result for each of the patterns)
      *
+     * Spectra are filtered in parallel (OpenMP) in blocks of consecutive spectra.
+     * The result does not depend on the number of threads.
+     *
      * @throw Exception::IllegalArgument if number of peaks and number of peak boundaries differ
      *
      * @see MultiplexIsotopicPeakPattern
@@ -103,6 +106,33 @@ public:
     std::vector<MultiplexFilterResult> filter();
 
 private:
+    /**
+     * @brief filters a single peak (filters 1 to 6)
+     *
+     * @param pattern    pattern of isotopic peaks to be searched for
+     * @param spectrum    index of the spectrum in exp_profile_, exp_picked_ and boundaries_
+     * @param peak_position    m/z positions of the peaks in spectrum
+     * @param peak_min    lower m/z boundaries of the peaks in spectrum
+     * @param peak_max    upper m/z boundaries of the peaks in spectrum
+     * @param peak_intensity    intensities of the peaks in spectrum
+     * @param peak    index of the peak in peak_position
+     * @param nav    navigator for moving on the spline-interpolated spectrum
+     * @param candidate    output for the pattern details of the peak
+     *
+     * @return true if at least one raw data point of the peak passed all filters, i.e. the peak needs to be blacklisted
+     */
+    bool filterPeak_(const MultiplexIsotopicPeakPattern& pattern, int spectrum, const std::vector<double>& peak_position, const std::vector<double>& peak_min, const std::vector<double>& peak_max, const std::vector<double>& peak_intensity, int peak, SplineSpectrum::Navigator& nav, PeakCandidate& candidate) const;
+
+    /**
+     * @brief returns true if the spectrum contains no data (profile, centroided or boundaries)
+     */
+    bool skipSpectrum_(int spectrum) const;
+
+    /**
+     * @brief returns positions, boundaries and intensities of the peaks in a spectrum
+     */
+    void getPeakDetails_(int spectrum, std::vector<double>& peak_position, std::vector<double>& peak_min, std::vector<double>& peak_max, std::vector<double>& peak_intensity) const;
+
     /**
      * @brief non-local intensity filter
      *
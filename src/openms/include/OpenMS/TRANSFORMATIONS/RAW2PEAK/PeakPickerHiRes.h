@@ -41,6 +41,7 @@
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
+#include <OpenMS/SYSTEM/PerformanceTrace.h>
 
 #include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
 
@@ -516,6 +517,8 @@ public:
      */
     void pickExperiment(const PeakMap& input, PeakMap& output, std::vector<std::vector<PeakBoundary> >& boundaries_spec, std::vector<std::vector<PeakBoundary> >& boundaries_chrom, const bool check_spectrum_type = true) const
     {
+      OPENMS_TRACE_SCOPE("PeakPickerHiRes::pickExperiment");
+
       // make sure that output is clear
       output.clear(true);
 
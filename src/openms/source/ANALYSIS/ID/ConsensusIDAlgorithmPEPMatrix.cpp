@@ -90,14 +90,9 @@ namespace OpenMS
     String unmod_seq1 = seq1.toUnmodifiedString();
     String unmod_seq2 = seq2.toUnmodifiedString();
     if (unmod_seq1 == unmod_seq2) return 1.0;
-    // order of sequences matters for cache look-up:
+    // fixed order of sequences, so the result is symmetric:
     if (unmod_seq1 > unmod_seq2) swap(unmod_seq1, unmod_seq2);
-    seq1 = AASequence::fromString(unmod_seq1);
-    seq2 = AASequence::fromString(unmod_seq2);
-    pair<AASequence, AASequence> seq_pair = make_pair(seq1, seq2);
-    SimilarityCache::iterator pos = similarities_.find(seq_pair);
-    if (pos != similarities_.end()) return pos->second; // score found in cache
-    
+
     // use SeqAn similarity scoring:
     SeqAnSequence seqan_seq1 = unmod_seq1.c_str();
     SeqAnSequence seqan_seq2 = unmod_seq2.c_str();
@@ -122,7 +117,6 @@ namespace OpenMS
     {
       score_sim /= min(score_self1, score_self2); // normalize
     }
-    similarities_[seq_pair] = score_sim; // cache the similarity score
 
     return score_sim;
   }
@@ -59,12 +59,28 @@ namespace OpenMS
       }
     }
 
+    // map all sequences to IDs once, so similarities can be looked up by ID:
+    vector<vector<Size> > seq_ids(ids.size());
+    for (Size i = 0; i < ids.size(); ++i)
+    {
+      const vector<PeptideHit>& hits = ids[i].getHits();
+      seq_ids[i].reserve(hits.size());
+      for (vector<PeptideHit>::const_iterator hit = hits.begin();
+           hit != hits.end(); ++hit)
+      {
+        seq_ids[i].push_back(getSequenceID_(hit->getSequence()));
+      }
+    }
+
     for (vector<PeptideIdentification>::iterator id1 = ids.begin();
          id1 != ids.end(); ++id1)
     {
+      const vector<Size>& seq_ids1 = seq_ids[id1 - ids.begin()];
       for (vector<PeptideHit>::iterator hit1 = id1->getHits().begin();
            hit1 != id1->getHits().end(); ++hit1)
       {
+        Size seq_id1 = seq_ids1[hit1 - id1->getHits().begin()];
+
         // have we scored this sequence already? if yes, skip:
         SequenceGrouping::iterator pos = results.find(hit1->getSequence());
         if (pos != results.end())
@@ -81,6 +97,7 @@ namespace OpenMS
              id2 != ids.end(); ++id2)
         {
           if (id1 == id2) continue;
+          const vector<Size>& seq_ids2 = seq_ids[id2 - ids.begin()];
           
           // similarity scores and PEPs of all matches in current ID run
           // (to get the best match, we look for highest similarity, breaking
@@ -91,8 +108,11 @@ namespace OpenMS
           for (vector<PeptideHit>::iterator hit2 = id2->getHits().begin();
                hit2 != id2->getHits().end(); ++hit2)
           {
-            double sim_score = getSimilarity_(hit1->getSequence(),
-                                              hit2->getSequence());
+            Size seq_id2 = seq_ids2[hit2 - id2->getHits().begin()];
+            double sim_score = getCachedSimilarity_(seq_id1,
+                                                    hit1->getSequence(),
+                                                    seq_id2,
+                                                    hit2->getSequence());
             // use "1 - PEP" so higher scores are better (for "max_element"):
             current_matches.push_back(make_pair(sim_score,
                                                 1.0 - hit2->getScore()));
@@ -130,4 +150,28 @@ namespace OpenMS
     }
   }
 
+
+  Size ConsensusIDAlgorithmSimilarity::getSequenceID_(const AASequence& seq)
+  {
+    // a new sequence gets the next free ID:
+    return sequence_ids_.insert(make_pair(seq.toString(),
+                                          sequence_ids_.size())).first->second;
+  }
+
+
+  double ConsensusIDAlgorithmSimilarity::getCachedSimilarity_(
+    Size id1, const AASequence& seq1, Size id2, const AASequence& seq2)
+  {
+    if (id1 == id2) return 1.0;
+    // order of IDs matters for cache look-up:
+    pair<Size, Size> id_pair = (id1 < id2) ? make_pair(id1, id2) :
+      make_pair(id2, id1);
+    SimilarityCache::const_iterator pos = similarities_.find(id_pair);
+    if (pos != similarities_.end()) return pos->second; // score found in cache
+
+    double score_sim = getSimilarity_(seq1, seq2);
+    similarities_[id_pair] = score_sim; // cache the similarity score
+    return score_sim;
+  }
+
 } // namespace OpenMS
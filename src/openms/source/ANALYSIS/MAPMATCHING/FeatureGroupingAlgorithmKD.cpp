@@ -37,6 +37,7 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
+#include <OpenMS/SYSTEM/PerformanceTrace.h>
 
 using namespace std;
 
@@ -107,6 +108,8 @@ namespace OpenMS
   void FeatureGroupingAlgorithmKD::group_(const vector<MapType>& input_maps,
                                           ConsensusMap& out)
   {
+    OPENMS_TRACE_SCOPE("FeatureGroupingAlgorithmKD::group");
+
     // set parameters
     String mz_unit(param_.getValue("mz_unit").toString());
     mz_ppm_ = mz_unit == "ppm";
@@ -185,6 +188,7 @@ namespace OpenMS
     bool align = param_.getValue("warp:enabled").toString() == "true";
     if (align)
     {
+      OPENMS_TRACE_SCOPE("FeatureGroupingAlgorithmKD: RT transformation");
       Size progress = 0;
       startProgress(0, partition_boundaries.size(), "computing RT transformations");
       for (size_t j = 0; j < partition_boundaries.size()-1; j++)
@@ -230,6 +234,7 @@ namespace OpenMS
     }
 
     // ------------ run alignment + feature linking on individual partitions ------------
+    OPENMS_TRACE_SCOPE("FeatureGroupingAlgorithmKD: linking");
     Size progress = 0;
     startProgress(0, partition_boundaries.size(), "linking features");
     for (size_t j = 0; j < partition_boundaries.size()-1; j++)
@@ -268,6 +273,7 @@ namespace OpenMS
       setProgress(progress++);
     }
     endProgress();
+    OPENMS_TRACE_COUNTER("FeatureGroupingAlgorithmKD consensus features", out.size());
 
     // add protein IDs and unassigned peptide IDs to the result map here,
     // to keep the same order as the input maps (useful for output later):
@@ -326,41 +332,75 @@ namespace OpenMS
     updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data);
 
     // pass 2: construct consensus features until all points assigned.
+    //
+    // Clusters are extracted in rounds. Within a round, we walk along the
+    // ordered potential clusters and accept them one after another until we
+    // reach a cluster whose center is a neighbor of an already accepted
+    // cluster (i.e., it would have been updated before being chosen).
+    // Updates can only make clusters worse, so all accepted clusters are
+    // exactly the ones that would be picked one at a time. The proxies
+    // affected by all extractions of a round are then updated in parallel.
+    vector<Int> dirty(n, false);
     while (!potential_clusters.empty())
     {
-      // get index of current best cluster center (as defined by ClusterProxyKD::operator<)
-      Size i = potential_clusters.begin()->getCenterIndex();
+      update_these = set<Size>();
+      vector<Size> extracted;
+      for (set<ClusterProxyKD>::const_iterator c_it = potential_clusters.begin(); c_it != potential_clusters.end(); ++c_it)
+      {
+        // get index of current best cluster center (as defined by ClusterProxyKD::operator<)
+        Size i = c_it->getCenterIndex();
+        if (assigned[i])
+        {
+          // proxy is removed below
+          continue;
+        }
+        if (dirty[i])
+        {
+          // proxy needs to be updated first
+          break;
+        }
 
-      // compile the actual list of sub feature indices for cluster with center i
-      vector<Size> cf_indices;
-      computeBestClusterForCenter_(i, cf_indices, assigned, kd_data);
+        // compile the actual list of sub feature indices for cluster with center i
+        vector<Size> cf_indices;
+        computeBestClusterForCenter_(i, cf_indices, assigned, kd_data, feature_distance_);
 
-      // add consensus feature
-      addConsensusFeature_(cf_indices, kd_data, out);
+        // add consensus feature
+        addConsensusFeature_(cf_indices, kd_data, out);
 
-      // mark selected sub features assigned and delete them from potential_clusters
-      for (vector<Size>::const_iterator f_it = cf_indices.begin(); f_it != cf_indices.end(); ++f_it)
-      {
-        assigned[*f_it] = true;
-        potential_clusters.erase(cluster_for_idx[*f_it]);
-      }
+        // mark selected sub features assigned
+        for (vector<Size>::const_iterator f_it = cf_indices.begin(); f_it != cf_indices.end(); ++f_it)
+        {
+          assigned[*f_it] = true;
+          extracted.push_back(*f_it);
+        }
 
-      // compile set of all points whose neighborhoods will need updating
-      update_these = set<Size>();
-      for (vector<Size>::const_iterator f_it = cf_indices.begin(); f_it != cf_indices.end(); ++f_it)
-      {
-        vector<Size> f_neighbors;
-        kd_data.getNeighborhood(*f_it, f_neighbors, rt_tol_secs_, mz_tol_, mz_ppm_, true);
-        for (vector<Size>::const_iterator it = f_neighbors.begin(); it != f_neighbors.end(); ++it)
+        // compile set of all points whose neighborhoods will need updating
+        for (vector<Size>::const_iterator f_it = cf_indices.begin(); f_it != cf_indices.end(); ++f_it)
         {
-          if (!assigned[*it])
+          vector<Size> f_neighbors;
+          kd_data.getNeighborhood(*f_it, f_neighbors, rt_tol_secs_, mz_tol_, mz_ppm_, true);
+          for (vector<Size>::const_iterator it = f_neighbors.begin(); it != f_neighbors.end(); ++it)
           {
-            update_these.insert(*it);
+            if (!assigned[*it])
+            {
+              update_these.insert(*it);
+              dirty[*it] = true;
+            }
           }
         }
       }
 
+      // delete the selected sub features from potential_clusters
+      for (vector<Size>::const_iterator f_it = extracted.begin(); f_it != extracted.end(); ++f_it)
+      {
+        potential_clusters.erase(cluster_for_idx[*f_it]);
+      }
+
       // now that the points are marked assigned, update the neighborhoods of their neighbors
+      for (set<Size>::const_iterator it = update_these.begin(); it != update_these.end(); ++it)
+      {
+        dirty[*it] = false;
+      }
       updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data);
     }
   }
@@ -373,12 +413,31 @@ namespace OpenMS
                                                          const vector<Int>& assigned,
                                                          const KDTreeFeatureMaps& kd_data)
   {
-    for (set<Size>::const_iterator it = update_these.begin(); it != update_these.end(); ++it)
+    // compute the new proxies in parallel (read-only access to the kd-tree)...
+    vector<Size> indices(update_these.begin(), update_these.end());
+    vector<ClusterProxyKD> new_proxies(indices.size());
+#ifdef _OPENMP
+#pragma omp parallel if (indices.size() > 1)
+#endif
     {
-      Size i = *it;
+      // the distance functor caches values during computation, use one per thread
+      FeatureDistance feature_distance(feature_distance_);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 64)
+#endif
+      for (SignedSize k = 0; k < (SignedSize)indices.size(); ++k)
+      {
+        vector<Size> unused;
+        new_proxies[k] = computeBestClusterForCenter_(indices[k], unused, assigned, kd_data, feature_distance);
+      }
+    }
+
+    // ... and update the ordered set serially
+    for (Size k = 0; k < indices.size(); ++k)
+    {
+      Size i = indices[k];
       const ClusterProxyKD& old_proxy = cluster_for_idx[i];
-      vector<Size> unused;
-      ClusterProxyKD new_proxy = computeBestClusterForCenter_(i, unused, assigned, kd_data);
+      const ClusterProxyKD& new_proxy = new_proxies[k];
 
       // only need to update if size and/or average distance have changed
       if (new_proxy != old_proxy)
@@ -390,7 +449,7 @@ namespace OpenMS
     }
   }
 
-  ClusterProxyKD FeatureGroupingAlgorithmKD::computeBestClusterForCenter_(Size i, vector<Size>& cf_indices, const vector<Int>& assigned, const KDTreeFeatureMaps& kd_data) const
+  ClusterProxyKD FeatureGroupingAlgorithmKD::computeBestClusterForCenter_(Size i, vector<Size>& cf_indices, const vector<Int>& assigned, const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance) const
   {
     // compute i's neighborhood, together with a look-up table
     // map index -> corresponding points
@@ -421,8 +480,7 @@ namespace OpenMS
       Size best_index = numeric_limits<Size>::max();
       for (vector<Size>::const_iterator c_it = candidates.begin(); c_it != candidates.end(); ++c_it)
       {
-        double dist = const_cast<FeatureDistance&>(feature_distance_)(*(kd_data.feature(*c_it)),
-                                                                      *(kd_data.feature(i))).second;
+        double dist = feature_distance(*(kd_data.feature(*c_it)), *(kd_data.feature(i))).second;
 
         if (dist < min_dist)
         {
@@ -35,6 +35,7 @@
 #include <OpenMS/ANALYSIS/MAPMATCHING/MapAlignmentAlgorithmPoseClustering.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 #include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/SYSTEM/PerformanceTrace.h>
 
 using namespace std;
 
@@ -92,7 +93,10 @@ namespace OpenMS
 
     // run superimposer to find the global transformation
     TransformationDescription si_trafo;
-    superimposer_.run(map_model, map_scene, si_trafo);
+    {
+      OPENMS_TRACE_SCOPE("MapAlignmentAlgorithmPoseClustering: superimposer");
+      superimposer_.run(map_model, map_scene, si_trafo);
+    }
 
     // apply transformation to consensus features and contained feature
     // handles
@@ -113,7 +117,10 @@ namespace OpenMS
     std::vector<ConsensusMap> input(2);
     input[0] = map_model;
     input[1] = map_scene;
-    pairfinder_.run(input, result);
+    {
+      OPENMS_TRACE_SCOPE("MapAlignmentAlgorithmPoseClustering: pair finder");
+      pairfinder_.run(input, result);
+    }
 
     // calculate the local transformation
     si_trafo.invert(); // to undo the transformation applied above
@@ -59,37 +59,61 @@ namespace OpenMS
   {
     msexp.clearRanges();
 
-    // Transform spectra
-    for (PeakMap::iterator mse_iter = msexp.begin();
-         mse_iter != msexp.end(); ++mse_iter)
+    // Transform spectra (all at once - they are usually sorted by RT)
+    vector<double> rts(msexp.size());
+    for (Size i = 0; i < msexp.size(); ++i)
     {
-      double rt = mse_iter->getRT();
-      if (store_original_rt) storeOriginalRT_(*mse_iter, rt);
-      mse_iter->setRT(trafo.apply(rt));
+      rts[i] = msexp[i].getRT();
+      if (store_original_rt) storeOriginalRT_(msexp[i], rts[i]);
+    }
+    trafo.apply(rts);
+    for (Size i = 0; i < msexp.size(); ++i)
+    {
+      msexp[i].setRT(rts[i]);
     }
 
     // Also transform chromatograms
     for (Size i = 0; i < msexp.getNrChromatograms(); ++i)
     {
-      MSChromatogram& chromatogram = msexp.getChromatogram(i);
-      vector<double> original_rts;
-      if (store_original_rt) original_rts.reserve(chromatogram.size());
-      for (Size j = 0; j < chromatogram.size(); j++)
-      {
-        double rt = chromatogram[j].getRT();
-        if (store_original_rt) original_rts.push_back(rt);
-        chromatogram[j].setRT(trafo.apply(rt));
-      }
-      if (store_original_rt && !chromatogram.metaValueExists("original_rt"))
-      {
-        chromatogram.setMetaValue("original_rt", original_rts);
-      }
+      transformRetentionTimes(msexp.getChromatogram(i), trafo,
+                              store_original_rt);
     }
 
     msexp.updateRanges();
   }
 
 
+  void MapAlignmentTransformer::transformRetentionTimes(
+    MSSpectrum& spectrum, const TransformationDescription& trafo,
+    bool store_original_rt)
+  {
+    double rt = spectrum.getRT();
+    if (store_original_rt) storeOriginalRT_(spectrum, rt);
+    spectrum.setRT(trafo.apply(rt));
+  }
+
+
+  void MapAlignmentTransformer::transformRetentionTimes(
+    MSChromatogram& chromatogram, const TransformationDescription& trafo,
+    bool store_original_rt)
+  {
+    vector<double> rts(chromatogram.size());
+    for (Size j = 0; j < chromatogram.size(); j++)
+    {
+      rts[j] = chromatogram[j].getRT();
+    }
+    if (store_original_rt && !chromatogram.metaValueExists("original_rt"))
+    {
+      chromatogram.setMetaValue("original_rt", rts);
+    }
+    trafo.apply(rts);
+    for (Size j = 0; j < chromatogram.size(); j++)
+    {
+      chromatogram[j].setRT(rts[j]);
+    }
+  }
+
+
   void MapAlignmentTransformer::transformRetentionTimes(
     FeatureMap& fmap, const TransformationDescription& trafo,
     bool store_original_rt)
@@ -141,11 +165,15 @@ namespace OpenMS
       // transform all hull point positions within convex hull
       ConvexHull2D::PointArrayType points = chiter->getHullPoints();
       chiter->clear();
-      for (ConvexHull2D::PointArrayType::iterator points_iter = points.begin();
-           points_iter != points.end(); ++points_iter)
+      vector<double> rts(points.size());
+      for (Size i = 0; i < points.size(); ++i)
+      {
+        rts[i] = points[i][Feature::RT];
+      }
+      trafo.apply(rts);
+      for (Size i = 0; i < points.size(); ++i)
       {
-        double rt = (*points_iter)[Feature::RT];
-        (*points_iter)[Feature::RT] = trafo.apply(rt);
+        points[i][Feature::RT] = rts[i];
       }
       chiter->setHullPoints(points);
     }
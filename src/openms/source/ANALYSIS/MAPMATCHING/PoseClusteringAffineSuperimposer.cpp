@@ -62,6 +62,13 @@ namespace OpenMS
                                                 "and to disregard weak signals during alignment.  For using all points, set this to -1.");
     defaults_.setMinInt("num_used_points", -1);
 
+    defaults_.setValue("point_selection", "intensity", "How the 'num_used_points' elements of each map are selected.  "
+                                                       "'intensity' takes the most abundant elements; 'intensity_stratified' "
+                                                       "spreads the selection evenly over the intensity ranks, so that weak signals "
+                                                       "are represented as well while the number of hashed pairs stays bounded.",
+                       ListUtils::create<String>("advanced"));
+    defaults_.setValidStrings("point_selection", ListUtils::create<String>("intensity,intensity_stratified"));
+
     defaults_.setValue("scaling_bucket_size", 0.005, "The scaling of the retention time "
                                                      "interval is being hashed into buckets of this size during pose "
                                                      "clustering.  A good choice for this would be a bit smaller than the "
@@ -133,6 +140,36 @@ namespace OpenMS
     rt_high_hash_.setMapping(shift_bucket_size, rt_buckets_num_half, rt_high);
   }
 
+  /// Comparator for finding the first element with m/z not less than a given value
+  struct MZLowerBound_
+  {
+    bool operator()(const Peak2D& peak, const double mz) const
+    {
+      return peak.getMZ() < mz;
+    }
+  };
+
+  /// Comparator for finding the first element with m/z greater than a given value
+  struct MZUpperBound_
+  {
+    bool operator()(const double mz, const Peak2D& peak) const
+    {
+      return mz < peak.getMZ();
+    }
+  };
+
+  /// Adds the bucket heights of @p source to those of @p target (both must have the same mapping)
+  void addHashData(const Math::LinearInterpolation<double, double>& source,
+                   Math::LinearInterpolation<double, double>& target)
+  {
+    std::vector<double>& target_data = target.getData();
+    const std::vector<double>& source_data = source.getData();
+    for (Size index = 0; index < target_data.size(); ++index)
+    {
+      target_data[index] += source_data[index];
+    }
+  }
+
   /**
     @brief Estimates scaling by trying different (weighted) affine transformations.
 
@@ -176,135 +213,166 @@ namespace OpenMS
       dump_pairs_file << "#" << ' ' << "i" << ' ' << "j" << ' ' << "k" << ' ' << "l" << ' ' << std::endl;
     }
 
-    // first point in model map (i)
-    for (Size i = 0, i_low = 0, i_high = 0, k_low = 0, k_high = 0; i < model_map_size - 1; ++i)
+    // Each thread votes into its own copy of the hash tables (same mapping,
+    // zeroed data), the copies are summed up at the end.  Dumping the pairs
+    // is a debug feature which requires a single thread.
+#ifdef _OPENMP
+#pragma omp parallel if (!do_dump_pairs)
+#endif
     {
-      // Adjust window around i in model map (get all features in a m/z range of item i in the model map)
-      while (i_low < model_map_size && model_map[i_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-        ++i_low;
-      while (i_high < model_map_size && model_map[i_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-        ++i_high;
-      // stop if there are too many features are in our window
-      double i_winlength_factor = 1. / (i_high - i_low);
-      i_winlength_factor -= winlength_factor_baseline;
-      if (i_winlength_factor <= 0)
-        continue;
-
-      // Adjust window around k in scene map (get all features in a m/z range of item i in the scene map)
-      while (k_low < scene_map_size && scene_map[k_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-        ++k_low;
-      while (k_high < scene_map_size && scene_map[k_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-        ++k_high;
-
-      // Iterate through all matching features in the scene map that are
-      // within the m/z distance of item i from the model map.
-      // first point in scene map (k)
-      for (Size k = k_low; k < k_high; ++k)
+      Math::LinearInterpolation<double, double> local_scaling_hash_1(scaling_hash_1);
+      Math::LinearInterpolation<double, double> local_scaling_hash_2(scaling_hash_2);
+      Math::LinearInterpolation<double, double> local_rt_low_hash(rt_low_hash_);
+      Math::LinearInterpolation<double, double> local_rt_high_hash(rt_high_hash_);
+      std::fill(local_scaling_hash_1.getData().begin(), local_scaling_hash_1.getData().end(), 0.);
+      std::fill(local_scaling_hash_2.getData().begin(), local_scaling_hash_2.getData().end(), 0.);
+      std::fill(local_rt_low_hash.getData().begin(), local_rt_low_hash.getData().end(), 0.);
+      std::fill(local_rt_high_hash.getData().begin(), local_rt_high_hash.getData().end(), 0.);
+
+      // first point in model map (i)
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+      for (SignedSize signed_i = 0; signed_i < (SignedSize)model_map_size - 1; ++signed_i)
       {
+        const Size i = signed_i;
+
+        // Window around i in model map (get all features in a m/z range of
+        // item i in the model map).  Both maps are sorted by m/z, so the
+        // window boundaries can be found independently for each i.
+        const Size i_low = std::lower_bound(model_map.begin(), model_map.end(), model_map[i].getMZ() - mz_pair_max_distance, MZLowerBound_()) - model_map.begin();
+        const Size i_high = std::upper_bound(model_map.begin(), model_map.end(), model_map[i].getMZ() + mz_pair_max_distance, MZUpperBound_()) - model_map.begin();
         // stop if there are too many features are in our window
-        double k_winlength_factor = 1. / (k_high - k_low);
-        k_winlength_factor -= winlength_factor_baseline;
-        if (k_winlength_factor <= 0)
+        double i_winlength_factor = 1. / (i_high - i_low);
+        i_winlength_factor -= winlength_factor_baseline;
+        if (i_winlength_factor <= 0)
           continue;
 
-        // compute similarity of intensities i k by taking the ratio of the two intensities
-        double similarity_ik;
-        {
-          const double int_i = model_map[i].getIntensity();
-          const double int_k = scene_map[k].getIntensity() * total_intensity_ratio;
-          similarity_ik = (int_i < int_k) ? int_i / int_k : int_k / int_i;
-          // weight is inverse proportional to number of elements with similar mz
-          similarity_ik *= i_winlength_factor;
-          similarity_ik *= k_winlength_factor;
-        }
+        // Window around k in scene map (get all features in a m/z range of item i in the scene map)
+        const Size k_low = std::lower_bound(scene_map.begin(), scene_map.end(), model_map[i].getMZ() - mz_pair_max_distance, MZLowerBound_()) - scene_map.begin();
+        const Size k_high = std::upper_bound(scene_map.begin(), scene_map.end(), model_map[i].getMZ() + mz_pair_max_distance, MZUpperBound_()) - scene_map.begin();
 
-        // second point in model map (j)
-        for (Size j = i + 1, j_low = i_low, j_high = i_low, l_low = k_low, l_high = k_high; j < model_map_size; ++j)
+        // Iterate through all matching features in the scene map that are
+        // within the m/z distance of item i from the model map.
+        // first point in scene map (k)
+        for (Size k = k_low; k < k_high; ++k)
         {
-          // diff in model map -> skip features that are too far away in RT
-          double diff_model = model_map[j].getRT() - model_map[i].getRT();
-          if (fabs(diff_model) < rt_pair_min_distance)
-            continue;
-
-          // Adjust window around j in model map
-          while (j_low < model_map_size && model_map[j_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-            ++j_low;
-          while (j_high < model_map_size && model_map[j_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-            ++j_high;
-          double j_winlength_factor = 1. / (j_high - j_low);
-          j_winlength_factor -= winlength_factor_baseline;
-          if (j_winlength_factor <= 0)
+          // stop if there are too many features are in our window
+          double k_winlength_factor = 1. / (k_high - k_low);
+          k_winlength_factor -= winlength_factor_baseline;
+          if (k_winlength_factor <= 0)
             continue;
 
-          // Adjust window around l in scene map
-          while (l_low < scene_map_size && scene_map[l_low].getMZ() < model_map[j].getMZ() - mz_pair_max_distance)
-            ++l_low;
-          while (l_high < scene_map_size && scene_map[l_high].getMZ() <= model_map[j].getMZ() + mz_pair_max_distance)
-            ++l_high;
+          // compute similarity of intensities i k by taking the ratio of the two intensities
+          double similarity_ik;
+          {
+            const double int_i = model_map[i].getIntensity();
+            const double int_k = scene_map[k].getIntensity() * total_intensity_ratio;
+            similarity_ik = (int_i < int_k) ? int_i / int_k : int_k / int_i;
+            // weight is inverse proportional to number of elements with similar mz
+            similarity_ik *= i_winlength_factor;
+            similarity_ik *= k_winlength_factor;
+          }
 
-          // second point in scene map (l)
-          for (Size l = l_low; l < l_high; ++l)
+          // second point in model map (j)
+          for (Size j = i + 1, j_low = i_low, j_high = i_low, l_low = k_low, l_high = k_high; j < model_map_size; ++j)
           {
-            double l_winlength_factor = 1. / (l_high - l_low);
-            l_winlength_factor -= winlength_factor_baseline;
-            if (l_winlength_factor <= 0)
+            // diff in model map -> skip features that are too far away in RT
+            double diff_model = model_map[j].getRT() - model_map[i].getRT();
+            if (fabs(diff_model) < rt_pair_min_distance)
               continue;
 
-            // diff in scene map -> skip features that are too far away in RT
-            double diff_scene = scene_map[l].getRT() - scene_map[k].getRT();
-
-            // avoid cross mappings (i,j) -> (k,l) (e.g. i_rt < j_rt and k_rt > l_rt)
-            // and point pairs with equal retention times (e.g. i_rt == j_rt)
-            if (fabs(diff_scene) < rt_pair_min_distance || ((diff_model > 0) != (diff_scene > 0)))
+            // Adjust window around j in model map
+            while (j_low < model_map_size && model_map[j_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
+              ++j_low;
+            while (j_high < model_map_size && model_map[j_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
+              ++j_high;
+            double j_winlength_factor = 1. / (j_high - j_low);
+            j_winlength_factor -= winlength_factor_baseline;
+            if (j_winlength_factor <= 0)
               continue;
 
-            // compute the transformation (i,j) -> (k,l)
-            double scaling = diff_model / diff_scene;
-            double shift = model_map[i].getRT() - scene_map[k].getRT() * scaling;
+            // Adjust window around l in scene map
+            while (l_low < scene_map_size && scene_map[l_low].getMZ() < model_map[j].getMZ() - mz_pair_max_distance)
+              ++l_low;
+            while (l_high < scene_map_size && scene_map[l_high].getMZ() <= model_map[j].getMZ() + mz_pair_max_distance)
+              ++l_high;
 
-            // compute similarity of intensities i k j l
-            double similarity_ik_jl;
-            {
-              // compute similarity of intensities j l
-              const double int_j = model_map[j].getIntensity();
-              const double int_l = scene_map[l].getIntensity() * total_intensity_ratio;
-              double similarity_jl = (int_j < int_l) ? int_j / int_l : int_l / int_j;
-              // weight is inverse proportional to number of elements with similar mz
-              similarity_jl *= j_winlength_factor;
-              similarity_jl *= l_winlength_factor;
-              similarity_ik_jl = similarity_ik * similarity_jl;
-            }
-
-            // hash the images of scaling, rt_low and rt_high into their respective hash tables
-            // store the scaling parameter and the (estimated) transformation of start/end of the maps in hashes
-            //   -> in round 2, discard values outside of scale_low_1 and
-            //   scale_high_1 (estimated before in scalingEstimate)
-            if (hashing_round == 1)
+            // second point in scene map (l)
+            for (Size l = l_low; l < l_high; ++l)
             {
-              // hashing round 1 (estimate the scaling only)
-              scaling_hash_1.addValue(log(scaling), similarity_ik_jl);
-            }
-            else if (scaling >= scale_low_1 && scaling <= scale_high_1)
-            {
-              // hashing round 2 (estimate scaling and shift)
-              scaling_hash_2.addValue(log(scaling), similarity_ik_jl);
+              double l_winlength_factor = 1. / (l_high - l_low);
+              l_winlength_factor -= winlength_factor_baseline;
+              if (l_winlength_factor <= 0)
+                continue;
+
+              // diff in scene map -> skip features that are too far away in RT
+              double diff_scene = scene_map[l].getRT() - scene_map[k].getRT();
+
+              // avoid cross mappings (i,j) -> (k,l) (e.g. i_rt < j_rt and k_rt > l_rt)
+              // and point pairs with equal retention times (e.g. i_rt == j_rt)
+              if (fabs(diff_scene) < rt_pair_min_distance || ((diff_model > 0) != (diff_scene > 0)))
+                continue;
 
-              const double rt_low_image = shift + rt_low * scaling;
-              rt_low_hash_.addValue(rt_low_image, similarity_ik_jl);
-              const double rt_high_image = shift + rt_high * scaling;
-              rt_high_hash_.addValue(rt_high_image, similarity_ik_jl);
+              // compute the transformation (i,j) -> (k,l)
+              double scaling = diff_model / diff_scene;
+              double shift = model_map[i].getRT() - scene_map[k].getRT() * scaling;
 
-              if (do_dump_pairs)
+              // compute similarity of intensities i k j l
+              double similarity_ik_jl;
               {
-                dump_pairs_file << i << ' ' << model_map[i].getRT() << ' ' << model_map[i].getMZ() << ' ' << j << ' ' << model_map[j].getRT() << ' '
-                                << model_map[j].getMZ() << ' ' << k << ' ' << scene_map[k].getRT() << ' ' << scene_map[k].getMZ() << ' ' << l << ' '
-                                << scene_map[l].getRT() << ' ' << scene_map[l].getMZ() << ' ' << similarity_ik_jl << ' ' << std::endl;
+                // compute similarity of intensities j l
+                const double int_j = model_map[j].getIntensity();
+                const double int_l = scene_map[l].getIntensity() * total_intensity_ratio;
+                double similarity_jl = (int_j < int_l) ? int_j / int_l : int_l / int_j;
+                // weight is inverse proportional to number of elements with similar mz
+                similarity_jl *= j_winlength_factor;
+                similarity_jl *= l_winlength_factor;
+                similarity_ik_jl = similarity_ik * similarity_jl;
               }
-            }
-          }   // l
-        }   // j
-      }   // k
-    }   // i
+
+              // hash the images of scaling, rt_low and rt_high into their respective hash tables
+              // store the scaling parameter and the (estimated) transformation of start/end of the maps in hashes
+              //   -> in round 2, discard values outside of scale_low_1 and
+              //   scale_high_1 (estimated before in scalingEstimate)
+              if (hashing_round == 1)
+              {
+                // hashing round 1 (estimate the scaling only)
+                local_scaling_hash_1.addValue(log(scaling), similarity_ik_jl);
+              }
+              else if (scaling >= scale_low_1 && scaling <= scale_high_1)
+              {
+                // hashing round 2 (estimate scaling and shift)
+                local_scaling_hash_2.addValue(log(scaling), similarity_ik_jl);
+
+                const double rt_low_image = shift + rt_low * scaling;
+                local_rt_low_hash.addValue(rt_low_image, similarity_ik_jl);
+                const double rt_high_image = shift + rt_high * scaling;
+                local_rt_high_hash.addValue(rt_high_image, similarity_ik_jl);
+
+                if (do_dump_pairs)
+                {
+                  dump_pairs_file << i << ' ' << model_map[i].getRT() << ' ' << model_map[i].getMZ() << ' ' << j << ' ' << model_map[j].getRT() << ' '
+                                  << model_map[j].getMZ() << ' ' << k << ' ' << scene_map[k].getRT() << ' ' << scene_map[k].getMZ() << ' ' << l << ' '
+                                  << scene_map[l].getRT() << ' ' << scene_map[l].getMZ() << ' ' << similarity_ik_jl << ' ' << std::endl;
+                }
+              }
+            }   // l
+          }   // j
+        }   // k
+      }   // i
+
+      // merge the votes of this thread
+#ifdef _OPENMP
+#pragma omp critical (PoseClusteringAffineSuperimposer_hashing)
+#endif
+      {
+        addHashData(local_scaling_hash_1, scaling_hash_1);
+        addHashData(local_scaling_hash_2, scaling_hash_2);
+        addHashData(local_rt_low_hash, rt_low_hash_);
+        addHashData(local_rt_high_hash, rt_high_hash_);
+      }
+    }
   }
 
   /**
@@ -717,6 +785,32 @@ namespace OpenMS
     }
   }
 
+  void PoseClusteringAffineSuperimposer::selectPoints(std::vector<Peak2D>& map, const Size num_used_points, const bool stratified)
+  {
+    if (map.size() <= num_used_points)
+    {
+      return;
+    }
+
+    if (!stratified)
+    {
+      // sort the last data points by ascending intensity (from the right, using reverse iterators)
+      //  -> linear in complexity, should be faster than sorting and then taking cutoff
+      std::nth_element(map.rbegin(), map.rbegin() + (map.size() - num_used_points),
+          map.rend(), Peak2D::IntensityLess());
+      map.resize(num_used_points);
+      return;
+    }
+
+    std::sort(map.rbegin(), map.rend(), Peak2D::IntensityLess());
+    const double stride = double(map.size()) / num_used_points;
+    for (Size index = 0; index < num_used_points; ++index)
+    {
+      map[index] = map[Size(index * stride)];
+    }
+    map.resize(num_used_points);
+  }
+
   double computeIntensityRatio(const std::vector<Peak2D> & model_map, const std::vector<Peak2D> & scene_map)
   {
     double total_int_model_map = 0;
@@ -811,22 +905,11 @@ namespace OpenMS
     {
       // truncate the data as necessary
       const Size num_used_points = (Int) param_.getValue("num_used_points");
+      const bool stratified = param_.getValue("point_selection") == "intensity_stratified";
 
-      // sort the last data points by ascending intensity (from the right, using reverse iterators)
-      //  -> linear in complexity, should be faster than sorting and then taking cutoff
-      if (model_map.size() > num_used_points)
-      {
-        std::nth_element(model_map.rbegin(), model_map.rbegin() + (model_map.size() - num_used_points),
-            model_map.rend(), Peak2D::IntensityLess());
-        model_map.resize(num_used_points);
-      }
+      selectPoints(model_map, num_used_points, stratified);
       setProgress(++actual_progress);
-      if (scene_map.size() > num_used_points)
-      {
-        std::nth_element(scene_map.rbegin(), scene_map.rbegin() + (scene_map.size() - num_used_points),
-            scene_map.rend(), Peak2D::IntensityLess());
-        scene_map.resize(num_used_points);
-      }
+      selectPoints(scene_map, num_used_points, stratified);
       setProgress(++actual_progress);
     }
     // sort by ascending m/z
@@ -35,6 +35,7 @@
 #include <OpenMS/ANALYSIS/MAPMATCHING/QTClusterFinder.h>
 #include <OpenMS/KERNEL/FeatureMap.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/SYSTEM/PerformanceTrace.h>
 
 // #define DEBUG_QTCLUSTERFINDER
 
@@ -94,6 +95,7 @@ namespace OpenMS
   void QTClusterFinder::run_(const vector<MapType>& input_maps,
                              ConsensusMap& result_map)
   {
+    OPENMS_TRACE_SCOPE("QTClusterFinder::run");
     // update parameters (dummy)
     setParameters_(1, 1);
 
@@ -238,15 +240,25 @@ namespace OpenMS
 
     // compute QT clustering:
     // std::cout << "Clustering..." << std::endl;
-    list<QTCluster> clustering;
-    computeClustering_(grid, clustering);
+    vector<QTCluster> clustering;
+    {
+      OPENMS_TRACE_SCOPE("QTClusterFinder: initial clustering");
+      computeClustering_(grid, clustering);
+    }
     // number of clusters == number of data points:
     Size size = clustering.size();
 
+    // order all clusters by quality (only valid clusters are kept here)
+    ClusterQueue queue;
+    for (Size i = 0; i < clustering.size(); ++i)
+    {
+      queue.insert(make_pair(clustering[i].getQuality(), i));
+    }
+
     // create a temp. map storing which grid features are next to which clusters
     typedef OpenMSBoost::unordered_map<Size, std::vector<GridFeature*> > NeighborList;
     ElementMapping element_mapping;
-    for (list<QTCluster>::iterator it = clustering.begin();
+    for (vector<QTCluster>::iterator it = clustering.begin();
          it != clustering.end(); ++it)
     {
       NeighborList neigh = it->getAllNeighbors();
@@ -263,7 +275,7 @@ namespace OpenMS
     }
 
     // ensure that all cluster centers are in the list
-    for (list<QTCluster>::iterator it = clustering.begin();
+    for (vector<QTCluster>::iterator it = clustering.begin();
          it != clustering.end(); ++it)
     {
       OpenMS::GridFeature* center_feature = it->getCenterPoint();
@@ -278,51 +290,31 @@ namespace OpenMS
       logger.startProgress(0, size, "linking features");
     }
 
-    while (!clustering.empty())
     {
-      // std::cout << "Clusters: " << clustering.size() << std::endl;
-      ConsensusFeature consensus_feature;
-      makeConsensusFeature_(clustering, consensus_feature, element_mapping, grid);
-      if (!clustering.empty())
+      OPENMS_TRACE_SCOPE("QTClusterFinder: cluster extraction");
+      while (!queue.empty())
       {
+        // std::cout << "Clusters: " << queue.size() << std::endl;
+        ConsensusFeature consensus_feature;
+        makeConsensusFeature_(clustering, queue, consensus_feature, element_mapping, grid);
         result_map.push_back(consensus_feature);
+        if (do_progress) logger.setProgress(progress++);
       }
-      if (do_progress) logger.setProgress(progress++);
     }
 
     if (do_progress) logger.endProgress();
   }
 
-  void QTClusterFinder::makeConsensusFeature_(list<QTCluster>& clustering,
+  void QTClusterFinder::makeConsensusFeature_(vector<QTCluster>& clustering,
+                                              ClusterQueue& queue,
                                               ConsensusFeature& feature,
                                               ElementMapping& element_mapping,
                                               Grid& grid)
   {
-    // find the best cluster (a valid cluster with the highest score)
-    // -> this is equivalent to std::max_element but we can skip invalid clusters
-    list<QTCluster>::iterator best = clustering.begin();
-    while (best != clustering.end() && best->isInvalid()) // find start element
-    {
-      ++best;
-    }
-    for (list<QTCluster>::iterator it = best;
-         it != clustering.end(); ++it)
-    {
-      if (!it->isInvalid())
-      {
-        if (it->getQuality() > best->getQuality())
-        {
-          best = it;
-        }
-      }
-    }
-
-    // no more clusters to process -> clear clustering and return
-    if (best == clustering.end())
-    {
-      clustering.clear();
-      return;
-    }
+    // get the best cluster (a valid cluster with the highest score, first in
+    // the clustering in case of ties) and remove it from the queue
+    QTCluster* best = &clustering[queue.begin()->second];
+    queue.erase(queue.begin());
 
     OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*> elements;
     best->getElements(elements);
@@ -362,6 +354,10 @@ namespace OpenMS
     // 2. update all clusters accordingly by removing already used elements
     // 3. Invalidate elements whose central has been used already
     best->setInvalid();
+
+    // clusters touched by the update, together with their quality before the
+    // update (i.e. their current key in the queue)
+    std::map<QTCluster*, double> touched;
     for (OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*>::const_iterator
         it = elements.begin(); it != elements.end(); ++it)
     {
@@ -378,6 +374,11 @@ namespace OpenMS
         // recompute the quality)
         if (!(*cluster)->isInvalid())
         {
+          if (touched.find(*cluster) == touched.end())
+          {
+            touched[*cluster] = (*cluster)->getQuality();
+          }
+
           // remove the elements of the new feature from the cluster
           if ((*cluster)->update(elements))
           {
@@ -393,7 +394,7 @@ namespace OpenMS
             // add elements to the current cluster to replace the ones we just
             // removed
             const OpenMS::GridFeature* center_feature = (*cluster)->getCenterPoint();
-            addClusterElements_(x, y, grid, (**cluster), center_feature);
+            addClusterElements_(x, y, grid, (**cluster), center_feature, feature_distance_);
 
             ////////////////////////////////////////
             // Step 2: update element_mapping as the best feature for each
@@ -425,10 +426,22 @@ namespace OpenMS
         }
       }
     }
+
+    // re-sort the touched clusters (invalidated ones are dropped)
+    for (std::map<QTCluster*, double>::iterator it = touched.begin();
+         it != touched.end(); ++it)
+    {
+      const Size index = it->first - &clustering[0];
+      queue.erase(make_pair(it->second, index));
+      if (!it->first->isInvalid())
+      {
+        queue.insert(make_pair(it->first->getQuality(), index));
+      }
+    }
   }
 
   void QTClusterFinder::addClusterElements_(int x, int y, const Grid& grid, QTCluster& cluster,
-    const OpenMS::GridFeature* center_feature)
+    const OpenMS::GridFeature* center_feature, FeatureDistance& feature_distance) const
   {
     cluster.initializeCluster();
 
@@ -471,7 +484,7 @@ namespace OpenMS
             if (center_feature != neighbor_feature)
             {
               // NOTE: this actually caches the distance -> memory problem
-              double dist = getDistance_(center_feature, neighbor_feature);
+              double dist = getDistance_(center_feature, neighbor_feature, feature_distance);
 
               if (dist == FeatureDistance::infinity)
               {
@@ -524,7 +537,7 @@ namespace OpenMS
   }
 
   void QTClusterFinder::computeClustering_(Grid& grid,
-                                           list<QTCluster>& clustering)
+                                           vector<QTCluster>& clustering)
   {
     clustering.clear();
     already_used_.clear();
@@ -532,25 +545,41 @@ namespace OpenMS
     // FeatureDistance produces normalized distances (between 0 and 1):
     const double max_distance = 1.0;
 
-    // iterate over all grid cells:
+    // create one (empty) cluster per grid feature - the clusters must not be
+    // moved afterwards, since they are referenced by pointer:
+    clustering.reserve(grid.size());
     for (Grid::iterator it = grid.begin(); it != grid.end(); ++it)
     {
       const Grid::CellIndex& act_coords = it.index();
       const Int x = act_coords[0], y = act_coords[1];
 
       OpenMS::GridFeature* center_feature = it->second;
-      QTCluster cluster(center_feature, num_maps_, max_distance, use_IDs_, x, y);
-
-      addClusterElements_(x, y, grid, cluster, center_feature);
+      clustering.push_back(QTCluster(center_feature, num_maps_, max_distance, use_IDs_, x, y));
+    }
 
-      clustering.push_back(cluster);
+    // fill the clusters from their grid neighborhoods (the grid is only read):
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      FeatureDistance feature_distance(feature_distance_);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 100)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)clustering.size(); ++i)
+      {
+        QTCluster& cluster = clustering[i];
+        addClusterElements_(cluster.getXCoord(), cluster.getYCoord(), grid,
+                            cluster, cluster.getCenterPoint(), feature_distance);
+      }
     }
   }
 
   double QTClusterFinder::getDistance_(const OpenMS::GridFeature* left,
-                                       const OpenMS::GridFeature* right)
+                                       const OpenMS::GridFeature* right,
+                                       FeatureDistance& feature_distance) const
   {
-    return feature_distance_(left->getFeature(), right->getFeature()).second;
+    return feature_distance(left->getFeature(), right->getFeature()).second;
   }
   
 
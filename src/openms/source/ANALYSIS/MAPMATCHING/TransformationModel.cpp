@@ -88,6 +88,14 @@ namespace OpenMS
     return value;
   }
 
+  void TransformationModel::evaluateSorted(std::vector<double>& values) const
+  {
+    for (std::vector<double>::iterator it = values.begin(); it != values.end(); ++it)
+    {
+      *it = evaluate(*it);
+    }
+  }
+
   const Param& TransformationModel::getParameters() const
   {
     return params_;
@@ -71,6 +71,11 @@ public:
       return spline_->eval(x);
     }
 
+    void evalSorted(std::vector<double>::iterator first, std::vector<double>::iterator last) const override
+    {
+      spline_->evalSorted(first, last);
+    }
+
     ~Spline2dInterpolator() override
     {
       delete spline_;
@@ -163,6 +168,39 @@ public:
       }
     }
 
+    void evalSorted(std::vector<double>::iterator first, std::vector<double>::iterator last) const override
+    {
+      // "upper" is the first knot > x (same as 'upper_bound' in 'eval'); for
+      // ascending x it only moves forward, so no binary search is needed
+      const Size n = x_.size();
+      Size upper = 0;
+      for (; first != last; ++first)
+      {
+        const double x = *first;
+        if (upper > 0 && x < x_[upper - 1]) // not ascending - search again
+        {
+          upper = std::upper_bound(x_.begin(), x_.end(), x) - x_.begin();
+        }
+        else
+        {
+          while (upper < n && x_[upper] <= x) ++upper;
+        }
+
+        if (upper == n)
+        {
+          *first = y_.back();
+        }
+        else
+        {
+          const double x_0 = x_[upper - 1];
+          const double x_1 = x_[upper];
+          const double y_0 = y_[upper - 1];
+          const double y_1 = y_[upper];
+          *first = y_0 + (y_1 - y_0) * (x - x_0) / (x_1 - x_0);
+        }
+      }
+    }
+
     ~LinearInterpolator() override
     {
     }
@@ -296,6 +334,40 @@ private:
     return interp_->eval(value);
   }
 
+  void TransformationModelInterpolated::evaluateSorted(std::vector<double>& values) const
+  {
+    const double x_min = x_.front(), x_max = x_.back();
+    std::vector<double>::iterator it = values.begin();
+    while (it != values.end())
+    {
+      if (*it < x_min) // extrapolate front
+      {
+        *it = lm_front_->evaluate(*it);
+        ++it;
+      }
+      else if (*it > x_max) // extrapolate back
+      {
+        *it = lm_back_->evaluate(*it);
+        ++it;
+      }
+      else // interpolate the whole run of values inside the data range
+      {
+        std::vector<double>::iterator end = it;
+        while (end != values.end() && *end >= x_min && *end <= x_max) ++end;
+        if (end == it) // NaN
+        {
+          *it = interp_->eval(*it);
+          ++end;
+        }
+        else
+        {
+          interp_->evalSorted(it, end);
+        }
+        it = end;
+      }
+    }
+  }
+
   void TransformationModelInterpolated::getDefaultParameters(Param& params)
   {
     params.clear();
@@ -110,6 +110,24 @@ namespace OpenMS
     return eval;
   }
 
+  void TransformationModelLinear::evaluateSorted(std::vector<double>& values) const
+  {
+    if (weighting_)
+    {
+      TransformationModel::evaluateSorted(values);
+      return;
+    }
+
+    // plain loop without calls, so the compiler can use SIMD instructions:
+    const double slope = slope_, intercept = intercept_;
+    double* v = values.empty() ? nullptr : &values[0];
+    const Size n = values.size();
+    for (Size i = 0; i < n; ++i)
+    {
+      v[i] = slope * v[i] + intercept;
+    }
+  }
+
   void TransformationModelLinear::invert()
   {
     if (slope_ == 0)
@@ -38,8 +38,20 @@
 
 #include <OpenMS/CONCEPT/Exception.h>
 
+#include <algorithm>
+
 namespace OpenMS
 {
+  namespace
+  {
+    struct RangeEndLess_
+    {
+      bool operator()(const std::pair<double, double>& left, const std::pair<double, double>& right) const
+      {
+        return left.second < right.second;
+      }
+    };
+  }
 
   void ChromatogramExtractorAlgorithm::extract_value_tophat(
       const std::vector<double>::const_iterator& mz_start,
@@ -166,14 +178,52 @@ namespace OpenMS
         "Input to extractChromatogram needs to be sorted by m/z");
     }
 
+    // if all coordinates are limited in RT, only spectra within (the union
+    // of) their RT ranges need to be accessed at all
+    std::vector<std::pair<double, double> > rt_ranges;
+    for (Size k = 0; k < extraction_coordinates.size(); ++k)
+    {
+      if (extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start <= 0)
+      {
+        rt_ranges.clear();
+        break;
+      }
+      rt_ranges.push_back(std::make_pair(extraction_coordinates[k].rt_start, extraction_coordinates[k].rt_end));
+    }
+    std::sort(rt_ranges.begin(), rt_ranges.end());
+    Size n_merged = 0;
+    for (Size k = 0; k < rt_ranges.size(); ++k)
+    {
+      if (n_merged > 0 && rt_ranges[k].first <= rt_ranges[n_merged - 1].second)
+      {
+        rt_ranges[n_merged - 1].second = std::max(rt_ranges[n_merged - 1].second, rt_ranges[k].second);
+      }
+      else
+      {
+        rt_ranges[n_merged++] = rt_ranges[k];
+      }
+    }
+    rt_ranges.resize(n_merged);
+
     //go through all spectra
     startProgress(0, input_size, "Extracting chromatograms");
     for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
     {
       setProgress(scan_idx);
 
-      OpenSwath::SpectrumPtr sptr = input->getSpectrumById(scan_idx);
       OpenSwath::SpectrumMeta s_meta = input->getSpectrumMetaById(scan_idx);
+      if (!rt_ranges.empty())
+      {
+        // first range that ends at or after the current RT:
+        std::vector<std::pair<double, double> >::const_iterator range_it =
+          std::lower_bound(rt_ranges.begin(), rt_ranges.end(), std::make_pair(s_meta.RT, s_meta.RT), RangeEndLess_());
+        if (range_it == rt_ranges.end() || s_meta.RT < range_it->first)
+        {
+          continue;
+        }
+      }
+
+      OpenSwath::SpectrumPtr sptr = input->getSpectrumById(scan_idx);
 
       OpenSwath::BinaryDataArrayPtr mz_arr = sptr->getMZArray();
       OpenSwath::BinaryDataArrayPtr int_arr = sptr->getIntensityArray();
@@ -36,7 +36,10 @@
 
 namespace OpenMS
 {
-  SpectrumAccessOpenMS::SpectrumAccessOpenMS(boost::shared_ptr<MSExperimentType> ms_experiment)
+  const Size SpectrumAccessOpenMS::MAX_CONVERTED_SCANS = 1000;
+
+  SpectrumAccessOpenMS::SpectrumAccessOpenMS(boost::shared_ptr<MSExperimentType> ms_experiment) :
+    converted_(new ConvertedData_)
   {
     // store shared pointer to the actual MSExperiment
     ms_experiment_ = ms_experiment;
@@ -47,7 +50,8 @@ namespace OpenMS
   }
 
   SpectrumAccessOpenMS::SpectrumAccessOpenMS(const SpectrumAccessOpenMS & rhs) :
-    ms_experiment_(rhs.ms_experiment_)
+    ms_experiment_(rhs.ms_experiment_),
+    converted_(rhs.converted_)
   {}
 
   boost::shared_ptr<OpenSwath::ISpectrumAccess> SpectrumAccessOpenMS::lightClone() const
@@ -60,18 +64,50 @@ namespace OpenMS
     OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
     OPENMS_PRECONDITION(id < (int)getNrSpectra(), "Id cannot be larger than number of spectra");
 
+    // look up whether the spectrum was already converted (possibly by a light clone)
+    OpenSwath::SpectrumPtr sptr;
+#ifdef _OPENMP
+#pragma omp critical (SpectrumAccessOpenMS_converted)
+#endif
+    {
+      if ((Size)id < converted_->spectra.size()) sptr = converted_->spectra[id];
+    }
+    if (sptr) return sptr;
+
+    // convert outside of the critical section, the peaks are only read
     const MSSpectrumType& spectrum = (*ms_experiment_)[id];
     OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray);
     OpenSwath::BinaryDataArrayPtr mz_array(new OpenSwath::BinaryDataArray);
+    mz_array->data.reserve(spectrum.size());
+    intensity_array->data.reserve(spectrum.size());
     for (MSSpectrumType::const_iterator it = spectrum.begin(); it != spectrum.end(); ++it)
     {
       mz_array->data.push_back(it->getMZ());
       intensity_array->data.push_back(it->getIntensity());
     }
 
-    OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+    sptr = OpenSwath::SpectrumPtr(new OpenSwath::Spectrum);
     sptr->setMZArray(mz_array);
     sptr->setIntensityArray(intensity_array);
+
+    // store it, unless another thread was faster (then use its copy)
+#ifdef _OPENMP
+#pragma omp critical (SpectrumAccessOpenMS_converted)
+#endif
+    {
+      if (converted_->spectra.size() < getNrSpectra()) converted_->spectra.resize(getNrSpectra());
+      if (converted_->spectra[id]) sptr = converted_->spectra[id];
+      else
+      {
+        converted_->spectra[id] = sptr;
+        converted_->spectra_order.push_back(id);
+        if (converted_->spectra_order.size() > MAX_CONVERTED_SCANS)
+        {
+          converted_->spectra[converted_->spectra_order.front()].reset();
+          converted_->spectra_order.pop_front();
+        }
+      }
+    }
     return sptr;
   }
 
@@ -91,18 +127,48 @@ namespace OpenMS
     OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
     OPENMS_PRECONDITION(id < (int)getNrChromatograms(), "Id cannot be larger than number of chromatograms");
 
+    // look up whether the chromatogram was already converted (possibly by a light clone)
+    OpenSwath::ChromatogramPtr cptr;
+#ifdef _OPENMP
+#pragma omp critical (SpectrumAccessOpenMS_converted)
+#endif
+    {
+      if ((Size)id < converted_->chromatograms.size()) cptr = converted_->chromatograms[id];
+    }
+    if (cptr) return cptr;
+
     const MSChromatogramType& chromatogram = ms_experiment_->getChromatograms()[id];
     OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray);
     OpenSwath::BinaryDataArrayPtr rt_array(new OpenSwath::BinaryDataArray);
+    rt_array->data.reserve(chromatogram.size());
+    intensity_array->data.reserve(chromatogram.size());
     for (MSChromatogramType::const_iterator it = chromatogram.begin(); it != chromatogram.end(); ++it)
     {
       rt_array->data.push_back(it->getRT());
       intensity_array->data.push_back(it->getIntensity());
     }
 
-    OpenSwath::ChromatogramPtr cptr(new OpenSwath::Chromatogram);
+    cptr = OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram);
     cptr->setTimeArray(rt_array);
     cptr->setIntensityArray(intensity_array);
+
+#ifdef _OPENMP
+#pragma omp critical (SpectrumAccessOpenMS_converted)
+#endif
+    {
+      if (converted_->chromatograms.size() < getNrChromatograms()) converted_->chromatograms.resize(getNrChromatograms());
+      if (converted_->chromatograms[id]) cptr = converted_->chromatograms[id];
+      else
+      {
+        converted_->chromatograms[id] = cptr;
+        converted_->chromatograms_order.push_back(id);
+        if (converted_->chromatograms_order.size() > MAX_CONVERTED_SCANS)
+        {
+          converted_->chromatograms[converted_->chromatograms_order.front()].reset();
+          converted_->chromatograms_order.pop_front();
+        }
+      }
+    }
     return cptr;
   }
 
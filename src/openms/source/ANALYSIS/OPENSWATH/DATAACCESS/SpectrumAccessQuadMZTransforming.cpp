@@ -60,25 +60,34 @@ namespace OpenMS
 
     OpenSwath::SpectrumPtr SpectrumAccessQuadMZTransforming::getSpectrumById(int id)
     {
-      OpenSwath::SpectrumPtr s = sptr_->getSpectrumById(id);
-      for (size_t i = 0; i < s->getMZArray()->data.size(); i++)
+      // The underlying access may hand out the same (cached) object on every
+      // call and to other threads, so never modify it: the result shares all
+      // arrays with the original spectrum except for the new m/z array.
+      OpenSwath::SpectrumPtr orig = sptr_->getSpectrumById(id);
+      OpenSwath::SpectrumPtr s(new OpenSwath::Spectrum(*orig));
+      const std::vector<double>& mz_in = orig->getMZArray()->data;
+
+      OpenSwath::BinaryDataArrayPtr mz_array(new OpenSwath::BinaryDataArray);
+      mz_array->data.reserve(mz_in.size());
+      for (size_t i = 0; i < mz_in.size(); i++)
       {
         // mz = a + b * mz + c * mz^2
         double predict = 
           a_ + 
-          b_ * s->getMZArray()->data[i] +
-          c_ * s->getMZArray()->data[i] * s->getMZArray()->data[i];
+          b_ * mz_in[i] +
+          c_ * mz_in[i] * mz_in[i];
 
         // If ppm is true, we predicted the ppm deviation, not the actual new mass
         if (ppm_)
         {
-          s->getMZArray()->data[i] = s->getMZArray()->data[i] - predict*s->getMZArray()->data[i]/1000000;
+          mz_array->data.push_back(mz_in[i] - predict*mz_in[i]/1000000);
         }
         else
         {
-          s->getMZArray()->data[i] = predict;
+          mz_array->data.push_back(predict);
         }
       }
+      s->setMZArray(mz_array);
       return s;
     }
 
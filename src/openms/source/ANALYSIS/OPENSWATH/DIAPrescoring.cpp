@@ -132,51 +132,63 @@ namespace OpenMS
                           double& dotprod,
                           double& manhattan)
   {
+    std::vector<double> theo_mz, theo_int, theo_int_normed, int_exp, mz_exp;
+    getTheoreticalSpectrum(lt, theo_mz, theo_int, theo_int_normed);
+    score(spec, theo_mz, theo_int, theo_int_normed, int_exp, mz_exp, dotprod, manhattan);
+  }
+
+  void DiaPrescore::getTheoreticalSpectrum(const std::vector<OpenSwath::LightTransition>& lt,
+                                           std::vector<double>& theo_mz,
+                                           std::vector<double>& theo_int,
+                                           std::vector<double>& theo_int_normed) const
+  {
+    theo_mz.clear();
+    theo_int.clear();
+    theo_int_normed.clear();
+
     std::vector<std::pair<double, double> > res;
     getMZIntensityFromTransition(lt, res);
-    std::vector<double> firstIstotope, theomasses;
+    std::vector<double> firstIstotope;
     DIAHelpers::extractFirst(res, firstIstotope);
-    std::vector<std::pair<double, double> > spectrum, spectrum2;
+    std::vector<std::pair<double, double> > spectrum;
     DIAHelpers::addIsotopes2Spec(res, spectrum, nr_charges_);
-    spectrum2.resize(spectrum.size());
-    std::copy(spectrum.begin(), spectrum.end(), spectrum2.begin());
-    //std::cout << spectrum.size() << std::endl;
     DIAHelpers::addPreisotopeWeights(firstIstotope, spectrum, 2, 0.0);
     //extracts masses from spectrum
-    DIAHelpers::extractFirst(spectrum, theomasses);
-    std::vector<double>  theorint;
-    DIAHelpers::extractSecond(spectrum, theorint);
-    std::vector<double> intExp, mzExp;
-    integrateWindows(spec, theomasses, dia_extract_window_, intExp,
-                     mzExp);
-    std::transform(intExp.begin(), intExp.end(), intExp.begin(), OpenSwath::mySqrt());
-    std::transform(theorint.begin(), theorint.end(), theorint.begin(), OpenSwath::mySqrt());
-
-    double intExptotal = std::accumulate(intExp.begin(), intExp.end(), 0.0);
-    double intTheorTotal = std::accumulate(theorint.begin(), theorint.end(), 0.0);
-
-    OpenSwath::normalize(intExp, intExptotal, intExp);
-    OpenSwath::normalize(theorint, intTheorTotal, theorint);
-
-    manhattan = OpenSwath::manhattanDist(intExp.begin(), intExp.end(), theorint.begin());
-
-    //std::cout << spectrum.size() << std::endl;
-    DIAHelpers::addPreisotopeWeights(firstIstotope, spectrum2, 2, -0.5);
-    std::vector<double>  theorint2;
-    DIAHelpers::extractSecond(spectrum, theorint2);
-    std::transform(theorint2.begin(), theorint2.end(), theorint2.begin(), OpenSwath::mySqrt());
-
-    intExptotal = OpenSwath::norm(intExp.begin(), intExp.end());
-    intTheorTotal = OpenSwath::norm(theorint2.begin(), theorint2.end());
-
-    OpenSwath::normalize(intExp, intExptotal, intExp);
-    OpenSwath::normalize(theorint2, intTheorTotal, theorint2);
-
-    //    std::copy(intExp.begin(), intExp.end(), std::ostream_iterator<double>(std::cout, ", "));
-    //    std::cout << std::endl;
-    //    std::copy(theorint2.begin(), theorint2.end(), std::ostream_iterator<double>(std::cout, ", "));
-    //    std::cout << std::endl;
-    dotprod = OpenSwath::dotProd(intExp.begin(), intExp.end(), theorint2.begin());
+    DIAHelpers::extractFirst(spectrum, theo_mz);
+    DIAHelpers::extractSecond(spectrum, theo_int);
+    std::transform(theo_int.begin(), theo_int.end(), theo_int.begin(), OpenSwath::mySqrt());
+    theo_int_normed = theo_int;
+
+    // sum-normalized intensities for the manhattan distance
+    double intTheorTotal = std::accumulate(theo_int.begin(), theo_int.end(), 0.0);
+    OpenSwath::normalize(theo_int, intTheorTotal, theo_int);
+
+    // unit-length intensities for the dot product
+    intTheorTotal = OpenSwath::norm(theo_int_normed.begin(), theo_int_normed.end());
+    OpenSwath::normalize(theo_int_normed, intTheorTotal, theo_int_normed);
+  }
+
+  void DiaPrescore::score(OpenSwath::SpectrumPtr spec,
+                          const std::vector<double>& theo_mz,
+                          const std::vector<double>& theo_int,
+                          const std::vector<double>& theo_int_normed,
+                          std::vector<double>& int_exp,
+                          std::vector<double>& mz_exp,
+                          double& dotprod,
+                          double& manhattan) const
+  {
+    int_exp.clear();
+    mz_exp.clear();
+    integrateWindows(spec, theo_mz, dia_extract_window_, int_exp, mz_exp);
+    std::transform(int_exp.begin(), int_exp.end(), int_exp.begin(), OpenSwath::mySqrt());
+
+    double intExptotal = std::accumulate(int_exp.begin(), int_exp.end(), 0.0);
+    OpenSwath::normalize(int_exp, intExptotal, int_exp);
+    manhattan = OpenSwath::manhattanDist(int_exp.begin(), int_exp.end(), theo_int.begin());
+
+    intExptotal = OpenSwath::norm(int_exp.begin(), int_exp.end());
+    OpenSwath::normalize(int_exp, intExptotal, int_exp);
+    dotprod = OpenSwath::dotProd(int_exp.begin(), int_exp.end(), theo_int_normed.begin());
   }
 
   void DiaPrescore::updateMembers_()
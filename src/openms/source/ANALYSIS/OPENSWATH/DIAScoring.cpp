@@ -73,7 +73,11 @@ namespace OpenMS
   }
 
   DIAScoring::DIAScoring() :
-    DefaultParamHandler("DIAScoring")
+    DefaultParamHandler("DIAScoring"),
+    prescore_(nullptr),
+    by_charge_(0),
+    ms1_pattern_mz_(-1.0),
+    ms1_pattern_charge_(0)
   {
 
     defaults_.setValue("dia_extraction_window", 0.05, "DIA extraction window in Th or ppm.");
@@ -118,6 +122,7 @@ namespace OpenMS
   DIAScoring::~DIAScoring() 
   {
     delete generator;
+    delete prescore_;
   }
 
   void DIAScoring::updateMembers_()
@@ -131,6 +136,14 @@ namespace OpenMS
     dia_nr_isotopes_ = (int)param_.getValue("dia_nr_isotopes");
     dia_nr_charges_ = (int)param_.getValue("dia_nr_charges");
     peak_before_mono_max_ppm_diff_ = (double)param_.getValue("peak_before_mono_max_ppm_diff");
+
+    delete prescore_;
+    prescore_ = new DiaPrescore(dia_extract_window_, dia_nr_isotopes_, dia_nr_charges_);
+
+    // theoretical values depend on the parameters
+    assay_ = AssayTables_();
+    by_charge_ = 0;
+    ms1_pattern_mz_ = -1.0;
   }
 
   ///////////////////////////////////////////////////////////////////////////
@@ -141,10 +154,9 @@ namespace OpenMS
   {
     isotope_corr = 0;
     isotope_overlap = 0;
-    // first compute a map of relative intensities from the feature, then compute the score
-    std::map<std::string, double> intensities;
-    getFirstIsotopeRelativeIntensities_(transitions, mrmfeature, intensities);
-    diaIsotopeScoresSub_(transitions, spectrum, intensities, isotope_corr, isotope_overlap);
+    // first compute the relative intensities from the feature, then compute the score
+    getFirstIsotopeRelativeIntensities_(transitions, mrmfeature, rel_intensities_);
+    diaIsotopeScoresSub_(transitions, spectrum, rel_intensities_, isotope_corr, isotope_overlap);
   }
 
   void DIAScoring::dia_massdiff_score(const std::vector<TransitionType>& transitions, SpectrumPtrType spectrum,
@@ -211,7 +223,7 @@ namespace OpenMS
     // collect the potential isotopes of this peak
     double max_ratio;
     int nr_occurences;
-    std::vector<double> isotopes_int;
+    isotopes_int_.clear();
     for (int iso = 0; iso <= dia_nr_isotopes_; ++iso)
     {
       double left  = precursor_mz + iso * C13C12_MASSDIFF_U / static_cast<double>(charge_state);
@@ -219,13 +231,22 @@ namespace OpenMS
       adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
       double mz, intensity;
       integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
-      isotopes_int.push_back(intensity);
+      isotopes_int_.push_back(intensity);
+    }
+
+    // the theoretical pattern is the same for all peak groups of this precursor
+    if (precursor_mz != ms1_pattern_mz_ || charge_state != ms1_pattern_charge_ || sum_formula != ms1_pattern_formula_)
+    {
+      getTheoreticalIsotopePattern_(precursor_mz, charge_state, sum_formula, ms1_pattern_);
+      ms1_pattern_mz_ = precursor_mz;
+      ms1_pattern_charge_ = charge_state;
+      ms1_pattern_formula_ = sum_formula;
     }
 
     // calculate the scores:
     // isotope correlation (forward) and the isotope overlap (backward) scores
-    isotope_corr = scoreIsotopePattern_(precursor_mz, isotopes_int, charge_state, sum_formula);
-    largePeaksBeforeFirstIsotope_(spectrum, precursor_mz, isotopes_int[0], nr_occurences, max_ratio);
+    isotope_corr = scoreIsotopePattern_(isotopes_int_, ms1_pattern_);
+    largePeaksBeforeFirstIsotope_(spectrum, precursor_mz, isotopes_int_[0], nr_occurences, max_ratio);
     isotope_overlap = max_ratio;
   }
 
@@ -238,8 +259,17 @@ namespace OpenMS
     OPENMS_PRECONDITION(charge > 0, "Charge is a positive integer"); // for peptides, charge should be positive
 
     double mz, intensity, left, right;
-    std::vector<double> yseries, bseries;
-    OpenMS::DIAHelpers::getBYSeries(sequence, bseries, yseries, generator, charge);
+    // the b/y series is the same for all peak groups of this peptide
+    if (charge != by_charge_ || !(sequence == by_sequence_))
+    {
+      bseries_.clear();
+      yseries_.clear();
+      OpenMS::DIAHelpers::getBYSeries(sequence, bseries_, yseries_, generator, charge);
+      by_sequence_ = sequence;
+      by_charge_ = charge;
+    }
+    const std::vector<double>& bseries = bseries_;
+    const std::vector<double>& yseries = yseries_;
     for (Size it = 0; it < bseries.size(); it++)
     {
       left = bseries[it];
@@ -271,8 +301,8 @@ namespace OpenMS
   void DIAScoring::score_with_isotopes(SpectrumPtrType spectrum, const std::vector<TransitionType>& transitions,
                                        double& dotprod, double& manhattan)
   {
-    OpenMS::DiaPrescore dp(dia_extract_window_, dia_nr_isotopes_, dia_nr_charges_);
-    dp.score(spectrum, transitions, dotprod, manhattan);
+    prepareAssay_(transitions);
+    prescore_->score(spectrum, assay_.theo_mz, assay_.theo_int, assay_.theo_int_normed, int_exp_, mz_exp_, dotprod, manhattan);
   }
 
   ///////////////////////////////////////////////////////////////////////////
@@ -281,28 +311,60 @@ namespace OpenMS
   /// computes a vector of relative intensities for each feature (output to intensities)
   void DIAScoring::getFirstIsotopeRelativeIntensities_(
     const std::vector<TransitionType>& transitions,
-    OpenSwath::IMRMFeature* mrmfeature, std::map<std::string, double>& intensities)
+    OpenSwath::IMRMFeature* mrmfeature, std::vector<double>& intensities)
+  {
+    intensities.resize(transitions.size());
+    for (Size k = 0; k < transitions.size(); k++)
+    {
+      intensities[k] = mrmfeature->getFeature(transitions[k].getNativeID())->getIntensity() / mrmfeature->getIntensity();
+    }
+  }
+
+  void DIAScoring::prepareAssay_(const std::vector<TransitionType>& transitions)
   {
+    // nothing to do if the tables were computed for the same transitions
+    bool same_assay = (assay_.product_mz.size() == transitions.size());
+    for (Size k = 0; same_assay && k < transitions.size(); k++)
+    {
+      same_assay = assay_.product_mz[k] == transitions[k].getProductMZ() &&
+                   assay_.fragment_charge[k] == transitions[k].fragment_charge &&
+                   assay_.library_intensity[k] == transitions[k].getLibraryIntensity();
+    }
+    if (same_assay && !transitions.empty()) return;
+
+    assay_.product_mz.resize(transitions.size());
+    assay_.fragment_charge.resize(transitions.size());
+    assay_.library_intensity.resize(transitions.size());
+    assay_.isotope_patterns.resize(transitions.size());
     for (Size k = 0; k < transitions.size(); k++)
     {
-      std::string native_id = transitions[k].getNativeID();
-      double rel_intensity = mrmfeature->getFeature(native_id)->getIntensity() / mrmfeature->getIntensity();
-      intensities.insert(std::pair<std::string, double>(native_id, rel_intensity));
+      assay_.product_mz[k] = transitions[k].getProductMZ();
+      assay_.fragment_charge[k] = transitions[k].fragment_charge;
+      assay_.library_intensity[k] = transitions[k].getLibraryIntensity();
+
+      // If no charge is given, we assume it to be 1
+      int putative_fragment_charge = 1;
+      if (transitions[k].fragment_charge > 0)
+      {
+        putative_fragment_charge = transitions[k].fragment_charge;
+      }
+      getTheoreticalIsotopePattern_(transitions[k].getProductMZ(), putative_fragment_charge, "", assay_.isotope_patterns[k]);
     }
+    prescore_->getTheoreticalSpectrum(transitions, assay_.theo_mz, assay_.theo_int, assay_.theo_int_normed);
   }
 
   void DIAScoring::diaIsotopeScoresSub_(const std::vector<TransitionType>& transitions, SpectrumPtrType spectrum,
-                                          std::map<std::string, double>& intensities, //relative intensities
+                                          const std::vector<double>& intensities, //relative intensities
                                           double& isotope_corr, double& isotope_overlap)
   {
-    std::vector<double> isotopes_int;
+    prepareAssay_(transitions);
+
     double max_ratio;
     int nr_occurences;
     for (Size k = 0; k < transitions.size(); k++)
     {
-      isotopes_int.clear();
-      String native_id = transitions[k].getNativeID();
-      double rel_intensity = intensities[native_id];
+      isotopes_int_.clear();
+      double rel_intensity = intensities[k];
 
       // If no charge is given, we assume it to be 1
       int putative_fragment_charge = 1;
@@ -321,14 +383,14 @@ namespace OpenMS
         adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
         double mz, intensity;
         integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
-        isotopes_int.push_back(intensity);
+        isotopes_int_.push_back(intensity);
       }
 
       // calculate the scores:
       // isotope correlation (forward) and the isotope overlap (backward) scores
-      double score = scoreIsotopePattern_(transitions[k].getProductMZ(), isotopes_int, putative_fragment_charge);
+      double score = scoreIsotopePattern_(isotopes_int_, assay_.isotope_patterns[k]);
       isotope_corr += score * rel_intensity;
-      largePeaksBeforeFirstIsotope_(spectrum, transitions[k].getProductMZ(), isotopes_int[0], nr_occurences, max_ratio);
+      largePeaksBeforeFirstIsotope_(spectrum, transitions[k].getProductMZ(), isotopes_int_[0], nr_occurences, max_ratio);
       isotope_overlap += nr_occurences * rel_intensity;
     }
   }
@@ -379,11 +441,28 @@ namespace OpenMS
                                           const std::vector<double>& isotopes_int, int putative_fragment_charge,
                                           std::string sum_formula)
   {
-    OPENMS_PRECONDITION(putative_fragment_charge != 0, "Charge needs to be set"); // charge can be positive and negative
+    std::vector<double> pattern;
+    getTheoreticalIsotopePattern_(product_mz, putative_fragment_charge, sum_formula, pattern);
+    return scoreIsotopePattern_(isotopes_int, pattern);
+  }
 
-    typedef OpenMS::FeatureFinderAlgorithmPickedHelperStructs::TheoreticalIsotopePattern TheoreticalIsotopePattern;
+  double DIAScoring::scoreIsotopePattern_(const std::vector<double>& isotopes_int,
+                                          const std::vector<double>& theoretical_pattern) const
+  {
+    // score the pattern against a theoretical one
+    double int_score = OpenSwath::cor_pearson(isotopes_int.begin(), isotopes_int.end(), theoretical_pattern.begin());
+    if (boost::math::isnan(int_score))
+    {
+      int_score = 0;
+    }
+    return int_score;
+  }
+
+  void DIAScoring::getTheoreticalIsotopePattern_(double product_mz, int putative_fragment_charge,
+                                                 const std::string& sum_formula, std::vector<double>& pattern) const
+  {
+    OPENMS_PRECONDITION(putative_fragment_charge != 0, "Charge needs to be set"); // charge can be positive and negative
 
-    TheoreticalIsotopePattern isotopes;
     IsotopeDistribution isotope_dist;
     if (!sum_formula.empty())
     {
@@ -398,38 +477,25 @@ namespace OpenMS
       isotope_dist.estimateFromPeptideWeight(std::fabs(product_mz * putative_fragment_charge));
     }
 
-
+    pattern.clear();
     for (IsotopeDistribution::Iterator it = isotope_dist.begin(); it != isotope_dist.end(); ++it)
     {
-      isotopes.intensity.push_back(it->second);
+      pattern.push_back(it->second);
     }
-    isotopes.optional_begin = 0;
-    isotopes.optional_end = dia_nr_isotopes_;
 
     // scale the distribution to a maximum of 1
     double max = 0.0;
-    for (Size i = 0; i < isotopes.intensity.size(); ++i)
+    for (Size i = 0; i < pattern.size(); ++i)
     {
-      if (isotopes.intensity[i] > max)
+      if (pattern[i] > max)
       {
-        max = isotopes.intensity[i];
+        max = pattern[i];
       }
     }
-    isotopes.max = max;
-    for (Size i = 0; i < isotopes.intensity.size(); ++i)
+    for (Size i = 0; i < pattern.size(); ++i)
     {
-      isotopes.intensity[i] /= max;
+      pattern[i] /= max;
     }
-    isotopes.trimmed_left = 0;
-
-    // score the pattern against a theoretical one
-    double int_score = OpenSwath::cor_pearson(isotopes_int.begin(), isotopes_int.end(), isotopes.intensity.begin());
-    if (boost::math::isnan(int_score))
-    {
-      int_score = 0;
-    }
-    return int_score;
-
-  } //end of dia_isotope_corr_sub
+  }
 
 }
@@ -74,7 +74,7 @@ namespace OpenMS
 
   void OpenSwathScoring::calculateDIAScores(OpenSwath::IMRMFeature* imrmfeature,
                                             const std::vector<TransitionType> & transitions,
-                                            std::vector<OpenSwath::SwathMap> swath_maps,
+                                            const std::vector<OpenSwath::SwathMap>& swath_maps,
                                             OpenSwath::SpectrumAccessPtr ms1_map,
                                             OpenMS::DIAScoring & diascoring,
                                             const CompoundType& compound,
@@ -185,7 +185,7 @@ namespace OpenMS
 
   void OpenSwathScoring::calculateDIAIdScores(OpenSwath::IMRMFeature* imrmfeature,
                                               const TransitionType & transition,
-                                              std::vector<OpenSwath::SwathMap> swath_maps,
+                                              const std::vector<OpenSwath::SwathMap>& swath_maps,
                                               OpenMS::DIAScoring & diascoring,
                                               OpenSwath_Scores & scores)
   {
@@ -356,7 +356,7 @@ namespace OpenMS
     OpenSwath::Scoring::normalize_sum(&normalized_library_intensity[0], boost::numeric_cast<int>(normalized_library_intensity.size()));
   }
 
-  OpenSwath::SpectrumPtr OpenSwathScoring::getAddedSpectra_(std::vector<OpenSwath::SwathMap> swath_maps,
+  OpenSwath::SpectrumPtr OpenSwathScoring::getAddedSpectra_(const std::vector<OpenSwath::SwathMap>& swath_maps,
                                                             double RT, int nr_spectra_to_add)
   {
     if (swath_maps.size() == 1)
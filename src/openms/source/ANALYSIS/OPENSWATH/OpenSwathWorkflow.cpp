@@ -907,10 +907,18 @@ namespace OpenMS
       // Use an rt extraction window of 0.0 which will just write the retention time in start / end positions
       // Then correct the start/end positions and add the extra_rt_extract parameter
       prepare_coordinates_sub(chrom_list, coordinates, transition_exp_used, 0.0, ms1);
-      for (std::vector< ChromatogramExtractor::ExtractionCoordinates >::iterator it = coordinates.begin(); it != coordinates.end(); ++it)
+      // transform all start/end positions in one go
+      std::vector<double> rts(2 * coordinates.size());
+      for (Size i = 0; i < coordinates.size(); ++i)
       {
-        it->rt_start = trafo_inverse.apply(it->rt_start) - (cp.rt_extraction_window + cp.extra_rt_extract)/ 2.0;
-        it->rt_end = trafo_inverse.apply(it->rt_end) + (cp.rt_extraction_window + cp.extra_rt_extract)/ 2.0;
+        rts[2 * i] = coordinates[i].rt_start;
+        rts[2 * i + 1] = coordinates[i].rt_end;
+      }
+      trafo_inverse.apply(rts);
+      for (Size i = 0; i < coordinates.size(); ++i)
+      {
+        coordinates[i].rt_start = rts[2 * i] - (cp.rt_extraction_window + cp.extra_rt_extract)/ 2.0;
+        coordinates[i].rt_end = rts[2 * i + 1] + (cp.rt_extraction_window + cp.extra_rt_extract)/ 2.0;
       }
     }
   }
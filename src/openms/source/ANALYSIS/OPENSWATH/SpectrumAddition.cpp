@@ -41,7 +41,7 @@
 namespace OpenMS
 {
 
-  OpenSwath::SpectrumPtr SpectrumAddition::addUpSpectra(std::vector<OpenSwath::SpectrumPtr> all_spectra,
+  OpenSwath::SpectrumPtr SpectrumAddition::addUpSpectra(const std::vector<OpenSwath::SpectrumPtr>& all_spectra,
       double sampling_rate, bool filter_zeros)
   {
     if (all_spectra.size() == 1) return all_spectra[0];
@@ -106,26 +106,28 @@ namespace OpenMS
       );
     }
 
-    if (!filter_zeros)
+    if (filter_zeros)
     {
-      return resampled_peak_container;
-    }
-    else
-    {
-      OpenSwath::SpectrumPtr master_spectrum_filtered(new OpenSwath::Spectrum);
-      for (Size i = 0; i < resampled_peak_container->getIntensityArray()->data.size(); ++i)
+      // remove the empty positions in place (no second spectrum needed)
+      std::vector<double>& mz_data = resampled_peak_container->getMZArray()->data;
+      std::vector<double>& int_data = resampled_peak_container->getIntensityArray()->data;
+      Size kept = 0;
+      for (Size i = 0; i < int_data.size(); ++i)
       {
-        if (resampled_peak_container->getIntensityArray()->data[i] > 0)
+        if (int_data[i] > 0)
         {
-          master_spectrum_filtered->getIntensityArray()->data.push_back(resampled_peak_container->getIntensityArray()->data[i]);
-          master_spectrum_filtered->getMZArray()->data.push_back(resampled_peak_container->getMZArray()->data[i]);
+          mz_data[kept] = mz_data[i];
+          int_data[kept] = int_data[i];
+          ++kept;
         }
       }
-      return master_spectrum_filtered;
+      mz_data.resize(kept);
+      int_data.resize(kept);
     }
+    return resampled_peak_container;
   }
 
-  OpenMS::MSSpectrum SpectrumAddition::addUpSpectra(std::vector<OpenMS::MSSpectrum> all_spectra, double sampling_rate, bool filter_zeros)
+  OpenMS::MSSpectrum SpectrumAddition::addUpSpectra(const std::vector<OpenMS::MSSpectrum>& all_spectra, double sampling_rate, bool filter_zeros)
   {
     if (all_spectra.size() == 1) return all_spectra[0];
     if (all_spectra.empty()) return MSSpectrum();
@@ -176,39 +178,27 @@ namespace OpenMS
       ++it;
     }
 
-    // resample all spectra and add to master spectrum
+    // resample all spectra and add to master spectrum (raster adds to the intensities already present)
     LinearResamplerAlign lresampler;
-    MSSpectrum master_spectrum = resampled_peak_container;
     for (Size curr_sp = 0; curr_sp < all_spectra.size(); curr_sp++)
     {
-      MSSpectrum input_spectrum;
-      MSSpectrum output_spectrum = resampled_peak_container;
-
-      lresampler.raster(all_spectra[curr_sp].begin(), all_spectra[curr_sp].end(), output_spectrum.begin(), output_spectrum.end());
-
-      // add to master spectrum
-      for (Size i = 0; i < output_spectrum.size(); ++i)
-      {
-        master_spectrum[i].setIntensity(master_spectrum[i].getIntensity() + output_spectrum[i].getIntensity());
-      }
+      lresampler.raster(all_spectra[curr_sp].begin(), all_spectra[curr_sp].end(), resampled_peak_container.begin(), resampled_peak_container.end());
     }
 
-    if (!filter_zeros)
-    {
-      return master_spectrum;
-    }
-    else
+    if (filter_zeros)
     {
-      MSSpectrum master_spectrum_filtered;
-      for (Size i = 0; i < master_spectrum.size(); ++i)
+      // remove the empty positions in place
+      Size kept = 0;
+      for (Size i = 0; i < resampled_peak_container.size(); ++i)
       {
-        if (master_spectrum[i].getIntensity() > 0)
+        if (resampled_peak_container[i].getIntensity() > 0)
         {
-          master_spectrum_filtered.push_back(master_spectrum[i]);
+          resampled_peak_container[kept++] = resampled_peak_container[i];
         }
       }
-      return master_spectrum_filtered;
+      resampled_peak_container.resize(kept);
     }
+    return resampled_peak_container;
   }
 
 }
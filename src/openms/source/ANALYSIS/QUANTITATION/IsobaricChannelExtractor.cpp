@@ -43,6 +43,10 @@
 #include <OpenMS/KERNEL/ConsensusMap.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
+#include <algorithm>
+#include <exception>
+#include <limits>
+
 // #define ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
 // #undef ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
 
@@ -54,59 +58,30 @@ namespace OpenMS
   // Also used for TMT_11PLEX
   double TMT_10AND11PLEX_CHANNEL_TOLERANCE = 0.003;
 
-  /// small quality control class, holding temporary data for reporting
-  struct ChannelQC
-  {
-    // C'tor
-    ChannelQC() :
-      mz_deltas(),
-      signal_not_unique(0)
-    {}
-
-    std::vector<double> mz_deltas; ///< m/z distance between expected and observed reporter ion closest to expected position
-    int signal_not_unique;  ///< counts if more than one peak was found within the search window of each reporter position
-  };
-
+  // Half width of the window around each reporter ion in which the closest peak is searched (for QC).
+  // This also limits the part of a quantitation scan which needs to be kept for extraction.
+  const double QC_DIST_MZ = 0.5; // fixed! Do not change!
 
-  IsobaricChannelExtractor::PuritySate_::PuritySate_(const PeakMap& targetExp) :
-    baseExperiment(targetExp)
+  /// deleter for non-owning shared pointers (e.g., to spectra of an experiment which outlives the extraction)
+  struct NullDeleter_
   {
-    // initialize precursorScan with end(), it will be updated later on
-    // from the calling method
-    precursorScan = baseExperiment.end();
-
-    // find the first ms1 scan in the experiment
-    followUpScan = baseExperiment.begin();
-    while (followUpScan != baseExperiment.end() && followUpScan->getMSLevel() != 1)
-    {
-      ++followUpScan;
-    }
-
-    // check if we found one
-    hasFollowUpScan = followUpScan != baseExperiment.end();
-  }
-
-
-  void IsobaricChannelExtractor::PuritySate_::advanceFollowUp(const double rt)
-  {
-    // advance follow up scan until we found a ms1 scan with a bigger RT
-    if (followUpScan != baseExperiment.end()) ++followUpScan;
-    while (followUpScan != baseExperiment.end())
-    {
-      if (followUpScan->getMSLevel() == 1 && followUpScan->getRT() > rt)
-      {
-        break;
-      }
-      ++followUpScan;
-    }
-
-    // check if we found one
-    hasFollowUpScan = followUpScan != baseExperiment.end();
-  }
+    void operator()(const void*) const {}
+  };
 
-  bool IsobaricChannelExtractor::PuritySate_::followUpValid(const double rt)
+  IsobaricChannelExtractor::ExtractionJob_::ExtractionJob_() :
+    spectrum(),
+    precursor_scan(),
+    follow_up_scan(),
+    has_ms2(false),
+    ms2_rt(0.0),
+    ms2_mz(0.0),
+    purity(-1.0),
+    low_purity(false),
+    intensities(),
+    mz_deltas(),
+    found(),
+    not_unique()
   {
-    return hasFollowUpScan ? rt < followUpScan->getRT() : true;
   }
 
   IsobaricChannelExtractor::IsobaricChannelExtractor(const IsobaricQuantitationMethod* const quant_method) :
@@ -241,28 +216,30 @@ namespace OpenMS
     return false;
   }
 
-  double IsobaricChannelExtractor::computeSingleScanPrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const
+  double IsobaricChannelExtractor::computeSingleScanPrecursorPurity_(const MSSpectrum& ms2_spec, const MSSpectrum& precursor_spec) const
   {
 
     typedef PeakMap::SpectrumType::ConstIterator const_spec_iterator;
 
+    const Precursor& precursor = ms2_spec.getPrecursors()[0];
+
     // compute distance between isotopic peaks based on the precursor charge.
-    const double charge_dist = Constants::NEUTRON_MASS_U / static_cast<double>(ms2_spec->getPrecursors()[0].getCharge());
+    const double charge_dist = Constants::NEUTRON_MASS_U / static_cast<double>(precursor.getCharge());
 
     // the actual boundary values
-    const double strict_lower_mz = ms2_spec->getPrecursors()[0].getMZ() - ms2_spec->getPrecursors()[0].getIsolationWindowLowerOffset();
-    const double strict_upper_mz = ms2_spec->getPrecursors()[0].getMZ() + ms2_spec->getPrecursors()[0].getIsolationWindowUpperOffset();
+    const double strict_lower_mz = precursor.getMZ() - precursor.getIsolationWindowLowerOffset();
+    const double strict_upper_mz = precursor.getMZ() + precursor.getIsolationWindowUpperOffset();
 
     const double fuzzy_lower_mz = strict_lower_mz - (strict_lower_mz * max_precursor_isotope_deviation_ / 1000000);
     const double fuzzy_upper_mz = strict_upper_mz + (strict_upper_mz * max_precursor_isotope_deviation_ / 1000000);
 
     // first find the actual precursor peak
-    Size precursor_peak_idx = precursor_spec.findNearest(ms2_spec->getPrecursors()[0].getMZ());
+    Size precursor_peak_idx = precursor_spec.findNearest(precursor.getMZ());
     const Peak1D& precursor_peak = precursor_spec[precursor_peak_idx];
 
     // now we get ourselves some border iterators
     const_spec_iterator lower_bound = precursor_spec.MZBegin(fuzzy_lower_mz);
-    const_spec_iterator upper_bound = precursor_spec.MZEnd(ms2_spec->getPrecursors()[0].getMZ());
+    const_spec_iterator upper_bound = precursor_spec.MZEnd(precursor.getMZ());
 
     Peak1D::IntensityType precursor_intensity = precursor_peak.getIntensity();
     Peak1D::IntensityType total_intensity = precursor_peak.getIntensity();
@@ -325,7 +302,7 @@ namespace OpenMS
     // try to find a match for our isotopic peak on the right
 
     // redefine bounds
-    lower_bound = precursor_spec.MZBegin(ms2_spec->getPrecursors()[0].getMZ());
+    lower_bound = precursor_spec.MZBegin(precursor.getMZ());
     upper_bound = precursor_spec.MZEnd(fuzzy_upper_mz);
 
     expected_next_mz = precursor_peak.getMZ() + charge_dist;
@@ -416,32 +393,32 @@ namespace OpenMS
     return precursor_intensity / total_intensity;
   }
 
-  double IsobaricChannelExtractor::computePrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PuritySate_& pState) const
+  double IsobaricChannelExtractor::computePrecursorPurity_(const MSSpectrum& ms2_spec, const MSSpectrum& precursor_spec, const MSSpectrum* follow_up_spec) const
   {
     // we cannot analyze precursors without a charge
-    if (ms2_spec->getPrecursors()[0].getCharge() == 0)
+    if (ms2_spec.getPrecursors()[0].getCharge() == 0)
     {
       return 1.0;
     }
     else
     {
 #ifdef ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
-      std::cerr << "------------------ analyzing " << ms2_spec->getNativeID() << std::endl;
+      std::cerr << "------------------ analyzing " << ms2_spec.getNativeID() << std::endl;
 #endif
 
       // compute purity of preceding ms1 scan
-      double early_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *(pState.precursorScan));
+      double early_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, precursor_spec);
 
-      if (pState.hasFollowUpScan && interpolate_precursor_purity_)
+      if (follow_up_spec != 0 && interpolate_precursor_purity_)
       {
-        double late_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *(pState.followUpScan));
+        double late_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *follow_up_spec);
 
         // calculating the extrapolated, S2I value as a time weighted linear combination of the two scans
         // see: Savitski MM, Sweetman G, Askenazi M, Marto JA, Lang M, Zinn N, et al. (2011).
         // Analytical chemistry 83: 8959–67. http://www.ncbi.nlm.nih.gov/pubmed/22017476
         // std::fabs is applied to compensate for potentially negative RTs
-        return std::fabs(ms2_spec->getRT() - pState.precursorScan->getRT()) *
-               ((late_scan_purity - early_scan_purity) / std::fabs(pState.followUpScan->getRT() - pState.precursorScan->getRT()))
+        return std::fabs(ms2_spec.getRT() - precursor_spec.getRT()) *
+               ((late_scan_purity - early_scan_purity) / std::fabs(follow_up_spec->getRT() - precursor_spec.getRT()))
                + early_scan_purity;
       }
       else
@@ -451,6 +428,75 @@ namespace OpenMS
     }
   }
 
+  void IsobaricChannelExtractor::processJob_(ExtractionJob_& job) const
+  {
+    const MSSpectrum& spec = *job.spectrum;
+
+    // check precursor purity if we have a valid precursor (empty MS1 scans contain no precursor peak) ..
+    if (job.precursor_scan && !job.precursor_scan->empty())
+    {
+      const MSSpectrum* follow_up_scan = (job.follow_up_scan && !job.follow_up_scan->empty()) ? job.follow_up_scan.get() : nullptr;
+      job.purity = computePrecursorPurity_(spec, *job.precursor_scan, follow_up_scan);
+      // check if purity is high enough
+      if (job.purity < min_precursor_purity_)
+      {
+        job.low_purity = true;
+        return;
+      }
+    }
+
+    const IsobaricQuantitationMethod::IsobaricChannelList& channels = quant_method_->getChannelInformation();
+    job.intensities.assign(channels.size(), 0);
+    job.mz_deltas.assign(channels.size(), 0.0);
+    job.found.assign(channels.size(), 0);
+    job.not_unique.assign(channels.size(), 0);
+
+    for (Size ch = 0; ch < channels.size(); ++ch)
+    {
+      const double center = channels[ch].center;
+
+      // as every evaluation requires time, we cache the MZEnd iterator
+      const MSSpectrum::ConstIterator mz_end = spec.MZEnd(center + QC_DIST_MZ);
+
+      // search for the non-zero signal closest to theoretical position
+      // & check for closest signal within reasonable distance (0.5 Da) -- might find neighbouring TMT channel, but that should not confuse anyone
+      int peak_count(0); // count peaks in user window -- should be only one, otherwise Window is too large
+      MSSpectrum::ConstIterator idx_nearest(mz_end);
+      for (MSSpectrum::ConstIterator mz_it = spec.MZBegin(center - QC_DIST_MZ);
+           mz_it != mz_end;
+           ++mz_it)
+      {
+        if (mz_it->getIntensity() == 0) continue; // ignore 0-intensity shoulder peaks -- could be detrimental when de-calibrated
+        double dist_mz = fabs(mz_it->getMZ() - center);
+        if (dist_mz < reporter_mass_shift_) ++peak_count;
+        if (idx_nearest == mz_end // first peak
+            || ((dist_mz < fabs(idx_nearest->getMZ() - center)))) // closer to best candidate
+        {
+          idx_nearest = mz_it;
+        }
+      }
+      if (idx_nearest != mz_end)
+      {
+        double mz_delta = center - idx_nearest->getMZ();
+        // stats: we don't care what shift the user specified
+        job.found[ch] = 1;
+        job.mz_deltas[ch] = mz_delta;
+        job.not_unique[ch] = (peak_count > 1);
+        // pass user threshold
+        if (std::fabs(mz_delta) < reporter_mass_shift_)
+        {
+          job.intensities[ch] = idx_nearest->getIntensity();
+        }
+      }
+
+      // discard contribution of this channel as it is below the required intensity threshold
+      if (job.intensities[ch] < min_reporter_intensity_)
+      {
+        job.intensities[ch] = 0;
+      }
+    }
+  }
+
   void IsobaricChannelExtractor::extractChannels(const PeakMap& ms_exp_data, ConsensusMap& consensus_map)
   {
     if (ms_exp_data.empty())
@@ -506,205 +552,43 @@ namespace OpenMS
     UInt quant_ms_level = ms_level.rbegin()->first;
     LOG_INFO << "Using MS-level " << quant_ms_level << " for quantification." << std::endl;
 
-    // now we have picked data
-    // --> assign peaks to channels
-    UInt64 element_index(0);
-
-    // remember the current precursor spectrum
-    PuritySate_ pState(ms_exp_data);
-
-    typedef std::map<String, ChannelQC > ChannelQCSet;
-    ChannelQCSet channel_mz_delta;
-    const double qc_dist_mz = 0.5; // fixed! Do not change!
-
-    Size number_of_channels = quant_method_->getNumberOfChannels();
-
-    PeakMap::ConstIterator it_last_MS2 = ms_exp_data.end(); // remember last MS2 spec, to get precursor in MS1 (also if quant is in MS3)
-
+    // feed the spectra to the streaming extraction; the experiment outlives the consumer, so spectra are referenced, not copied
+    IsobaricChannelExtractionConsumer consumer(*this, consensus_map, quant_ms_level);
     for (PeakMap::ConstIterator it = ms_exp_data.begin(); it != ms_exp_data.end(); ++it)
     {
-      // remember the last MS1 spectra as we assume it to be the precursor spectrum
-      if (it->getMSLevel() ==  1)
-      {
-        // remember potential precursor and continue
-        pState.precursorScan = it;
-        // reset last MS2 -- we expect to see a new one soon and the old one should not be used for the following MS3 (if any)
-        it_last_MS2 = ms_exp_data.end();
-        continue;
-      }
-      else if (it->getMSLevel() == 2)
-      { // remember last MS2 spec, to get precursor in MS1 (also if quant is in MS3)
-        it_last_MS2 = it;
-        if (it_last_MS2->getPrecursors().empty())
-        {
-          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No precursor information given for scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT()));
-        }
-      }
-      if (it->getMSLevel() != quant_ms_level) continue;
-      if ((*it).empty()) continue; // skip empty spectra
-      if (!(selected_activation_ == "" || isValidActivation(*it))) continue;
-
-      // find following ms1 scan (needed for purity computation)
-      if (!pState.followUpValid(it->getRT()))
-      {
-        // advance iterator
-        pState.advanceFollowUp(it->getRT());
-      }
-
-      // check if precursor is available
-      if (it->getPrecursors().empty())
-      {
-        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No precursor information given for scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT()));
-      }
-
-      // check precursor constraints
-      if (!isValidPrecursor_(it->getPrecursors()[0]))
-      {
-        LOG_DEBUG << "Skip spectrum " << it->getNativeID() << ": Precursor doesn't fulfill all constraints." << std::endl;
-        continue;
-      }
-
-      // check precursor purity if we have a valid precursor ..
-      double precursor_purity = -1.0;
-      if (pState.precursorScan != ms_exp_data.end())
-      {
-        precursor_purity = computePrecursorPurity_(it, pState);
-        // check if purity is high enough
-        if (precursor_purity < min_precursor_purity_)
-        {
-          LOG_DEBUG << "Skip spectrum " << it->getNativeID() << ": Precursor purity is below the threshold. [purity = " << precursor_purity << "]" << std::endl;
-          continue;
-        }
-      }
-      else
-      {
-        LOG_INFO << "No precursor available for spectrum: " << it->getNativeID() << std::endl;
-      }
-
-      // store RT&MZ of MS1 parent ion as centroid of ConsensusFeature
-      if (it_last_MS2 == ms_exp_data.end())
-      { // this only happens if an MS3 spec does not have a preceeding MS2
-        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No MS2 precursor information given for MS3 scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT()));
-      }
-      ConsensusFeature cf;
-      cf.setUniqueId();
-      cf.setRT(it_last_MS2->getRT());
-      cf.setMZ(it_last_MS2->getPrecursors()[0].getMZ());
-
-      Peak2D channel_value;
-      channel_value.setRT(it->getRT());
-      // for each each channel
-      UInt64 map_index = 0;
-      Peak2D::IntensityType overall_intensity = 0;
-
-      for (IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = quant_method_->getChannelInformation().begin();
-            cl_it != quant_method_->getChannelInformation().end();
-            ++cl_it)
-      {
-        // set mz-position of channel
-        channel_value.setMZ(cl_it->center);
-        // reset intensity
-        channel_value.setIntensity(0);
-
-        // as every evaluation requires time, we cache the MZEnd iterator
-        const PeakMap::SpectrumType::ConstIterator mz_end = it->MZEnd(cl_it->center + qc_dist_mz);
-
-        // search for the non-zero signal closest to theoretical position
-        // & check for closest signal within reasonable distance (0.5 Da) -- might find neighbouring TMT channel, but that should not confuse anyone
-        int peak_count(0); // count peaks in user window -- should be only one, otherwise Window is too large
-        PeakMap::SpectrumType::ConstIterator idx_nearest(mz_end);
-        for (PeakMap::SpectrumType::ConstIterator mz_it = it->MZBegin(cl_it->center - qc_dist_mz);
-              mz_it != mz_end;
-              ++mz_it)
-        {
-          if (mz_it->getIntensity() == 0) continue; // ignore 0-intensity shoulder peaks -- could be detrimental when de-calibrated
-          double dist_mz = fabs(mz_it->getMZ() - cl_it->center);
-          if (dist_mz < reporter_mass_shift_) ++peak_count;
-          if (idx_nearest == mz_end // first peak
-              || ((dist_mz < fabs(idx_nearest->getMZ() - cl_it->center)))) // closer to best candidate
-          {
-            idx_nearest = mz_it;
-          }
-        }
-        if (idx_nearest != mz_end)
-        {
-          double mz_delta = cl_it->center - idx_nearest->getMZ();
-          // stats: we don't care what shift the user specified
-          channel_mz_delta[cl_it->name].mz_deltas.push_back(mz_delta);
-          if (peak_count > 1) ++channel_mz_delta[cl_it->name].signal_not_unique;
-          // pass user threshold
-          if (std::fabs(mz_delta) < reporter_mass_shift_)
-          {
-            channel_value.setIntensity(idx_nearest->getIntensity());
-          }
-        }
-
-        // discard contribution of this channel as it is below the required intensity threshold
-        if (channel_value.getIntensity() < min_reporter_intensity_)
-        {
-          channel_value.setIntensity(0);
-        }
-
-        overall_intensity += channel_value.getIntensity();
-        // add channel to ConsensusFeature
-        cf.insert(map_index, channel_value, element_index);
-        ++map_index;
-      } // ! channel_iterator
-
-      // check if we keep this feature or if it contains low-intensity quantifications
-      if (remove_low_intensity_quantifications_ && hasLowIntensityReporter_(cf))
-      {
-        continue;
-      }
-
-      // check featureHandles are not empty
-      if (overall_intensity <= 0)
-      {
-        cf.setMetaValue("all_empty", String("true"));
-      }
-      // add purity information if we could compute it
-      if (precursor_purity > 0.0)
-      {
-        cf.setMetaValue("precursor_purity", precursor_purity);
-      }
-
-      // embed the id of the scan from which the quantitative information was extracted
-      cf.setMetaValue("scan_id", it->getNativeID());
-      // ...as well as additional meta information
-      cf.setMetaValue("precursor_intensity", it->getPrecursors()[0].getIntensity());
-
-      cf.setCharge(it->getPrecursors()[0].getCharge());
-      cf.setIntensity(overall_intensity);
-      consensus_map.push_back(cf);
+      consumer.consume_(*it, boost::shared_ptr<const MSSpectrum>(&(*it), NullDeleter_()));
+    }
+    consumer.finish();
+  }
 
-      // the tandem-scan in the order they appear in the experiment
-      ++element_index;
-    } // ! Experiment iterator
+  void IsobaricChannelExtractor::printChannelQC_(std::vector<std::vector<double> >& mz_deltas, const std::vector<int>& signal_not_unique) const
+  {
+    Size number_of_channels = quant_method_->getNumberOfChannels();
 
     // print stats about m/z calibration / presence of signal
-    LOG_INFO << "Calibration stats: Median distance of observed reporter ions m/z to expected position (up to " << qc_dist_mz << " Th):\n";
+    LOG_INFO << "Calibration stats: Median distance of observed reporter ions m/z to expected position (up to " << QC_DIST_MZ << " Th):\n";
     bool impurities_found(false);
-    for (IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = quant_method_->getChannelInformation().begin();
-      cl_it != quant_method_->getChannelInformation().end();
-      ++cl_it)
+    const IsobaricQuantitationMethod::IsobaricChannelList& channels = quant_method_->getChannelInformation();
+    for (Size ch = 0; ch < channels.size(); ++ch)
     {
-      LOG_INFO << "  ch " << String(cl_it->name).fillRight(' ', 4) << " (~" << String(cl_it->center).substr(0, 7).fillRight(' ', 7) << "): ";
-      if (channel_mz_delta.find(cl_it->name) != channel_mz_delta.end())
+      const IsobaricQuantitationMethod::IsobaricChannelInformation& channel = channels[ch];
+      LOG_INFO << "  ch " << String(channel.name).fillRight(' ', 4) << " (~" << String(channel.center).substr(0, 7).fillRight(' ', 7) << "): ";
+      if (!mz_deltas[ch].empty())
       {
         // sort
-        double median = Math::median(channel_mz_delta[cl_it->name].mz_deltas.begin(), channel_mz_delta[cl_it->name].mz_deltas.end(), false);
+        double median = Math::median(mz_deltas[ch].begin(), mz_deltas[ch].end(), false);
         if (((number_of_channels == 10) || (number_of_channels == 11)) &&
             (fabs(median) > TMT_10AND11PLEX_CHANNEL_TOLERANCE) &&
-            (int(cl_it->center) != 126 && int(cl_it->center) != 131)) // these two channels have ~1 Th spacing.. so they do not suffer from the tolerance problem
+            (int(channel.center) != 126 && int(channel.center) != 131)) // these two channels have ~1 Th spacing.. so they do not suffer from the tolerance problem
         { // the channel was most likely empty, and we picked up the neighbouring channel's data (~0.006 Th apart). So reporting median here is misleading.
           LOG_INFO << "<invalid data (>" << TMT_10AND11PLEX_CHANNEL_TOLERANCE << " Th channel tolerance)>\n";
         }
         else
         {
           LOG_INFO << median << " Th";
-          if (channel_mz_delta[cl_it->name].signal_not_unique > 0) 
+          if (signal_not_unique[ch] > 0)
           {
-            LOG_INFO << " [MSn impurity (within " << reporter_mass_shift_ << " Th): " << channel_mz_delta[cl_it->name].signal_not_unique << " windows|spectra]";
+            LOG_INFO << " [MSn impurity (within " << reporter_mass_shift_ << " Th): " << signal_not_unique[ch] << " windows|spectra]";
             impurities_found = true;
           }
           LOG_INFO << "\n";
@@ -715,16 +599,12 @@ namespace OpenMS
         LOG_INFO << "<no data>\n";
       }
     }
-    if (impurities_found) LOG_INFO << "\nImpurities within the allowed reporter mass shift " << reporter_mass_shift_ << " Th have been found." 
+    if (impurities_found) LOG_INFO << "\nImpurities within the allowed reporter mass shift " << reporter_mass_shift_ << " Th have been found."
                                    << "They can be ignored if the spectra are m/z calibrated (see above), since only the peak closest to the theoretical position is used for quantification!";
     LOG_INFO << std::endl;
-
-
-    /// add meta information to the map
-    registerChannelsInOutputMap_(consensus_map);
   }
 
-  void IsobaricChannelExtractor::registerChannelsInOutputMap_(ConsensusMap& consensus_map)
+  void IsobaricChannelExtractor::registerChannelsInOutputMap_(ConsensusMap& consensus_map) const
   {
     // register the individual channels in the output consensus map
     Int index = 0;
@@ -749,4 +629,326 @@ namespace OpenMS
     }
   }
 
+  const Size IsobaricChannelExtractionConsumer::BATCH_SIZE = 1000;
+
+  IsobaricChannelExtractionConsumer::IsobaricChannelExtractionConsumer(const IsobaricChannelExtractor& extractor, ConsensusMap& consensus_map, UInt quant_ms_level) :
+    extractor_(extractor),
+    consensus_map_(consensus_map),
+    settings_(),
+    is_valid_activation_(ListUtils::create<String>(extractor.selected_activation_)),
+    quant_ms_level_(quant_ms_level),
+    fixed_ms_level_(quant_ms_level != 0),
+    min_reporter_mz_(std::numeric_limits<double>::max()),
+    max_reporter_mz_(-std::numeric_limits<double>::max()),
+    spectra_count_(0),
+    last_rt_(-std::numeric_limits<double>::max()),
+    last_ms1_(),
+    has_last_ms2_(false),
+    last_ms2_rt_(0.0),
+    last_ms2_mz_(0.0),
+    pending_(),
+    resolved_(0),
+    element_index_(0),
+    ms_level_counts_(),
+    activation_modes_(),
+    mz_deltas_(),
+    signal_not_unique_()
+  {
+    const IsobaricQuantitationMethod::IsobaricChannelList& channels = extractor_.quant_method_->getChannelInformation();
+    for (IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = channels.begin(); cl_it != channels.end(); ++cl_it)
+    {
+      min_reporter_mz_ = std::min(min_reporter_mz_, cl_it->center - QC_DIST_MZ);
+      max_reporter_mz_ = std::max(max_reporter_mz_, cl_it->center + QC_DIST_MZ);
+    }
+    mz_deltas_.resize(channels.size());
+    signal_not_unique_.resize(channels.size(), 0);
+
+    // clear the output map
+    consensus_map_.clear(false);
+    consensus_map_.setExperimentType("labeled_MS2");
+
+    if (!fixed_ms_level_)
+    {
+      LOG_INFO << "Selecting scans with activation mode: " << (extractor_.selected_activation_ == "" ? "any" : extractor_.selected_activation_) << std::endl;
+    }
+  }
+
+  void IsobaricChannelExtractionConsumer::setExperimentalSettings(const ExperimentalSettings& exp)
+  {
+    settings_ = exp;
+  }
+
+  const ExperimentalSettings& IsobaricChannelExtractionConsumer::getExperimentalSettings() const
+  {
+    return settings_;
+  }
+
+  void IsobaricChannelExtractionConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    consume_(s, boost::shared_ptr<const MSSpectrum>());
+  }
+
+  void IsobaricChannelExtractionConsumer::consume_(const MSSpectrum& s, const boost::shared_ptr<const MSSpectrum>& shared)
+  {
+    ++spectra_count_;
+
+    // check if RT is sorted (we rely on it)
+    if (s.getRT() < last_rt_)
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Spectra are not sorted in RT! Please sort them first!");
+    }
+    last_rt_ = s.getRT();
+
+    // remember the last MS1 spectra as we assume it to be the precursor spectrum
+    if (s.getMSLevel() == 1)
+    {
+      boost::shared_ptr<const MSSpectrum> ms1 = shared;
+      if (!ms1)
+      { // only peaks and RT are needed for the purity computation
+        MSSpectrum* copy = new MSSpectrum();
+        copy->setRT(s.getRT());
+        copy->insert(copy->end(), s.begin(), s.end());
+        ms1.reset(copy);
+      }
+
+      // this is the follow-up scan of all pending quantitation scans with a smaller RT
+      while (resolved_ < pending_.size() && pending_[resolved_].spectrum->getRT() < ms1->getRT())
+      {
+        pending_[resolved_].follow_up_scan = ms1;
+        ++resolved_;
+      }
+      if (resolved_ >= BATCH_SIZE) processPending_(resolved_);
+
+      last_ms1_ = ms1;
+      // reset last MS2 -- we expect to see a new one soon and the old one should not be used for the following MS3 (if any)
+      has_last_ms2_ = false;
+      return;
+    }
+
+    ++activation_modes_[extractor_.getActivationMethod_(s)]; // count HCD, CID, ...
+    const bool valid_activation = extractor_.selected_activation_ == "" || is_valid_activation_(s);
+    if (valid_activation) ++ms_level_counts_[s.getMSLevel()];
+
+    if (s.getMSLevel() == 2)
+    { // remember last MS2 spec, to get precursor in MS1 (also if quant is in MS3)
+      if (s.getPrecursors().empty())
+      {
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No precursor information given for scan native ID ") + s.getNativeID() + " with RT " + String(s.getRT()));
+      }
+      has_last_ms2_ = true;
+      last_ms2_rt_ = s.getRT();
+      last_ms2_mz_ = s.getPrecursors()[0].getMZ();
+    }
+
+    // only the highest level is used for quantification (e.g. MS3, if present)
+    if (!fixed_ms_level_ && valid_activation && s.getMSLevel() > quant_ms_level_)
+    {
+      if (quant_ms_level_ != 0)
+      {
+        LOG_INFO << "Found MS-level " << s.getMSLevel() << " scan " << s.getNativeID() << ". Discarding results of MS-level " << quant_ms_level_ << "." << std::endl;
+      }
+      quant_ms_level_ = s.getMSLevel();
+      consensus_map_.clear(false);
+      pending_.clear();
+      resolved_ = 0;
+      element_index_ = 0;
+      for (Size ch = 0; ch < mz_deltas_.size(); ++ch)
+      {
+        mz_deltas_[ch].clear();
+        signal_not_unique_[ch] = 0;
+      }
+    }
+
+    if (s.getMSLevel() != quant_ms_level_) return;
+    if (s.empty()) return; // skip empty spectra
+    if (!valid_activation) return;
+
+    // check if precursor is available
+    if (s.getPrecursors().empty())
+    {
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No precursor information given for scan native ID ") + s.getNativeID() + " with RT " + String(s.getRT()));
+    }
+
+    // check precursor constraints
+    if (!extractor_.isValidPrecursor_(s.getPrecursors()[0]))
+    {
+      LOG_DEBUG << "Skip spectrum " << s.getNativeID() << ": Precursor doesn't fulfill all constraints." << std::endl;
+      return;
+    }
+
+    IsobaricChannelExtractor::ExtractionJob_ job;
+    job.spectrum = shared;
+    if (!job.spectrum)
+    { // keep only the meta data and the reporter ion region required for extraction
+      MSSpectrum* trimmed = new MSSpectrum();
+      trimmed->setRT(s.getRT());
+      trimmed->setMSLevel(s.getMSLevel());
+      trimmed->setNativeID(s.getNativeID());
+      trimmed->setPrecursors(s.getPrecursors());
+      trimmed->insert(trimmed->end(), s.MZBegin(min_reporter_mz_), s.MZEnd(max_reporter_mz_));
+      job.spectrum.reset(trimmed);
+    }
+    job.precursor_scan = last_ms1_;
+    job.has_ms2 = has_last_ms2_;
+    job.ms2_rt = last_ms2_rt_;
+    job.ms2_mz = last_ms2_mz_;
+    pending_.push_back(job);
+
+    // without interpolation, the follow-up scan is not needed
+    if (!extractor_.interpolate_precursor_purity_) resolved_ = pending_.size();
+    if (resolved_ >= BATCH_SIZE) processPending_(resolved_);
+  }
+
+  void IsobaricChannelExtractionConsumer::processPending_(Size count)
+  {
+    std::exception_ptr error; // first exception thrown in the parallel loop (must not escape it)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)count; ++i)
+    {
+      try
+      {
+        extractor_.processJob_(pending_[i]);
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (IsobaricChannelExtractor_error)
+#endif
+        if (!error) error = std::current_exception();
+      }
+    }
+    if (error) std::rethrow_exception(error);
+
+    // results are added in the order of the input
+    for (Size i = 0; i < count; ++i)
+    {
+      commitJob_(pending_[i]);
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + count);
+    resolved_ = (resolved_ > count ? resolved_ - count : 0);
+  }
+
+  void IsobaricChannelExtractionConsumer::commitJob_(const IsobaricChannelExtractor::ExtractionJob_& job)
+  {
+    const MSSpectrum& spec = *job.spectrum;
+
+    if (!job.precursor_scan)
+    {
+      LOG_INFO << "No precursor available for spectrum: " << spec.getNativeID() << std::endl;
+    }
+    else if (job.precursor_scan->empty())
+    {
+      LOG_INFO << "Empty precursor scan for spectrum: " << spec.getNativeID() << std::endl;
+    }
+    else if (job.low_purity)
+    {
+      LOG_DEBUG << "Skip spectrum " << spec.getNativeID() << ": Precursor purity is below the threshold. [purity = " << job.purity << "]" << std::endl;
+      return;
+    }
+
+    // store RT&MZ of MS1 parent ion as centroid of ConsensusFeature
+    if (!job.has_ms2)
+    { // this only happens if an MS3 spec does not have a preceeding MS2
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No MS2 precursor information given for MS3 scan native ID ") + spec.getNativeID() + " with RT " + String(spec.getRT()));
+    }
+
+    ConsensusFeature cf;
+    cf.setUniqueId();
+    cf.setRT(job.ms2_rt);
+    cf.setMZ(job.ms2_mz);
+
+    Peak2D channel_value;
+    channel_value.setRT(spec.getRT());
+    Peak2D::IntensityType overall_intensity = 0;
+
+    // for each each channel
+    const IsobaricQuantitationMethod::IsobaricChannelList& channels = extractor_.quant_method_->getChannelInformation();
+    for (Size ch = 0; ch < channels.size(); ++ch)
+    {
+      if (job.found[ch])
+      {
+        mz_deltas_[ch].push_back(job.mz_deltas[ch]);
+        if (job.not_unique[ch]) ++signal_not_unique_[ch];
+      }
+
+      // set mz-position of channel
+      channel_value.setMZ(channels[ch].center);
+      channel_value.setIntensity(job.intensities[ch]);
+      overall_intensity += channel_value.getIntensity();
+      // add channel to ConsensusFeature
+      cf.insert(ch, channel_value, element_index_);
+    }
+
+    // check if we keep this feature or if it contains low-intensity quantifications
+    if (extractor_.remove_low_intensity_quantifications_ && extractor_.hasLowIntensityReporter_(cf))
+    {
+      return;
+    }
+
+    // check featureHandles are not empty
+    if (overall_intensity <= 0)
+    {
+      cf.setMetaValue("all_empty", String("true"));
+    }
+    // add purity information if we could compute it
+    if (job.purity > 0.0)
+    {
+      cf.setMetaValue("precursor_purity", job.purity);
+    }
+
+    // embed the id of the scan from which the quantitative information was extracted
+    cf.setMetaValue("scan_id", spec.getNativeID());
+    // ...as well as additional meta information
+    cf.setMetaValue("precursor_intensity", spec.getPrecursors()[0].getIntensity());
+
+    cf.setCharge(spec.getPrecursors()[0].getCharge());
+    cf.setIntensity(overall_intensity);
+    consensus_map_.push_back(cf);
+
+    // the tandem-scan in the order they appear in the experiment
+    ++element_index_;
+  }
+
+  void IsobaricChannelExtractionConsumer::finish()
+  {
+    if (spectra_count_ == 0)
+    {
+      LOG_WARN << "The given file does not contain any conventional peak data, but might"
+                  " contain chromatograms. This tool currently cannot handle them, sorry.\n";
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Experiment has no scans!");
+    }
+
+    // scans without a follow-up MS1 scan can be processed now
+    processPending_(pending_.size());
+    last_ms1_.reset();
+
+    if (!fixed_ms_level_)
+    {
+      if (ms_level_counts_.empty())
+      {
+        LOG_WARN << "Filtering by MS/MS(/MS) and activation mode: no spectra pass activation mode filter!\n"
+                 << "Activation modes found:\n";
+        for (std::map<String, int>::const_iterator it = activation_modes_.begin(); it != activation_modes_.end(); ++it)
+        {
+          LOG_WARN << "  mode " << (it->first.empty() ? "<none>" : it->first) << ": " << it->second << " scans\n";
+        }
+        LOG_WARN << "Result will be empty!" << std::endl;
+        return;
+      }
+      LOG_INFO << "Filtering by MS/MS(/MS) and activation mode:\n";
+      for (std::map<UInt, UInt>::const_iterator it = ms_level_counts_.begin(); it != ms_level_counts_.end(); ++it)
+      {
+        LOG_INFO << "  level " << it->first << ": " << it->second << " scans\n";
+      }
+      LOG_INFO << "Used MS-level " << quant_ms_level_ << " for quantification." << std::endl;
+    }
+
+    extractor_.printChannelQC_(mz_deltas_, signal_not_unique_);
+
+    /// add meta information to the map
+    extractor_.registerChannelsInOutputMap_(consensus_map_);
+  }
+
 } // namespace
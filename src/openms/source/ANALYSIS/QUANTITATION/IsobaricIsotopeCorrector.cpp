@@ -44,6 +44,8 @@
 
 #include <Eigen/LU>
 
+#include <algorithm>
+
 // #define ISOBARIC_QUANT_DEBUG
 
 namespace OpenMS
@@ -86,34 +88,64 @@ namespace OpenMS
     }
 
     // data structures for NNLS
-    Matrix<double> m_b(quant_method->getNumberOfChannels(), 1);
-    Matrix<double> m_x(quant_method->getNumberOfChannels(), 1);
-
-    // correct all consensus elements
-    for (ConsensusMap::size_type i = 0; i < consensus_map_out.size(); ++i)
+    const Size channel_count = quant_method->getNumberOfChannels();
+    Matrix<double> m_b(channel_count, 1);
+    Matrix<double> m_x(channel_count, 1);
+
+    // correct the consensus elements in chunks; all elements share the correction matrix,
+    // so the LU decomposition and the NNLS setup are reused for all right-hand sides of a chunk
+    const Size chunk_size = 10000;
+    for (ConsensusMap::size_type chunk_start = 0; chunk_start < consensus_map_out.size(); chunk_start += chunk_size)
     {
-#ifdef ISOBARIC_QUANT_DEBUG
-      std::cout << "\nMAP element  #### " << i << " #### \n" << std::endl;
-#endif
-      // delete only the consensus handles from the output map
-      consensus_map_out[i].clear();
+      const Size chunk_end = std::min(chunk_start + chunk_size, consensus_map_out.size());
+      const Size chunk_count = chunk_end - chunk_start;
 
-      // fill b vector
-      fillInputVector_(b, m_b, consensus_map_in[i], consensus_map_in);
+      Eigen::MatrixXd e_b(channel_count, chunk_count);
+      Matrix<double> m_B(channel_count, chunk_count);
+      for (ConsensusMap::size_type i = chunk_start; i < chunk_end; ++i)
+      {
+        // fill b vector
+        fillInputVector_(b, m_b, consensus_map_in[i], consensus_map_in);
+        e_b.col(i - chunk_start) = b;
+        for (Size row = 0; row < channel_count; ++row)
+        {
+          m_B(row, i - chunk_start) = m_b(row, 0);
+        }
+      }
 
       //solve
-      Eigen::MatrixXd e_mx = ludecomp.solve(b);
-      if (!((*m) * e_mx).isApprox(b))
+      Eigen::MatrixXd e_x = ludecomp.solve(e_b);
+      for (Size col = 0; col < chunk_count; ++col)
       {
-        throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "IsobaricIsotopeCorrector: Cannot multiply!");
+        if (!((*m) * e_x.col(col)).isApprox(e_b.col(col)))
+        {
+          throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "IsobaricIsotopeCorrector: Cannot multiply!");
+        }
       }
-      solveNNLS_(correction_matrix, m_b, m_x);
+      Matrix<double> m_X;
+      solveNNLS_(correction_matrix, m_B, m_X);
 
-      // update the output consensus map with the corrected intensities
-      float cf_intensity = updateOutpuMap_(consensus_map_in, consensus_map_out, i, m_x);
+      for (ConsensusMap::size_type i = chunk_start; i < chunk_end; ++i)
+      {
+#ifdef ISOBARIC_QUANT_DEBUG
+        std::cout << "\nMAP element  #### " << i << " #### \n" << std::endl;
+#endif
+        // delete only the consensus handles from the output map
+        consensus_map_out[i].clear();
 
-      // check consistency
-      computeStats_(m_x, e_mx, cf_intensity, quant_method, stats);    
+        const Size col = i - chunk_start;
+        for (Size row = 0; row < channel_count; ++row)
+        {
+          m_x(row, 0) = m_X(row, col);
+        }
+        Eigen::MatrixXd e_mx = e_x.col(col);
+
+        // update the output consensus map with the corrected intensities
+        float cf_intensity = updateOutpuMap_(consensus_map_in, consensus_map_out, i, m_x);
+
+        // check consistency
+        computeStats_(m_x, e_mx, cf_intensity, quant_method, stats);
+      }
     }
 
     return stats;
@@ -142,7 +174,7 @@ namespace OpenMS
   IsobaricIsotopeCorrector::solveNNLS_(const Matrix<double>& correction_matrix,
                                        const Matrix<double>& m_b, Matrix<double>& m_x)
   {
-    Int status = NonNegativeLeastSquaresSolver::solve(correction_matrix, m_b, m_x);
+    Int status = NonNegativeLeastSquaresSolver::solveBatch(correction_matrix, m_b, m_x);
     if (status != NonNegativeLeastSquaresSolver::SOLVED)
     {
       throw Exception::FailedAPICall(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "IsobaricIsotopeCorrector: Failed to find least-squares fit!");
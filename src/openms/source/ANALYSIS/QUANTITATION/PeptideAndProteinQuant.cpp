@@ -36,11 +36,77 @@
 #include <OpenMS/ANALYSIS/QUANTITATION/PeptideAndProteinQuant.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
+
 using namespace std;
 
 namespace OpenMS
 {
 
+  namespace
+  {
+    /// Hash of a peptide sequence, consistent with the equivalence defined by AASequence::operator<
+    struct SequenceHash_
+    {
+      size_t operator()(const AASequence* seq) const
+      {
+        size_t hash = boost::hash_value(seq->size());
+        if (seq->hasNTerminalModification())
+        {
+          boost::hash_combine(hash, static_cast<const std::string&>(seq->getNTerminalModification()->getId()));
+        }
+        for (AASequence::ConstIterator it = seq->begin(); it != seq->end(); ++it)
+        {
+          boost::hash_combine(hash, static_cast<const std::string&>(it->getOneLetterCode()));
+          boost::hash_combine(hash, it->getModification());
+        }
+        if (seq->hasCTerminalModification())
+        {
+          boost::hash_combine(hash, static_cast<const std::string&>(seq->getCTerminalModification()->getId()));
+        }
+        return hash;
+      }
+    };
+
+    /// Equivalence of peptide sequences as used by the keys of PeptideAndProteinQuant::PeptideQuant
+    struct SequenceEqual_
+    {
+      bool operator()(const AASequence* lhs, const AASequence* rhs) const
+      {
+        return !(*lhs < *rhs) && !(*rhs < *lhs);
+      }
+    };
+  }
+
+  /// Hashed access to the entries of PeptideAndProteinQuant::PeptideQuant (keys point into the map)
+  class PeptideAndProteinQuant::PeptideIndex_
+  {
+public:
+    explicit PeptideIndex_(PeptideQuant& pep_quant) :
+      pep_quant_(pep_quant)
+    {
+      for (PeptideQuant::iterator it = pep_quant_.begin(); it != pep_quant_.end(); ++it)
+      {
+        index_[&(it->first)] = &(it->second);
+      }
+    }
+
+    /// Returns the data for @p seq, inserting an empty entry if necessary (like PeptideQuant::operator[])
+    PeptideData& operator[](const AASequence& seq)
+    {
+      boost::unordered_map<const AASequence*, PeptideData*, SequenceHash_, SequenceEqual_>::iterator pos = index_.find(&seq);
+      if (pos != index_.end()) return *(pos->second);
+      PeptideQuant::iterator it = pep_quant_.insert(make_pair(seq, PeptideData())).first;
+      index_[&(it->first)] = &(it->second);
+      return it->second;
+    }
+
+private:
+    PeptideQuant& pep_quant_;
+    boost::unordered_map<const AASequence*, PeptideData*, SequenceHash_, SequenceEqual_> index_;
+  };
+
   PeptideAndProteinQuant::PeptideAndProteinQuant() :
     DefaultParamHandler("PeptideAndProteinQuant"), stats_(), pep_quant_(),
     prot_quant_()
@@ -72,7 +138,7 @@ namespace OpenMS
 
 
   void PeptideAndProteinQuant::countPeptides_(vector<PeptideIdentification>&
-                                              peptides)
+                                              peptides, PeptideIndex_& pep_index)
   {
     for (vector<PeptideIdentification>::iterator pep_it =
            peptides.begin(); pep_it != peptides.end(); ++pep_it)
@@ -81,7 +147,7 @@ namespace OpenMS
       {
         pep_it->sort();
         const PeptideHit& hit = pep_it->getHits()[0];
-        PeptideData& data = pep_quant_[hit.getSequence()];
+        PeptideData& data = pep_index[hit.getSequence()];
         data.id_count++;
         data.abundances[hit.getCharge()]; // insert empty element for charge
         // add protein accessions:
@@ -113,7 +179,8 @@ namespace OpenMS
 
 
   void PeptideAndProteinQuant::quantifyFeature_(const FeatureHandle& feature,
-                                                const PeptideHit& hit)
+                                                const PeptideHit& hit,
+                                                PeptideIndex_& pep_index)
   {
     if (hit == PeptideHit())
     {
@@ -121,7 +188,7 @@ namespace OpenMS
     }
     stats_.quant_features++;
     const AASequence& seq = hit.getSequence();
-    pep_quant_[seq].abundances[hit.getCharge()][feature.getMapIndex()] +=
+    pep_index[seq].abundances[hit.getCharge()][feature.getMapIndex()] +=
       feature.getIntensity(); // new map element is initialized with 0
   }
 
@@ -170,44 +237,57 @@ namespace OpenMS
       pep_quant_ = filtered;
     }
 
-    // now perform the actual peptide quantification:
+    // now perform the actual peptide quantification (peptides are independent):
+    bool filter_charge = (param_.getValue("filter_charge") == "true");
+    vector<PeptideData*> pep_data;
+    pep_data.reserve(pep_quant_.size());
     for (PeptideQuant::iterator q_it = pep_quant_.begin();
          q_it != pep_quant_.end(); ++q_it)
     {
-      if (param_.getValue("filter_charge") == "true")
+      pep_data.push_back(&(q_it->second));
+    }
+    Size quant_peptides = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1000) reduction(+: quant_peptides)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)pep_data.size(); ++i)
+    {
+      PeptideData& data = *pep_data[i];
+      if (filter_charge)
       {
         // find charge state with abundances for highest number of samples
         // (break ties by total abundance):
         IntList charges; // sorted charge states (best first)
-        orderBest_(q_it->second.abundances, charges);
+        orderBest_(data.abundances, charges);
         if (charges.empty()) continue; // only identified, not quantified
         Int best_charge = charges[0];
 
         // quantify according to the best charge state only:
         for (SampleAbundances::iterator samp_it =
-               q_it->second.abundances[best_charge].begin(); samp_it !=
-             q_it->second.abundances[best_charge].end(); ++samp_it)
+               data.abundances[best_charge].begin(); samp_it !=
+             data.abundances[best_charge].end(); ++samp_it)
         {
-          q_it->second.total_abundances[samp_it->first] = samp_it->second;
+          data.total_abundances[samp_it->first] = samp_it->second;
         }
       }
       else
       {
         // sum up abundances over all charge states:
         for (map<Int, SampleAbundances>::iterator ab_it =
-               q_it->second.abundances.begin(); ab_it !=
-             q_it->second.abundances.end(); ++ab_it)
+               data.abundances.begin(); ab_it != data.abundances.end();
+             ++ab_it)
         {
           for (SampleAbundances::iterator samp_it = ab_it->second.begin();
                samp_it != ab_it->second.end(); ++samp_it)
           {
-            q_it->second.total_abundances[samp_it->first] += samp_it->second;
+            data.total_abundances[samp_it->first] += samp_it->second;
           }
         }
       }
-      if (!q_it->second.total_abundances.empty())
-        stats_.quant_peptides++;
+      if (!data.total_abundances.empty())
+        quant_peptides++;
     }
+    stats_.quant_peptides += quant_peptides;
 
     if ((stats_.n_samples > 1) &&
         (param_.getValue("consensus:normalize") == "true"))
@@ -257,24 +337,36 @@ namespace OpenMS
       scale_factors[med_it->first] = overall_median / med_it->second;
     }
 
-    // scale all abundance values:
+    // scale all abundance values (peptides are independent):
+    vector<PeptideData*> pep_data;
+    pep_data.reserve(pep_quant_.size());
     for (PeptideQuant::iterator q_it = pep_quant_.begin();
          q_it != pep_quant_.end(); ++q_it)
     {
-      for (SampleAbundances::iterator tot_it =
-             q_it->second.total_abundances.begin(); tot_it !=
-           q_it->second.total_abundances.end(); ++tot_it)
+      pep_data.push_back(&(q_it->second));
+    }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1000)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)pep_data.size(); ++i)
+    {
+      PeptideData& data = *pep_data[i];
+      for (SampleAbundances::iterator tot_it = data.total_abundances.begin();
+           tot_it != data.total_abundances.end(); ++tot_it)
       {
-        tot_it->second *= scale_factors[tot_it->first];
+        tot_it->second *= scale_factors.find(tot_it->first)->second;
       }
       for (map<Int, SampleAbundances>::iterator ab_it =
-             q_it->second.abundances.begin(); ab_it !=
-           q_it->second.abundances.end(); ++ab_it)
+             data.abundances.begin(); ab_it != data.abundances.end(); ++ab_it)
       {
         for (SampleAbundances::iterator samp_it = ab_it->second.begin();
              samp_it != ab_it->second.end(); ++samp_it)
         {
-          samp_it->second *= scale_factors[samp_it->first];
+          // samples only quantified for non-best charge states have no
+          // median - the original code scaled them by 0 (default value):
+          SampleAbundances::const_iterator pos =
+            scale_factors.find(samp_it->first);
+          samp_it->second *= (pos == scale_factors.end()) ? 0.0 : pos->second;
         }
       }
     }
@@ -341,15 +433,17 @@ namespace OpenMS
                                        accession_to_leader);
       if (!accession.empty()) // proteotypic peptide
       {
-        prot_quant_[accession].id_count += pep_it->second.id_count;
+        ProteinData& prot_data = prot_quant_[accession];
+        prot_data.id_count += pep_it->second.id_count;
+        if (pep_it->second.total_abundances.empty()) continue;
+        // add up contributions of same peptide with different mods:
+        SampleAbundances& raw_abundances =
+          prot_data.abundances[pep_it->first.toUnmodifiedString()];
         for (SampleAbundances::const_iterator tot_it =
                pep_it->second.total_abundances.begin(); tot_it !=
              pep_it->second.total_abundances.end(); ++tot_it)
         {
-          // add up contributions of same peptide with different mods:
-          String raw_peptide = pep_it->first.toUnmodifiedString();
-          prot_quant_[accession].abundances[raw_peptide][tot_it->first] +=
-            tot_it->second;
+          raw_abundances[tot_it->first] += tot_it->second;
         }
       }
     }
@@ -359,12 +453,24 @@ namespace OpenMS
     bool include_all = param_.getValue("include_all") == "true";
     bool fix_peptides = param_.getValue("consensus:fix_peptides") == "true";
 
+    // aggregate peptide abundances per protein (proteins are independent):
+    vector<ProteinData*> prot_data;
+    prot_data.reserve(prot_quant_.size());
     for (ProteinQuant::iterator prot_it = prot_quant_.begin();
          prot_it != prot_quant_.end(); ++prot_it)
     {
-      if ((top > 0) && (prot_it->second.abundances.size() < top))
+      prot_data.push_back(&(prot_it->second));
+    }
+    Size too_few_peptides = 0, quant_proteins = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100) reduction(+: too_few_peptides, quant_proteins)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)prot_data.size(); ++i)
+    {
+      ProteinData& data = *prot_data[i];
+      if ((top > 0) && (data.abundances.size() < top))
       {
-        stats_.too_few_peptides++;
+        too_few_peptides++;
         if (!include_all)
           continue; // not enough proteotypic peptides
       }
@@ -374,8 +480,8 @@ namespace OpenMS
       {
         // consider all peptides that occur in every sample:
         for (map<String, SampleAbundances>::iterator ab_it =
-               prot_it->second.abundances.begin(); ab_it !=
-             prot_it->second.abundances.end(); ++ab_it)
+               data.abundances.begin(); ab_it !=
+             data.abundances.end(); ++ab_it)
         {
           if (ab_it->second.size() == stats_.n_samples)
           {
@@ -384,17 +490,17 @@ namespace OpenMS
         }
       }
       else if (fix_peptides && (top > 0) &&
-               (prot_it->second.abundances.size() > top))
+               (data.abundances.size() > top))
       {
-        orderBest_(prot_it->second.abundances, peptides);
+        orderBest_(data.abundances, peptides);
         peptides.resize(top);
       }
       else
       {
         // consider all peptides:
         for (map<String, SampleAbundances>::iterator ab_it =
-               prot_it->second.abundances.begin(); ab_it !=
-             prot_it->second.abundances.end(); ++ab_it)
+               data.abundances.begin(); ab_it !=
+             data.abundances.end(); ++ab_it)
         {
           peptides.push_back(ab_it->first);
         }
@@ -405,7 +511,7 @@ namespace OpenMS
       for (vector<String>::iterator pep_it = peptides.begin();
            pep_it != peptides.end(); ++pep_it)
       {
-        SampleAbundances& current_ab = prot_it->second.abundances[*pep_it];
+        SampleAbundances& current_ab = data.abundances[*pep_it];
         for (SampleAbundances::iterator samp_it = current_ab.begin();
              samp_it != current_ab.end(); ++samp_it)
         {
@@ -453,13 +559,15 @@ namespace OpenMS
         {
           result = Math::sum(ab_it->second.begin(), ab_it->second.end());
         }
-        prot_it->second.total_abundances[ab_it->first] = result;
+        data.total_abundances[ab_it->first] = result;
       }
 
       // update statistics:
-      if (prot_it->second.total_abundances.empty()) stats_.too_few_peptides++;
-      else stats_.quant_proteins++;
+      if (data.total_abundances.empty()) too_few_peptides++;
+      else quant_proteins++;
     }
+    stats_.too_few_peptides += too_few_peptides;
+    stats_.quant_proteins += quant_proteins;
   }
 
 
@@ -468,6 +576,7 @@ namespace OpenMS
     updateMembers_(); // clear data
     stats_.n_samples = 1;
     stats_.total_features = features.size();
+    PeptideIndex_ pep_index(pep_quant_);
 
     for (FeatureMap::Iterator feat_it = features.begin();
          feat_it != features.end(); ++feat_it)
@@ -477,12 +586,12 @@ namespace OpenMS
         stats_.blank_features++;
         continue;
       }
-      countPeptides_(feat_it->getPeptideIdentifications());
+      countPeptides_(feat_it->getPeptideIdentifications(), pep_index);
       PeptideHit hit = getAnnotation_(feat_it->getPeptideIdentifications());
       FeatureHandle handle(0, *feat_it);
-      quantifyFeature_(handle, hit); // updates "stats_.quant_features"
+      quantifyFeature_(handle, hit, pep_index); // updates "stats_.quant_features"
     }
-    countPeptides_(features.getUnassignedPeptideIdentifications());
+    countPeptides_(features.getUnassignedPeptideIdentifications(), pep_index);
     stats_.total_peptides = pep_quant_.size();
     stats_.ambig_features = stats_.total_features - stats_.blank_features -
                             stats_.quant_features;
@@ -493,6 +602,7 @@ namespace OpenMS
   {
     updateMembers_(); // clear data
     stats_.n_samples = consensus.getFileDescriptions().size();
+    PeptideIndex_ pep_index(pep_quant_);
 
     for (ConsensusMap::Iterator cons_it = consensus.begin();
          cons_it != consensus.end(); ++cons_it)
@@ -503,16 +613,25 @@ namespace OpenMS
         stats_.blank_features += cons_it->getFeatures().size();
         continue;
       }
-      countPeptides_(cons_it->getPeptideIdentifications());
+      countPeptides_(cons_it->getPeptideIdentifications(), pep_index);
       PeptideHit hit = getAnnotation_(cons_it->getPeptideIdentifications());
+      if (hit == PeptideHit())
+      {
+        continue; // annotation for the features is ambiguous or missing
+      }
+      // all features of the consensus feature go to the same peptide/charge:
+      stats_.quant_features += cons_it->getFeatures().size();
+      SampleAbundances& abundances =
+        pep_index[hit.getSequence()].abundances[hit.getCharge()];
       for (ConsensusFeature::HandleSetType::const_iterator feat_it =
              cons_it->getFeatures().begin(); feat_it !=
            cons_it->getFeatures().end(); ++feat_it)
       {
-        quantifyFeature_(*feat_it, hit); // updates "stats_.quant_features"
+        // new map element is initialized with 0:
+        abundances[feat_it->getMapIndex()] += feat_it->getIntensity();
       }
     }
-    countPeptides_(consensus.getUnassignedPeptideIdentifications());
+    countPeptides_(consensus.getUnassignedPeptideIdentifications(), pep_index);
     stats_.total_peptides = pep_quant_.size();
     stats_.ambig_features = stats_.total_features - stats_.blank_features -
                             stats_.quant_features;
@@ -526,8 +645,9 @@ namespace OpenMS
     updateMembers_(); // clear data
     stats_.n_samples = proteins.size();
     stats_.total_features = peptides.size();
+    PeptideIndex_ pep_index(pep_quant_);
 
-    countPeptides_(peptides);
+    countPeptides_(peptides, pep_index);
 
     // treat identification runs as different samples - otherwise we could just
     // use the "id_count" element of PeptideData (filled by "countPeptides_") to
@@ -546,7 +666,7 @@ namespace OpenMS
       stats_.quant_features++;
       const AASequence& seq = hit.getSequence();
       Size sample = identifiers[pep_it->getIdentifier()];
-      pep_quant_[seq].abundances[hit.getCharge()][sample] += 1;
+      pep_index[seq].abundances[hit.getCharge()][sample] += 1;
     }
     stats_.total_peptides = pep_quant_.size();
   }
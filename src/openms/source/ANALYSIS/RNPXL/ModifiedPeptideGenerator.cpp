@@ -33,6 +33,10 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
+#include <OpenMS/CHEMISTRY/ModificationsDB.h>
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+
+#include <algorithm>
 
 using std::vector;
 using std::map;
@@ -98,42 +102,13 @@ namespace OpenMS
     }
   }
 
+  const int ModifiedPeptideGenerator::N_TERM_MODIFICATION_INDEX = -1;
+  const int ModifiedPeptideGenerator::C_TERM_MODIFICATION_INDEX = -2;
+
   // static
-  void ModifiedPeptideGenerator::applyVariableModifications(const vector<ResidueModification>::const_iterator& var_mods_begin, const vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, Size max_variable_mods_per_peptide, vector<AASequence>& all_modified_peptides, bool keep_unmodified)
+  void ModifiedPeptideGenerator::getCompatibleSites_(const vector<ResidueModification>::const_iterator& var_mods_begin, const vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, map<int, vector<const ResidueModification*> >& map_compatibility)
   {
-    // no variable modifications specified or no variable mods allowed? no compatibility map needs to be build
-    if (var_mods_begin == var_mods_end || max_variable_mods_per_peptide == 0)
-    {
-      // if unmodified peptides should be kept return the original list of digested peptides
-      if (keep_unmodified)
-      {
-        all_modified_peptides.push_back(peptide);
-      }
-      return;
-    }
-
-    // if there is at most one variable modification allowed for a peptide we don't need combinatoric placement and can reside to a faster implementation
-    if (max_variable_mods_per_peptide == 1)
-    {
-      applyAtMostOneVariableModification_(var_mods_begin, var_mods_end, peptide, all_modified_peptides, keep_unmodified);
-      return;
-    }
-
-    const int N_TERM_MODIFICATION_INDEX = -1; // magic constant to distinguish N_TERM only modifications from ANYWHERE modifications placed at N-term residue
-    const int C_TERM_MODIFICATION_INDEX = -2; // magic constant to distinguish C_TERM only modifications from ANYWHERE modifications placed at C-term residue
-
-    //keep a list of all possible modifications of this peptide
-    vector<AASequence> modified_peptides;
-
-    // only add unmodified version if flag is set (default)
-    if (keep_unmodified)
-    {
-      modified_peptides.push_back(peptide);
-    }
-
-    //iterate over each residue and build compatibility mapping describing
-    //which amino acid (peptide index) is compatible with which modification
-    map<int, vector<ResidueModification> > map_compatibility;
+    map_compatibility.clear();
 
     // set terminal modifications for modifications without amino acid preference
     for (vector<ResidueModification>::const_iterator variable_it = var_mods_begin; variable_it != var_mods_end; ++variable_it)
@@ -142,14 +117,14 @@ namespace OpenMS
       {
         if (!peptide.hasNTerminalModification())
         {
-          map_compatibility[N_TERM_MODIFICATION_INDEX].push_back(*variable_it);
+          map_compatibility[N_TERM_MODIFICATION_INDEX].push_back(&(*variable_it));
         }
       }
       else if (variable_it->getTermSpecificity() == ResidueModification::C_TERM)
       {
         if (!peptide.hasCTerminalModification())
         {
-          map_compatibility[C_TERM_MODIFICATION_INDEX].push_back(*variable_it);
+          map_compatibility[C_TERM_MODIFICATION_INDEX].push_back(&(*variable_it));
         }
       }
     }
@@ -179,24 +154,27 @@ namespace OpenMS
         const ResidueModification::TermSpecificity& term_spec = variable_it->getTermSpecificity();
         if (term_spec == ResidueModification::ANYWHERE)
         {
-          map_compatibility[static_cast<int>(residue_index)].push_back(*variable_it);
+          map_compatibility[static_cast<int>(residue_index)].push_back(&(*variable_it));
         }
         else if (term_spec == ResidueModification::C_TERM && residue_index == (peptide.size() - 1))
         {
-          map_compatibility[C_TERM_MODIFICATION_INDEX].push_back(*variable_it);
+          map_compatibility[C_TERM_MODIFICATION_INDEX].push_back(&(*variable_it));
         }
         else if (term_spec == ResidueModification::N_TERM && residue_index == 0)
         {
-          map_compatibility[N_TERM_MODIFICATION_INDEX].push_back(*variable_it);
+          map_compatibility[N_TERM_MODIFICATION_INDEX].push_back(&(*variable_it));
         }
       }
     }
+  }
 
-    // Check if no compatible site that can be modified by variable
-    // modification. If so just return peptides without variable modifications.
-    const Size compatible_mod_sites = map_compatibility.size();
-    if (compatible_mod_sites == 0)
+  // static
+  void ModifiedPeptideGenerator::applyVariableModifications(const vector<ResidueModification>::const_iterator& var_mods_begin, const vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, Size max_variable_mods_per_peptide, vector<AASequence>& all_modified_peptides, bool keep_unmodified)
+  {
+    // no variable modifications specified or no variable mods allowed? no compatibility map needs to be build
+    if (var_mods_begin == var_mods_end || max_variable_mods_per_peptide == 0)
     {
+      // if unmodified peptides should be kept return the original list of digested peptides
       if (keep_unmodified)
       {
         all_modified_peptides.push_back(peptide);
@@ -204,104 +182,191 @@ namespace OpenMS
       return;
     }
 
-    // generate powerset of max_variable_mods_per_peptide sized subset of all compatible modification sites
-    Size max_placements = std::min(max_variable_mods_per_peptide, compatible_mod_sites);
-    for (Size n_var_mods = 1; n_var_mods <= max_placements; ++n_var_mods)
+    // enumerate all combinations of compatible sites and modifications
+    VariantEnumerator variants(var_mods_begin, var_mods_end, peptide, max_variable_mods_per_peptide, keep_unmodified);
+    while (variants.next())
+    {
+      all_modified_peptides.push_back(variants.getSequence());
+    }
+  }
+
+  ModifiedPeptideGenerator::VariantEnumerator::VariantEnumerator(const vector<ResidueModification>::const_iterator& var_mods_begin, const vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, Size max_variable_mods_per_peptide, bool keep_original) :
+    peptide_(peptide),
+    sites_(),
+    max_placements_(0),
+    keep_original_(keep_original),
+    state_(NOT_STARTED),
+    base_mass_(-1.0),
+    subset_mask_(),
+    selected_(),
+    choices_(),
+    mass_delta_(0.0)
+  {
+    map<int, vector<const ResidueModification*> > map_compatibility;
+    if (max_variable_mods_per_peptide == 1)
+    {
+      // no combinatoric placement needed: just every site is modified once by each compatible modification
+      getSingleModificationSites_(var_mods_begin, var_mods_end, peptide, map_compatibility);
+    }
+    else if (max_variable_mods_per_peptide > 1)
     {
-      // enumerate all modified peptides with n_var_mods variable modified residues
-      Size zeros = std::max((Size)0, compatible_mod_sites - n_var_mods);
-      vector<bool> subset_mask;
+      getCompatibleSites_(var_mods_begin, var_mods_end, peptide, map_compatibility);
+    }
 
-      for (Size i = 0; i != compatible_mod_sites; ++i)
+    // precompute the mass difference of every modification at every site (one ResidueDB/ModificationsDB lookup each)
+    ModificationsDB* mod_db = ModificationsDB::getInstance();
+    for (map<int, vector<const ResidueModification*> >::const_iterator mit = map_compatibility.begin(); mit != map_compatibility.end(); ++mit)
+    {
+      Site_ site;
+      site.index = mit->first;
+      site.mods = mit->second;
+      for (vector<const ResidueModification*>::const_iterator mod_it = site.mods.begin(); mod_it != site.mods.end(); ++mod_it)
       {
-        // create mask 000011 to select last (e.g. n_var_mods = 2) two compatible sites as subset from the set of all compatible sites
-        if (i < zeros)
+        const String& name = (*mod_it)->getFullName();
+        double delta(0);
+        if (site.index == N_TERM_MODIFICATION_INDEX)
+        {
+          delta = mod_db->getModification(name, "", ResidueModification::N_TERM).getDiffMonoMass();
+          if (peptide.hasNTerminalModification()) delta -= peptide.getNTerminalModification()->getDiffMonoMass();
+        }
+        else if (site.index == C_TERM_MODIFICATION_INDEX)
         {
-          subset_mask.push_back(false);
+          delta = mod_db->getModification(name, "", ResidueModification::C_TERM).getDiffMonoMass();
+          if (peptide.hasCTerminalModification()) delta -= peptide.getCTerminalModification()->getDiffMonoMass();
         }
         else
         {
-          subset_mask.push_back(true);
+          const Residue* residue = &peptide[site.index];
+          const Residue* modified = ResidueDB::getInstance()->getModifiedResidue(residue, name);
+          delta = modified->getMonoWeight(Residue::Internal) - residue->getMonoWeight(Residue::Internal);
         }
+        site.mass_deltas.push_back(delta);
       }
+      sites_.push_back(site);
+    }
+    max_placements_ = std::min(max_variable_mods_per_peptide, sites_.size());
+  }
 
-      // generate all subsets of compatible sites {000011, ... , 101000, 110000} with current number of allowed variable modifications per peptide
-      do
-      {
-        // create subset indices e.g.{4,12} from subset mask e.g. 1010000 corresponding to the positions in the peptide sequence
-        vector<int> subset_indices;
-        map<int, vector<ResidueModification> >::const_iterator mit = map_compatibility.begin();
-        for (Size i = 0; i != compatible_mod_sites; ++i, ++mit)
-        {
-          if (subset_mask[i])
-          {
-            subset_indices.push_back(mit->first);
-          }
-        }
+  bool ModifiedPeptideGenerator::VariantEnumerator::next()
+  {
+    if (state_ == DONE) return false;
+
+    if (state_ == NOT_STARTED && keep_original_)
+    {
+      state_ = ORIGINAL;
+      mass_delta_ = 0.0;
+      return true;
+    }
+
+    if (state_ != ENUMERATING) // not started or original peptide
+    {
+      return startPlacements_(1);
+    }
 
-        // now enumerate all modifications
-        recurseAndGenerateVariableModifiedPeptides_(subset_indices, map_compatibility, 0, peptide, modified_peptides);
+    // next combination of modifications at the selected sites (the last site changes fastest)
+    for (SignedSize depth = (SignedSize)selected_.size() - 1; depth >= 0; --depth)
+    {
+      if (++choices_[depth] < sites_[selected_[depth]].mods.size())
+      {
+        updateMass_();
+        return true;
       }
-      while (next_permutation(subset_mask.begin(), subset_mask.end()));
+      choices_[depth] = 0;
+    }
+
+    // next subset of sites with the same number of modifications
+    if (std::next_permutation(subset_mask_.begin(), subset_mask_.end()))
+    {
+      startSubset_();
+      return true;
     }
-    // add modified version of the current peptide to the list of all peptides
-    all_modified_peptides.insert(all_modified_peptides.end(), modified_peptides.begin(), modified_peptides.end());
-  }
 
+    return startPlacements_(selected_.size() + 1);
+  }
 
-  // static
-  void ModifiedPeptideGenerator::recurseAndGenerateVariableModifiedPeptides_(const vector<int>& subset_indices, const map<int, vector<ResidueModification> >& map_compatibility, int depth, const AASequence& current_peptide, vector<AASequence>& modified_peptides)
+  bool ModifiedPeptideGenerator::VariantEnumerator::startPlacements_(Size n_mods)
   {
-    const int N_TERM_MODIFICATION_INDEX = -1; // magic constant to distinguish N_TERM only modifications from ANYWHERE modifications placed at N-term residue
-    const int C_TERM_MODIFICATION_INDEX = -2; // magic constant to distinguish C_TERM only modifications from ANYWHERE modifications placed at C-term residue
+    if (n_mods > max_placements_)
+    {
+      state_ = DONE;
+      selected_.clear();
+      mass_delta_ = 0.0;
+      return false;
+    }
+    state_ = ENUMERATING;
 
-    // cout << depth << " " << subset_indices.size() << " " << current_peptide.toString() << endl;
+    // create mask 000011 to select last (e.g. n_mods = 2) two compatible sites as subset from the set of all compatible sites
+    subset_mask_.assign(sites_.size(), false);
+    std::fill(subset_mask_.end() - n_mods, subset_mask_.end(), true);
+    startSubset_();
+    return true;
+  }
 
-    // end of recursion. Add the modified peptide and return
-    if (depth == (int)subset_indices.size())
+  void ModifiedPeptideGenerator::VariantEnumerator::startSubset_()
+  {
+    selected_.clear();
+    for (Size i = 0; i != subset_mask_.size(); ++i)
     {
-      modified_peptides.push_back(current_peptide);
-      return;
+      if (subset_mask_[i]) selected_.push_back(i);
     }
+    choices_.assign(selected_.size(), 0);
+    updateMass_();
+  }
 
-    // get modifications compatible to residue at current peptide position
-    const int current_index = subset_indices[depth];
+  void ModifiedPeptideGenerator::VariantEnumerator::updateMass_()
+  {
+    // few modifications per peptide: summing up is as cheap as (and more precise than) an incremental update
+    mass_delta_ = 0.0;
+    for (Size i = 0; i != selected_.size(); ++i)
+    {
+      mass_delta_ += sites_[selected_[i]].mass_deltas[choices_[i]];
+    }
+  }
+
+  double ModifiedPeptideGenerator::VariantEnumerator::getMonoWeight() const
+  {
+    // computed on first use: peptides with unknown residues ('X') have no mass, but can still be enumerated
+    if (base_mass_ < 0.0)
+    {
+      base_mass_ = peptide_.empty() ? 0.0 : peptide_.getMonoWeight();
+    }
+    return base_mass_ + mass_delta_;
+  }
 
-    map<int, vector<ResidueModification> >::const_iterator pos_mod_it = map_compatibility.find(current_index);
-    const vector<ResidueModification>& mods = pos_mod_it->second; // we don't need to check for .end as entry is guaranteed to exist
+  Size ModifiedPeptideGenerator::VariantEnumerator::getNumberOfModifications() const
+  {
+    return selected_.size();
+  }
 
-    for (vector<ResidueModification>::const_iterator mod_it = mods.begin(); mod_it != mods.end(); ++mod_it)
+  AASequence ModifiedPeptideGenerator::VariantEnumerator::getSequence() const
+  {
+    AASequence sequence = peptide_;
+    for (Size i = 0; i != selected_.size(); ++i)
     {
-      // copy peptide and apply modification
-      AASequence new_peptide = current_peptide;
-      if (current_index == C_TERM_MODIFICATION_INDEX)
+      const Site_& site = sites_[selected_[i]];
+      const String& name = site.mods[choices_[i]]->getFullName();
+      if (site.index == C_TERM_MODIFICATION_INDEX)
       {
-        new_peptide.setCTerminalModification(mod_it->getFullName());
+        sequence.setCTerminalModification(name);
       }
-      else if (current_index == N_TERM_MODIFICATION_INDEX)
+      else if (site.index == N_TERM_MODIFICATION_INDEX)
       {
-        new_peptide.setNTerminalModification(mod_it->getFullName());
+        sequence.setNTerminalModification(name);
       }
       else
       {
-        new_peptide.setModification(current_index, mod_it->getFullName());
+        sequence.setModification(site.index, name);
       }
-
-      // recurse with modified peptide
-      recurseAndGenerateVariableModifiedPeptides_(subset_indices, map_compatibility, depth + 1, new_peptide, modified_peptides);
     }
+    return sequence;
   }
 
   // static
-  void ModifiedPeptideGenerator::applyAtMostOneVariableModification_(const vector<ResidueModification>::const_iterator& var_mods_begin, const vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, vector<AASequence>& all_modified_peptides, bool keep_unmodified)
+  void ModifiedPeptideGenerator::getSingleModificationSites_(const vector<ResidueModification>::const_iterator& var_mods_begin, const vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, map<int, vector<const ResidueModification*> >& map_compatibility)
   {
-    if (keep_unmodified)
-    {
-      all_modified_peptides.push_back(peptide);
-    }
+    map_compatibility.clear();
 
-    // we want the same behavior as for the slower function... we would need a reverse iterator here that AASequence doesn't provide
-    for (AASequence::ConstIterator residue_it = peptide.end() - 1; residue_it != peptide.begin() - 1; --residue_it)
+    for (AASequence::ConstIterator residue_it = peptide.begin(); residue_it != peptide.end(); ++residue_it)
     {
       // skip already modified residues
       if (residue_it->isModified())
@@ -319,29 +384,15 @@ namespace OpenMS
         {
           continue;
         }
-        bool is_compatible = false;
 
         // Term specificity is ANYWHERE on the peptide, C_TERM or N_TERM (currently no explicit support in OpenMS for protein C-term and protein N-term)
+        // All of them are placed at the residue.
         const ResidueModification::TermSpecificity& term_spec = variable_it->getTermSpecificity();
-        if (term_spec == ResidueModification::ANYWHERE)
-        {
-          is_compatible = true;
-        }
-        else if (term_spec == ResidueModification::C_TERM && residue_index == (peptide.size() - 1))
-        {
-          is_compatible = true;
-        }
-        else if (term_spec == ResidueModification::N_TERM && residue_index == 0)
-        {
-          is_compatible = true;
-        }
-
-        // residue modification an be placed at current position? Then generate modified peptide.
-        if (is_compatible)
+        if ((term_spec == ResidueModification::ANYWHERE) ||
+            (term_spec == ResidueModification::C_TERM && residue_index == (peptide.size() - 1)) ||
+            (term_spec == ResidueModification::N_TERM && residue_index == 0))
         {
-          AASequence new_peptide = peptide;
-          new_peptide.setModification(residue_index, variable_it->getFullName());
-          all_modified_peptides.push_back(new_peptide);
+          map_compatibility[static_cast<int>(residue_index)].push_back(&(*variable_it));
         }
       }
     }
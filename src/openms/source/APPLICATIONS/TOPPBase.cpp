@@ -35,6 +35,7 @@
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
 #include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/PerformanceTrace.h>
 #include <OpenMS/SYSTEM/StopWatch.h>
 #include <OpenMS/SYSTEM/SysInfo.h>
 #include <OpenMS/SYSTEM/UpdateCheck.h>
@@ -164,6 +165,7 @@ namespace OpenMS
     registerIntOption_("threads", "<n>", 1, "Sets the number of threads allowed to be used by the TOPP tool", false);
     registerStringOption_("write_ini", "<file>", "", "Writes the default configuration file", false);
     registerStringOption_("write_ctd", "<out_dir>", "", "Writes the common tool description file(s) (Toolname(s).ctd) to <out_dir>", false, true);
+    registerStringOption_("trace_out", "<file>", "", "Writes timing and memory usage of the processing stages to <file> (Chrome trace event JSON, see chrome://tracing)", false, true);
     registerFlag_("no_progress", "Disables progress logging to command line", true);
     registerFlag_("force", "Overwrite tool specific checks.", true);
     registerFlag_("test", "Enables the test mode (needed for internal use only)", true);
@@ -433,10 +435,31 @@ namespace OpenMS
     //----------------------------------------------------------
     //main
     //----------------------------------------------------------
+    String trace_out;
+    if (param_cmdline_.exists("trace_out"))
+    {
+      trace_out = param_cmdline_.getValue("trace_out");
+    }
+    if (!trace_out.empty())
+    {
+      outputFileWritable_(trace_out, "trace_out");
+      PerformanceTrace::setEnabled(true);
+    }
+
     StopWatch sw;
     sw.start();
-    result = main_(argc, argv);
+    {
+      PerformanceTrace::Scope trace_main(tool_name_.c_str(), "TOPP");
+      result = main_(argc, argv);
+    }
     sw.stop();
+
+    if (!trace_out.empty())
+    {
+      PerformanceTrace::store(trace_out);
+      PerformanceTrace::setEnabled(false);
+      writeDebug_("Performance trace written to '" + trace_out + "'", 1);
+    }
     LOG_INFO << this->tool_name_ << " took " << sw.toString() << "." << std::endl;
 
     // useful for benchmarking
@@ -1991,7 +2014,7 @@ namespace OpenMS
     //parameters
     for (vector<ParameterInformation>::const_iterator it = parameters_.begin(); it != parameters_.end(); ++it)
     {
-      if (it->name == "ini" || it->name == "-help" || it->name == "-helphelp" || it->name == "instance" || it->name == "write_ini" || it->name == "write_ctd") // do not store those params in ini file
+      if (it->name == "ini" || it->name == "-help" || it->name == "-helphelp" || it->name == "instance" || it->name == "write_ini" || it->name == "write_ctd" || it->name == "trace_out") // do not store those params in ini file
       {
         continue;
       }
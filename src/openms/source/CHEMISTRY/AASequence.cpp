@@ -42,20 +42,29 @@
 #include <OpenMS/CONCEPT/Macros.h>
 #include <OpenMS/CONCEPT/PrecisionWrapper.h>
 
+#include <boost/unordered_map.hpp>
+
+#include <cmath>
+#include <limits>
+
 using namespace std;
 
 namespace OpenMS
 {
   AASequence::AASequence() :
     n_term_mod_(nullptr),
-    c_term_mod_(nullptr)
+    c_term_mod_(nullptr),
+    residue_mono_weight_(std::numeric_limits<double>::quiet_NaN()),
+    residue_formula_()
   {
   }
 
   AASequence::AASequence(const AASequence& rhs) :
     peptide_(rhs.peptide_),
     n_term_mod_(rhs.n_term_mod_),
-    c_term_mod_(rhs.c_term_mod_)
+    c_term_mod_(rhs.c_term_mod_),
+    residue_mono_weight_(rhs.residue_mono_weight_.load(std::memory_order_relaxed)),
+    residue_formula_(std::atomic_load(&rhs.residue_formula_))
   {
   }
 
@@ -70,10 +79,18 @@ namespace OpenMS
       peptide_ = rhs.peptide_;
       n_term_mod_ = rhs.n_term_mod_;
       c_term_mod_ = rhs.c_term_mod_;
+      residue_mono_weight_.store(rhs.residue_mono_weight_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      std::atomic_store(&residue_formula_, std::atomic_load(&rhs.residue_formula_));
     }
     return *this;
   }
 
+  void AASequence::resetMemo_()
+  {
+    residue_mono_weight_.store(std::numeric_limits<double>::quiet_NaN(), std::memory_order_relaxed);
+    std::atomic_store(&residue_formula_, std::shared_ptr<const EmpiricalFormula>());
+  }
+
   const Residue& AASequence::getResidue(Size index) const
   {
     if (index >= peptide_.size())
@@ -322,15 +339,24 @@ namespace OpenMS
         ef += c_term_mod_->getDiffFormula();
       }
 
-      static auto const rx = ResidueDB::getInstance()->getResidue("X");
-      for (auto const& e : peptide_)
+      // the residue sum does not depend on type and charge, compute it only once
+      std::shared_ptr<const EmpiricalFormula> residue_formula = std::atomic_load(&residue_formula_);
+      if (!residue_formula)
       {
-        // While PEPTIX[123]DE makes sense and represents an unknown mass of 123.0
-        // Da, the sequence PEPTIXDE does not make sense as it is unclear what a
-        // standard internal residue including named modifications
-        if (e == rx) throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Cannot get EF of sequence with unknown AA 'X'.", toString());
-        ef += e->getFormula(Residue::Internal);
+        EmpiricalFormula residue_sum;
+        static auto const rx = ResidueDB::getInstance()->getResidue("X");
+        for (auto const& e : peptide_)
+        {
+          // While PEPTIX[123]DE makes sense and represents an unknown mass of 123.0
+          // Da, the sequence PEPTIXDE does not make sense as it is unclear what a
+          // standard internal residue including named modifications
+          if (e == rx) throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Cannot get EF of sequence with unknown AA 'X'.", toString());
+          residue_sum += e->getFormula(Residue::Internal);
+        }
+        residue_formula = std::make_shared<const EmpiricalFormula>(residue_sum);
+        std::atomic_store(&residue_formula_, residue_formula);
       }
+      ef += *residue_formula;
  
       // add the missing formula part
       switch (type)
@@ -420,16 +446,26 @@ namespace OpenMS
       {
         mono_weight += c_term_mod_->getDiffMonoMass();
       }
-      static auto const rx = ResidueDB::getInstance()->getResidue("X");
-      for (auto const& e : peptide_)
+
+      // the residue sum does not depend on type and charge, compute it only once
+      // (concurrent callers may both compute it, but store the same value)
+      double residue_weight = residue_mono_weight_.load(std::memory_order_relaxed);
+      if (std::isnan(residue_weight))
       {
-        // While PEPTIX[123]DE makes sense and represents an unknown mass of 123.0
-        // Da, the sequence PEPTIXDE does not make sense as it is unclear what a
-        // standard internal residue including named modifications
-        if (e == rx) throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Cannot get weight of sequence with unknown AA 'X' with unknown mass.", toString());
-        // single, unknown residue should represent.
-        mono_weight += e->getMonoWeight(Residue::Internal);
+        residue_weight = 0.0;
+        static auto const rx = ResidueDB::getInstance()->getResidue("X");
+        for (auto const& e : peptide_)
+        {
+          // While PEPTIX[123]DE makes sense and represents an unknown mass of 123.0
+          // Da, the sequence PEPTIXDE does not make sense as it is unclear what a
+          // standard internal residue including named modifications
+          if (e == rx) throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Cannot get weight of sequence with unknown AA 'X' with unknown mass.", toString());
+          // single, unknown residue should represent.
+          residue_weight += e->getMonoWeight(Residue::Internal);
+        }
+        residue_mono_weight_.store(residue_weight, std::memory_order_relaxed);
       }
+      mono_weight += residue_weight;
 
       // add the missing formula part
       switch (type)
@@ -539,6 +575,7 @@ namespace OpenMS
     {
       peptide_.push_back(sequence.peptide_[i]);
     }
+    resetMemo_();
     return *this;
   }
 
@@ -571,6 +608,7 @@ namespace OpenMS
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "given residue");
     }
     peptide_.push_back(residue);
+    resetMemo_();
     return *this;
   }
 
@@ -1218,6 +1256,7 @@ namespace OpenMS
                                 bool permissive)
   {
     aas.peptide_.clear();
+    aas.resetMemo_();
     String peptide(pep);
     peptide.trim();
 
@@ -1348,6 +1387,7 @@ namespace OpenMS
     {
       peptide_[index] = ResidueDB::getInstance()->getResidue(peptide_[index]->getOneLetterCode());
     }
+    resetMemo_();
   }
 
   void AASequence::setNTerminalModification(const String& modification)
@@ -1406,15 +1446,49 @@ namespace OpenMS
   AASequence AASequence::fromString(const String& s, bool permissive)
   {
     AASequence aas;
+
+    // unmodified sequences are parsed quickly, only modifications require
+    // (expensive) look-ups in the ModificationsDB and are worth caching
+    if (s.find_first_of("([") == String::npos)
+    {
+      parseString_(s, aas, permissive);
+      return aas;
+    }
+
+    // separate caches for permissive and strict parsing, bounded in size
+    static const Size max_cache_size = 100000;
+    static boost::unordered_map<String, AASequence> parse_cache[2];
+    boost::unordered_map<String, AASequence>& cache = parse_cache[permissive ? 1 : 0];
+
+    bool found(false);
+#ifdef _OPENMP
+#pragma omp critical (AASequence_parse_cache)
+#endif
+    {
+      boost::unordered_map<String, AASequence>::const_iterator it = cache.find(s);
+      if (it != cache.end())
+      {
+        aas = it->second;
+        found = true;
+      }
+    }
+    if (found) return aas;
+
     parseString_(s, aas, permissive);
+
+#ifdef _OPENMP
+#pragma omp critical (AASequence_parse_cache)
+#endif
+    {
+      if (cache.size() >= max_cache_size) cache.clear();
+      cache.insert(std::make_pair(s, aas));
+    }
     return aas;
   }
 
   AASequence AASequence::fromString(const char* s, bool permissive)
   {
-    AASequence aas;
-    parseString_(String(s), aas, permissive);
-    return aas;
+    return fromString(String(s), permissive);
   }
 
 }
@@ -35,12 +35,19 @@
 
 #include <OpenMS/CHEMISTRY/Element.h>
 
+#include <atomic>
 #include <ostream>
 
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    // see Element::getIsotopeDistributionVersion()
+    std::atomic<Size> isotope_distribution_version(0);
+  }
+
   Element::Element() :
     name_(OPENMS_CHEMISTRY_ELEMENT_NAME_DEFAULT),
     symbol_(OPENMS_CHEMISTRY_ELEMENT_SYMBOL_DEFAULT),
@@ -112,6 +119,13 @@ namespace OpenMS
   void Element::setIsotopeDistribution(const IsotopeDistribution & distribution)
   {
     isotopes_ = distribution;
+    // cached isotope patterns might contain this element
+    ++isotope_distribution_version;
+  }
+
+  Size Element::getIsotopeDistributionVersion()
+  {
+    return isotope_distribution_version.load();
   }
 
   const IsotopeDistribution & Element::getIsotopeDistribution() const
@@ -44,12 +44,149 @@ namespace OpenMS
   const std::string EnzymaticDigestion::NamesOfSpecificity[] = {"full", "semi", "none"};
   const std::string EnzymaticDigestion::UnspecificCleavage = "unspecific cleavage";
 
+  namespace
+  {
+    // parses a single character or a character class ("[KR]", "[^P]", "[A-Z]") starting at @p pos
+    bool parseCharacterClass(const String& regex, Size& pos, std::bitset<256>& chars)
+    {
+      chars.reset();
+      if (pos >= regex.size()) return false;
+      if (regex[pos] != '[')
+      {
+        if (String("()[]{}|.*+?^$\\").has(regex[pos])) return false;
+        chars.set((unsigned char)regex[pos++]);
+        return true;
+      }
+      ++pos;
+      bool negate = (pos < regex.size() && regex[pos] == '^');
+      if (negate) ++pos;
+      bool empty = true;
+      while (pos < regex.size() && (regex[pos] != ']' || empty))
+      {
+        unsigned char first = regex[pos], last = first;
+        if (first == '\\' || first == '[') return false;
+        if (pos + 2 < regex.size() && regex[pos + 1] == '-' && regex[pos + 2] != ']')
+        {
+          last = regex[pos + 2];
+          pos += 2;
+        }
+        if (last < first) return false;
+        for (unsigned c = first; c <= last; ++c) chars.set(c);
+        ++pos;
+        empty = false;
+      }
+      if (pos >= regex.size()) return false; // missing ']'
+      ++pos;
+      if (negate) chars.flip();
+      return true;
+    }
+  }
+
+  EnzymaticDigestion::CleavageRule_::Alternative::Alternative() :
+    has_lookbehind(false),
+    has_lookahead(false),
+    has_negative_lookahead(false)
+  {
+  }
+
+  bool EnzymaticDigestion::CleavageRule_::compile(const String& regex)
+  {
+    alternatives.clear();
+
+    // split into top-level alternatives
+    std::vector<String> parts(1);
+    int depth = 0;
+    bool in_class = false;
+    for (Size i = 0; i < regex.size(); ++i)
+    {
+      char c = regex[i];
+      if (in_class) in_class = (c != ']');
+      else if (c == '[') in_class = true;
+      else if (c == '(') ++depth;
+      else if (c == ')') --depth;
+      else if (c == '|' && depth == 0)
+      {
+        parts.push_back(String());
+        continue;
+      }
+      parts.back() += c;
+    }
+
+    for (std::vector<String>::iterator it = parts.begin(); it != parts.end(); ++it)
+    {
+      String& part = *it;
+      // remove capturing groups around the alternative, e.g. "((?<=D))"
+      while (part.size() > 2 && part.hasPrefix("(") && !part.hasPrefix("(?") && part.hasSuffix(")"))
+      {
+        part = part.substr(1, part.size() - 2);
+      }
+      if (part.empty())
+      {
+        alternatives.clear();
+        return false; // would match everywhere
+      }
+
+      Alternative alt;
+      Size pos = 0;
+      while (pos < part.size())
+      {
+        bool* has = nullptr;
+        std::bitset<256>* chars = nullptr;
+        if (part.substr(pos, 4) == "(?<=")
+        {
+          has = &alt.has_lookbehind;
+          chars = &alt.lookbehind;
+          pos += 4;
+        }
+        else if (part.substr(pos, 3) == "(?=")
+        {
+          has = &alt.has_lookahead;
+          chars = &alt.lookahead;
+          pos += 3;
+        }
+        else if (part.substr(pos, 3) == "(?!")
+        {
+          has = &alt.has_negative_lookahead;
+          chars = &alt.negative_lookahead;
+          pos += 3;
+        }
+        // only one assertion of each kind, consisting of a single character (class)
+        if (has == nullptr || *has || !parseCharacterClass(part, pos, *chars) ||
+            pos >= part.size() || part[pos] != ')')
+        {
+          alternatives.clear();
+          return false;
+        }
+        *has = true;
+        ++pos;
+      }
+      alternatives.push_back(alt);
+    }
+    return true;
+  }
+
+  bool EnzymaticDigestion::CleavageRule_::isCleavageSite(const char* begin, const char* pos, const char* end) const
+  {
+    for (std::vector<Alternative>::const_iterator it = alternatives.begin(); it != alternatives.end(); ++it)
+    {
+      // look-arounds cannot see beyond the range (same as for the regex)
+      if (it->has_lookbehind && (pos == begin || !it->lookbehind.test((unsigned char)*(pos - 1)))) continue;
+      if (it->has_lookahead && (pos == end || !it->lookahead.test((unsigned char)*pos))) continue;
+      if (it->has_negative_lookahead && pos != end && it->negative_lookahead.test((unsigned char)*pos)) continue;
+      return true;
+    }
+    return false;
+  }
+
   EnzymaticDigestion::EnzymaticDigestion() :
     missed_cleavages_(0),
     enzyme_(ProteaseDB::getInstance()->getEnzyme("Trypsin")), // @TODO: keep trypsin as default?
-    re_(enzyme_->getRegEx()),
+    re_(),
+    rule_(),
+    use_rule_(false),
     specificity_(SPEC_FULL)
   {
+    compileCleavageRule_();
   }
 
   EnzymaticDigestion::~EnzymaticDigestion()
@@ -69,7 +206,14 @@ namespace OpenMS
   void EnzymaticDigestion::setEnzyme(const DigestionEnzyme* enzyme)
   {
     enzyme_ = enzyme;
-    re_ = boost::regex(enzyme_->getRegEx());
+    compileCleavageRule_();
+  }
+
+  void EnzymaticDigestion::compileCleavageRule_()
+  {
+    // the common (single residue) rules are evaluated directly, the regex is only needed for the rest
+    use_rule_ = rule_.compile(enzyme_->getRegEx());
+    re_ = use_rule_ ? boost::regex() : boost::regex(enzyme_->getRegEx());
   }
 
   String EnzymaticDigestion::getEnzymeName() const
@@ -103,7 +247,26 @@ namespace OpenMS
     start = std::max(0, start);
     if (end < 0 || end > (int)sequence.size()) end = (int)sequence.size();
 
-    if (enzyme_->getRegEx() != "()") // if it's not "no cleavage"
+    if (enzyme_->getRegEx() == "()") // "no cleavage"
+    {
+      positions.push_back(start);
+    }
+    else if (use_rule_)
+    {
+      // same result as the regex below: a site at 'start' (only possible with a look-ahead) is reported twice,
+      // the end of the range is never reported
+      if (start < end)
+      {
+        const char* begin = sequence.c_str() + start;
+        const char* stop = sequence.c_str() + end;
+        positions.push_back(start);
+        for (const char* pos = begin; pos != stop; ++pos)
+        {
+          if (rule_.isCleavageSite(begin, pos, stop)) positions.push_back(int(pos - sequence.c_str()));
+        }
+      }
+    }
+    else
     {
       boost::sregex_token_iterator i(sequence.begin() + start, sequence.begin() + end, re_, -1);
       boost::sregex_token_iterator j;
@@ -114,10 +277,6 @@ namespace OpenMS
         ++i;
       }
     }
-    else
-    {
-      positions.push_back(start);
-    }
     return positions;
   }
 
@@ -0,0 +1,422 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CHEMISTRY/IsotopePatternGenerator.h>
+
+#include <OpenMS/CHEMISTRY/Element.h>
+#include <OpenMS/CHEMISTRY/ElementDB.h>
+#include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    // average elemental composition (C, H, N, O, S, P) of the averagine models
+    bool getAveragineComposition(const String& type, double composition[6])
+    {
+      static const double peptide[6] = {4.9384, 7.7583, 1.3577, 1.4773, 0.0417, 0};
+      static const double rna[6] = {9.75, 12.25, 3.75, 7, 0, 1};
+      static const double dna[6] = {9.75, 12.25, 3.75, 6, 0, 1};
+
+      const double* source;
+      if (type == "peptide")
+      {
+        source = peptide;
+      }
+      else if (type == "RNA")
+      {
+        source = rna;
+      }
+      else if (type == "DNA")
+      {
+        source = dna;
+      }
+      else
+      {
+        return false;
+      }
+      std::copy(source, source + 6, composition);
+      return true;
+    }
+
+    // logarithm of the binomial probability P(X = k) with X ~ B(n, q)
+    double logBinomial(SignedSize n, SignedSize k, double log_q, double log_1mq)
+    {
+      return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0) + k * log_q + (n - k) * log_1mq;
+    }
+  }
+
+  const Size IsotopePatternGenerator::MAX_CACHE_SIZE = 100000;
+
+  IsotopePatternGenerator::IsotopePatternGenerator(double probability_threshold) :
+    probability_threshold_(probability_threshold),
+    cache_version_(Element::getIsotopeDistributionVersion())
+  {
+  }
+
+  IsotopePatternGenerator::~IsotopePatternGenerator()
+  {
+  }
+
+  IsotopePatternGenerator* IsotopePatternGenerator::getInstance()
+  {
+    static IsotopePatternGenerator instance;
+    return &instance;
+  }
+
+  double IsotopePatternGenerator::getProbabilityThreshold() const
+  {
+    return probability_threshold_;
+  }
+
+  IsotopePatternGenerator::FineStructure IsotopePatternGenerator::getFineStructure(const EmpiricalFormula& formula, double resolution) const
+  {
+    const std::pair<String, double> key(formula.toString(), resolution);
+    bool found = false;
+    FineStructure result;
+#ifdef _OPENMP
+#pragma omp critical (IsotopePatternGenerator_cache)
+#endif
+    {
+      validateCache_();
+      std::map<std::pair<String, double>, FineStructure>::const_iterator it = fine_cache_.find(key);
+      if (it != fine_cache_.end())
+      {
+        result = it->second;
+        found = true;
+      }
+    }
+    if (found) return result;
+
+    computeFineStructure_(formula, resolution, result);
+
+#ifdef _OPENMP
+#pragma omp critical (IsotopePatternGenerator_cache)
+#endif
+    {
+      validateCache_();
+      if (fine_cache_.size() >= MAX_CACHE_SIZE) fine_cache_.clear();
+      fine_cache_.insert(std::make_pair(key, result));
+    }
+
+    return result;
+  }
+
+  IsotopeDistribution IsotopePatternGenerator::getCoarseDistribution(const EmpiricalFormula& formula, Size max_isotope) const
+  {
+    const std::pair<String, Size> key(formula.toString(), max_isotope);
+    bool found = false;
+    IsotopeDistribution result;
+#ifdef _OPENMP
+#pragma omp critical (IsotopePatternGenerator_cache)
+#endif
+    {
+      validateCache_();
+      std::map<std::pair<String, Size>, IsotopeDistribution>::const_iterator it = coarse_cache_.find(key);
+      if (it != coarse_cache_.end())
+      {
+        result = it->second;
+        found = true;
+      }
+    }
+    if (found) return result;
+
+    result = formula.getIsotopeDistribution((UInt)max_isotope);
+
+#ifdef _OPENMP
+#pragma omp critical (IsotopePatternGenerator_cache)
+#endif
+    {
+      validateCache_();
+      if (coarse_cache_.size() >= MAX_CACHE_SIZE) coarse_cache_.clear();
+      coarse_cache_.insert(std::make_pair(key, result));
+    }
+
+    return result;
+  }
+
+  IsotopeDistribution IsotopePatternGenerator::getAveragineDistribution(double average_weight, Size max_isotope, const String& type) const
+  {
+    return getCoarseDistribution(getAveragineFormula(average_weight, type), max_isotope);
+  }
+
+  std::vector<IsotopeDistribution> IsotopePatternGenerator::getAveragineDistributions(const std::vector<double>& average_weights, Size max_isotope, const String& type) const
+  {
+    double composition[6];
+    if (!getAveragineComposition(type, composition))
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Averagine type unrecognized.");
+    }
+
+    std::vector<IsotopeDistribution> result(average_weights.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)average_weights.size(); ++i)
+    {
+      result[i] = getAveragineDistribution(average_weights[i], max_isotope, type);
+    }
+    return result;
+  }
+
+  std::vector<IsotopeDistribution> IsotopePatternGenerator::getAveragineDistributions(double weight_min, double weight_max, double weight_step, Size max_isotope, const String& type) const
+  {
+    if (weight_step <= 0 || weight_max < weight_min)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Invalid weight range or step size.");
+    }
+
+    std::vector<double> average_weights;
+    Size count = (Size)std::floor((weight_max - weight_min) / weight_step + 1e-9) + 1;
+    average_weights.reserve(count);
+    for (Size i = 0; i < count; ++i)
+    {
+      average_weights.push_back(weight_min + i * weight_step);
+    }
+    return getAveragineDistributions(average_weights, max_isotope, type);
+  }
+
+  Size IsotopePatternGenerator::getCacheSize() const
+  {
+    Size size = 0;
+#ifdef _OPENMP
+#pragma omp critical (IsotopePatternGenerator_cache)
+#endif
+    {
+      validateCache_();
+      size = fine_cache_.size() + coarse_cache_.size();
+    }
+    return size;
+  }
+
+  void IsotopePatternGenerator::clearCache()
+  {
+#ifdef _OPENMP
+#pragma omp critical (IsotopePatternGenerator_cache)
+#endif
+    {
+      fine_cache_.clear();
+      coarse_cache_.clear();
+    }
+  }
+
+  void IsotopePatternGenerator::validateCache_() const
+  {
+    // cached patterns depend on the isotope abundances of the elements
+    const Size version = Element::getIsotopeDistributionVersion();
+    if (version != cache_version_)
+    {
+      fine_cache_.clear();
+      coarse_cache_.clear();
+      cache_version_ = version;
+    }
+  }
+
+  EmpiricalFormula IsotopePatternGenerator::getAveragineFormula(double average_weight, const String& type)
+  {
+    double composition[6];
+    if (!getAveragineComposition(type, composition))
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Averagine type unrecognized.");
+    }
+
+    EmpiricalFormula formula;
+    formula.estimateFromWeightAndComp(average_weight, composition[0], composition[1], composition[2], composition[3], composition[4], composition[5]);
+    return formula;
+  }
+
+  void IsotopePatternGenerator::computeElementPattern_(const Element* element, SignedSize count, ElementPattern_& result) const
+  {
+    result.clear();
+
+    // isotopes with non-zero abundance and their exact masses
+    std::vector<double> masses, abundances;
+    const IsotopeDistribution::ContainerType& isotopes = element->getIsotopeDistribution().getContainer();
+    for (IsotopeDistribution::ContainerType::const_iterator it = isotopes.begin(); it != isotopes.end(); ++it)
+    {
+      if (it->second <= 0) continue;
+
+      double mass;
+      String isotope_symbol = "(" + String(it->first) + ")" + element->getSymbol();
+      if (isotopes.size() == 1)
+      {
+        // single isotope (e.g. a specific isotope like "(13)C")
+        mass = element->getMonoWeight();
+      }
+      else if (ElementDB::getInstance()->hasElement(isotope_symbol))
+      {
+        mass = ElementDB::getInstance()->getElement(isotope_symbol)->getMonoWeight();
+      }
+      else
+      {
+        // no exact mass available: approximate by the nominal offset to the lightest isotope
+        mass = element->getMonoWeight() + (double(it->first) - double(isotopes.front().first)) * Constants::C13C12_MASSDIFF_U;
+      }
+      masses.push_back(mass);
+      abundances.push_back(it->second);
+    }
+
+    if (count == 0 || masses.empty())
+    {
+      result.push_back(std::make_pair(0.0, 1.0));
+      return;
+    }
+
+    // The multinomial distribution of the isotope counts is factorised into conditional binomials:
+    // k_0 ~ B(n, q_0), k_1 ~ B(n - k_0, q_1), ... with q_j = p_j / (p_j + ... + p_last).
+    // Each factor is <= 1, so a partial product below the threshold can be pruned.
+    std::vector<double> tail(abundances.size() + 1, 0.0);
+    for (SignedSize j = (SignedSize)abundances.size() - 1; j >= 0; --j)
+    {
+      tail[j] = tail[j + 1] + abundances[j];
+    }
+
+    const double log_threshold = std::log(probability_threshold_);
+
+    // explicit stack of (isotope index, remaining atoms, log probability, mass)
+    struct State
+    {
+      Size isotope;
+      SignedSize remaining;
+      double log_probability;
+      double mass;
+    };
+    std::vector<State> stack;
+    State start = {0, count, 0.0, 0.0};
+    stack.push_back(start);
+
+    while (!stack.empty())
+    {
+      State state = stack.back();
+      stack.pop_back();
+
+      // the last isotope takes all remaining atoms
+      if (state.isotope + 1 == masses.size() || state.remaining == 0)
+      {
+        result.push_back(std::make_pair(state.mass + state.remaining * masses[state.isotope], std::exp(state.log_probability)));
+        continue;
+      }
+
+      const double q = abundances[state.isotope] / tail[state.isotope];
+      const double log_q = std::log(q);
+      const double log_1mq = std::log1p(-q);
+      const SignedSize n = state.remaining;
+      const SignedSize mode = std::min(n, (SignedSize)std::floor((n + 1) * q));
+
+      // the binomial is unimodal: walk from the mode in both directions until the threshold is reached
+      for (SignedSize k = mode; k <= n; ++k)
+      {
+        double log_p = state.log_probability + logBinomial(n, k, log_q, log_1mq);
+        if (log_p < log_threshold) break;
+        State next = {state.isotope + 1, n - k, log_p, state.mass + k * masses[state.isotope]};
+        stack.push_back(next);
+      }
+      for (SignedSize k = mode - 1; k >= 0; --k)
+      {
+        double log_p = state.log_probability + logBinomial(n, k, log_q, log_1mq);
+        if (log_p < log_threshold) break;
+        State next = {state.isotope + 1, n - k, log_p, state.mass + k * masses[state.isotope]};
+        stack.push_back(next);
+      }
+    }
+  }
+
+  void IsotopePatternGenerator::computeFineStructure_(const EmpiricalFormula& formula, double resolution, FineStructure& result) const
+  {
+    result.clear();
+    result.push_back(std::make_pair(0.0, 1.0));
+
+    ElementPattern_ element_pattern;
+    FineStructure combined;
+    for (EmpiricalFormula::ConstIterator it = formula.begin(); it != formula.end(); ++it)
+    {
+      if (it->second < 0)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Negative element count in formula '" + formula.toString() + "'.");
+      }
+      computeElementPattern_(it->first, it->second, element_pattern);
+
+      // combine with the pattern of the previous elements (products below the threshold are discarded)
+      combined.clear();
+      for (FineStructure::const_iterator a = result.begin(); a != result.end(); ++a)
+      {
+        for (ElementPattern_::const_iterator b = element_pattern.begin(); b != element_pattern.end(); ++b)
+        {
+          double probability = a->second * b->second;
+          if (probability >= probability_threshold_)
+          {
+            combined.push_back(std::make_pair(a->first + b->first, probability));
+          }
+        }
+      }
+      result.swap(combined);
+    }
+
+    std::sort(result.begin(), result.end());
+
+    // merge isotopologues which are not resolved
+    if (resolution > 0 && !result.empty())
+    {
+      FineStructure merged;
+      double weighted_mass = result[0].first * result[0].second;
+      double probability = result[0].second;
+      double last_mass = result[0].first;
+      for (Size i = 1; i < result.size(); ++i)
+      {
+        if (result[i].first - last_mass < resolution)
+        {
+          weighted_mass += result[i].first * result[i].second;
+          probability += result[i].second;
+        }
+        else
+        {
+          merged.push_back(std::make_pair(weighted_mass / probability, probability));
+          weighted_mass = result[i].first * result[i].second;
+          probability = result[i].second;
+        }
+        last_mass = result[i].first;
+      }
+      merged.push_back(std::make_pair(weighted_mass / probability, probability));
+      result.swap(merged);
+    }
+  }
+
+} // namespace OpenMS
@@ -36,7 +36,6 @@
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/CONCEPT/LogStream.h>
-#include <boost/regex.hpp>
 
 #include <iostream>
 #include <limits>
@@ -47,8 +46,7 @@ namespace OpenMS
 {
   void ProteaseDigestion::setEnzyme(const String& enzyme_name)
   {
-    enzyme_ = ProteaseDB::getInstance()->getEnzyme(enzyme_name);
-    re_ = boost::regex(enzyme_->getRegEx());
+    EnzymaticDigestion::setEnzyme(ProteaseDB::getInstance()->getEnzyme(enzyme_name));
   }
 
   bool ProteaseDigestion::isValidProduct(const String& protein,
@@ -41,7 +41,7 @@ namespace OpenMS
 {
   void RNaseDigestion::setEnzyme(const String& enzyme_name)
   {
-    enzyme_ = RNaseDB::getInstance()->getEnzyme(enzyme_name);
+    EnzymaticDigestion::setEnzyme(RNaseDB::getInstance()->getEnzyme(enzyme_name));
   }
 
   void RNaseDigestion::digest(const String& rna, vector<String>& output,
@@ -162,6 +162,16 @@ namespace OpenMS
           residue_mod_names_[*it][*mod_it] = r;
         }
       }
+
+      if (!r->getOneLetterCode().empty())
+      {
+        boost::unordered_map<String, const Residue*>& lookup = modified_residue_by_one_letter_code_[(unsigned char)r->getOneLetterCode()[0]];
+        for (vector<String>::const_iterator mod_it = mod_names.begin(); mod_it != mod_names.end(); ++mod_it)
+        {
+          if (!mod_it->empty()) lookup[*mod_it] = r;
+        }
+      }
+      return; // modified residues do not change the residue names
     }
     buildResidueNames_();
     return;
@@ -255,6 +265,12 @@ namespace OpenMS
     residues_.clear();
     residue_names_.clear();
     const_residues_.clear();
+
+    // modified residues refer to the (deleted) residues by name
+    for (Size i = 0; i != sizeof(modified_residue_by_one_letter_code_)/sizeof(modified_residue_by_one_letter_code_[0]); ++i)
+    {
+      modified_residue_by_one_letter_code_[i].clear();
+    }
   }
 
   Residue* ResidueDB::parseResidue_(Map<String, String>& values)
@@ -460,6 +476,17 @@ namespace OpenMS
   const Residue* ResidueDB::getModifiedResidue(const Residue* residue, const String& modification)
   {
     OPENMS_PRECONDITION(!modification.empty(), "Modification cannot be empty")
+    // fast path for modified residues that exist already: no modification to resolve, no string copies
+    if (!residue->getOneLetterCode().empty())
+    {
+      const boost::unordered_map<String, const Residue*>& lookup = modified_residue_by_one_letter_code_[(unsigned char)residue->getOneLetterCode()[0]];
+      boost::unordered_map<String, const Residue*>::const_iterator it = lookup.find(modification);
+      if (it != lookup.end() && it->second->getName() == residue->getName())
+      {
+        return it->second;
+      }
+    }
+
     // search if the mod already exists
     String res_name = residue->getName();
 
@@ -489,4 +516,28 @@ namespace OpenMS
     return res;
   }
 
+  void ResidueDB::registerModifications(const vector<String>& modifications)
+  {
+    ModificationsDB* mod_db = ModificationsDB::getInstance();
+    for (vector<String>::const_iterator it = modifications.begin(); it != modifications.end(); ++it)
+    {
+      const ResidueModification& mod = mod_db->getModification(*it);
+      char origin = mod.getOrigin();
+      for (set<const Residue*>::const_iterator res_it = const_residues_.begin(); res_it != const_residues_.end(); ++res_it)
+      {
+        const Residue* residue = *res_it;
+        if (residue->isModified() || residue->getOneLetterCode().empty() || ((origin != 'X') && (residue->getOneLetterCode()[0] != origin))) continue;
+        try
+        {
+          // same call as done later (e.g. by AASequence::setModification) creates the entries for the fast lookup
+          getModifiedResidue(residue, *it);
+        }
+        catch (Exception::BaseException&)
+        {
+          // modification does not apply to this residue (e.g. terminal modification), fails later as it would have without registration
+        }
+      }
+    }
+  }
+
 }
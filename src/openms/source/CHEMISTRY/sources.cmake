@@ -15,6 +15,7 @@ DigestionEnzymeProtein.cpp
 DigestionEnzymeRNA.cpp
 DigestionEnzymeDB.cpp
 IsotopeDistribution.cpp
+IsotopePatternGenerator.cpp
 ModificationDefinition.cpp
 ModificationDefinitionsSet.cpp
 ModificationsDB.cpp
@@ -125,11 +125,14 @@ namespace OpenMS
         //update original_distance matrix
         //average linkage: new distance between clusters is the minimum distance between elements of each cluster
         //lance-williams update for d((i,j),k): (m_i/m_i+m_j)* d(i,k) + (m_j/m_i+m_j)* d(j,k) ; m_x is the number of elements in cluster x
+        // (rows are contiguous, columns below min.second can be scanned with unit stride)
+        const float* row_i = original_distance.getRow(min.first);
+        float* row_j = original_distance.getRow(min.second);
         for (Size k = 0; k < min.second; ++k)
         {
-          float dik = original_distance.getValue(min.first, k);
-          float djk = original_distance.getValue(min.second, k);
-          original_distance.setValueQuick(min.second, k, (alpha_i * dik + alpha_j * djk));
+          float dik = row_i[k];
+          float djk = row_j[k];
+          row_j[k] = (alpha_i * dik + alpha_j * djk);
         }
         for (Size k = min.second + 1; k < original_distance.dimensionsize(); ++k)
         {
@@ -121,11 +121,14 @@ namespace OpenMS
         //update original_distance matrix
         //complete linkage: new distance between clusters is the minimum distance between elements of each cluster
         //lance-williams update for d((i,j),k): 0.5* d(i,k) + 0.5* d(j,k) + 0.5* |d(i,k)-d(j,k)|
+        // (rows are contiguous, columns below min.second can be scanned with unit stride)
+        const float* row_i = original_distance.getRow(min.first);
+        float* row_j = original_distance.getRow(min.second);
         for (Size k = 0; k < min.second; ++k)
         {
-          float dik = original_distance.getValue(min.first, k);
-          float djk = original_distance.getValue(min.second, k);
-          original_distance.setValueQuick(min.second, k, (0.5f * dik + 0.5f * djk + 0.5f * std::fabs(dik - djk)));
+          float dik = row_i[k];
+          float djk = row_j[k];
+          row_j[k] = (0.5f * dik + 0.5f * djk + 0.5f * std::fabs(dik - djk));
         }
         for (Size k = min.second + 1; k < original_distance.dimensionsize(); ++k)
         {
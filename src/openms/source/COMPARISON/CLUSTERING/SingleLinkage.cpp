@@ -101,18 +101,13 @@ namespace OpenMS
 
     for (Size k = 1; k < original_distance.dimensionsize(); ++k)
     {
-      std::vector<float> row_k;
-      row_k.reserve(k);
-
       //initialize pointer values for element to cluster
       pi.push_back(k);
       lambda.push_back(std::numeric_limits<float>::max());
 
-      // get the right distances
-      for (Size i = 0; i < k; ++i)
-      {
-        row_k.push_back(original_distance.getValue(i, k));
-      }
+      // get the right distances (distances to all i < k are stored contiguously in row k)
+      const float* row = original_distance.getRow(k);
+      std::vector<float> row_k(row, row + k);
 
       //calculate pointer values for element k
       for (Size i = 0; i < k; ++i)
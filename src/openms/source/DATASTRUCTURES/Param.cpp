@@ -38,6 +38,8 @@
 #include <OpenMS/DATASTRUCTURES/Map.h>
 
 #include <QtCore/QString>
+#include <boost/unordered_map.hpp>
+#include <atomic>
 #include <fstream>
 
 namespace OpenMS
@@ -444,15 +446,84 @@ namespace OpenMS
     return key;
   }
 
+  //********************************* Param::KeyIndex_ **************************************
+
+  struct Param::KeyIndex_
+  {
+    /// Position of an entry: indices of the nodes along the path, followed by the index of the entry
+    typedef std::vector<Size> Position;
+
+    explicit KeyIndex_(const ParamNode& root) :
+      positions(),
+      outdated(0)
+    {
+      Position position;
+      add_(root, "", position);
+    }
+
+    /// Returns the entry stored at @p position if it (still) has the full name @p key, nullptr otherwise
+    static ParamEntry* resolve(ParamNode& root, const String& key, const Position& position)
+    {
+      ParamNode* node = &root;
+      Size offset = 0;
+      for (Size i = 0; i + 1 < position.size(); ++i)
+      {
+        if (position[i] >= node->nodes.size()) return nullptr;
+        node = &(node->nodes[position[i]]);
+        const String& name = node->name;
+        if (key.size() <= offset + name.size() || key[offset + name.size()] != ':' || key.compare(offset, name.size(), name) != 0)
+        {
+          return nullptr;
+        }
+        offset += name.size() + 1;
+      }
+      if (position.empty() || position.back() >= node->entries.size()) return nullptr;
+      ParamEntry& entry = node->entries[position.back()];
+      if (key.size() != offset + entry.name.size() || key.compare(offset, entry.name.size(), entry.name) != 0)
+      {
+        return nullptr;
+      }
+      return &entry;
+    }
+
+    /// Full key -> position of the entry
+    boost::unordered_map<String, Position> positions;
+
+    /// Number of lookups that had to fall back to the tree search
+    mutable std::atomic<Size> outdated;
+
+private:
+    void add_(const ParamNode& node, const String& prefix, Position& position)
+    {
+      // names containing ':' cannot be reached by a tree search and are left to it
+      for (Size i = 0; i < node.entries.size(); ++i)
+      {
+        if (node.entries[i].name.has(':')) continue;
+        position.push_back(i);
+        positions.insert(std::make_pair(prefix + node.entries[i].name, position)); // first one wins, as in the tree search
+        position.pop_back();
+      }
+      for (Size i = 0; i < node.nodes.size(); ++i)
+      {
+        if (node.nodes[i].name.has(':')) continue;
+        position.push_back(i);
+        add_(node.nodes[i], prefix + node.nodes[i].name + ":", position);
+        position.pop_back();
+      }
+    }
+  };
+
   //********************************* Param **************************************
 
   Param::Param() :
-    root_("ROOT", "")
+    root_("ROOT", ""),
+    index_()
   {
   }
 
   Param::Param(const Param& rhs) :
-    root_(rhs.root_)
+    root_(rhs.root_),
+    index_(std::atomic_load(&rhs.index_)) // the tree is identical, so the (immutable) index can be shared
   {
   }
 
@@ -462,12 +533,15 @@ namespace OpenMS
 
   Param& Param::operator=(const Param& rhs)
   {
+    if (&rhs == this) return *this;
     root_ = rhs.root_;
+    index_ = std::atomic_load(&rhs.index_);
     return *this;
   }
 
   Param::Param(const ParamNode& node) :
-    root_(node)
+    root_(node),
+    index_()
   {
     root_.name = "ROOT";
     root_.description = "";
@@ -650,6 +724,7 @@ namespace OpenMS
 
   void Param::remove(const String& key)
   {
+    index_.reset(); // positions behind the removed element would be shifted
     String keyname = key;
     if (key.hasSuffix(':')) // delete section
     {
@@ -693,6 +768,7 @@ namespace OpenMS
 
   void Param::removeAll(const String& prefix)
   {
+    index_.reset(); // positions behind the removed elements would be shifted
     if (prefix.hasSuffix(':')) //we have to delete one node only (and its subnodes)
     {
       ParamNode* node = root_.findParentOf(prefix.chop(1));
@@ -1020,6 +1096,7 @@ namespace OpenMS
   void Param::clear()
   {
     root_ = ParamNode("ROOT", "");
+    index_.reset();
   }
 
   void Param::checkDefaults(const String& name, const Param& defaults, const String& prefix) const
@@ -1045,7 +1122,7 @@ namespace OpenMS
       }
 
       //different types
-      ParamEntry* default_value = defaults.root_.findEntryRecursive(prefix2 + it.getName());
+      ParamEntry* default_value = defaults.findEntry_(prefix2 + it.getName());
       if (default_value == nullptr)
         continue;
       if (default_value->value.valueType() != it->value.valueType())
@@ -1549,12 +1626,44 @@ namespace OpenMS
 
   bool Param::exists(const String& key) const
   {
-    return root_.findEntryRecursive(key);
+    return findEntry_(key);
   }
 
-  Param::ParamEntry& Param::getEntry_(const String& key) const
+  Param::ParamEntry* Param::findEntry_(const String& key) const
   {
+    // no global lock: concurrent readers at worst build the same index twice
+    std::shared_ptr<const KeyIndex_> index = std::atomic_load(&index_);
+    if (!index)
+    {
+      index = std::make_shared<const KeyIndex_>(root_);
+      std::atomic_store(&index_, index);
+    }
+
+    boost::unordered_map<String, KeyIndex_::Position>::const_iterator it = index->positions.find(key);
+    if (it != index->positions.end())
+    {
+      ParamEntry* entry = KeyIndex_::resolve(root_, key, it->second);
+      if (entry != nullptr) return entry;
+    }
+
+    // not indexed (or moved): the entry was added after the index was built, or it does not exist
     ParamEntry* entry = root_.findEntryRecursive(key);
+    if (entry != nullptr)
+    {
+      // rebuild only once enough keys are missing, to keep interleaved insertions and lookups linear
+      if (++(index->outdated) > index->positions.size() / 4 + 8)
+      {
+        // drop the index, unless another thread has replaced it already
+        std::shared_ptr<const KeyIndex_> expected = index;
+        std::atomic_compare_exchange_strong(&index_, &expected, std::shared_ptr<const KeyIndex_>());
+      }
+    }
+    return entry;
+  }
+
+  Param::ParamEntry& Param::getEntry_(const String& key) const
+  {
+    ParamEntry* entry = findEntry_(key);
     if (entry == nullptr)
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, key);
@@ -35,6 +35,7 @@
 #include <OpenMS/FILTERING/DATAREDUCTION/IsotopeDistributionCache.h>
 
 #include <OpenMS/CHEMISTRY/IsotopeDistribution.h>
+#include <OpenMS/CHEMISTRY/IsotopePatternGenerator.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
 namespace OpenMS
@@ -48,13 +49,19 @@ namespace OpenMS
     //reserve enough space
     isotope_distributions_.resize(num_isotopes);
 
+    //calculate the averagine distributions of all mass windows in one batch
+    std::vector<double> masses(num_isotopes);
+    for (Size index = 0; index < num_isotopes; ++index)
+    {
+      masses[index] = 0.5 * mass_window_width + index * mass_window_width;
+    }
+    std::vector<IsotopeDistribution> distributions = IsotopePatternGenerator::getInstance()->getAveragineDistributions(masses, 20);
+
     //calculate distribution if necessary
     for (Size index = 0; index < num_isotopes; ++index)
     {
       //log_ << "Calculating iso dist for mass: " << 0.5*mass_window_width_ + index * mass_window_width_ << std::endl;
-      IsotopeDistribution d;
-      d.setMaxIsotope(20);
-      d.estimateFromPeptideWeight(0.5 * mass_window_width + index * mass_window_width);
+      IsotopeDistribution& d = distributions[index];
 
       //trim left and right. And store the number of isotopes on the left, to reconstruct the monoisotopic peak
       Size size_before = d.size();
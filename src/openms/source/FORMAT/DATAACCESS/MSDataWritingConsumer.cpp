@@ -34,20 +34,33 @@
 
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
 
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
   MSDataWritingConsumer::MSDataWritingConsumer(String filename) :
     Internal::MzMLHandler(MapType(), filename, MzMLFile().getVersion(), ProgressLogger()),
     started_writing_(false),
+    closed_(false),
     writing_spectra_(false),
     writing_chromatograms_(false),
     spectra_written_(0),
     chromatograms_written_(0),
     spectra_expected_(0),
     chromatograms_expected_(0),
-    add_dataprocessing_(false)
+    add_dataprocessing_(false),
+    buffer_size_(1)
   {
+#ifdef _OPENMP
+    // keep enough elements around so that every thread has a few to encode
+    buffer_size_ = 8 * omp_get_max_threads();
+#endif
+
     validator_ = new Internal::MzMLValidator(this->mapping_, this->cv_);
 
     // open file in binary mode to avoid any line ending conversions
@@ -73,15 +86,29 @@ namespace OpenMS
 
    void MSDataWritingConsumer::consumeSpectrum(SpectrumType & s)
   {
+    if (closed_)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Cannot write spectra after closing the file.");
+    }
     if (writing_chromatograms_)
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
           "Cannot write spectra after writing chromatograms.");
     }
 
-    // Process the spectrum 
-    SpectrumType scpy = s;
-    processSpectrum_(scpy);
+    // Process a copy of the spectrum (directly inside the write buffer)
+    spectra_buffer_.push_back(s);
+    SpectrumType& scpy = spectra_buffer_.back();
+    try
+    {
+      processSpectrum_(scpy);
+    }
+    catch (...)
+    {
+      spectra_buffer_.pop_back();
+      throw;
+    }
 
     // Add dataprocessing if required
     if (add_dataprocessing_)
@@ -110,24 +137,39 @@ namespace OpenMS
       ofs_ << "\t\t<spectrumList count=\"" << spectra_expected_ << "\" defaultDataProcessingRef=\"dp_sp_0\">\n";
       writing_spectra_ = true;
     }
-    bool renew_native_ids = false;
-    // TODO writeSpectrum assumes that dps_ has at least one value -> assert
-    // this here ...
-    Internal::MzMLHandler::writeSpectrum_(ofs_, scpy,
-            spectra_written_++, *validator_, renew_native_ids, dps_);
+    ++spectra_written_;
+    if (spectra_buffer_.size() >= buffer_size_)
+    {
+      flushSpectra_();
+    }
   }
 
    void MSDataWritingConsumer::consumeChromatogram(ChromatogramType & c)
   {
+    if (closed_)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Cannot write chromatograms after closing the file.");
+    }
     // make sure to close an open List tag
     if (writing_spectra_)
     {
+      flushSpectra_();
       ofs_ << "\t\t</spectrumList>\n";
     }
 
-    // Create copy and add dataprocessing if required
-    ChromatogramType ccpy = c;
-    processChromatogram_(ccpy);
+    // Create copy (directly inside the write buffer) and add dataprocessing if required
+    chromatograms_buffer_.push_back(c);
+    ChromatogramType& ccpy = chromatograms_buffer_.back();
+    try
+    {
+      processChromatogram_(ccpy);
+    }
+    catch (...)
+    {
+      chromatograms_buffer_.pop_back();
+      throw;
+    }
 
     if (add_dataprocessing_)
     {
@@ -155,8 +197,37 @@ namespace OpenMS
       writing_chromatograms_ = true;
       writing_spectra_ = false;
     }
-    Internal::MzMLHandler::writeChromatogram_(ofs_, ccpy,
-            chromatograms_written_++, *validator_);
+    ++chromatograms_written_;
+    if (chromatograms_buffer_.size() >= buffer_size_)
+    {
+      flushChromatograms_();
+    }
+  }
+
+  void MSDataWritingConsumer::flushSpectra_()
+  {
+    if (spectra_buffer_.empty()) return;
+
+    // take the buffer first so that a failed write is not repeated on cleanup
+    std::vector<SpectrumType> spectra;
+    spectra.swap(spectra_buffer_);
+
+    bool renew_native_ids = false;
+    // TODO writeSpectra_ assumes that dps_ has at least one value -> assert
+    // this here ...
+    Internal::MzMLHandler::writeSpectra_(ofs_, spectra, spectra_written_ - spectra.size(),
+            *validator_, renew_native_ids, dps_);
+  }
+
+  void MSDataWritingConsumer::flushChromatograms_()
+  {
+    if (chromatograms_buffer_.empty()) return;
+
+    std::vector<ChromatogramType> chromatograms;
+    chromatograms.swap(chromatograms_buffer_);
+
+    Internal::MzMLHandler::writeChromatograms_(ofs_, chromatograms, chromatograms_written_ - chromatograms.size(),
+            *validator_);
   }
 
    void MSDataWritingConsumer::addDataProcessing(DataProcessing d)
@@ -169,11 +240,23 @@ namespace OpenMS
 
    Size MSDataWritingConsumer::getNrChromatogramsWritten() {return chromatograms_written_;}
 
-   void MSDataWritingConsumer::doCleanup_()
+   void MSDataWritingConsumer::close()
   {
-    //--------------------------------------------------------------------------------------------
-    //cleanup
-    //--------------------------------------------------------------------------------------------
+    if (closed_) return;
+    closed_ = true;
+
+    // write out whatever is still buffered
+    try
+    {
+      flushSpectra_();
+      flushChromatograms_();
+    }
+    catch (...)
+    {
+      ofs_.close(); // the file is incomplete anyway
+      throw;
+    }
+
     // make sure to close an open List tag
     if (writing_spectra_)
     {
@@ -188,8 +271,29 @@ namespace OpenMS
     if (started_writing_) 
       Internal::MzMLHandlerHelper::writeFooter_(ofs_, options_, spectra_offsets, chromatograms_offsets);
 
-    delete validator_;
     ofs_.close();
+    if (ofs_.fail())
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, file_, "Error while writing the mzML file.");
+    }
+  }
+
+   void MSDataWritingConsumer::doCleanup_()
+  {
+    //--------------------------------------------------------------------------------------------
+    //cleanup
+    //--------------------------------------------------------------------------------------------
+    // we must not throw from the destructor (call close() to get the errors)
+    try
+    {
+      close();
+    }
+    catch (std::exception& e)
+    {
+      LOG_ERROR << "Error while writing the mzML file '" << file_ << "': " << e.what() << std::endl;
+    }
+
+    delete validator_;
   }
 
 } // namespace OpenMS
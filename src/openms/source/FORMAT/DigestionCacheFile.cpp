@@ -0,0 +1,188 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DigestionCacheFile.h>
+
+#include <OpenMS/CHEMISTRY/EnzymaticDigestion.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <QCryptographicHash>
+
+#include <cstdio>
+#include <fstream>
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    void writeString_(std::ofstream& ofs, const String& s)
+    {
+      Size length = s.size();
+      ofs.write((char*)&length, sizeof(length));
+      ofs.write(s.c_str(), length);
+    }
+
+    /// reads a size field, fails for values exceeding @p max_value (damaged file)
+    bool readSize_(std::ifstream& ifs, Size max_value, Size& value)
+    {
+      return ifs.read((char*)&value, sizeof(value)) && value <= max_value;
+    }
+
+    bool readString_(std::ifstream& ifs, Size file_size, String& s)
+    {
+      Size length;
+      if (!readSize_(ifs, file_size, length)) return false;
+      s.resize(length);
+      return length == 0 || bool(ifs.read(&s[0], length));
+    }
+  }
+
+  DigestionCacheFile::DigestionCacheFile()
+  {
+  }
+
+  DigestionCacheFile::~DigestionCacheFile()
+  {
+  }
+
+  String DigestionCacheFile::computeKey(const String& fasta_file, const EnzymaticDigestion& digestion, Size min_length, Size max_length)
+  {
+    if (!File::exists(fasta_file))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, fasta_file);
+    }
+    return String("sha1=") + FileHandler::computeFileHash(fasta_file) +
+           ";enzyme=" + digestion.getEnzymeName() +
+           ";missed_cleavages=" + digestion.getMissedCleavages() +
+           ";specificity=" + EnzymaticDigestion::NamesOfSpecificity[digestion.getSpecificity()] +
+           ";min_length=" + min_length +
+           ";max_length=" + max_length;
+  }
+
+  String DigestionCacheFile::getCacheFileName(const String& cache_dir, const String& key)
+  {
+    QByteArray hash = QCryptographicHash::hash(QByteArray(key.c_str()), QCryptographicHash::Sha1);
+    return cache_dir + "/" + String((QString)hash.toHex()) + ".digest";
+  }
+
+  bool DigestionCacheFile::load(const String& filename, const String& key, Digests& digests) const
+  {
+    digests.clear();
+    std::ifstream ifs(filename.c_str(), std::ios::binary | std::ios::ate);
+    if (ifs.fail())
+    {
+      return false;
+    }
+    // no count or length can exceed the file size (protects against damaged files)
+    const Size file_size = ifs.tellg();
+    ifs.seekg(0, ifs.beg);
+
+    int file_identifier(0), version(0);
+    ifs.read((char*)&file_identifier, sizeof(file_identifier));
+    ifs.read((char*)&version, sizeof(version));
+    String file_key;
+    if (!ifs || file_identifier != DIGESTION_CACHE_FILE_IDENTIFIER ||
+        version != DIGESTION_CACHE_FILE_VERSION || !readString_(ifs, file_size, file_key) || file_key != key)
+    {
+      return false;
+    }
+
+    Size proteins(0), peptides(0);
+    bool ok = readSize_(ifs, file_size, proteins);
+    if (ok) digests.resize(proteins);
+    for (Size i = 0; ok && i < proteins; ++i)
+    {
+      ok = readSize_(ifs, file_size, peptides);
+      if (ok) digests[i].resize(peptides);
+      for (Size j = 0; ok && j < peptides; ++j)
+      {
+        ok = readString_(ifs, file_size, digests[i][j]);
+      }
+    }
+
+    if (!ok)
+    {
+      LOG_WARN << "Digestion cache file '" << filename << "' is damaged and will be ignored." << std::endl;
+      digests.clear();
+    }
+    return ok;
+  }
+
+  void DigestionCacheFile::store(const String& filename, const String& key, const Digests& digests) const
+  {
+    String tmp_filename = filename + "." + File::getUniqueName(false) + ".tmp";
+    {
+      std::ofstream ofs(tmp_filename.c_str(), std::ios::binary);
+      int file_identifier = DIGESTION_CACHE_FILE_IDENTIFIER;
+      int version = DIGESTION_CACHE_FILE_VERSION;
+      ofs.write((char*)&file_identifier, sizeof(file_identifier));
+      ofs.write((char*)&version, sizeof(version));
+      writeString_(ofs, key);
+
+      Size proteins = digests.size();
+      ofs.write((char*)&proteins, sizeof(proteins));
+      for (Digests::const_iterator it = digests.begin(); it != digests.end(); ++it)
+      {
+        Size peptides = it->size();
+        ofs.write((char*)&peptides, sizeof(peptides));
+        for (std::vector<String>::const_iterator pep_it = it->begin(); pep_it != it->end(); ++pep_it)
+        {
+          writeString_(ofs, *pep_it);
+        }
+      }
+      ofs.close();
+      if (ofs.fail())
+      {
+        File::remove(tmp_filename);
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+    }
+
+    // replace an existing cache file (rename does not overwrite on all platforms)
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+    {
+      File::remove(filename);
+      if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+      {
+        File::remove(tmp_filename);
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+    }
+  }
+
+} // namespace OpenMS
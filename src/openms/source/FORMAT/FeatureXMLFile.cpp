@@ -39,6 +39,7 @@
 #include <OpenMS/METADATA/DataProcessing.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/SYSTEM/PerformanceTrace.h>
 
 #include <fstream>
 
@@ -102,6 +103,7 @@ namespace OpenMS
 
   void FeatureXMLFile::load(const String& filename, FeatureMap& feature_map)
   {
+    OPENMS_TRACE_SCOPE("FeatureXMLFile::load");
     //Filename for error messages in XMLHandler
     file_ = filename;
 
@@ -130,11 +132,13 @@ namespace OpenMS
 
     // put ranges into defined state
     feature_map.updateRanges();
+    OPENMS_TRACE_COUNTER("FeatureXMLFile::load features", feature_map.size());
     return;
   }
 
   void FeatureXMLFile::store(const String& filename, const FeatureMap& feature_map)
   {
+    OPENMS_TRACE_SCOPE("FeatureXMLFile::store");
     if (!FileHandler::hasValidExtension(filename, FileTypes::FEATUREXML))
     {
       throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "invalid file extension, expected '" + FileTypes::typeToName(FileTypes::FEATUREXML) + "'");
@@ -36,6 +36,8 @@
 
 #include <OpenMS/FORMAT/CVMappingFile.h>
 
+#include <exception>
+
 namespace OpenMS
 {
   namespace Internal
@@ -3610,7 +3612,7 @@ namespace OpenMS
     {
       const MapType& exp = *(cexp_);
       logger_.startProgress(0, exp.size() + exp.getChromatograms().size(), "storing mzML file");
-      int progress = 0;
+      Size progress = 0;
       Internal::MzMLValidator validator(mapping_, cv_);
 
       std::vector<std::vector< ConstDataProcessingPtr > > dps;
@@ -3647,12 +3649,8 @@ namespace OpenMS
         }
 
         //write actual data
-        for (Size s = 0; s < exp.size(); ++s)
-        {
-          logger_.setProgress(progress++);
-          const SpectrumType& spec = exp[s];
-          writeSpectrum_(os, spec, s, validator, renew_native_ids, dps);
-        }
+        writeSpectra_(os, exp.getSpectra(), 0, validator, renew_native_ids, dps, true, progress);
+        progress += exp.size();
         os << "\t\t</spectrumList>\n";
       }
 
@@ -3666,12 +3664,7 @@ namespace OpenMS
         // meta information needs to be stored here but the actual data is
         // stored somewhere else).
         os << "\t\t<chromatogramList count=\"" << exp.getChromatograms().size() << "\" defaultDataProcessingRef=\"dp_sp_0\">\n";
-        for (Size c = 0; c != exp.getChromatograms().size(); ++c)
-        {
-          logger_.setProgress(progress++);
-          const ChromatogramType& chromatogram = exp.getChromatograms()[c];
-          writeChromatogram_(os, chromatogram, c, validator);
-        }
+        writeChromatograms_(os, exp.getChromatograms(), 0, validator, true, progress);
         os << "\t\t</chromatogramList>" << "\n";
       }
 
@@ -3679,6 +3672,114 @@ namespace OpenMS
       logger_.endProgress();
     }
 
+    void MzMLHandler::writeSpectra_(std::ostream& os, const std::vector<SpectrumType>& spectra, Size first_index,
+                                    Internal::MzMLValidator& validator, bool renew_native_ids,
+                                    const std::vector<std::vector< ConstDataProcessingPtr > >& dps,
+                                    bool log_progress, Size progress_offset)
+    {
+      std::exception_ptr error;
+
+#ifdef _OPENMP
+#pragma omp parallel for ordered schedule(dynamic, 1)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)spectra.size(); ++i)
+      {
+        const Size s = first_index + i;
+        const SpectrumType& spec = spectra[i];
+
+        //native id
+        String native_id = spec.getNativeID();
+        if (renew_native_ids)
+        {
+          native_id = String("spectrum=") + s;
+        }
+
+        // format and encode the spectrum independently of all other spectra
+        std::ostringstream buffer;
+        buffer.flags(os.flags());
+        buffer.precision(os.precision());
+        std::exception_ptr local_error;
+        try
+        {
+          writeSpectrumElement_(buffer, spec, native_id, s, validator, dps);
+        }
+        catch (...)
+        {
+          local_error = std::current_exception();
+        }
+
+        // append to the output in the original order
+#ifdef _OPENMP
+#pragma omp ordered
+#endif
+        {
+          if (local_error && !error)
+          {
+            error = local_error;
+          }
+          if (!error)
+          {
+            if (log_progress) logger_.setProgress(progress_offset + i);
+            long offset = os.tellp();
+            spectra_offsets.push_back(make_pair(native_id, offset + 3));
+            // IMPORTANT make sure the offset (above) corresponds to the start of the <spectrum tag
+            os << buffer.str();
+          }
+        }
+      }
+
+      if (error) std::rethrow_exception(error);
+    }
+
+    void MzMLHandler::writeChromatograms_(std::ostream& os, const std::vector<ChromatogramType>& chromatograms, Size first_index,
+                                          Internal::MzMLValidator& validator, bool log_progress, Size progress_offset)
+    {
+      std::exception_ptr error;
+
+#ifdef _OPENMP
+#pragma omp parallel for ordered schedule(dynamic, 1)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)chromatograms.size(); ++i)
+      {
+        const ChromatogramType& chromatogram = chromatograms[i];
+
+        // format and encode the chromatogram independently of all other chromatograms
+        std::ostringstream buffer;
+        buffer.flags(os.flags());
+        buffer.precision(os.precision());
+        std::exception_ptr local_error;
+        try
+        {
+          writeChromatogramElement_(buffer, chromatogram, first_index + i, validator);
+        }
+        catch (...)
+        {
+          local_error = std::current_exception();
+        }
+
+        // append to the output in the original order
+#ifdef _OPENMP
+#pragma omp ordered
+#endif
+        {
+          if (local_error && !error)
+          {
+            error = local_error;
+          }
+          if (!error)
+          {
+            if (log_progress) logger_.setProgress(progress_offset + i);
+            long offset = os.tellp();
+            chromatograms_offsets.push_back(make_pair(chromatogram.getNativeID(), offset + 3));
+            // IMPORTANT make sure the offset (above) corresponds to the start of the <chromatogram tag
+            os << buffer.str();
+          }
+        }
+      }
+
+      if (error) std::rethrow_exception(error);
+    }
+
     void MzMLHandler::writeHeader_(std::ostream& os, const MapType& exp,
                                             std::vector<std::vector< ConstDataProcessingPtr > >& dps, Internal::MzMLValidator& validator)
     {
@@ -4626,6 +4727,14 @@ namespace OpenMS
       spectra_offsets.push_back(make_pair(native_id, offset + 3));
 
       // IMPORTANT make sure the offset (above) corresponds to the start of the <spectrum tag
+      writeSpectrumElement_(os, spec, native_id, s, validator, dps);
+    }
+
+    void MzMLHandler::writeSpectrumElement_(std::ostream& os,
+                                            const SpectrumType& spec, const String& native_id, Size s,
+                                            Internal::MzMLValidator& validator,
+                                            const std::vector<std::vector< ConstDataProcessingPtr > >& dps)
+    {
       os << "\t\t\t<spectrum id=\"" << writeXMLEscape(native_id) << "\" index=\"" << s << "\" defaultArrayLength=\"" << spec.size() << "\"";
       if (spec.getSourceFile() != SourceFile())
       {
@@ -5082,8 +5191,14 @@ namespace OpenMS
       long offset = os.tellp();
       chromatograms_offsets.push_back(make_pair(chromatogram.getNativeID(), offset + 3));
 
-      // TODO native id with chromatogram=?? prefix?
       // IMPORTANT make sure the offset (above) corresponds to the start of the <chromatogram tag
+      writeChromatogramElement_(os, chromatogram, c, validator);
+    }
+
+    void MzMLHandler::writeChromatogramElement_(std::ostream& os,
+                                                const ChromatogramType& chromatogram, Size c, Internal::MzMLValidator& validator)
+    {
+      // TODO native id with chromatogram=?? prefix?
       os << "\t\t\t<chromatogram id=\"" << writeXMLEscape(chromatogram.getNativeID()) << "\" index=\"" << c << "\" defaultArrayLength=\"" << chromatogram.size() << "\">" << "\n";
 
       // write cvParams (chromatogram type)
@@ -35,6 +35,7 @@
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/PerformanceTrace.h>
 
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/CONCEPT/PrecisionWrapper.h>
@@ -64,6 +65,7 @@ namespace OpenMS
   void IdXMLFile::load(const String& filename, std::vector<ProteinIdentification>& protein_ids,
                        std::vector<PeptideIdentification>& peptide_ids, String& document_id)
   {
+    OPENMS_TRACE_SCOPE("IdXMLFile::load");
     startProgress(0, 0, "Loading idXML");
     //Filename for error messages in XMLHandler
     file_ = filename;
@@ -91,10 +93,12 @@ namespace OpenMS
     proteinid_to_accession_.clear();
     
     endProgress();
+    OPENMS_TRACE_COUNTER("IdXMLFile::load peptide identifications", peptide_ids.size());
   }
 
   void IdXMLFile::store(String filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids, const String& document_id)
   {
+    OPENMS_TRACE_SCOPE("IdXMLFile::store");
     if (!FileHandler::hasValidExtension(filename, FileTypes::IDXML))
     {
       throw Exception::UnableToCreateFile(
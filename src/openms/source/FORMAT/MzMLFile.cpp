@@ -38,6 +38,7 @@
 #include <OpenMS/FORMAT/CVMappingFile.h>
 #include <OpenMS/FORMAT/VALIDATORS/XMLValidator.h>
 #include <OpenMS/FORMAT/TextFile.h>
+#include <OpenMS/SYSTEM/PerformanceTrace.h>
 
 namespace OpenMS
 {
@@ -162,6 +163,7 @@ namespace OpenMS
 
   void MzMLFile::load(const String& filename, PeakMap& map)
   {
+    OPENMS_TRACE_SCOPE("MzMLFile::load");
     map.reset();
 
     //set DocumentIdentifier
@@ -171,10 +173,12 @@ namespace OpenMS
     Internal::MzMLHandler handler(map, filename, getVersion(), *this);
     handler.setOptions(options_);
     safeParse_(filename, &handler);
+    OPENMS_TRACE_COUNTER("MzMLFile::load spectra", map.size());
   }
 
   void MzMLFile::store(const String& filename, const PeakMap& map) const
   {
+    OPENMS_TRACE_SCOPE("MzMLFile::store");
     Internal::MzMLHandler handler(map, filename, getVersion(), *this);
     handler.setOptions(options_);
     save_(filename, &handler);
@@ -198,6 +202,7 @@ namespace OpenMS
 
   void MzMLFile::transform(const String& filename_in, Interfaces::IMSDataConsumer* consumer, bool skip_full_count, bool skip_first_pass)
   {
+    OPENMS_TRACE_SCOPE("MzMLFile::transform");
     // First pass through the file -> get the meta-data and hand it to the consumer
     if (!skip_first_pass) transformFirstPass_(filename_in, consumer, skip_full_count);
 
@@ -213,6 +218,7 @@ namespace OpenMS
 
   void MzMLFile::transform(const String& filename_in, Interfaces::IMSDataConsumer* consumer, PeakMap& map, bool skip_full_count, bool skip_first_pass)
   {
+    OPENMS_TRACE_SCOPE("MzMLFile::transform");
     // First pass through the file -> get the meta-data and hand it to the consumer
     if (!skip_first_pass) transformFirstPass_(filename_in, consumer, skip_full_count);
 
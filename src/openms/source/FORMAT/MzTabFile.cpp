@@ -35,10 +35,12 @@
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/FORMAT/MzTabFile.h>
 
-#include <OpenMS/FORMAT/TextFile.h>
 
 #include <boost/regex.hpp>
 
+#include <deque>
+#include <fstream>
+
 using namespace std;
 
 // TODO fix all the shadowed "String s"
@@ -48,6 +50,170 @@ using namespace std;
 namespace OpenMS
 {
 
+namespace
+{
+  /// Reads a text file line by line, with the same line ending handling and trimming as TextFile(filename, true),
+  /// but without holding the whole file in memory.
+  class MzTabLineReader
+  {
+public:
+    explicit MzTabLineReader(const String& filename) :
+      is_(filename.c_str(), ios_base::in | ios_base::binary)
+    {
+      if (!is_)
+      {
+        throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+    }
+
+    /// reads the next line into @p line (returns false at the end of the file)
+    bool next(String& line)
+    {
+      while (pending_.empty())
+      {
+        if (!getline(is_, buffer_, '\n'))
+        {
+          return false;
+        }
+
+        // Windows line endings
+        if (!buffer_.empty() && *buffer_.rbegin() == '\r')
+        {
+          buffer_.resize(buffer_.size() - 1);
+        }
+
+        // Mac (OS<=9) line endings
+        if (buffer_.find('\r') == std::string::npos)
+        {
+          line.swap(buffer_);
+          line.trim();
+          return true;
+        }
+        StringList lines = ListUtils::create<String>(buffer_, '\r');
+        pending_.insert(pending_.end(), lines.begin(), lines.end());
+      }
+      line.swap(pending_.front());
+      line.trim();
+      pending_.pop_front();
+      return true;
+    }
+
+private:
+    std::ifstream is_;
+    String buffer_;
+    std::deque<String> pending_;
+  };
+
+  /// Splits a line at tabs (same result as String::split("\t", cells)), reusing the memory of @p cells from previous lines.
+  void splitCells(const String& line, StringList& cells)
+  {
+    if (line.empty())
+    {
+      cells.clear();
+      return;
+    }
+
+    Size count = 0;
+    Size start = 0;
+    while (true)
+    {
+      Size pos = line.find('\t', start);
+      Size end = (pos == std::string::npos) ? line.size() : pos;
+      if (count == cells.size())
+      {
+        cells.push_back(String());
+      }
+      cells[count].assign(line, start, end - start);
+      ++count;
+      if (pos == std::string::npos) break;
+      start = pos + 1;
+    }
+    cells.resize(count);
+  }
+
+  /// Writes lines in the format of TextFile::store() and restores the empty and comment lines of a loaded file.
+  class MzTabLineWriter
+  {
+public:
+    MzTabLineWriter(std::ostream& os, const vector<Size>& empty_rows, const map<Size, String>& comment_rows) :
+      os_(os), empty_rows_(empty_rows), comment_rows_(comment_rows), line_(0)
+    {
+    }
+
+    void write(const String& line)
+    {
+      // check if current line was originally an empty line or a comment line
+      while (true)
+      {
+        if (std::binary_search(empty_rows_.begin(), empty_rows_.end(), line_))
+        {
+          writeLine_("\n");
+        }
+        else
+        {
+          map<Size, String>::const_iterator it = comment_rows_.find(line_);
+          if (it == comment_rows_.end()) break;
+          writeLine_(it->second);
+        }
+        ++line_;
+      }
+      writeLine_(line);
+      ++line_;
+    }
+
+    /// formats the rows of a section in parallel (@p format has to be thread-safe) and writes them in their original order
+    template <typename RowType, typename Formatter>
+    void writeRows(const std::vector<RowType>& rows, const Formatter& format)
+    {
+      // only a chunk of formatted rows is kept in memory
+      const Size chunk_size = 4096;
+      StringList lines;
+      for (Size begin = 0; begin < rows.size(); begin += chunk_size)
+      {
+        const Size end = std::min(begin + chunk_size, rows.size());
+        lines.resize(end - begin);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+        for (SignedSize i = (SignedSize)begin; i < (SignedSize)end; ++i)
+        {
+          lines[i - begin] = format(rows[i]);
+        }
+        for (Size i = 0; i < lines.size(); ++i)
+        {
+          write(lines[i]);
+        }
+      }
+    }
+
+private:
+    void writeLine_(const String& line)
+    {
+      if (line.hasSuffix("\n"))
+      {
+        if (line.hasSuffix("\r\n"))
+        {
+          os_.write(line.c_str(), line.size() - 2);
+          os_ << "\n";
+        }
+        else
+        {
+          os_ << line;
+        }
+      }
+      else
+      {
+        os_ << line << "\n";
+      }
+    }
+
+    std::ostream& os_;
+    const vector<Size>& empty_rows_;
+    const map<Size, String>& comment_rows_;
+    Size line_;
+  };
+}
+
 MzTabFile::MzTabFile():
   store_protein_reliability_(false),
   store_peptide_reliability_(false),
@@ -98,7 +264,6 @@ std::pair<int, int> MzTabFile::extractIndexPairsFromBrackets_(const String & s)
 
 void MzTabFile::load(const String& filename, MzTab& mz_tab)
 {
-  TextFile tf(filename, true);
 
   MzTabMetaData mz_tab_metadata;
   MzTabProteinSectionRows mz_tab_protein_section_data;
@@ -222,11 +387,12 @@ void MzTabFile::load(const String& filename, MzTab& mz_tab)
   Size count_psm_search_engine_score = 0;
   Size count_smallmolecule_search_engine_score = 0;
 
+  // lines are streamed from the file, and the cells of each line reuse the memory of the previous line
   Size line_number = 0;
-  for (TextFile::ConstIterator sit = tf.begin(); sit != tf.end(); ++sit, ++line_number)
+  String s;
+  StringList cells;
+  for (MzTabLineReader reader(filename); reader.next(s); ++line_number)
   {
-    //  std::cout << *sit << std::endl;
-    String s = *sit;
 
     // skip empty lines or lines that are too short
     if (s.trim().size() < 3)
@@ -244,8 +410,7 @@ void MzTabFile::load(const String& filename, MzTab& mz_tab)
       continue;
     }
 
-    StringList cells;
-    s.split("\t", cells);
+    splitCells(s, cells);
 
     if (cells.size() < 3)
     {
@@ -2067,32 +2232,6 @@ String MzTabFile::generateMzTabProteinSectionRow_(const MzTabProteinSectionRow&
   return ListUtils::concatenate(s, "\t");
 }
 
-void MzTabFile::generateMzTabProteinSection_(const MzTabProteinSectionRows& rows, StringList& sl, const vector<String>& optional_columns) const
-{
-  for (MzTabProteinSectionRows::const_iterator it = rows.begin(); it != rows.end(); ++it)
-  {
-    sl.push_back(generateMzTabProteinSectionRow_(*it, optional_columns));
-  }
-  sl.push_back(String("\n"));
-}
-
-void MzTabFile::generateMzTabPeptideSection_(const MzTabPeptideSectionRows& rows, StringList& sl, const vector<String>& optional_columns) const
-{
-  for (MzTabPeptideSectionRows::const_iterator it = rows.begin(); it != rows.end(); ++it)
-  {
-    sl.push_back(generateMzTabPeptideSectionRow_(*it, optional_columns));
-  }
-  sl.push_back(String("\n"));
-}
-
-void MzTabFile::generateMzTabSmallMoleculeSection_(const MzTabSmallMoleculeSectionRows& rows, StringList& sl, const std::vector<String>& optional_columns) const
-{
-  for (MzTabSmallMoleculeSectionRows::const_iterator it = rows.begin(); it != rows.end(); ++it)
-  {
-    sl.push_back(generateMzTabSmallMoleculeSectionRow_(*it, optional_columns));
-  }
-}
-
 String MzTabFile::generateMzTabPeptideHeader_(Size search_ms_runs, Size n_best_search_engine_scores, Size n_search_engine_scores, Size assays, Size study_variables, const vector<String>& optional_columns) const
 {
   StringList header;
@@ -2281,15 +2420,6 @@ String MzTabFile::generateMzTabPeptideSectionRow_(const MzTabPeptideSectionRow&
   return ListUtils::concatenate(s, "\t");
 }
 
-void MzTabFile::generateMzTabPSMSection_(const MzTabPSMSectionRows& rows, StringList& sl, const vector<String>& optional_columns) const
-{
-  for (MzTabPSMSectionRows::const_iterator it = rows.begin(); it != rows.end(); ++it)
-  {
-    sl.push_back(generateMzTabPSMSectionRow_(*it, optional_columns));
-  }
-  sl.push_back(String("\n"));
-}
-
 String MzTabFile::generateMzTabPSMSectionRow_(const MzTabPSMSectionRow& row, const vector<String>& optional_columns) const
 {
   StringList s;
@@ -2508,9 +2638,26 @@ void MzTabFile::store(const String& filename, const MzTab& mz_tab) const
     throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "invalid file extension, expected '" + FileTypes::typeToName(FileTypes::TSV) + "'");
   }
 
-  StringList out;
+  // stream not opened in binary mode, thus "\n" will be evaluated platform dependent (as in TextFile::store())
+  ofstream os(filename.c_str(), ofstream::out);
+  if (!os)
+  {
+    throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+  }
+
+  // insert comment (might provide critical cues for human reader) and empty lines
+  const vector<Size> empty_rows = mz_tab.getEmptyRows();
+  const map<Size, String> comment_rows = mz_tab.getCommentRows();
+  MzTabLineWriter out(os, empty_rows, comment_rows);
+
+  StringList meta_data;
+  generateMzTabMetaDataSection_(mz_tab.getMetaData(), meta_data);
+  for (Size i = 0; i < meta_data.size(); ++i)
+  {
+    out.write(meta_data[i]);
+  }
+  meta_data.clear();
 
-  generateMzTabMetaDataSection_(mz_tab.getMetaData(), out);
   bool complete = (mz_tab.getMetaData().mz_tab_mode.toCellString() == "Complete");
   Size ms_runs = mz_tab.getMetaData().ms_run.size();
 
@@ -2519,15 +2666,18 @@ void MzTabFile::store(const String& filename, const MzTab& mz_tab) const
   const MzTabPSMSectionRows& psm_section = mz_tab.getPSMSectionRows();
   const MzTabSmallMoleculeSectionRows& smallmolecule_section = mz_tab.getSmallMoleculeSectionRows();
 
+  // rows are formatted in parallel and streamed to the file in their original order
   if (!protein_section.empty())
   {   
     Size n_best_search_engine_score = mz_tab.getMetaData().protein_search_engine_score.size();
+    const vector<String> optional_columns = mz_tab.getProteinOptionalColumnNames();
 
     // add header
-    out.push_back(generateMzTabProteinHeader_(protein_section[0], n_best_search_engine_score, mz_tab.getProteinOptionalColumnNames()));
+    out.write(generateMzTabProteinHeader_(protein_section[0], n_best_search_engine_score, optional_columns));
 
     // add section
-    generateMzTabProteinSection_(protein_section, out, mz_tab.getProteinOptionalColumnNames());
+    out.writeRows(protein_section, [&](const MzTabProteinSectionRow& row) { return generateMzTabProteinSectionRow_(row, optional_columns); });
+    out.write(String("\n"));
   }
 
   if (!peptide_section.empty())
@@ -2541,13 +2691,13 @@ void MzTabFile::store(const String& filename, const MzTab& mz_tab) const
       search_ms_runs = ms_runs;
     } else // only report all scores if user provided at least one
     {
-      const MzTabPeptideSectionRows psr = mz_tab.getPeptideSectionRows();
       bool has_ms_run_level_scores = false;
-      for (Size i = 0; i != psr.size(); ++i)
+      for (Size i = 0; i != peptide_section.size(); ++i)
       {
-        if (!psr[i].search_engine_score_ms_run.empty())
+        if (!peptide_section[i].search_engine_score_ms_run.empty())
         {
           has_ms_run_level_scores = true;
+          break;
         }
       }
 
@@ -2558,8 +2708,10 @@ void MzTabFile::store(const String& filename, const MzTab& mz_tab) const
     }
     Size n_search_engine_score = peptide_section[0].search_engine_score_ms_run.size();
     Size n_best_search_engine_score = mz_tab.getMetaData().peptide_search_engine_score.size();
-    out.push_back(generateMzTabPeptideHeader_(search_ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, mz_tab.getPeptideOptionalColumnNames()));
-    generateMzTabPeptideSection_(mz_tab.getPeptideSectionRows(), out, mz_tab.getPeptideOptionalColumnNames());
+    const vector<String> optional_columns = mz_tab.getPeptideOptionalColumnNames();
+    out.write(generateMzTabPeptideHeader_(search_ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, optional_columns));
+    out.writeRows(peptide_section, [&](const MzTabPeptideSectionRow& row) { return generateMzTabPeptideSectionRow_(row, optional_columns); });
+    out.write(String("\n"));
   }
 
   if (!psm_section.empty())
@@ -2570,8 +2722,10 @@ void MzTabFile::store(const String& filename, const MzTab& mz_tab) const
     {
       // TODO warn
     }
-    out.push_back(generateMzTabPSMHeader_(n_search_engine_scores, mz_tab.getPSMOptionalColumnNames()));
-    generateMzTabPSMSection_(mz_tab.getPSMSectionRows(), out, mz_tab.getPSMOptionalColumnNames());
+    const vector<String> optional_columns = mz_tab.getPSMOptionalColumnNames();
+    out.write(generateMzTabPSMHeader_(n_search_engine_scores, optional_columns));
+    out.writeRows(psm_section, [&](const MzTabPSMSectionRow& row) { return generateMzTabPSMSectionRow_(row, optional_columns); });
+    out.write(String("\n"));
   }
 
   if (!smallmolecule_section.empty())
@@ -2580,47 +2734,12 @@ void MzTabFile::store(const String& filename, const MzTab& mz_tab) const
     Size study_variables = smallmolecule_section[0].smallmolecule_abundance_study_variable.size();
     Size n_search_engine_score = smallmolecule_section[0].search_engine_score_ms_run.size();
     Size n_best_search_engine_score = mz_tab.getMetaData().smallmolecule_search_engine_score.size();
-    out.push_back(generateMzTabSmallMoleculeHeader_(ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, mz_tab.getSmallMoleculeOptionalColumnNames()));
-    generateMzTabSmallMoleculeSection_(smallmolecule_section, out, mz_tab.getSmallMoleculeOptionalColumnNames());
+    const vector<String> optional_columns = mz_tab.getSmallMoleculeOptionalColumnNames();
+    out.write(generateMzTabSmallMoleculeHeader_(ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, optional_columns));
+    out.writeRows(smallmolecule_section, [&](const MzTabSmallMoleculeSectionRow& row) { return generateMzTabSmallMoleculeSectionRow_(row, optional_columns); });
   }
 
-  // insert comment (might provide critical cues for human reader) and empty lines
-  Size line = 0;
-  vector<Size> empty_rows = mz_tab.getEmptyRows();
-  map<Size, String> comment_rows = mz_tab.getCommentRows();
-
-  if (empty_rows.empty() && comment_rows.empty())
-  {
-    TextFile tmp_out;
-    for (TextFile::ConstIterator it = out.begin(); it != out.end(); ++it)
-    {
-      tmp_out.addLine(*it);
-    }
-    tmp_out.store(filename);
-  } else
-  {
-    TextFile tmp_out;
-    for (TextFile::ConstIterator it = out.begin(); it != out.end(); )
-    {
-      if (std::binary_search(empty_rows.begin(), empty_rows.end(), line))  // check if current line was originally an empty line
-      {
-        tmp_out.addLine("\n");
-        ++line;
-      }
-      else if (comment_rows.find(line) != comment_rows.end()) // check if current line was originally a comment line
-      {
-        tmp_out.addLine(comment_rows[line]);
-        ++line;
-      }
-      else   // no empty line, no comment => add row
-      {
-        tmp_out.addLine(*it);
-        ++line;
-        ++it;
-      }
-    }
-    tmp_out.store(filename);
-  }
+  os.close();
 }
 
 }
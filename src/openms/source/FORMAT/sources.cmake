@@ -17,6 +17,7 @@ ControlledVocabulary.cpp
 CsvFile.cpp
 DTA2DFile.cpp
 DTAFile.cpp
+DigestionCacheFile.cpp
 EDTAFile.cpp
 FASTAFile.cpp
 FastaIterator.cpp
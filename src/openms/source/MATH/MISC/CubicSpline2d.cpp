@@ -106,6 +106,36 @@ namespace OpenMS
     return ((d_[i] * xx + c_[i]) * xx + b_[i]) * xx + a_[i];
   }
 
+  void CubicSpline2d::evalSorted(std::vector<double>::iterator first, std::vector<double>::iterator last) const
+  {
+    const unsigned n = static_cast<unsigned>(x_.size());
+    unsigned i = 0; // closest node left of (or exactly at) the current x
+    for (; first != last; ++first)
+    {
+      const double x = *first;
+      if (x < x_.front() || x > x_.back())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Argument out of range of spline interpolation.");
+      }
+
+      if (x < x_[i]) // not ascending - search again
+      {
+        i = static_cast<unsigned>(std::lower_bound(x_.begin(), x_.end(), x) - x_.begin());
+        if (x_[i] > x || x_.back() == x)
+        {
+          --i;
+        }
+      }
+      else
+      {
+        while (i + 2 < n && x_[i + 1] <= x) ++i;
+      }
+
+      const double xx = x - x_[i];
+      *first = ((d_[i] * xx + c_[i]) * xx + b_[i]) * xx + a_[i];
+    }
+  }
+
   double CubicSpline2d::derivatives(double x, unsigned order) const
   {
     if (x < x_.front() || x > x_.back())
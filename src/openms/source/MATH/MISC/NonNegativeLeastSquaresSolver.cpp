@@ -35,18 +35,53 @@
 #include <OpenMS/MATH/MISC/NonNegativeLeastSquaresSolver.h>
 #include <OpenMS/MATH/MISC/NNLS/NNLS.h>
 
+#include <Eigen/Core>
+#include <Eigen/QR>
+
+#include <vector>
+
 namespace OpenMS
 {
   Int NonNegativeLeastSquaresSolver::solve(const Matrix<double> & A, const Matrix<double> & b, Matrix<double> & x)
   {
-
     if (A.rows() != b.rows())
     {
       throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "NNSL::solve() #rows of A does not match #rows of b !");
     }
 
-    // translate A to array a (column major order)
-    double * a_vec = new double[A.rows() * A.cols()];
+    // only the first column of b is used
+    Matrix<double> b_col(b.rows(), 1);
+    for (size_t row = 0; row < b.rows(); ++row)
+    {
+      b_col(row, 0) = b(row, 0);
+    }
+    // Lawson-Hanson iterations only, as the least squares shortcut changes the results within rounding
+    return solve_(A, b_col, x, false);
+  }
+
+  Int NonNegativeLeastSquaresSolver::solveBatch(const Matrix<double> & A, const Matrix<double> & B, Matrix<double> & X)
+  {
+    return solve_(A, B, X, true);
+  }
+
+  Int NonNegativeLeastSquaresSolver::solve_(const Matrix<double> & A, const Matrix<double> & B, Matrix<double> & X, bool use_least_squares)
+  {
+    if (A.rows() != B.rows())
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "NNSL::solve() #rows of A does not match #rows of b !");
+    }
+    if (A.rows() == 0 || A.cols() == 0)
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "NonNegativeLeastSquaresSolver::solve() Bad dimension reported!");
+    }
+
+    // this needs to be int (not Int, Size or anything else), because the external nnls constructor expects it this way!
+    const int a_rows = (int)A.rows();
+    const int a_cols = (int)A.cols();
+    const SignedSize n_rhs = (SignedSize)B.cols();
+
+    // translate A to array a (column major order); the NNLS solver overwrites its input, so every solve starts from a copy
+    std::vector<double> a_vec(A.rows() * A.cols());
     size_t idx = 0;
     for (size_t col = 0; col < A.cols(); ++col)
     {
@@ -61,65 +96,90 @@ namespace OpenMS
     //std::cout << "A:\n" << A << std::endl;
 #endif
 
-    // this needs to be int (not Int, Size or anything else), because the external nnls constructor expects it this way!
-    int a_rows = (int)A.rows();
-    int a_cols = (int)A.cols();
-
-    // translate b
-    double * b_vec = new double[a_rows];
-    for (size_t row = 0; row < b.rows(); ++row)
+    // factorize A once: if A has full column rank and the unconstrained least squares
+    // solution is non-negative, it is also the (unique) solution of the NNLS problem
+    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr;
+    bool full_rank = false;
+    if (use_least_squares)
     {
-      b_vec[row] = b(row, 0);
+      qr.compute(Eigen::Map<const Eigen::MatrixXd>(&a_vec[0], a_rows, a_cols));
+      full_rank = qr.rank() == a_cols;
     }
 
-#ifdef NNLS_DEBUG
-    std::cout << "b:\n" << b << std::endl;
-#endif
-
-    // prepare solution array (directly copied from example)
-    double * x_vec = new double[a_cols + 1];
-    double rnorm;
-    double * w = new double[a_cols + 1];
-    double * zz = new double[a_rows + 1];
-    int * indx = new int[a_cols + 1];
-    int mode;
+    X.resize(a_cols, n_rhs);
+    Size iteration_exceeded(0);
+    Size bad_dimension(0);
 
-#ifdef NNLS_DEBUG
-    std::cout << "solving ..." << std::endl;
+#ifdef _OPENMP
+#pragma omp parallel if (n_rhs > 1)
 #endif
-
-    NNLS::nnls_(a_vec, &a_rows, &a_rows, &a_cols, b_vec, x_vec, &rnorm, w, zz, indx, &mode);
-
-
-    // translate solution back to Matrix:
-    x.resize(a_cols, 1);
-    for (Int row = 0; row < a_cols; ++row)
     {
-      x(row, 0) = x_vec[row];
+      // working space of the NNLS solver (sizes directly copied from example)
+      std::vector<double> a_work(a_vec.size());
+      std::vector<double> b_vec(a_rows);
+      std::vector<double> x_vec(a_cols + 1);
+      std::vector<double> w(a_cols + 1);
+      std::vector<double> zz(a_rows + 1);
+      std::vector<int> indx(a_cols + 1);
+      Eigen::VectorXd e_b(a_rows);
+      Eigen::VectorXd e_x(a_cols);
+
+#ifdef _OPENMP
+#pragma omp for schedule(static) reduction(+: iteration_exceeded, bad_dimension)
+#endif
+      for (SignedSize k = 0; k < n_rhs; ++k)
+      {
+        // translate b
+        for (int row = 0; row < a_rows; ++row)
+        {
+          e_b(row) = B(row, k);
+        }
+
+        if (full_rank)
+        {
+          e_x = qr.solve(e_b);
+          if (e_x.minCoeff() >= 0.0)
+          {
+            for (int row = 0; row < a_cols; ++row)
+            {
+              X(row, k) = e_x(row);
+            }
+            continue;
+          }
+        }
+
+        std::copy(a_vec.begin(), a_vec.end(), a_work.begin());
+        for (int row = 0; row < a_rows; ++row)
+        {
+          b_vec[row] = e_b(row);
+        }
+        int mda = a_rows, m = a_rows, n = a_cols;
+        double rnorm;
+        int mode;
+
+        NNLS::nnls_(&a_work[0], &mda, &m, &n, &b_vec[0], &x_vec[0], &rnorm, &w[0], &zz[0], &indx[0], &mode);
+
+        // translate solution back to Matrix:
+        for (int row = 0; row < a_cols; ++row)
+        {
+          X(row, k) = x_vec[row];
+        }
+
+        if (mode == 2) ++bad_dimension;
+        else if (mode != 1) ++iteration_exceeded;
+      }
     }
 
 #ifdef NNLS_DEBUG
     std::cout << "done" << std::endl;
-    std::cout << "solution x:\n" << x << std::endl;
+    std::cout << "solution X:\n" << X << std::endl;
 #endif
 
-    // clean up
-    delete[] a_vec;
-    delete[] b_vec;
-    delete[] x_vec;
-    delete[] w;
-    delete[] zz;
-    delete[] indx;
-
-    if (mode == 1)
-      return SOLVED;
-    else if (mode == 2) // this should not happen (dimensions are bad)
+    if (bad_dimension > 0) // this should not happen (dimensions are bad)
     {
       throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "NonNegativeLeastSquaresSolver::solve() Bad dimension reported!");
     }
-    else     /*if (mode==3)*/
-      return ITERATION_EXCEEDED;
-
+    return iteration_exceeded == 0 ? SOLVED : ITERATION_EXCEEDED;
   }
 
 } // namespace OpenMS
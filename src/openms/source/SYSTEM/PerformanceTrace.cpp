@@ -0,0 +1,259 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/SYSTEM/PerformanceTrace.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/SYSTEM/SysInfo.h>
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OpenMS
+{
+  namespace
+  {
+    typedef std::chrono::steady_clock TraceClock;
+
+    TraceClock::time_point& traceOrigin()
+    {
+      static TraceClock::time_point origin = TraceClock::now();
+      return origin;
+    }
+
+    std::vector<PerformanceTrace::Event>& traceEvents()
+    {
+      static std::vector<PerformanceTrace::Event> events;
+      return events;
+    }
+
+    // writes @p s as JSON string literal
+    void writeJSONString(std::ostream& os, const String& s)
+    {
+      os << '"';
+      for (String::const_iterator it = s.begin(); it != s.end(); ++it)
+      {
+        switch (*it)
+        {
+        case '"': os << "\\\""; break;
+        case '\\': os << "\\\\"; break;
+        case '\n': os << "\\n"; break;
+        case '\t': os << "\\t"; break;
+        default:
+          if (static_cast<unsigned char>(*it) < 0x20) os << ' ';
+          else os << *it;
+        }
+      }
+      os << '"';
+    }
+
+    bool inParallelRegion()
+    {
+#ifdef _OPENMP
+      return omp_in_parallel();
+#else
+      return false;
+#endif
+    }
+  }
+
+  bool PerformanceTrace::enabled_ = false;
+
+  Size PerformanceTrace::depth_ = 0;
+
+  PerformanceTrace::Scope::Scope(const char* name, const char* category) :
+    name_(name),
+    category_(category),
+    start_(0.0),
+    active_(PerformanceTrace::isEnabled()),
+    serial_(false),
+    top_level_(false)
+  {
+    if (active_)
+    {
+      // the depth is only changed outside of parallel regions, i.e. by one thread at a time:
+      serial_ = !inParallelRegion();
+      if (serial_)
+      {
+        top_level_ = (PerformanceTrace::depth_ <= 1);
+        ++PerformanceTrace::depth_;
+      }
+      start_ = PerformanceTrace::now();
+    }
+  }
+
+  PerformanceTrace::Scope::~Scope()
+  {
+    if (active_)
+    {
+      double duration = PerformanceTrace::now() - start_;
+      if (serial_) --PerformanceTrace::depth_;
+      PerformanceTrace::addScope(name_, category_, start_, duration, top_level_);
+    }
+  }
+
+  void PerformanceTrace::setEnabled(bool enabled)
+  {
+    if (enabled && !enabled_) traceOrigin() = TraceClock::now();
+    enabled_ = enabled;
+  }
+
+  double PerformanceTrace::now()
+  {
+    return std::chrono::duration<double, std::micro>(TraceClock::now() - traceOrigin()).count();
+  }
+
+  void PerformanceTrace::addScope(const String& name, const String& category, double start, double duration, bool sample_memory)
+  {
+    Event event;
+    event.type = Event::SCOPE;
+    event.name = name;
+    event.category = category;
+    event.start = start;
+    event.duration = duration;
+    event.value = 0.0;
+    event.memory = 0;
+    if (sample_memory)
+    {
+      size_t mem(0);
+      SysInfo::getProcessMemoryConsumption(mem);
+      event.memory = mem;
+    }
+    add_(event);
+  }
+
+  void PerformanceTrace::addCounter(const String& name, double value, const String& category)
+  {
+    Event event;
+    event.type = Event::COUNTER;
+    event.name = name;
+    event.category = category;
+    event.start = now();
+    event.duration = 0.0;
+    event.value = value;
+    event.memory = 0;
+    add_(event);
+  }
+
+  void PerformanceTrace::add_(Event& event)
+  {
+#ifdef _OPENMP
+    event.thread = omp_get_thread_num();
+#else
+    event.thread = 0;
+#endif
+
+#ifdef _OPENMP
+#pragma omp critical (PerformanceTrace_events)
+#endif
+    traceEvents().push_back(event);
+  }
+
+  std::vector<PerformanceTrace::Event> PerformanceTrace::getEvents()
+  {
+    std::vector<Event> events;
+#ifdef _OPENMP
+#pragma omp critical (PerformanceTrace_events)
+#endif
+    events = traceEvents();
+    return events;
+  }
+
+  void PerformanceTrace::clear()
+  {
+#ifdef _OPENMP
+#pragma omp critical (PerformanceTrace_events)
+#endif
+    traceEvents().clear();
+  }
+
+  void PerformanceTrace::write(std::ostream& os)
+  {
+    std::vector<Event> events = getEvents();
+
+    os << std::fixed << std::setprecision(3);
+    os << "{\"traceEvents\":[";
+    for (Size i = 0; i < events.size(); ++i)
+    {
+      const Event& e = events[i];
+      os << (i == 0 ? "\n" : ",\n");
+      os << "{\"name\":";
+      writeJSONString(os, e.name);
+      os << ",\"cat\":";
+      writeJSONString(os, e.category);
+      if (e.type == Event::SCOPE)
+      {
+        os << ",\"ph\":\"X\",\"ts\":" << e.start << ",\"dur\":" << e.duration
+           << ",\"pid\":1,\"tid\":" << e.thread;
+        if (e.memory > 0)
+        {
+          os << ",\"args\":{\"memory_kb\":" << e.memory << "}}";
+          // memory track, sampled at the end of each top-level phase
+          os << ",\n{\"name\":\"memory (KB)\",\"ph\":\"C\",\"ts\":" << e.start + e.duration
+             << ",\"pid\":1,\"args\":{\"memory\":" << e.memory << "}}";
+        }
+        else
+        {
+          os << "}";
+        }
+      }
+      else
+      {
+        os << ",\"ph\":\"C\",\"ts\":" << e.start
+           << ",\"pid\":1,\"tid\":" << e.thread
+           << ",\"args\":{\"value\":" << e.value << "}}";
+      }
+    }
+    size_t peak(0);
+    SysInfo::getProcessPeakMemoryConsumption(peak);
+    os << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"peak_memory_kb\":" << peak << "}}\n";
+  }
+
+  void PerformanceTrace::store(const String& filename)
+  {
+    std::ofstream os(filename.c_str());
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    write(os);
+  }
+
+} // namespace OpenMS
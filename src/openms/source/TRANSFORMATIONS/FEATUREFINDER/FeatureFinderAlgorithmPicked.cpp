@@ -41,6 +41,7 @@
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 #include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/CHEMISTRY/IsotopeDistribution.h>
+#include <OpenMS/CHEMISTRY/IsotopePatternGenerator.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 #include <OpenMS/CHEMISTRY/Element.h>
@@ -392,13 +393,19 @@ namespace OpenMS
       //reserve enough space
       isotope_distributions_.resize(num_isotopes);
 
+      //calculate the averagine distributions of all mass windows in one batch
+      std::vector<double> masses(num_isotopes);
+      for (Size index = 0; index < num_isotopes; ++index)
+      {
+        masses[index] = 0.5 * mass_window_width_ + index * mass_window_width_;
+      }
+      std::vector<IsotopeDistribution> distributions = IsotopePatternGenerator::getInstance()->getAveragineDistributions(masses, max_isotopes);
+
       //calculate distribution if necessary
       for (Size index = 0; index < num_isotopes; ++index)
       {
         //if(debug_) log_ << "Calculating iso dist for mass: " << 0.5*mass_window_width_ + index * mass_window_width_ << std::endl;
-        IsotopeDistribution d;
-        d.setMaxIsotope(max_isotopes);
-        d.estimateFromPeptideWeight(0.5 * mass_window_width_ + index * mass_window_width_);
+        IsotopeDistribution& d = distributions[index];
         //trim left and right. And store the number of isotopes on the left, to reconstruct the monoisotopic peak
         Size size_before = d.size();
         d.trimLeft(intensity_percentage_optional_);
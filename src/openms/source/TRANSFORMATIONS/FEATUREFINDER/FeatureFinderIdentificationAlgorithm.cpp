@@ -49,6 +49,8 @@
 #include <OpenMS/CHEMISTRY/ElementDB.h>
 #include <OpenMS/CHEMISTRY/IsotopeDistribution.h>
 #include <OpenMS/ANALYSIS/MAPMATCHING/MapAlignmentAlgorithmIdentification.h>
+#include <OpenMS/SYSTEM/PerformanceTrace.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/DataAccessHelper.h>
 
 #include <boost/math/special_functions/fpclassify.hpp>
 
@@ -56,6 +58,7 @@
 #include <numeric>
 #include <fstream>
 #include <algorithm>
+#include <exception>
 
 #include <QtCore/QDir>
 
@@ -103,6 +106,12 @@ namespace OpenMS
       "RT window size (in sec.) for chromatogram extraction. If set, this parameter takes precedence over 'extract:rt_quantile'.",
       ListUtils::create<String>("advanced"));
     defaults_.setMinFloat("extract:rt_window", 0.0);
+    defaults_.setValue(
+      "extract:batch_size",
+      5000,
+      "Number of peptide assays to process at once (chromatogram extraction and feature detection). Batches are processed in parallel if multiple threads are available. Smaller batches need less memory, each batch requires a pass over the LC-MS data. Set to 0 to process all assays at once.",
+      ListUtils::create<String>("advanced"));
+    defaults_.setMinInt("extract:batch_size", 0);
 
     defaults_.setSectionDescription("extract", "Parameters for ion chromatogram extraction");
 
@@ -275,36 +284,23 @@ namespace OpenMS
     //-------------------------------------------------------------
     // run feature detection
     //-------------------------------------------------------------
-    LOG_INFO << "Extracting chromatograms..." << endl;
-    ChromatogramExtractor extractor;
-    // extractor.setLogType(ProgressLogger::NONE);
-    vector<OpenSwath::ChromatogramPtr> chrom_temp;
-    vector<ChromatogramExtractor::ExtractionCoordinates> coords;
-    extractor.prepare_coordinates(chrom_temp, coords, library_,
-                                  numeric_limits<double>::quiet_NaN(), false);
-
-    boost::shared_ptr<PeakMap> shared = boost::make_shared<PeakMap>(ms_data_);
-    OpenSwath::SpectrumAccessPtr spec_temp =
-      SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(shared);
-    extractor.extractChromatograms(spec_temp, chrom_temp, coords, mz_window_,
-                                   mz_window_ppm_, "tophat");
-    extractor.return_chromatogram(chrom_temp, coords, library_, (*shared)[0],
-                                  chrom_data_.getChromatograms(), false);
-
-    LOG_DEBUG << "Extracted " << chrom_data_.getNrChromatograms()
-              << " chromatogram(s)." << endl;
-
-    LOG_INFO << "Detecting chromatographic peaks..." << endl;
+    LOG_INFO << "Extracting chromatograms and detecting chromatographic peaks..."
+             << endl;
     Log_info.remove(cout); // suppress status output from OpenSWATH
-    feat_finder_.pickExperiment(chrom_data_, features, library_,
-                                TransformationDescription(), ms_data_);
+    extractAndDetectFeatures_(features);
     Log_info.insert(cout);
+    LOG_DEBUG << "Extracted " << chrom_data_.getNrChromatograms()
+              << " chromatogram(s)." << endl;
     LOG_INFO << "Found " << features.size() << " feature candidates in total."
              << endl;
+    OPENMS_TRACE_COUNTER("FeatureFinderIdentification feature candidates", features.size());
     ms_data_.reset(); // not needed anymore, free up the memory
 
     // complete feature annotation:
-    annotateFeatures_(features, ref_rt_map);
+    {
+      OPENMS_TRACE_SCOPE("FeatureFinderIdentification: annotation");
+      annotateFeatures_(features, ref_rt_map);
+    }
 
     // sort everything:
     sort(features.getUnassignedPeptideIdentifications().begin(),
@@ -312,7 +308,10 @@ namespace OpenMS
          peptide_compare_);
     sort(features.begin(), features.end(), feature_compare_);
 
-    postProcess_(features, with_external_ids);
+    {
+      OPENMS_TRACE_SCOPE("FeatureFinderIdentification: post-processing");
+      postProcess_(features, with_external_ids);
+    }
     statistics_(features);
 
     features.setProteinIdentifications(proteins);
@@ -327,6 +326,182 @@ namespace OpenMS
     features.ensureUniqueId();
   }
 
+  void FeatureFinderIdentificationAlgorithm::extractAndDetectFeatures_(FeatureMap& features)
+  {
+    // the MS data is shared with the OpenSWATH classes, not copied (the
+    // pointer does not own the map, hence the no-op deleter):
+    boost::shared_ptr<PeakMap> shared(&ms_data_, [](PeakMap*) {});
+    OpenSwath::SpectrumAccessPtr spec_temp =
+      SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(shared);
+    const SpectrumSettings settings = ms_data_.empty() ? SpectrumSettings() : SpectrumSettings(ms_data_[0]);
+
+    // extraction coordinates for all assays, sorted by m/z (in this order the
+    // chromatograms are stored in "chrom_data_"):
+    ChromatogramExtractor extractor;
+    vector<OpenSwath::ChromatogramPtr> chrom_temp;
+    vector<ChromatogramExtractor::ExtractionCoordinates> coords;
+    extractor.prepare_coordinates(chrom_temp, coords, library_,
+                                  numeric_limits<double>::quiet_NaN(), false);
+    chrom_temp.clear();
+
+    OpenSwath::LightTargetedExperiment light_library;
+    OpenSwathDataAccessHelper::convertTargetedExp(library_, light_library);
+
+    // batches of assays - contiguous ranges of the assays sorted by RT (ties
+    // broken by ID), so each batch only covers a narrow RT range and the
+    // extraction only needs to access the spectra in that range:
+    vector<Size> compound_order(light_library.getCompounds().size());
+    for (Size i = 0; i < compound_order.size(); ++i) compound_order[i] = i;
+    sort(compound_order.begin(), compound_order.end(),
+         [&light_library](Size i, Size j)
+         {
+           const OpenSwath::LightCompound& ci = light_library.getCompounds()[i];
+           const OpenSwath::LightCompound& cj = light_library.getCompounds()[j];
+           return (ci.rt < cj.rt) || ((ci.rt == cj.rt) && (ci.id < cj.id));
+         });
+    if (compound_order.empty()) return;
+    Size batch_size = (batch_size_ == 0) ? compound_order.size() : batch_size_;
+    Size n_batches = (compound_order.size() + batch_size - 1) / batch_size;
+
+    map<String, Size> batch_by_ref;
+    for (Size i = 0; i < compound_order.size(); ++i)
+    {
+      batch_by_ref[light_library.getCompounds()[compound_order[i]].id] = i / batch_size;
+    }
+    vector<vector<Size> > batch_transitions(n_batches), batch_coords(n_batches);
+    map<String, Size> batch_by_transition;
+    for (Size i = 0; i < light_library.getTransitions().size(); ++i)
+    {
+      const OpenSwath::LightTransition& transition = light_library.getTransitions()[i];
+      map<String, Size>::const_iterator pos = batch_by_ref.find(transition.getPeptideRef());
+      if (pos == batch_by_ref.end())
+      {
+        throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                         "peptide reference '" + transition.getPeptideRef() +
+                                         "' of transition '" + transition.getNativeID() + "'");
+      }
+      batch_transitions[pos->second].push_back(i);
+      batch_by_transition[transition.getNativeID()] = pos->second;
+    }
+    for (Size i = 0; i < coords.size(); ++i)
+    {
+      map<String, Size>::const_iterator pos = batch_by_transition.find(coords[i].id);
+      if (pos == batch_by_transition.end())
+      {
+        throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                         "transition '" + coords[i].id + "'");
+      }
+      batch_coords[pos->second].push_back(i);
+    }
+
+    vector<MSChromatogram> chromatograms(coords.size());
+    vector<FeatureMap> batch_features(n_batches);
+
+    // exceptions must not leave the parallel region, so we rethrow the first one afterwards:
+    std::exception_ptr error;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (SignedSize batch = 0; batch < (SignedSize)n_batches; ++batch)
+    {
+      try
+      {
+        OPENMS_TRACE_SCOPE("FeatureFinderIdentification: extraction and peak picking (batch)");
+
+        // assays of the current batch:
+        OpenSwath::LightTargetedExperiment batch_library;
+        batch_library.proteins = light_library.proteins;
+        Size first = batch * batch_size, last = min(first + batch_size, compound_order.size());
+        for (Size i = first; i < last; ++i)
+        {
+          batch_library.compounds.push_back(light_library.getCompounds()[compound_order[i]]);
+        }
+        for (Size i = 0; i < batch_transitions[batch].size(); ++i)
+        {
+          batch_library.transitions.push_back(light_library.getTransitions()[batch_transitions[batch][i]]);
+        }
+
+        // extract chromatograms (only within the RT regions of the assays):
+        const vector<Size>& indexes = batch_coords[batch];
+        vector<ChromatogramExtractor::ExtractionCoordinates> batch_coord;
+        vector<OpenSwath::ChromatogramPtr> batch_chroms;
+        for (Size i = 0; i < indexes.size(); ++i)
+        {
+          batch_coord.push_back(coords[indexes[i]]);
+          batch_chroms.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+        }
+        ChromatogramExtractor batch_extractor;
+        batch_extractor.extractChromatograms(spec_temp->lightClone(), batch_chroms,
+                                             batch_coord, mz_window_,
+                                             mz_window_ppm_, "tophat");
+        boost::shared_ptr<PeakMap> batch_chrom_data = boost::make_shared<PeakMap>();
+        // "return_chromatogram" annotates the data processing entries, which
+        // are shared pointers - use batch-local copies to avoid a data race:
+        SpectrumSettings batch_settings = settings;
+        for (Size i = 0; i < batch_settings.getDataProcessing().size(); ++i)
+        {
+          DataProcessingPtr& processing = batch_settings.getDataProcessing()[i];
+          processing = boost::make_shared<DataProcessing>(*processing);
+        }
+        // meta data of the chromatograms comes from the batch's own assays (not
+        // from the shared library, whose reference maps are built lazily):
+        ChromatogramExtractor::return_chromatogram(batch_chroms, batch_coord, batch_library, batch_settings,
+                                                   batch_chrom_data->getChromatograms(), false);
+        batch_chroms.clear();
+
+        // detect features:
+        MRMFeatureFinderScoring feat_finder;
+        feat_finder.setParameters(feat_finder_.getParameters());
+        feat_finder.setLogType(ProgressLogger::NONE);
+        feat_finder.setStrictFlag(false);
+        OpenSwath::SwathMap swath_map;
+        swath_map.sptr = spec_temp->lightClone();
+        vector<OpenSwath::SwathMap> swath_maps(1, swath_map);
+        MRMFeatureFinderScoring::TransitionGroupMapType transition_group_map;
+        feat_finder.pickExperiment(SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(batch_chrom_data),
+                                   batch_features[batch], batch_library,
+                                   TransformationDescription(), swath_maps,
+                                   transition_group_map);
+        batch_features[batch].getProteinIdentifications().clear();
+
+        for (Size i = 0; i < indexes.size(); ++i)
+        {
+          swap(chromatograms[indexes[i]], batch_chrom_data->getChromatograms()[i]);
+        }
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (FeatureFinderIdentificationAlgorithm_error)
+#endif
+        if (!error) error = std::current_exception();
+      }
+    }
+
+    if (error) std::rethrow_exception(error);
+
+    // collect results in the order of the batches:
+    if (chrom_data_.getChromatograms().empty())
+    {
+      chrom_data_.getChromatograms().swap(chromatograms);
+    }
+    else
+    {
+      chrom_data_.getChromatograms().insert(chrom_data_.getChromatograms().end(),
+                                            chromatograms.begin(), chromatograms.end());
+    }
+    for (Size batch = 0; batch < n_batches; ++batch)
+    {
+      for (FeatureMap::Iterator it = batch_features[batch].begin();
+           it != batch_features[batch].end(); ++it)
+      {
+        features.push_back(*it);
+      }
+      FeatureMap().swap(batch_features[batch]);
+    }
+  }
+
   void FeatureFinderIdentificationAlgorithm::postProcess_(
    FeatureMap & features,
    bool with_external_ids)
@@ -981,6 +1156,7 @@ namespace OpenMS
 
     isotope_pmin_ = param_.getValue("extract:isotope_pmin");
     n_isotopes_ = param_.getValue("extract:n_isotopes");
+    batch_size_ = (Int)param_.getValue("extract:batch_size");
 
     mapping_tolerance_ = param_.getValue("detect:mapping_tolerance");
 
@@ -35,6 +35,7 @@
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/KERNEL/BaseFeature.h>
 #include <OpenMS/CHEMISTRY/IsotopeDistribution.h>
+#include <OpenMS/CHEMISTRY/IsotopePatternGenerator.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFiltering.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
@@ -47,9 +48,71 @@ using namespace boost::math;
 namespace OpenMS
 {
 
+  const int MultiplexFiltering::block_size_ = 64;
+
+  const double MultiplexFiltering::averagine_bin_width_ = 1.0;
+
+  const int MultiplexFiltering::averagine_samples_per_bin_ = 20;
+
   MultiplexFiltering::MultiplexFiltering(const PeakMap& exp_picked, const std::vector<MultiplexIsotopicPeakPattern> patterns, int peaks_per_peptide_min, int peaks_per_peptide_max, bool missing_peaks, double intensity_cutoff, double mz_tolerance, bool mz_tolerance_unit, double peptide_similarity, double averagine_similarity, double averagine_similarity_scaling, String averigine_type) :
     exp_picked_(exp_picked), patterns_(patterns), peaks_per_peptide_min_(peaks_per_peptide_min), peaks_per_peptide_max_(peaks_per_peptide_max), missing_peaks_(missing_peaks), intensity_cutoff_(intensity_cutoff), mz_tolerance_(mz_tolerance), mz_tolerance_unit_(mz_tolerance_unit), peptide_similarity_(peptide_similarity), averagine_similarity_(averagine_similarity), averagine_similarity_scaling_(averagine_similarity_scaling), averagine_type_(averigine_type)
   {
+    // Precompute the averagine patterns for all masses which can occur during filtering.
+    // The averagine formula is rounded to whole atoms, so it is the same for many neighbouring masses.
+    double mz_max = 0;
+    for (PeakMap::ConstIterator it = exp_picked_.begin(); it != exp_picked_.end(); ++it)
+    {
+      if (!it->empty())
+      {
+        mz_max = std::max(mz_max, it->back().getMZ());
+      }
+    }
+    int charge_max = 0;
+    for (std::vector<MultiplexIsotopicPeakPattern>::const_iterator it = patterns_.begin(); it != patterns_.end(); ++it)
+    {
+      charge_max = std::max(charge_max, it->getCharge());
+    }
+    if (peaks_per_peptide_max_ <= 0 || mz_max * charge_max <= 0)
+    {
+      return;
+    }
+    // checks the averagine type (exceptions must not leave the parallel loop below)
+    IsotopePatternGenerator::getAveragineFormula(mz_max, averagine_type_);
+
+    averagine_patterns_.resize((Size)(mz_max * charge_max / averagine_bin_width_) + 1);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (SignedSize bin = 0; bin < (SignedSize)averagine_patterns_.size(); ++bin)
+    {
+      AveragineBin_& entries = averagine_patterns_[bin];
+      for (int sample = 0; sample < averagine_samples_per_bin_; ++sample)
+      {
+        double m = (bin + double(sample) / averagine_samples_per_bin_) * averagine_bin_width_;
+        EmpiricalFormula formula = IsotopePatternGenerator::getAveragineFormula(m, averagine_type_);
+        bool known = false;
+        for (AveragineBin_::const_iterator it = entries.begin(); it != entries.end(); ++it)
+        {
+          if (it->first == formula)
+          {
+            known = true;
+            break;
+          }
+        }
+        if (known)
+        {
+          continue;
+        }
+
+        // (The patterns are calculated for each number of isotopes, since truncating a longer pattern is not exactly the same.)
+        std::vector<std::vector<double> > patterns;
+        for (int isotopes = 1; isotopes <= peaks_per_peptide_max_; ++isotopes)
+        {
+          patterns.push_back(calculateAveraginePattern_(formula, isotopes));
+        }
+        entries.push_back(std::make_pair(formula, patterns));
+      }
+    }
   }
 
   int MultiplexFiltering::positionsAndBlacklistFilter_(const MultiplexIsotopicPeakPattern& pattern, int spectrum,
@@ -349,6 +412,36 @@ namespace OpenMS
     }
   }
 
+  bool MultiplexFiltering::blacklistChanged_(const MultiplexIsotopicPeakPattern& pattern, int spectrum, const vector<double>& peak_position, int peak, const vector<char>& black_before) const
+  {
+    for (unsigned mz_position = 0; mz_position < pattern.getMZShiftCount(); ++mz_position)
+    {
+      double scaling = 1;
+      if (mz_position % (peaks_per_peptide_max_ + 1) == 0)
+      {
+        scaling = 2;
+      }
+
+      // same look-up as in positionsAndBlacklistFilter_()
+      int index = getPeakIndex_(peak_position, peak, peak_position[peak] + pattern.getMZShiftAt(mz_position), scaling);
+      if (index != -1 && blacklist_[spectrum][index].black != (black_before[index] != 0))
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  void MultiplexFiltering::getBlacklistFlags_(int spectrum, vector<char>& black) const
+  {
+    black.resize(blacklist_[spectrum].size());
+    for (Size i = 0; i < blacklist_[spectrum].size(); ++i)
+    {
+      black[i] = blacklist_[spectrum][i].black;
+    }
+  }
+
   int MultiplexFiltering::getPeakIndex_(const std::vector<double>& peak_position, int start, double mz, double scaling) const
   {
     const double tolerance_th = mz_tolerance_unit_ ? (scaling * mz_tolerance_ / 1000000) * peak_position[start] : scaling * mz_tolerance_;
@@ -388,34 +481,41 @@ namespace OpenMS
   double MultiplexFiltering::getAveragineSimilarity_(const vector<double>& pattern, double m) const
 
   {
-    // construct averagine distribution
-    IsotopeDistribution distribution;
-    vector<double> averagine_pattern;
-    distribution.setMaxIsotope(pattern.size());
-    if (averagine_type_ == "peptide")
+    if (pattern.empty())
     {
-        distribution.estimateFromPeptideWeight(m);
-    }
-    else if (averagine_type_ == "RNA")
-    {
-        distribution.estimateFromRNAWeight(m);
-    }
-    else if (averagine_type_ == "DNA")
-    {
-        distribution.estimateFromDNAWeight(m);
+      return std::numeric_limits<double>::quiet_NaN();
     }
-    else
+
+    // look up the averagine pattern by the exact averagine formula at this mass
+    EmpiricalFormula formula = IsotopePatternGenerator::getAveragineFormula(m, averagine_type_);
+    Size bin = (Size)(m / averagine_bin_width_);
+    if (m >= 0 && bin < averagine_patterns_.size())
     {
-        throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-          "Averagine type unrecognized.");;
+      const AveragineBin_& entries = averagine_patterns_[bin];
+      for (AveragineBin_::const_iterator it = entries.begin(); it != entries.end(); ++it)
+      {
+        if (it->first == formula && pattern.size() <= it->second.size())
+        {
+          return getPatternSimilarity_(pattern, it->second[pattern.size() - 1]);
+        }
+      }
     }
 
+    return getPatternSimilarity_(pattern, calculateAveraginePattern_(formula, pattern.size()));
+  }
+
+  vector<double> MultiplexFiltering::calculateAveraginePattern_(const EmpiricalFormula& formula, Size isotopes) const
+  {
+    // same as IsotopeDistribution::estimateFromPeptideWeight() etc., which use the averagine formula internally
+    IsotopeDistribution distribution = formula.getIsotopeDistribution((UInt)isotopes);
+    vector<double> averagine_pattern;
+
     for (IsotopeDistribution::Iterator it = distribution.begin(); it != distribution.end(); ++it)
     {
       averagine_pattern.push_back(it->second);
     }
 
-    return getPatternSimilarity_(pattern, averagine_pattern);
+    return averagine_pattern;
   }
 
 }
@@ -37,6 +37,7 @@
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFilteringCentroided.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
+#include <OpenMS/SYSTEM/PerformanceTrace.h>
 
 #include <QDir>
 
@@ -102,6 +103,8 @@ namespace OpenMS
 
   vector<MultiplexFilterResult> MultiplexFilteringCentroided::filter()
   {
+    OPENMS_TRACE_SCOPE("MultiplexFilteringCentroided: filter");
+
     // progress logger
     unsigned progress = 0;
     startProgress(0, patterns_.size() * exp_picked_.size(), "filtering LC-MS data");
@@ -109,119 +112,101 @@ namespace OpenMS
     // list of filter results for each peak pattern
     vector<MultiplexFilterResult> filter_results;
 
+    const int spectrum_count = exp_picked_.size();
+
     // loop over patterns
     for (unsigned pattern = 0; pattern < patterns_.size(); ++pattern)
     {
       // data structure storing peaks which pass all filters
       MultiplexFilterResult result;
 
-      // iterate over spectra
-      for (PeakMap::Iterator it_rt_picked = exp_picked_.begin(); it_rt_picked < exp_picked_.end(); ++it_rt_picked)
+      // Spectra are processed in blocks. Within a block, all peaks are filtered concurrently against the
+      // blacklist as it was at the start of the block. The peaks which passed are then blacklisted and added
+      // to the result in the original spectrum and peak order. Peaks whose blacklist entries changed in the
+      // meantime are filtered again, hence the result is identical to a sequential scan.
+      for (int block_begin = 0; block_begin < spectrum_count; block_begin += block_size_)
       {
-        // skip empty spectra
-        if (it_rt_picked->empty())
-        {
-          continue;
-        }
+        const int block_end = std::min(block_begin + block_size_, spectrum_count);
 
-        setProgress(++progress);
-
-        int spectrum = it_rt_picked - exp_picked_.begin(); // index of the spectrum in exp_picked_
-        double rt_picked = it_rt_picked->getRT();
-
-        // vectors of peak details
-        vector<double> peak_position;
-        vector<double> peak_intensity;
-        peak_position.reserve(it_rt_picked->size());
-        peak_intensity.reserve(it_rt_picked->size());
-        for (MSSpectrum::Iterator it_mz = it_rt_picked->begin(); it_mz < it_rt_picked->end(); ++it_mz)
+        // peaks passing all filters (one buffer per spectrum)
+        vector<vector<PeakCandidate> > candidates(block_end - block_begin);
+        // blacklist at the start of the block
+        vector<vector<char> > black_before(block_end - block_begin);
+        for (int spectrum = block_begin; spectrum < block_end; ++spectrum)
         {
-          peak_position.push_back(it_mz->getMZ());
-          peak_intensity.push_back(it_mz->getIntensity());
+          getBlacklistFlags_(spectrum, black_before[spectrum - block_begin]);
         }
 
-        // iterate over peaks in spectrum (mz)
-        for (unsigned peak = 0; peak < peak_position.size(); ++peak)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+        for (SignedSize spectrum = block_begin; spectrum < block_end; ++spectrum)
         {
+          vector<double> peak_position;
+          getPeakPositions_(spectrum, peak_position);
 
-          /**
-           * Filter (1): m/z position and blacklist filter
-           * Are there non-black peaks with the expected relative m/z shifts?
-           */
-          vector<double> mz_shifts_actual; // actual m/z shifts (differ slightly from expected m/z shifts)
-          vector<int> mz_shifts_actual_indices; // peak indices in the spectrum corresponding to the actual m/z shifts
-
-          mz_shifts_actual.reserve(patterns_[pattern].getMZShiftCount());
-          mz_shifts_actual_indices.reserve(patterns_[pattern].getMZShiftCount());
-
-          int peaks_found_in_all_peptides = positionsAndBlacklistFilter_(patterns_[pattern], spectrum, peak_position, peak, mz_shifts_actual, mz_shifts_actual_indices);
-          if (peaks_found_in_all_peptides < peaks_per_peptide_min_)
+          for (int peak = 0; peak < (int) peak_position.size(); ++peak)
           {
-            continue;
+            PeakCandidate candidate;
+            if (filterPeak_(patterns_[pattern], spectrum, peak_position, peak, candidate))
+            {
+              candidates[spectrum - block_begin].push_back(candidate);
+            }
           }
+        }
 
-          /**
-           * Filter (2): blunt intensity filter
-           * Are the mono-isotopic peak intensities of all peptides above the cutoff?
-           */
-          bool bluntVeto = monoIsotopicPeakIntensityFilter_(patterns_[pattern], spectrum, mz_shifts_actual_indices);
-          if (bluntVeto)
+        // commit the block in the original order
+        vector<bool> touched(block_end - block_begin, false);
+        for (int spectrum = block_begin; spectrum < block_end; ++spectrum)
+        {
+          // skip empty spectra
+          if (exp_picked_[spectrum].empty())
           {
             continue;
           }
 
-          /**
-           * Filter (3): non-local intensity filter
-           * Are the peak intensities of all peptides above the cutoff?
-           */
-          std::vector<double> intensities_actual; // peak intensities @ m/z peak position + actual m/z shift
-          int peaks_found_in_all_peptides_centroided = nonLocalIntensityFilter_(patterns_[pattern], spectrum, mz_shifts_actual_indices, intensities_actual, peaks_found_in_all_peptides);
-          if (peaks_found_in_all_peptides_centroided < peaks_per_peptide_min_)
-          {
-            continue;
-          }
+          setProgress(++progress);
 
-          /**
-           * Filter (4): zeroth peak filter
-           * There should not be a significant peak to the left of the mono-isotopic
-           * (i.e. first) peak.
-           */
-          bool zero_peak = zerothPeakFilter_(patterns_[pattern], intensities_actual);
-          if (zero_peak)
-          {
-            continue;
-          }
+          int index = spectrum - block_begin;
+          double rt_picked = exp_picked_[spectrum].getRT();
 
-          /**
-           * Filter (5): peptide similarity filter
-           * How similar are the isotope patterns of the peptides?
-           */
-          bool peptide_similarity = peptideSimilarityFilter_(patterns_[pattern], intensities_actual, peaks_found_in_all_peptides_centroided);
-          if (!peptide_similarity)
-          {
-            continue;
-          }
+          vector<double> peak_position;
+          getPeakPositions_(spectrum, peak_position);
 
-          /**
-           * Filter (6): averagine similarity filter
-           * Does each individual isotope pattern resemble a peptide?
-           */
-          bool averagine_similarity = averagineSimilarityFilter_(patterns_[pattern], intensities_actual, peaks_found_in_all_peptides_centroided, peak_position[peak]);
-          if (!averagine_similarity)
+          vector<PeakCandidate>::iterator it_candidate = candidates[index].begin();
+          for (int peak = 0; peak < (int) peak_position.size(); ++peak)
           {
-            continue;
+            bool speculative = (it_candidate != candidates[index].end() && it_candidate->peak == peak);
+
+            PeakCandidate candidate;
+            if (touched[index] && blacklistChanged_(patterns_[pattern], spectrum, peak_position, peak, black_before[index]))
+            {
+              if (!filterPeak_(patterns_[pattern], spectrum, peak_position, peak, candidate))
+              {
+                if (speculative) ++it_candidate;
+                continue;
+              }
+            }
+            else if (speculative)
+            {
+              std::swap(candidate, *it_candidate);
+            }
+            else
+            {
+              continue;
+            }
+            if (speculative) ++it_candidate;
+
+            // add the peak to the result
+            result.addFilterResultPeak(peak_position[peak], rt_picked, candidate.mz_shifts_actual, candidate.intensities_actual, candidate.results_raw);
+
+            // blacklist peaks in the current spectrum and the two neighbouring ones
+            blacklistPeaks_(patterns_[pattern], spectrum, candidate.mz_shifts_actual_indices, candidate.peaks_found_in_all_peptides);
+            for (int i = std::max(spectrum - 2, block_begin); i <= std::min(spectrum + 2, block_end - 1); ++i)
+            {
+              touched[i - block_begin] = true;
+            }
           }
-
-          /**
-           * All filters passed.
-           */
-          // add the peak to the result
-          vector<MultiplexFilterResultRaw> results_raw;
-          result.addFilterResultPeak(peak_position[peak], rt_picked, mz_shifts_actual, intensities_actual, results_raw);
-
-          // blacklist peaks in the current spectrum and the two neighbouring ones
-          blacklistPeaks_(patterns_[pattern], spectrum, mz_shifts_actual_indices, peaks_found_in_all_peptides_centroided);
-
         }
       }
 
@@ -234,6 +219,95 @@ namespace OpenMS
     return filter_results;
   }
 
+  void MultiplexFilteringCentroided::getPeakPositions_(int spectrum, vector<double>& peak_position) const
+  {
+    const MSSpectrum& spectrum_picked = exp_picked_[spectrum];
+    peak_position.reserve(spectrum_picked.size());
+    for (MSSpectrum::ConstIterator it_mz = spectrum_picked.begin(); it_mz < spectrum_picked.end(); ++it_mz)
+    {
+      peak_position.push_back(it_mz->getMZ());
+    }
+  }
+
+  bool MultiplexFilteringCentroided::filterPeak_(const MultiplexIsotopicPeakPattern& pattern, int spectrum, const vector<double>& peak_position, int peak, PeakCandidate& candidate) const
+  {
+    candidate.peak = peak;
+
+    /**
+     * Filter (1): m/z position and blacklist filter
+     * Are there non-black peaks with the expected relative m/z shifts?
+     */
+    vector<double>& mz_shifts_actual = candidate.mz_shifts_actual; // actual m/z shifts (differ slightly from expected m/z shifts)
+    vector<int>& mz_shifts_actual_indices = candidate.mz_shifts_actual_indices; // peak indices in the spectrum corresponding to the actual m/z shifts
+
+    mz_shifts_actual.reserve(pattern.getMZShiftCount());
+    mz_shifts_actual_indices.reserve(pattern.getMZShiftCount());
+
+    int peaks_found_in_all_peptides = positionsAndBlacklistFilter_(pattern, spectrum, peak_position, peak, mz_shifts_actual, mz_shifts_actual_indices);
+    if (peaks_found_in_all_peptides < peaks_per_peptide_min_)
+    {
+      return false;
+    }
+
+    /**
+     * Filter (2): blunt intensity filter
+     * Are the mono-isotopic peak intensities of all peptides above the cutoff?
+     */
+    bool bluntVeto = monoIsotopicPeakIntensityFilter_(pattern, spectrum, mz_shifts_actual_indices);
+    if (bluntVeto)
+    {
+      return false;
+    }
+
+    /**
+     * Filter (3): non-local intensity filter
+     * Are the peak intensities of all peptides above the cutoff?
+     */
+    std::vector<double>& intensities_actual = candidate.intensities_actual; // peak intensities @ m/z peak position + actual m/z shift
+    int peaks_found_in_all_peptides_centroided = nonLocalIntensityFilter_(pattern, spectrum, mz_shifts_actual_indices, intensities_actual, peaks_found_in_all_peptides);
+    if (peaks_found_in_all_peptides_centroided < peaks_per_peptide_min_)
+    {
+      return false;
+    }
+
+    /**
+     * Filter (4): zeroth peak filter
+     * There should not be a significant peak to the left of the mono-isotopic
+     * (i.e. first) peak.
+     */
+    bool zero_peak = zerothPeakFilter_(pattern, intensities_actual);
+    if (zero_peak)
+    {
+      return false;
+    }
+
+    /**
+     * Filter (5): peptide similarity filter
+     * How similar are the isotope patterns of the peptides?
+     */
+    bool peptide_similarity = peptideSimilarityFilter_(pattern, intensities_actual, peaks_found_in_all_peptides_centroided);
+    if (!peptide_similarity)
+    {
+      return false;
+    }
+
+    /**
+     * Filter (6): averagine similarity filter
+     * Does each individual isotope pattern resemble a peptide?
+     */
+    bool averagine_similarity = averagineSimilarityFilter_(pattern, intensities_actual, peaks_found_in_all_peptides_centroided, peak_position[peak]);
+    if (!averagine_similarity)
+    {
+      return false;
+    }
+
+    /**
+     * All filters passed.
+     */
+    candidate.peaks_found_in_all_peptides = peaks_found_in_all_peptides_centroided;
+    return true;
+  }
+
   int MultiplexFilteringCentroided::nonLocalIntensityFilter_(const MultiplexIsotopicPeakPattern& pattern, int spectrum_index, const std::vector<int>& mz_shifts_actual_indices, std::vector<double>& intensities_actual, int peaks_found_in_all_peptides) const
   {
     PeakMap::ConstIterator it_rt = exp_picked_.begin() + spectrum_index;
@@ -37,9 +37,12 @@
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFilteringProfile.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
+#include <OpenMS/SYSTEM/PerformanceTrace.h>
 
 #include <QDir>
 
+#include <boost/shared_ptr.hpp>
+
 using namespace std;
 using namespace boost::math;
 
@@ -114,6 +117,17 @@ namespace OpenMS
 
   vector<MultiplexFilterResult> MultiplexFilteringProfile::filter()
   {
+    OPENMS_TRACE_SCOPE("MultiplexFilteringProfile: filter");
+
+    const int spectrum_count = exp_profile_.size();
+    for (int spectrum = 0; spectrum < spectrum_count; ++spectrum)
+    {
+      if (!skipSpectrum_(spectrum) && exp_picked_[spectrum].size() != boundaries_[spectrum].size())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Number of peaks and number of peak boundaries differ.");
+      }
+    }
+
     // progress logger
     unsigned progress = 0;
     startProgress(0, patterns_.size() * exp_profile_.size(), "filtering LC-MS data");
@@ -127,167 +141,126 @@ namespace OpenMS
       // data structure storing peaks which pass all filters
       MultiplexFilterResult result;
 
-      // iterate over spectra
-      PeakMap::Iterator it_rt_profile;
-      PeakMap::ConstIterator it_rt_picked;
-      vector<vector<PeakPickerHiRes::PeakBoundary> >::const_iterator it_rt_boundaries;
-      for (it_rt_profile = exp_profile_.begin(), it_rt_picked = exp_picked_.begin(), it_rt_boundaries = boundaries_.begin();
-           it_rt_profile < exp_profile_.end() && it_rt_picked < exp_picked_.end() && it_rt_boundaries < boundaries_.end();
-           ++it_rt_profile, ++it_rt_picked, ++it_rt_boundaries)
+      // Spectra are processed in blocks. Within a block, all peaks are filtered concurrently against the
+      // blacklist as it was at the start of the block. The peaks which passed are then blacklisted and added
+      // to the result in the original spectrum and peak order. Peaks whose blacklist entries changed in the
+      // meantime are filtered again, hence the result is identical to a sequential scan.
+      for (int block_begin = 0; block_begin < spectrum_count; block_begin += block_size_)
       {
-        // skip empty spectra
-        if ((*it_rt_profile).size() == 0 || (*it_rt_picked).size() == 0 || (*it_rt_boundaries).size() == 0)
-        {
-          continue;
-        }
-        
-        if ((*it_rt_picked).size() != (*it_rt_boundaries).size())
-        {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Number of peaks and number of peak boundaries differ.");
-        }
-
-        setProgress(++progress);
-
-        int spectrum = it_rt_profile - exp_profile_.begin(); // index of the spectrum in exp_profile_, exp_picked_ and boundaries_
-        double rt_picked = it_rt_picked->getRT();
-
-        // spline fit profile data
-        SplineSpectrum spline(*it_rt_profile);
-        SplineSpectrum::Navigator nav = spline.getNavigator();
-
-        // vectors of peak details
-        vector<double> peak_position;
-        vector<double> peak_min;
-        vector<double> peak_max;
-        vector<double> peak_intensity;
-        MSSpectrum::ConstIterator it_mz;
-        vector<PeakPickerHiRes::PeakBoundary>::const_iterator it_mz_boundary;
-        for (it_mz = it_rt_picked->begin(), it_mz_boundary = it_rt_boundaries->begin();
-             it_mz < it_rt_picked->end() && it_mz_boundary < it_rt_boundaries->end();
-             ++it_mz, ++it_mz_boundary)
+        const int block_end = std::min(block_begin + block_size_, spectrum_count);
+
+        // spline fits of the profile spectra (shared read-only by all peaks of a spectrum)
+        vector<boost::shared_ptr<SplineSpectrum> > splines(block_end - block_begin);
+        // peaks passing all filters (one buffer per spectrum)
+        vector<vector<PeakCandidate> > candidates(block_end - block_begin);
+        // blacklist at the start of the block
+        vector<vector<char> > black_before(block_end - block_begin);
+        for (int spectrum = block_begin; spectrum < block_end; ++spectrum)
         {
-          peak_position.push_back(it_mz->getMZ());
-          peak_min.push_back((*it_mz_boundary).mz_min);
-          peak_max.push_back((*it_mz_boundary).mz_max);
-          peak_intensity.push_back(it_mz->getIntensity());
+          getBlacklistFlags_(spectrum, black_before[spectrum - block_begin]);
         }
 
-        // iterate over peaks in spectrum (mz)
-        for (unsigned peak = 0; peak < peak_position.size(); ++peak)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+        for (SignedSize spectrum = block_begin; spectrum < block_end; ++spectrum)
         {
-
-          /**
-           * Filter (1): m/z position and blacklist filter
-           * Are there non-black peaks with the expected relative m/z shifts?
-           */
-          vector<double> mz_shifts_actual; // actual m/z shifts (differ slightly from expected m/z shifts)
-          vector<int> mz_shifts_actual_indices; // peak indices in the spectrum corresponding to the actual m/z shifts
-          
-          mz_shifts_actual.reserve(patterns_[pattern].getMZShiftCount());
-          mz_shifts_actual_indices.reserve(patterns_[pattern].getMZShiftCount());
-          
-          int peaks_found_in_all_peptides = positionsAndBlacklistFilter_(patterns_[pattern], spectrum, peak_position, peak, mz_shifts_actual, mz_shifts_actual_indices);
-          if (peaks_found_in_all_peptides < peaks_per_peptide_min_)
+          if (skipSpectrum_(spectrum))
           {
             continue;
           }
 
-          /**
-           * Filter (2): blunt intensity filter
-           * Are the mono-isotopic peak intensities of all peptides above the cutoff?
-           */
-          bool bluntVeto = monoIsotopicPeakIntensityFilter_(patterns_[pattern], spectrum, mz_shifts_actual_indices);
-          if (bluntVeto)
+          // spline fit profile data
+          // (A spectrum without spline packages is reported during the commit below.)
+          boost::shared_ptr<SplineSpectrum> spline(new SplineSpectrum(exp_profile_[spectrum]));
+          SplineSpectrum::Navigator nav;
+          try
+          {
+            nav = spline->getNavigator();
+          }
+          catch (Exception::BaseException&)
           {
             continue;
           }
+          splines[spectrum - block_begin] = spline;
 
-          // Arrangement of peaks looks promising. Now scan through the spline fitted data.
-          vector<MultiplexFilterResultRaw> results_raw; // raw data points of this peak that will pass the remaining filters
-          bool blacklisted = false; // Has this peak already been blacklisted?
-          for (double mz = peak_min[peak]; mz < peak_max[peak]; mz = nav.getNextMz(mz))
+          vector<double> peak_position, peak_min, peak_max, peak_intensity;
+          getPeakDetails_(spectrum, peak_position, peak_min, peak_max, peak_intensity);
+
+          for (int peak = 0; peak < (int) peak_position.size(); ++peak)
           {
-            /**
-             * Filter (3): non-local intensity filter
-             * Are the spline interpolated intensities at m/z above the threshold?
-             */
-            vector<double> intensities_actual; // spline interpolated intensities @ m/z + actual m/z shift
-            int peaks_found_in_all_peptides_spline = nonLocalIntensityFilter_(patterns_[pattern], mz_shifts_actual, mz_shifts_actual_indices, nav, intensities_actual, peaks_found_in_all_peptides, mz);
-            if (peaks_found_in_all_peptides_spline < peaks_per_peptide_min_)
+            PeakCandidate candidate;
+            if (filterPeak_(patterns_[pattern], spectrum, peak_position, peak_min, peak_max, peak_intensity, peak, nav, candidate))
             {
-              continue;
+              candidates[spectrum - block_begin].push_back(candidate);
             }
+          }
+        }
+
+        // commit the block in the original order
+        vector<bool> touched(block_end - block_begin, false);
+        for (int spectrum = block_begin; spectrum < block_end; ++spectrum)
+        {
+          // skip empty spectra
+          if (skipSpectrum_(spectrum))
+          {
+            continue;
+          }
 
-            /**
-             * Filter (4): zeroth peak filter
-             * There should not be a significant peak to the left of the mono-isotopic
-             * (i.e. first) peak.
-             */
-            bool zero_peak = zerothPeakFilter_(patterns_[pattern], intensities_actual);
-            if (zero_peak)
+          setProgress(++progress);
+
+          int index = spectrum - block_begin;
+          if (!splines[index])
+          {
+            // spectrum without spline packages (see SplineSpectrum::getNavigator())
+            throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 0);
+          }
+
+          SplineSpectrum::Navigator nav = splines[index]->getNavigator();
+          double rt_picked = exp_picked_[spectrum].getRT();
+
+          vector<double> peak_position, peak_min, peak_max, peak_intensity;
+          getPeakDetails_(spectrum, peak_position, peak_min, peak_max, peak_intensity);
+
+          vector<PeakCandidate>::iterator it_candidate = candidates[index].begin();
+          for (int peak = 0; peak < (int) peak_position.size(); ++peak)
+          {
+            bool speculative = (it_candidate != candidates[index].end() && it_candidate->peak == peak);
+
+            PeakCandidate candidate;
+            if (touched[index] && blacklistChanged_(patterns_[pattern], spectrum, peak_position, peak, black_before[index]))
             {
-              continue;
+              if (!filterPeak_(patterns_[pattern], spectrum, peak_position, peak_min, peak_max, peak_intensity, peak, nav, candidate))
+              {
+                if (speculative) ++it_candidate;
+                continue;
+              }
             }
-
-            /**
-             * Filter (5): peptide similarity filter
-             * How similar are the isotope patterns of the peptides?
-             */
-            bool peptide_similarity = peptideSimilarityFilter_(patterns_[pattern], intensities_actual, peaks_found_in_all_peptides_spline);
-            if (!peptide_similarity)
+            else if (speculative)
             {
-              continue;
+              std::swap(candidate, *it_candidate);
             }
-
-            /**
-             * Filter (6): averagine similarity filter
-             * Does each individual isotope pattern resemble a peptide?
-             */
-            bool averagine_similarity = averagineSimilarityFilter_(patterns_[pattern], intensities_actual, peaks_found_in_all_peptides_spline, mz);
-            if (!averagine_similarity)
+            else
             {
               continue;
             }
+            if (speculative) ++it_candidate;
 
-            /**
-             * All filters passed.
-             */
-            // add raw data point to list that passed all filters
-            MultiplexFilterResultRaw result_raw(mz, mz_shifts_actual, intensities_actual);
-            results_raw.push_back(result_raw);
-            
             // blacklist peaks in the current spectrum and the two neighbouring ones
-            if (!blacklisted)
+            blacklistPeaks_(patterns_[pattern], spectrum, candidate.mz_shifts_actual_indices, candidate.peaks_found_in_all_peptides);
+            for (int i = std::max(spectrum - 2, block_begin); i <= std::min(spectrum + 2, block_end - 1); ++i)
             {
-              blacklistPeaks_(patterns_[pattern], spectrum, mz_shifts_actual_indices, peaks_found_in_all_peptides_spline);
-              blacklisted = true;
+              touched[i - block_begin] = true;
             }
 
-          }
-
-          // add the peak with its corresponding raw data to the result
-          if (results_raw.size() > 2)
-          {
-            // Scanning over the profile of the peak, we want at least three raw data points to pass all filters.
-            vector<double> intensities_actual;
-            for (unsigned i = 0; i < mz_shifts_actual_indices.size(); ++i)
+            // add the peak with its corresponding raw data to the result
+            // (Scanning over the profile of the peak, we want at least three raw data points to pass all filters.)
+            if (candidate.results_raw.size() > 2)
             {
-              int index = mz_shifts_actual_indices[i];
-              if (index == -1)
-              {
-                // no peak found
-                intensities_actual.push_back(std::numeric_limits<double>::quiet_NaN());
-              }
-              else
-              {
-                intensities_actual.push_back(peak_intensity[mz_shifts_actual_indices[i]]);
-              }
+              result.addFilterResultPeak(peak_position[peak], rt_picked, candidate.mz_shifts_actual, candidate.intensities_actual, candidate.results_raw);
             }
-            result.addFilterResultPeak(peak_position[peak], rt_picked, mz_shifts_actual, intensities_actual, results_raw);
           }
-
         }
-
       }
 
       // add results of this pattern to list
@@ -299,6 +272,145 @@ namespace OpenMS
     return filter_results;
   }
 
+  bool MultiplexFilteringProfile::skipSpectrum_(int spectrum) const
+  {
+    return exp_profile_[spectrum].empty() || exp_picked_[spectrum].empty() || boundaries_[spectrum].empty();
+  }
+
+  void MultiplexFilteringProfile::getPeakDetails_(int spectrum, vector<double>& peak_position, vector<double>& peak_min, vector<double>& peak_max, vector<double>& peak_intensity) const
+  {
+    const MSSpectrum& spectrum_picked = exp_picked_[spectrum];
+    const vector<PeakPickerHiRes::PeakBoundary>& spectrum_boundaries = boundaries_[spectrum];
+
+    peak_position.reserve(spectrum_picked.size());
+    peak_min.reserve(spectrum_picked.size());
+    peak_max.reserve(spectrum_picked.size());
+    peak_intensity.reserve(spectrum_picked.size());
+    for (Size i = 0; i < spectrum_picked.size() && i < spectrum_boundaries.size(); ++i)
+    {
+      peak_position.push_back(spectrum_picked[i].getMZ());
+      peak_min.push_back(spectrum_boundaries[i].mz_min);
+      peak_max.push_back(spectrum_boundaries[i].mz_max);
+      peak_intensity.push_back(spectrum_picked[i].getIntensity());
+    }
+  }
+
+  bool MultiplexFilteringProfile::filterPeak_(const MultiplexIsotopicPeakPattern& pattern, int spectrum, const vector<double>& peak_position, const vector<double>& peak_min, const vector<double>& peak_max, const vector<double>& peak_intensity, int peak, SplineSpectrum::Navigator& nav, PeakCandidate& candidate) const
+  {
+    candidate.peak = peak;
+
+    /**
+     * Filter (1): m/z position and blacklist filter
+     * Are there non-black peaks with the expected relative m/z shifts?
+     */
+    vector<double>& mz_shifts_actual = candidate.mz_shifts_actual; // actual m/z shifts (differ slightly from expected m/z shifts)
+    vector<int>& mz_shifts_actual_indices = candidate.mz_shifts_actual_indices; // peak indices in the spectrum corresponding to the actual m/z shifts
+
+    mz_shifts_actual.reserve(pattern.getMZShiftCount());
+    mz_shifts_actual_indices.reserve(pattern.getMZShiftCount());
+
+    int peaks_found_in_all_peptides = positionsAndBlacklistFilter_(pattern, spectrum, peak_position, peak, mz_shifts_actual, mz_shifts_actual_indices);
+    if (peaks_found_in_all_peptides < peaks_per_peptide_min_)
+    {
+      return false;
+    }
+
+    /**
+     * Filter (2): blunt intensity filter
+     * Are the mono-isotopic peak intensities of all peptides above the cutoff?
+     */
+    bool bluntVeto = monoIsotopicPeakIntensityFilter_(pattern, spectrum, mz_shifts_actual_indices);
+    if (bluntVeto)
+    {
+      return false;
+    }
+
+    // Arrangement of peaks looks promising. Now scan through the spline fitted data.
+    vector<MultiplexFilterResultRaw>& results_raw = candidate.results_raw; // raw data points of this peak that will pass the remaining filters
+    bool blacklisted = false; // Has this peak already been blacklisted?
+    for (double mz = peak_min[peak]; mz < peak_max[peak]; mz = nav.getNextMz(mz))
+    {
+      /**
+       * Filter (3): non-local intensity filter
+       * Are the spline interpolated intensities at m/z above the threshold?
+       */
+      vector<double> intensities_actual; // spline interpolated intensities @ m/z + actual m/z shift
+      int peaks_found_in_all_peptides_spline = nonLocalIntensityFilter_(pattern, mz_shifts_actual, mz_shifts_actual_indices, nav, intensities_actual, peaks_found_in_all_peptides, mz);
+      if (peaks_found_in_all_peptides_spline < peaks_per_peptide_min_)
+      {
+        continue;
+      }
+
+      /**
+       * Filter (4): zeroth peak filter
+       * There should not be a significant peak to the left of the mono-isotopic
+       * (i.e. first) peak.
+       */
+      bool zero_peak = zerothPeakFilter_(pattern, intensities_actual);
+      if (zero_peak)
+      {
+        continue;
+      }
+
+      /**
+       * Filter (5): peptide similarity filter
+       * How similar are the isotope patterns of the peptides?
+       */
+      bool peptide_similarity = peptideSimilarityFilter_(pattern, intensities_actual, peaks_found_in_all_peptides_spline);
+      if (!peptide_similarity)
+      {
+        continue;
+      }
+
+      /**
+       * Filter (6): averagine similarity filter
+       * Does each individual isotope pattern resemble a peptide?
+       */
+      bool averagine_similarity = averagineSimilarityFilter_(pattern, intensities_actual, peaks_found_in_all_peptides_spline, mz);
+      if (!averagine_similarity)
+      {
+        continue;
+      }
+
+      /**
+       * All filters passed.
+       */
+      // add raw data point to list that passed all filters
+      MultiplexFilterResultRaw result_raw(mz, mz_shifts_actual, intensities_actual);
+      results_raw.push_back(result_raw);
+
+      // The peaks in the current spectrum and the two neighbouring ones are blacklisted
+      // with the isotope count seen at the first raw data point which passed.
+      if (!blacklisted)
+      {
+        candidate.peaks_found_in_all_peptides = peaks_found_in_all_peptides_spline;
+        blacklisted = true;
+      }
+    }
+
+    if (!blacklisted)
+    {
+      return false;
+    }
+
+    // peak intensities at the pattern positions
+    for (unsigned i = 0; i < mz_shifts_actual_indices.size(); ++i)
+    {
+      int index = mz_shifts_actual_indices[i];
+      if (index == -1)
+      {
+        // no peak found
+        candidate.intensities_actual.push_back(std::numeric_limits<double>::quiet_NaN());
+      }
+      else
+      {
+        candidate.intensities_actual.push_back(peak_intensity[index]);
+      }
+    }
+
+    return true;
+  }
+
   int MultiplexFilteringProfile::nonLocalIntensityFilter_(const MultiplexIsotopicPeakPattern& pattern, const vector<double>& mz_shifts_actual, const vector<int>& mz_shifts_actual_indices, SplineSpectrum::Navigator nav, std::vector<double>& intensities_actual, int peaks_found_in_all_peptides, double mz) const
   {
     // calculate intensities
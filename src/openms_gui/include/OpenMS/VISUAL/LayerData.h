@@ -54,6 +54,8 @@
 
 namespace OpenMS
 {
+  class PeakMapPyramid;
+
   /**
   @brief Class that stores the data for one layer
 
@@ -306,6 +308,9 @@ public:
     /// Filters to apply before painting
     DataFilters filters;
 
+    /// Multi-resolution overview of the peak data for fast painting of large maps (2D view, may be null)
+    boost::shared_ptr<PeakMapPyramid> peak_pyramid;
+
     /// Annotations of all spectra of the experiment (1D view)
     std::vector<Annotations1DContainer> annotations_1d;
 
@@ -0,0 +1,203 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#ifndef OPENMS_VISUAL_PEAKMAPPYRAMID_H
+#define OPENMS_VISUAL_PEAKMAPPYRAMID_H
+
+// OpenMS_GUI config
+#include <OpenMS/VISUAL/OpenMS_GUIConfig.h>
+
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+//QT
+#include <QtCore/QObject>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+      @brief Multi-resolution intensity overview (level of detail pyramid) of the MS1 peaks of a peak map.
+
+      Level 0 divides the RT and m/z range of the map into a regular grid of
+      tiles and stores the maximum and the sum of the intensities of all MS1
+      peaks falling into each tile. Every following level merges 2x2 tiles of
+      the previous one, until a single tile remains. The tile size doubles from
+      level to level, so with an odd number of tiles the grid of a coarser
+      level extends beyond the data range.
+
+      The pyramid is built in small chunks on the event loop (see start()), so
+      the GUI remains responsive while it is computed and no lock on the peak
+      data is needed. Painting code should only use it if isValidFor() returns
+      true and then pick the level matching the current pixel density (see
+      selectLevel()).
+
+      @ingroup Visual
+  */
+  class OPENMS_GUI_DLLAPI PeakMapPyramid :
+    public QObject
+  {
+    Q_OBJECT
+
+public:
+    /// One level of the pyramid (tiles are stored row-wise, i.e. RT-major)
+    struct Level
+    {
+      /// Number of tiles in RT dimension
+      Size rt_bins;
+      /// Number of tiles in m/z dimension
+      Size mz_bins;
+      /// Extent of one tile in RT dimension
+      double tile_rt;
+      /// Extent of one tile in m/z dimension
+      double tile_mz;
+      /// Maximum intensity of each tile (negative for empty tiles)
+      std::vector<float> max_intensity;
+      /// Intensity sum of each tile
+      std::vector<float> sum_intensity;
+    };
+
+    /**
+      @brief Constructor
+
+      @param map The peak map to summarize (only a weak reference is kept)
+      @param max_bins Number of tiles of level 0 in each dimension (RT is additionally limited to the number of MS1 scans)
+      @param parent Parent object
+    */
+    PeakMapPyramid(const boost::shared_ptr<PeakMap>& map, Size max_bins = 2048, QObject* parent = 0);
+
+    /// Destructor
+    ~PeakMapPyramid() override;
+
+    /// Starts (or restarts) building the pyramid on the event loop. finished() is emitted once it is done.
+    void start();
+
+    /// Builds the pyramid immediately (blocking)
+    void build();
+
+    /// Returns if the pyramid was built completely
+    bool isReady() const;
+
+    /// Returns if the pyramid is ready and was built from @p map in its current state (same object, same number of spectra and peaks)
+    bool isValidFor(const PeakMap& map) const;
+
+    /// Returns the number of levels (0 if not ready)
+    Size getLevelCount() const;
+
+    /// Returns a level (0 is the finest)
+    const Level& getLevel(Size level) const;
+
+    /**
+      @brief Returns the coarsest level whose tiles are not larger than the given pixel size
+
+      @param rt_per_pixel Extent of one pixel in RT dimension
+      @param mz_per_pixel Extent of one pixel in m/z dimension
+      @return The level index or -1 if even level 0 is too coarse (or the pyramid is not ready)
+    */
+    Int selectLevel(double rt_per_pixel, double mz_per_pixel) const;
+
+    /// Extent of one tile of @p level in RT dimension
+    double getTileRT(Size level) const;
+
+    /// Extent of one tile of @p level in m/z dimension
+    double getTileMZ(Size level) const;
+
+    /// Lower RT boundary of the tile grid
+    double getMinRT() const
+    {
+      return rt_min_;
+    }
+
+    /// Lower m/z boundary of the tile grid
+    double getMinMZ() const
+    {
+      return mz_min_;
+    }
+
+signals:
+    /// Emitted when the pyramid was built completely
+    void finished();
+
+private slots:
+    /// Processes the next chunk of spectra and schedules the following one
+    void processChunk_();
+
+private:
+    /// Not implemented
+    PeakMapPyramid(const PeakMapPyramid&);
+    /// Not implemented
+    PeakMapPyramid& operator=(const PeakMapPyramid&);
+
+    /// Determines the grid from the map and allocates level 0. Returns false if there is nothing to summarize.
+    bool initialize_(const PeakMap& map);
+
+    /// Adds the MS1 peaks of spectrum @p index to level 0
+    void addSpectrum_(const PeakMap& map, Size index);
+
+    /// Computes all coarser levels from level 0
+    void computeLevels_();
+
+    /// The summarized map
+    boost::weak_ptr<PeakMap> map_;
+    /// Identity and size of the map when building started (for validity checks)
+    const PeakMap* map_address_;
+    Size map_spectra_;
+    UInt64 map_peaks_;
+
+    /// Maximum number of tiles of level 0 in each dimension
+    Size max_bins_;
+    /// Grid boundaries
+    double rt_min_;
+    double rt_max_;
+    double mz_min_;
+    double mz_max_;
+
+    /// Levels (finest first)
+    std::vector<Level> levels_;
+
+    /// Index of the next spectrum to process
+    Size next_spectrum_;
+    /// Whether the pyramid is complete
+    bool ready_;
+  };
+
+}
+
+#endif // OPENMS_VISUAL_PEAKMAPPYRAMID_H
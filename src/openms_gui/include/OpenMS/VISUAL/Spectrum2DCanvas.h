@@ -141,6 +141,9 @@ protected slots:
     /// Reacts on changed layer parameters
     void currentLayerParametersChanged_();
 
+    /// Repaints once a peak map pyramid was built
+    void peakPyramidFinished_();
+
 protected:
     // Docu in base class
     bool finishAdding_() override;
@@ -193,6 +196,19 @@ protected:
     */
     void paintMaximumIntensities_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count, QPainter& p);
 
+    /**
+      @brief Paints maximum intensities using the multi-resolution overview of the layer (see PeakMapPyramid)
+
+      @param layer_index The index of the layer.
+      @param rt_pixel_count
+      @param mz_pixel_count
+      @return False if the overview cannot be used (not built yet, outdated or too coarse for the current zoom level)
+    */
+    bool paintMaximumIntensitiesFromPyramid_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count);
+
+    /// (Re)starts building the multi-resolution overview of a peak layer in the background (only for large maps)
+    void updatePeakPyramid_(Size layer_index);
+
     /**
       @brief Paints the precursor peaks.
 
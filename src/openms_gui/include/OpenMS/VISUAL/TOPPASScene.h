@@ -44,6 +44,8 @@
 
 #include <QtWidgets/QGraphicsScene>
 #include <QtCore/QProcess>
+#include <QtCore/QHash>
+#include <QtCore/QList>
 
 namespace OpenMS
 {
@@ -94,11 +96,15 @@ public:
     struct TOPPProcess
     {
       /// Constructor
-      TOPPProcess(QProcess * p, const QString & cmd, const QStringList & arg, TOPPASToolVertex * const tool) :
+      TOPPProcess(QProcess * p, const QString & cmd, const QStringList & arg, TOPPASToolVertex * const tool,
+                  int num_threads = 1, double mem = 0.0, int prio = 0) :
         proc(p),
         command(cmd),
         args(arg),
-        tv(tool)
+        tv(tool),
+        threads(num_threads),
+        memory(mem),
+        priority(prio)
       {
       }
 
@@ -110,6 +116,12 @@ public:
       QStringList args;
       /// The tool which is started (used to call its slots)
       TOPPASToolVertex * tv;
+      /// Number of threads the process will use
+      int threads;
+      /// Estimated memory usage of the process (in MB)
+      double memory;
+      /// Scheduling priority, i.e. the length of the critical path starting at the tool (higher runs first)
+      int priority;
     };
 
     /// The current action mode (creation of a new edge, or panning of the widget)
@@ -205,9 +217,21 @@ public:
     bool isPipelineRunning();
     /// Shows a dialog that allows to specify the output directory. If @p always_ask == false, the dialog won't be shown if a directory has been set, already.
     bool askForOutputDir(bool always_ask = true);
-    /// Enqueues the process, it will be run when the currently pending processes have finished
+    /// Enqueues the process, it will be run as soon as enough threads and memory are available
     void enqueueProcess(const TOPPProcess & process);
-    /// Runs the next process in the queue, if any
+    /**
+      @brief Starts queued processes as long as the thread and memory budget allows
+
+      The queued process with the highest priority (longest chain of downstream tools; ties are
+      resolved in queue order) is started as soon as it fits into the remaining budget. A process
+      requesting more than the whole budget is started once nothing else is running.
+
+      If it does not fit, its resources are reserved: assuming that running processes finish in
+      the order they were started, the point at which it can start and the resources it leaves
+      unused then are determined. Lower priority processes are only started in the meantime
+      (backfilling) if they fit into the current budget and into these unused resources, so they
+      can never delay the top priority process.
+    */
     void runNextProcess();
     /// Resets the processes queue
     void resetProcessesQueue();
@@ -241,8 +265,17 @@ public:
     QString getDescription() const;
     /// when description is updated by user, use this to update the description for later storage in file
     void setDescription(const QString & desc);
-    /// sets the maximum number of jobs
+    /// sets the maximum number of threads used by all running jobs together
     void setAllowedThreads(int num_threads);
+    /// sets the maximum estimated memory (in MB) used by all running jobs together (0 = unlimited)
+    void setAllowedMemory(double memory);
+    /**
+      @brief Returns the length of the longest chain of tool vertices starting at @p tv (including @p tv itself)
+
+      Results are memoized (otherwise the number of paths through diamond-shaped workflows
+      grows exponentially); the memo is cleared whenever a pipeline is started, resumed or stopped.
+    */
+    int getCriticalPathLength(TOPPASVertex * tv) const;
     /// returns the hovering edge
     TOPPASEdge* getHoveringEdge();
     /// Checks whether all output vertices are finished, and if yes, emits entirePipelineFinished() (called by finished output vertices)
@@ -276,8 +309,8 @@ public slots:
     void changedParameter(const bool invalidates_running_pipeline);
     /// Invoked by OutfilelistVertex of user changed the folder name
     void changedOutputFolder();
-    /// Called by a finished QProcess to indicate that we are free to start a new one
-    void processFinished();
+    /// Called by a finished QProcess to release its resources and start new processes
+    void processFinished(QProcess * process);
     /// dirty solution: when using ExecutePipeline this slot is called when the pipeline crashes. This will quit the app
     void quitWithError();
 
@@ -356,12 +389,27 @@ protected:
     TOPPASScene * clipboard_;
     /// dry run mode (no tools are actually called)
     bool dry_run_;
-    /// currently running processes...
+    /// number of threads used by the currently running processes
     int threads_active_;
+    /// estimated memory (in MB) used by the currently running processes
+    double memory_active_;
+    /// resources held by a running process
+    struct RunningProcess_
+    {
+      QProcess * proc;
+      int threads;
+      double memory;
+    };
+    /// running processes, in the order they were started
+    QList<RunningProcess_> running_processes_;
+    /// memoized results of getCriticalPathLength()
+    mutable QHash<const TOPPASVertex *, int> critical_path_lengths_;
     /// description text
     QString description_text_;
     /// maximum number of allowed threads
     int allowed_threads_;
+    /// maximum estimated memory (in MB) of all running processes (0 = unlimited)
+    double allowed_memory_;
     /// last node where 'resume' was started
     TOPPASToolVertex* resume_source_;
 
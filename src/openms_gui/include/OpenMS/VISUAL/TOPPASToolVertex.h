@@ -195,6 +195,10 @@ public:
     bool isToolReady() const;
     /// Toggle breakpoint
     void toggleBreakpoint();
+    /// Returns the number of threads the tool is configured to use (its 'threads' parameter, 1 if not available)
+    int getNumThreads() const;
+    /// Returns a rough estimate of the memory (in MB) required to process the input files of @p round
+    double estimateMemoryUsage(const RoundPackage& round) const;
     /// Called when the QProcess in the queue is called: emits 'toolStarted()'
     virtual void emitToolStarted();
     /// invert status of recycling (overriding base class)
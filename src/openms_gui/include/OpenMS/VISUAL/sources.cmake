@@ -18,6 +18,7 @@ MetaDataBrowser.h
 MultiGradient.h
 MultiGradientSelector.h
 ParamEditor.h
+PeakMapPyramid.h
 SpectraViewWidget.h
 SpectraIdentificationViewWidget.h
 Spectrum1DCanvas.h
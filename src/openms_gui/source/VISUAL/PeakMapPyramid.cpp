@@ -0,0 +1,262 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/VISUAL/PeakMapPyramid.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+
+//QT
+#include <QtCore/QTimer>
+
+#include <algorithm>
+
+namespace OpenMS
+{
+  /// Number of peaks processed per chunk on the event loop
+  static const Size PEAKS_PER_CHUNK = 500000;
+
+  PeakMapPyramid::PeakMapPyramid(const boost::shared_ptr<PeakMap>& map, Size max_bins, QObject* parent) :
+    QObject(parent),
+    map_(map),
+    map_address_(map.get()),
+    map_spectra_(0),
+    map_peaks_(0),
+    max_bins_(std::max(max_bins, (Size)1)),
+    rt_min_(0.0),
+    rt_max_(0.0),
+    mz_min_(0.0),
+    mz_max_(0.0),
+    next_spectrum_(0),
+    ready_(false)
+  {
+  }
+
+  PeakMapPyramid::~PeakMapPyramid()
+  {
+  }
+
+  void PeakMapPyramid::start()
+  {
+    boost::shared_ptr<PeakMap> map = map_.lock();
+    if (!map || !initialize_(*map))
+    {
+      return;
+    }
+    QTimer::singleShot(0, this, SLOT(processChunk_()));
+  }
+
+  void PeakMapPyramid::build()
+  {
+    boost::shared_ptr<PeakMap> map = map_.lock();
+    if (!map || !initialize_(*map))
+    {
+      return;
+    }
+    for (; next_spectrum_ < map->size(); ++next_spectrum_)
+    {
+      addSpectrum_(*map, next_spectrum_);
+    }
+    computeLevels_();
+  }
+
+  bool PeakMapPyramid::initialize_(const PeakMap& map)
+  {
+    levels_.clear();
+    ready_ = false;
+    next_spectrum_ = 0;
+    map_address_ = &map;
+    map_spectra_ = map.size();
+    map_peaks_ = map.getSize();
+
+    // the grid spans the data range of the map (see MSExperiment::updateRanges)
+    Size ms1_scans = 0;
+    for (Size i = 0; i < map.size(); ++i)
+    {
+      if (map[i].getMSLevel() == 1) ++ms1_scans;
+    }
+    rt_min_ = map.getMinRT();
+    rt_max_ = map.getMaxRT();
+    mz_min_ = map.getMinMZ();
+    mz_max_ = map.getMaxMZ();
+    if (ms1_scans == 0 || !(rt_min_ <= rt_max_) || !(mz_min_ <= mz_max_))
+    {
+      return false;
+    }
+
+    Level level;
+    level.rt_bins = std::min(max_bins_, ms1_scans);
+    level.mz_bins = max_bins_;
+    level.tile_rt = (rt_max_ - rt_min_) / level.rt_bins;
+    level.tile_mz = (mz_max_ - mz_min_) / level.mz_bins;
+    level.max_intensity.assign(level.rt_bins * level.mz_bins, -1.0f);
+    level.sum_intensity.assign(level.rt_bins * level.mz_bins, 0.0f);
+    levels_.push_back(level);
+    return true;
+  }
+
+  void PeakMapPyramid::addSpectrum_(const PeakMap& map, Size index)
+  {
+    const MSSpectrum& spec = map[index];
+    if (spec.getMSLevel() != 1 || spec.empty())
+    {
+      return;
+    }
+
+    Level& base = levels_[0];
+    const double rt_scale = base.rt_bins / std::max(rt_max_ - rt_min_, 1e-9);
+    const double mz_scale = base.mz_bins / std::max(mz_max_ - mz_min_, 1e-9);
+
+    double rt_pos = (spec.getRT() - rt_min_) * rt_scale;
+    if (rt_pos < 0.0 || rt_pos > base.rt_bins) return; // outside of the data range
+    Size rt_bin = std::min((Size)rt_pos, base.rt_bins - 1);
+
+    float* max_row = &base.max_intensity[rt_bin * base.mz_bins];
+    float* sum_row = &base.sum_intensity[rt_bin * base.mz_bins];
+    for (MSSpectrum::ConstIterator it = spec.begin(); it != spec.end(); ++it)
+    {
+      double mz_pos = (it->getMZ() - mz_min_) * mz_scale;
+      if (mz_pos < 0.0 || mz_pos > base.mz_bins) continue;
+      Size mz_bin = std::min((Size)mz_pos, base.mz_bins - 1);
+      max_row[mz_bin] = std::max(max_row[mz_bin], it->getIntensity());
+      sum_row[mz_bin] += it->getIntensity();
+    }
+  }
+
+  void PeakMapPyramid::computeLevels_()
+  {
+    while (levels_.back().rt_bins > 1 || levels_.back().mz_bins > 1)
+    {
+      const Level& fine = levels_.back();
+      Level coarse;
+      coarse.rt_bins = (fine.rt_bins + 1) / 2;
+      coarse.mz_bins = (fine.mz_bins + 1) / 2;
+      // each coarse tile covers two fine tiles (also if the last one is missing), unless there was only one:
+      coarse.tile_rt = (fine.rt_bins > 1) ? 2 * fine.tile_rt : fine.tile_rt;
+      coarse.tile_mz = (fine.mz_bins > 1) ? 2 * fine.tile_mz : fine.tile_mz;
+      coarse.max_intensity.assign(coarse.rt_bins * coarse.mz_bins, -1.0f);
+      coarse.sum_intensity.assign(coarse.rt_bins * coarse.mz_bins, 0.0f);
+      for (Size rt = 0; rt < fine.rt_bins; ++rt)
+      {
+        for (Size mz = 0; mz < fine.mz_bins; ++mz)
+        {
+          const Size from = rt * fine.mz_bins + mz;
+          const Size to = (rt / 2) * coarse.mz_bins + mz / 2;
+          coarse.max_intensity[to] = std::max(coarse.max_intensity[to], fine.max_intensity[from]);
+          coarse.sum_intensity[to] += fine.sum_intensity[from];
+        }
+      }
+      levels_.push_back(coarse); // invalidates 'fine'
+    }
+    ready_ = true;
+  }
+
+  void PeakMapPyramid::processChunk_()
+  {
+    boost::shared_ptr<PeakMap> map = map_.lock();
+    // stop if the map is gone or was modified in the meantime
+    if (!map || map.get() != map_address_ || map->size() != map_spectra_)
+    {
+      levels_.clear();
+      return;
+    }
+
+    Size peaks = 0;
+    while (next_spectrum_ < map->size() && peaks < PEAKS_PER_CHUNK)
+    {
+      addSpectrum_(*map, next_spectrum_);
+      peaks += (*map)[next_spectrum_].size();
+      ++next_spectrum_;
+    }
+
+    if (next_spectrum_ < map->size())
+    {
+      QTimer::singleShot(0, this, SLOT(processChunk_()));
+    }
+    else
+    {
+      computeLevels_();
+      emit finished();
+    }
+  }
+
+  bool PeakMapPyramid::isReady() const
+  {
+    return ready_;
+  }
+
+  bool PeakMapPyramid::isValidFor(const PeakMap& map) const
+  {
+    return ready_ && &map == map_address_ && map.size() == map_spectra_ && map.getSize() == map_peaks_;
+  }
+
+  Size PeakMapPyramid::getLevelCount() const
+  {
+    return ready_ ? levels_.size() : 0;
+  }
+
+  const PeakMapPyramid::Level& PeakMapPyramid::getLevel(Size level) const
+  {
+    if (level >= getLevelCount())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, level, getLevelCount());
+    }
+    return levels_[level];
+  }
+
+  double PeakMapPyramid::getTileRT(Size level) const
+  {
+    return getLevel(level).tile_rt;
+  }
+
+  double PeakMapPyramid::getTileMZ(Size level) const
+  {
+    return getLevel(level).tile_mz;
+  }
+
+  Int PeakMapPyramid::selectLevel(double rt_per_pixel, double mz_per_pixel) const
+  {
+    Int selected = -1;
+    for (Size i = 0; i < getLevelCount(); ++i)
+    {
+      if (getTileRT(i) > rt_per_pixel || getTileMZ(i) > mz_per_pixel)
+      {
+        break;
+      }
+      selected = (Int)i;
+    }
+    return selected;
+  }
+
+}
@@ -45,6 +45,7 @@
 #include <OpenMS/VISUAL/ColorSelector.h>
 #include <OpenMS/VISUAL/MultiGradientSelector.h>
 #include <OpenMS/VISUAL/DIALOGS/FeatureEditDialog.h>
+#include <OpenMS/VISUAL/PeakMapPyramid.h>
 #include <OpenMS/SYSTEM/FileWatcher.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 //STL
@@ -73,6 +74,10 @@
 #define CANVAS_COVERAGE_MIN_LIMITHIGH 0.5
 #define CANVAS_COVERAGE_MIN_LIMITLOW 0.1
 
+// minimum number of peaks of a map for which a multi-resolution overview (PeakMapPyramid) is built;
+// smaller maps are painted fast enough from the raw data
+#define PEAK_PYRAMID_MIN_PEAKS 5000000
+
 
 using namespace std;
 
@@ -638,6 +643,12 @@ namespace OpenMS
   {
     //set painter to black (we operate directly on the pixels for all colored data)
     painter.setPen(Qt::black);
+
+    // large maps: use the precomputed overview if it matches the current zoom level
+    if (paintMaximumIntensitiesFromPyramid_(layer_index, rt_pixel_count, mz_pixel_count))
+    {
+      return;
+    }
     //temporary variables
     Int image_width = buffer_.width();
     Int image_height = buffer_.height();
@@ -726,6 +737,105 @@ namespace OpenMS
     }
   }
 
+  bool Spectrum2DCanvas::paintMaximumIntensitiesFromPyramid_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count)
+  {
+    const LayerData & layer = getLayer(layer_index);
+
+    // the overview knows nothing about data filters
+    if (!layer.peak_pyramid || layer.filters.isActive() || !layer.peak_pyramid->isValidFor(*layer.getPeakData()))
+    {
+      return false;
+    }
+    const PeakMapPyramid & pyramid = *layer.peak_pyramid;
+
+    //temporary variables
+    Int image_width = buffer_.width();
+    Int image_height = buffer_.height();
+
+    const double rt_min = visible_area_.minPosition()[1];
+    const double rt_max = visible_area_.maxPosition()[1];
+    const double mz_min = visible_area_.minPosition()[0];
+    const double mz_max = visible_area_.maxPosition()[0];
+
+    double snap_factor = snap_factors_[layer_index];
+
+    //calculate pixel size in data coordinates
+    double rt_step_size = (rt_max - rt_min) / rt_pixel_count;
+    double mz_step_size = (mz_max - mz_min) / mz_pixel_count;
+
+    // pick the coarsest level that still has at least one tile per pixel
+    Int level_index = pyramid.selectLevel(rt_step_size, mz_step_size);
+    if (level_index < 0)
+    {
+      return false;
+    }
+    const PeakMapPyramid::Level & level = pyramid.getLevel(level_index);
+    const double tile_rt = pyramid.getTileRT(level_index);
+    const double tile_mz = pyramid.getTileMZ(level_index);
+
+    // visible tiles
+    SignedSize rt_tile_begin = std::max(SignedSize(0), SignedSize(std::floor((rt_min - pyramid.getMinRT()) / tile_rt)));
+    SignedSize rt_tile_end = std::min(SignedSize(level.rt_bins), SignedSize(std::floor((rt_max - pyramid.getMinRT()) / tile_rt)) + 1);
+    SignedSize mz_tile_begin = std::max(SignedSize(0), SignedSize(std::floor((mz_min - pyramid.getMinMZ()) / tile_mz)));
+    SignedSize mz_tile_end = std::min(SignedSize(level.mz_bins), SignedSize(std::floor((mz_max - pyramid.getMinMZ()) / tile_mz)) + 1);
+
+    // maximum of each pixel, taken over all tiles whose center falls into it
+    vector<float> pixel_max(rt_pixel_count * mz_pixel_count, -1.0f);
+    for (SignedSize rt_tile = rt_tile_begin; rt_tile < rt_tile_end; ++rt_tile)
+    {
+      double rt_pos = (pyramid.getMinRT() + (rt_tile + 0.5) * tile_rt - rt_min) / rt_step_size;
+      if (rt_pos < 0.0 || rt_pos >= rt_pixel_count) continue;
+      float * pixel_row = &pixel_max[Size(rt_pos) * mz_pixel_count];
+      const float * tile_row = &level.max_intensity[rt_tile * level.mz_bins];
+      for (SignedSize mz_tile = mz_tile_begin; mz_tile < mz_tile_end; ++mz_tile)
+      {
+        if (tile_row[mz_tile] < 0.0) continue; // no data
+        double mz_pos = (pyramid.getMinMZ() + (mz_tile + 0.5) * tile_mz - mz_min) / mz_step_size;
+        if (mz_pos < 0.0 || mz_pos >= mz_pixel_count) continue;
+        pixel_row[Size(mz_pos)] = std::max(pixel_row[Size(mz_pos)], tile_row[mz_tile]);
+      }
+    }
+
+    //draw to buffer
+    for (Size rt = 0; rt < rt_pixel_count; ++rt)
+    {
+      for (Size mz = 0; mz < mz_pixel_count; ++mz)
+      {
+        float max = pixel_max[rt * mz_pixel_count + mz];
+        if (max >= 0.0)
+        {
+          QPoint pos;
+          dataToWidget_(mz_min + (mz + 0.5) * mz_step_size, rt_min + (rt + 0.5) * rt_step_size, pos);
+          if (pos.x() >= 0 && pos.y() >= 0 && pos.y() < image_height && pos.x() < image_width)
+          {
+            buffer_.setPixel(pos.x(), pos.y(), heightColor_(max, layer.gradient, snap_factor).rgb());
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  void Spectrum2DCanvas::updatePeakPyramid_(Size layer_index)
+  {
+    LayerData & layer = getLayer_(layer_index);
+    layer.peak_pyramid.reset();
+    if (layer.type != LayerData::DT_PEAK || layer.chromatogram_flag_set() || layer.getPeakData()->getSize() < PEAK_PYRAMID_MIN_PEAKS)
+    {
+      return;
+    }
+
+    layer.peak_pyramid = boost::shared_ptr<PeakMapPyramid>(new PeakMapPyramid(layer.getPeakData()));
+    connect(layer.peak_pyramid.get(), SIGNAL(finished()), this, SLOT(peakPyramidFinished_()));
+    layer.peak_pyramid->start();
+  }
+
+  void Spectrum2DCanvas::peakPyramidFinished_()
+  {
+    update_buffer_ = true;
+    update_(OPENMS_PRETTY_FUNCTION);
+  }
+
   void Spectrum2DCanvas::paintFeatureData_(Size layer_index, QPainter& painter)
   {
     const LayerData& layer = getLayer(layer_index);
@@ -1245,6 +1355,8 @@ namespace OpenMS
       {
         setLayerFlag(LayerData::P_PRECURSORS, true); // show precursors if no MS1 data is contained
       }
+      // large maps: build an overview for fast zoomed-out painting in the background
+      updatePeakPyramid_(current_layer_);
     }
     else if (layers_.back().type == LayerData::DT_FEATURE)  //feature data
     {
@@ -2829,6 +2941,9 @@ namespace OpenMS
 
   void Spectrum2DCanvas::updateLayer(Size i)
   {
+    // the data changed, rebuild the overview
+    updatePeakPyramid_(i);
+
     //update nearest peak
     selected_peak_.clear();
     recalculateRanges_(0, 1, 2);
@@ -59,6 +59,8 @@
 #include <QtCore/QTextStream>
 #include <QtWidgets/QMessageBox>
 
+#include <algorithm>
+
 namespace OpenMS
 {
 
@@ -87,7 +89,11 @@ namespace OpenMS
     clipboard_(nullptr),
     dry_run_(true),
     threads_active_(0),
+    memory_active_(0.0),
+    running_processes_(),
+    critical_path_lengths_(),
     allowed_threads_(1),
+    allowed_memory_(0.0),
     resume_source_(nullptr)
   {
     /*	ATTENTION!
@@ -1657,6 +1663,7 @@ namespace OpenMS
   void TOPPASScene::setPipelineRunning(bool b)
   {
     running_ = b;
+    critical_path_lengths_.clear(); // the workflow may be edited between runs
     if (!running_) // whenever we stop the pipeline and user is not looking, the icon should flash
     {
       resume_source_ = nullptr;
@@ -1664,9 +1671,24 @@ namespace OpenMS
     }
   }
 
-  void TOPPASScene::processFinished()
+  void TOPPASScene::processFinished(QProcess* process)
   {
-    --threads_active_;
+    // release the resources held by the process
+    for (int i = 0; i < running_processes_.size(); ++i)
+    {
+      if (running_processes_[i].proc == process)
+      {
+        threads_active_ -= running_processes_[i].threads;
+        memory_active_ -= running_processes_[i].memory;
+        running_processes_.removeAt(i);
+        break;
+      }
+    }
+    if (running_processes_.empty())
+    { // avoid drift of the floating point sum
+      threads_active_ = 0;
+      memory_active_ = 0.0;
+    }
     // try to run next in line
     runNextProcess();
   }
@@ -2004,11 +2026,68 @@ namespace OpenMS
 
     used = true;
 
-    while (!topp_processes_queue_.empty() && threads_active_ < allowed_threads_)
+    const bool limit_memory = (allowed_memory_ > 0.0);
+    while (!topp_processes_queue_.empty())
     {
-      ++threads_active_; // will be decreased, once the tool finishes
-      TOPPProcess tp = topp_processes_queue_.first();
-      topp_processes_queue_.pop_front();
+      // the most urgent process (the first one among equal priorities)
+      int head = 0;
+      for (int i = 1; i < topp_processes_queue_.size(); ++i)
+      {
+        if (topp_processes_queue_[i].priority > topp_processes_queue_[head].priority) head = i;
+      }
+
+      // a process asking for more than the whole budget gets all of it, but has to run alone
+      const int head_threads = std::min(std::max(topp_processes_queue_[head].threads, 1), allowed_threads_);
+      const double head_memory = topp_processes_queue_[head].memory;
+      const int free_threads = allowed_threads_ - threads_active_;
+      const double free_memory = allowed_memory_ - memory_active_;
+
+      int next = -1;
+      if (head_threads <= free_threads && (!limit_memory || running_processes_.empty() || head_memory <= free_memory))
+      {
+        next = head;
+      }
+      else
+      {
+        // reserve resources for the head: assuming that running processes finish in the order they
+        // were started, find out what is left over once enough of them finished for the head to start
+        int shadow_threads = free_threads;
+        double shadow_memory = free_memory;
+        for (int r = 0; r < running_processes_.size(); ++r)
+        {
+          if (shadow_threads >= head_threads && (!limit_memory || shadow_memory >= head_memory)) break;
+          shadow_threads += running_processes_[r].threads;
+          shadow_memory += running_processes_[r].memory;
+        }
+        const int extra_threads = shadow_threads - head_threads;
+        const double extra_memory = shadow_memory - head_memory; // negative if the head has to run alone
+
+        // backfill: the most urgent other process that fits now and does not touch the reservation
+        for (int i = 0; i < topp_processes_queue_.size(); ++i)
+        {
+          if (i == head) continue;
+          const TOPPProcess& candidate = topp_processes_queue_[i];
+          if (next >= 0 && candidate.priority <= topp_processes_queue_[next].priority) continue;
+
+          int threads = std::min(std::max(candidate.threads, 1), allowed_threads_);
+          bool fits = (threads <= free_threads && threads <= extra_threads) &&
+                      (!limit_memory || (candidate.memory <= free_memory && candidate.memory <= extra_memory));
+          if (fits) next = i;
+        }
+      }
+      if (next < 0) break; // wait for running processes to finish
+
+      TOPPProcess tp = topp_processes_queue_[next];
+      topp_processes_queue_.removeAt(next);
+
+      // will be released, once the tool finishes
+      RunningProcess_ running;
+      running.proc = tp.proc;
+      running.threads = std::min(std::max(tp.threads, 1), allowed_threads_);
+      running.memory = tp.memory;
+      threads_active_ += running.threads;
+      memory_active_ += running.memory;
+      running_processes_.append(running);
       FakeProcess* p = qobject_cast<FakeProcess*>(tp.proc);
       if (p)
       {
@@ -2348,6 +2427,29 @@ namespace OpenMS
     allowed_threads_ = num_jobs;
   }
 
+  void TOPPASScene::setAllowedMemory(double memory)
+  {
+    allowed_memory_ = std::max(memory, 0.0);
+  }
+
+  int TOPPASScene::getCriticalPathLength(TOPPASVertex* tv) const
+  {
+    QHash<const TOPPASVertex*, int>::const_iterator known = critical_path_lengths_.constFind(tv);
+    if (known != critical_path_lengths_.constEnd())
+    {
+      return known.value();
+    }
+
+    int longest = 0;
+    for (TOPPASVertex::ConstEdgeIterator it = tv->outEdgesBegin(); it != tv->outEdgesEnd(); ++it)
+    {
+      longest = std::max(longest, getCriticalPathLength((*it)->getTargetVertex()));
+    }
+    longest += (qobject_cast<TOPPASToolVertex*>(tv) ? 1 : 0);
+    critical_path_lengths_.insert(tv, longest);
+    return longest;
+  }
+
   bool TOPPASScene::isGUIMode() const
   {
     return gui_;
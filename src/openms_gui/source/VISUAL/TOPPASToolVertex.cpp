@@ -590,6 +590,10 @@ namespace OpenMS
 
     bool ini_round_dependent = false; // indicates if we need a new INI file for each round (usually GenericWrapper issue)
 
+    // resources for the scheduler: all rounds of this tool share threads and priority
+    const int num_threads = getNumThreads();
+    const int priority = ts->getCriticalPathLength(this);
+
     for (int round = 0; round < round_total_; ++round)
     {
       debugOut_(String("Enqueueing process nr ") + round + "/" + round_total_);
@@ -648,6 +652,9 @@ namespace OpenMS
 
       }
 
+      // estimate of the memory required for this round
+      double memory = estimateMemoryUsage(pkg[round]);
+
       // OUTGOING EDGES
       // ;output names are already prepared by 'updateCurrentOutputFileNames()'
       typedef RoundPackage::iterator EdgeIndexIt;
@@ -731,7 +738,7 @@ namespace OpenMS
         }
       }
       toolScheduledSlot();
-      ts->enqueueProcess(TOPPASScene::TOPPProcess(p, File::findExecutable(name_).toQString(), args, this));
+      ts->enqueueProcess(TOPPASScene::TOPPProcess(p, File::findExecutable(name_).toQString(), args, this, num_threads, memory, priority));
     }
 
     // run pending processes
@@ -740,6 +747,30 @@ namespace OpenMS
     __DEBUG_END_METHOD__
   }
 
+  int TOPPASToolVertex::getNumThreads() const
+  {
+    if (param_.exists("threads"))
+    {
+      return std::max(1, (int)param_.getValue("threads"));
+    }
+    return 1;
+  }
+
+  double TOPPASToolVertex::estimateMemoryUsage(const RoundPackage& round) const
+  {
+    // the in-memory representation of the common (XML) formats is in the order of the file size
+    qint64 bytes(0);
+    for (RoundPackageConstIt it = round.begin(); it != round.end(); ++it)
+    {
+      foreach(const QString& file, it->second.filenames.get())
+      {
+        QFileInfo fi(file);
+        if (fi.exists()) bytes += fi.size();
+      }
+    }
+    return bytes / (1024.0 * 1024.0);
+  }
+
   void TOPPASToolVertex::emitToolStarted()
   {
     emit toolStarted();
@@ -798,13 +829,12 @@ namespace OpenMS
 
     //clean up
     QProcess* p = qobject_cast<QProcess*>(QObject::sender());
+    ts->processFinished(p);
     if (p)
     {
       delete p;
     }
 
-    ts->processFinished();
-
     __DEBUG_END_METHOD__
   }
 
@@ -19,6 +19,7 @@ MultiGradient.cpp
 MultiGradientSelector.cpp
 
 ParamEditor.cpp
+PeakMapPyramid.cpp
 ParamEditor.ui
 
 SpectraIdentificationViewWidget.cpp
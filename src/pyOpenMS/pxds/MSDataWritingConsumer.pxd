@@ -20,6 +20,7 @@ cdef extern from "<OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>" namespace
         void addDataProcessing(DataProcessing d) nogil except +
         Size getNrSpectraWritten()  nogil except +
         Size getNrChromatogramsWritten() nogil except +
+        void close() nogil except +
 
         void setOptions(PeakFileOptions opt) nogil except +
         PeakFileOptions getOptions() nogil except +
@@ -38,4 +39,5 @@ cdef extern from "<OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>" namespace
         void addDataProcessing(DataProcessing d) nogil except +
         Size getNrSpectraWritten()  nogil except +
         Size getNrChromatogramsWritten() nogil except +
+        void close() nogil except +
 
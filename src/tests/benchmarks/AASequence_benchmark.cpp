@@ -0,0 +1,193 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/FORMAT/IdXMLFile.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+#include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <iostream>
+#include <random>
+
+using namespace OpenMS;
+using namespace std;
+
+/*
+  Benchmark of AASequence parsing and mass computation on a large idXML file.
+
+  Usage: AASequence_benchmark [<number of PSMs> [<idXML file>]]
+
+  If the idXML file does not exist, a synthetic one with the given number of
+  PSMs (default: 2,000,000) is generated first. The PSMs are drawn from a pool
+  of random tryptic peptides, a part of them with oxidized methionines and
+  carbamidomethylated cysteines, so sequences repeat as in real search results.
+*/
+
+namespace
+{
+  String randomPeptide(std::mt19937& rng)
+  {
+    static const String residues = "ACDEFGHILMNPQSTVWY"; // no K/R inside tryptic peptides
+    std::uniform_int_distribution<Size> length_dist(6, 24);
+    std::uniform_int_distribution<Size> residue_dist(0, residues.size() - 1);
+    std::bernoulli_distribution oxidized(0.5);
+
+    String peptide;
+    Size length = length_dist(rng);
+    for (Size i = 0; i < length; ++i)
+    {
+      char aa = residues[residue_dist(rng)];
+      peptide += aa;
+      if (aa == 'C') peptide += "(Carbamidomethyl)";
+      else if (aa == 'M' && oxidized(rng)) peptide += "(Oxidation)";
+    }
+    peptide += (rng() % 2) ? 'K' : 'R';
+    return peptide;
+  }
+
+  void generate(const String& filename, Size num_psms)
+  {
+    std::mt19937 rng(42);
+    vector<String> pool(50000);
+    for (Size i = 0; i < pool.size(); ++i)
+    {
+      pool[i] = randomPeptide(rng);
+    }
+
+    vector<ProteinIdentification> proteins(1);
+    proteins[0].setIdentifier("benchmark");
+    proteins[0].setSearchEngine("benchmark");
+
+    std::uniform_int_distribution<Size> pool_dist(0, pool.size() - 1);
+    vector<PeptideIdentification> peptides(num_psms);
+    for (Size i = 0; i < num_psms; ++i)
+    {
+      PeptideIdentification& id = peptides[i];
+      id.setIdentifier("benchmark");
+      id.setScoreType("q-value");
+      id.setHigherScoreBetter(false);
+      id.setRT(i * 0.01);
+      PeptideHit hit(1.0 / (i + 1), 1, 2 + i % 3, AASequence::fromString(pool[pool_dist(rng)]));
+      id.setMZ(hit.getSequence().getMonoWeight(Residue::Full, hit.getCharge()) / hit.getCharge());
+      id.insertHit(hit);
+    }
+    IdXMLFile().store(filename, proteins, peptides);
+  }
+}
+
+int main(int argc, const char** argv)
+{
+  Size num_psms = (argc > 1) ? String(argv[1]).toInt() : 2000000;
+  String filename = (argc > 2) ? String(argv[2]) : File::getTempDirectory() + "/AASequence_benchmark_" + String(num_psms) + ".idXML";
+
+  StopWatch sw;
+  if (!File::exists(filename))
+  {
+    sw.start();
+    generate(filename, num_psms);
+    sw.stop();
+    cout << "generating " << filename << ": " << sw.getClockTime() << " s" << endl;
+  }
+
+  // loading parses every sequence string
+  vector<ProteinIdentification> proteins;
+  vector<PeptideIdentification> peptides;
+  sw.reset();
+  sw.start();
+  IdXMLFile().load(filename, proteins, peptides);
+  sw.stop();
+  cout << "loading " << peptides.size() << " PSMs: " << sw.getClockTime() << " s" << endl;
+
+  vector<String> sequences;
+  sequences.reserve(peptides.size());
+  for (Size i = 0; i < peptides.size(); ++i)
+  {
+    for (Size j = 0; j < peptides[i].getHits().size(); ++j)
+    {
+      sequences.push_back(peptides[i].getHits()[j].getSequence().toString());
+    }
+  }
+
+  sw.reset();
+  sw.start();
+  Size residues = 0;
+  for (Size i = 0; i < sequences.size(); ++i)
+  {
+    residues += AASequence::fromString(sequences[i]).size();
+  }
+  sw.stop();
+  cout << "parsing " << sequences.size() << " sequences (" << residues << " residues): " << sw.getClockTime() << " s" << endl;
+
+  // first and repeated mass computations (ion types and charges as in fragment/precursor matching)
+  double sum = 0.0;
+  for (Size pass = 1; pass <= 2; ++pass)
+  {
+    sw.reset();
+    sw.start();
+    for (Size i = 0; i < peptides.size(); ++i)
+    {
+      for (Size j = 0; j < peptides[i].getHits().size(); ++j)
+      {
+        const AASequence& seq = peptides[i].getHits()[j].getSequence();
+        for (Int charge = 1; charge <= 3; ++charge)
+        {
+          sum += seq.getMonoWeight(Residue::Full, charge);
+        }
+      }
+    }
+    sw.stop();
+    cout << "getMonoWeight, pass " << pass << ": " << sw.getClockTime() << " s" << endl;
+  }
+
+  for (Size pass = 1; pass <= 2; ++pass)
+  {
+    sw.reset();
+    sw.start();
+    for (Size i = 0; i < peptides.size(); ++i)
+    {
+      for (Size j = 0; j < peptides[i].getHits().size(); ++j)
+      {
+        sum += peptides[i].getHits()[j].getSequence().getFormula().getMonoWeight();
+      }
+    }
+    sw.stop();
+    cout << "getFormula, pass " << pass << ": " << sw.getClockTime() << " s" << endl;
+  }
+
+  // print the checksum, so the computations are not optimized away
+  cout << "checksum: " << sum << endl;
+  return 0;
+}
@@ -112,6 +112,7 @@ set(system_executables_list
   File_test
   FileWatcher_test
   JavaInfo_test
+  PerformanceTrace_test
   StopWatch_test
   SysInfo_test
 )
@@ -160,6 +161,7 @@ set(format_executables_list
   CsvFile_test
   DTA2DFile_test
   DTAFile_test
+  DigestionCacheFile_test
   EDTAFile_test
   FASTAFile_test
   FeatureFileOptions_test
@@ -184,7 +186,7 @@ set(format_executables_list
   MascotInfile_test
   MascotRemoteQuery_test
   MascotXMLFile_test
-  #MSDataWritingConsumer_test
+  MSDataWritingConsumer_test
   MRMFeaturePickerFile_test
   MsInspectFile_test
   MzDataFile_test
@@ -367,6 +369,7 @@ set(chemistry_executables_list
   FastaIteratorIntern_test
   FastaIterator_test
   IsotopeDistribution_test
+  IsotopePatternGenerator_test
   ModificationDefinition_test
   ModificationDefinitionsSet_test
   ModificationsDB_test
@@ -375,6 +378,7 @@ set(chemistry_executables_list
   PepIterator_test
   ProteaseDB_test
   ProteaseDigestion_test
+  RNaseDigestion_test
   ResidueDB_test
   ResidueModification_test
   Residue_test
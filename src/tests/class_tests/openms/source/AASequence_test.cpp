@@ -98,6 +98,13 @@ START_SECTION(AASequence fromString(const String& s, bool permissive = true))
   AASequence seq4 = AASequence::fromString("VPQVSTPTLVEVSRSLGK(Label:18O(2))");
   TEST_EQUAL(seq3, seq4);
 
+  // repeated parsing of modified sequences (served from the parse cache) returns independent copies
+  seq4.setCTerminalModification("");
+  AASequence seq_cached = AASequence::fromString("VPQVSTPTLVEVSRSLGK(Label:18O(2))");
+  TEST_EQUAL(seq3, seq_cached);
+  TEST_NOT_EQUAL(seq4, seq_cached);
+  TEST_EQUAL(AASequence::fromString("VPQVSTPTLVEVSRSLGK(Label:18O(2))", false), seq_cached);
+
   AASequence seq5 = AASequence::fromString("(ICPL:2H(4))CNARCNCNCN");
   TEST_EQUAL(seq5.hasNTerminalModification(), true);
   TEST_EQUAL(seq5.isModified(), true);
@@ -228,6 +235,31 @@ START_SECTION((EmpiricalFormula getFormula(Residue::ResidueType type = Residue::
   TEST_EQUAL(seq.getFormula(), EmpiricalFormula("O10SH33N5C24"))
   TEST_EQUAL(seq.getFormula(Residue::Full, 1), EmpiricalFormula("O10SH33N5C24+"))
   TEST_EQUAL(seq.getFormula(Residue::BIon, 0), EmpiricalFormula("O9SH31N5C24"))
+
+  // memoized formula follows changes of the residues, copies are independent
+  AASequence seq2(seq);
+  seq.setModification(1, "Carbamidomethyl");
+  TEST_EQUAL(seq.getFormula(), EmpiricalFormula("O10SH33N5C24") + EmpiricalFormula("C2H3NO"))
+  TEST_EQUAL(seq2.getFormula(), EmpiricalFormula("O10SH33N5C24"))
+  seq2 += AASequence::fromString("G");
+  TEST_EQUAL(seq2.getFormula(), AASequence::fromString("ACDEFG").getFormula())
+  seq2 = seq;
+  TEST_EQUAL(seq2.getFormula(), seq.getFormula())
+
+  // concurrent access to the memo of the same object
+  const AASequence shared_seq = AASequence::fromString("DFPIANGER");
+  const EmpiricalFormula expected_formula = AASequence::fromString("DFPIANGER").getFormula();
+  const double expected_weight = AASequence::fromString("DFPIANGER").getMonoWeight();
+  Size mismatches = 0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+: mismatches)
+#endif
+  for (SignedSize i = 0; i < 1000; ++i)
+  {
+    if (shared_seq.getFormula() != expected_formula) ++mismatches;
+    if (shared_seq.getMonoWeight() != expected_weight) ++mismatches;
+  }
+  TEST_EQUAL(mismatches, 0)
 END_SECTION
 
 START_SECTION((double getAverageWeight(Residue::ResidueType type = Residue::Full, Int charge=0) const))
@@ -291,6 +323,20 @@ START_SECTION((double getMonoWeight(Residue::ResidueType type = Residue::Full, I
   TEST_REAL_SIMILAR(AASequence::fromString("TYQYS(Phospho)").getFormula().getMonoWeight(), AASequence::fromString("TYQYS(Phospho)").getMonoWeight());
 
   TEST_REAL_SIMILAR(AASequence::fromString("TYQYS(Phospho)").getFormula().getMonoWeight(), AASequence::fromString("TYQYS(Phospho)").getMonoWeight());
+
+  // memoized weight follows changes of the residues
+  AASequence seq4 = AASequence::fromString("DFPIANGER");
+  TEST_REAL_SIMILAR(seq4.getMonoWeight(), double(1017.48796))
+  seq4.setModification(5, "Deamidated");
+  TEST_REAL_SIMILAR(seq4.getMonoWeight(), double(1017.48796) + double(0.984016))
+  seq4.setModification(5, "");
+  TEST_REAL_SIMILAR(seq4.getMonoWeight(), double(1017.48796))
+  seq4 += ResidueDB::getInstance()->getResidue("R");
+  TEST_REAL_SIMILAR(seq4.getMonoWeight(), AASequence::fromString("DFPIANGERR").getMonoWeight())
+  seq4 += AASequence::fromString("K");
+  TEST_REAL_SIMILAR(seq4.getMonoWeight(), AASequence::fromString("DFPIANGERRK").getMonoWeight())
+  seq4 = AASequence::fromString("DFP");
+  TEST_REAL_SIMILAR(seq4.getMonoWeight(), AASequence::fromString("DFP").getFormula().getMonoWeight())
 END_SECTION
 
 START_SECTION(const Residue& operator[](Size index) const)
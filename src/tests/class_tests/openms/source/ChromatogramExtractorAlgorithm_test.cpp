@@ -151,6 +151,55 @@ START_SECTION(void extractChromatograms(const OpenSwath::SpectrumAccessPtr input
 }
 END_SECTION
 
+START_SECTION([EXTRA] void extractChromatograms with RT-limited extraction coordinates)
+{
+  boost::shared_ptr<PeakMap > exp(new PeakMap);
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("ChromatogramExtractor_input.mzML"), *exp);
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  ChromatogramExtractorAlgorithm extractor;
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates;
+  std::vector< OpenSwath::ChromatogramPtr > out_exp;
+  {
+    ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+    coord.mz = 618.31; coord.rt_start = 3000; coord.rt_end = 3060; coord.id = "tr1";
+    coordinates.push_back(coord);
+    coord.mz = 628.45; coord.rt_start = 3100; coord.rt_end = 3150; coord.id = "tr2";
+    coordinates.push_back(coord);
+  }
+  for (Size i = 0; i < coordinates.size(); i++)
+  {
+    out_exp.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+  }
+  extractor.extractChromatograms(expptr, out_exp, coordinates, 0.05, false, "tophat");
+
+  for (Size k = 0; k < coordinates.size(); k++)
+  {
+    const std::vector<double>& rts = out_exp[k]->getTimeArray()->data;
+    TEST_EQUAL(rts.empty(), false)
+    TEST_EQUAL(rts.size(), out_exp[k]->getIntensityArray()->data.size())
+    for (Size i = 0; i < rts.size(); i++)
+    {
+      TEST_EQUAL(rts[i] >= coordinates[k].rt_start && rts[i] <= coordinates[k].rt_end, true)
+    }
+  }
+
+  // the apex of the second chromatogram is within its RT window:
+  double max_value = -1; double foundat = -1;
+  OpenSwath::ChromatogramPtr chrom = out_exp[1];
+  for (Size i = 0; i < chrom->getTimeArray()->data.size(); i++)
+  {
+    if (chrom->getIntensityArray()->data[i] > max_value)
+    {
+      max_value = chrom->getIntensityArray()->data[i];
+      foundat = chrom->getTimeArray()->data[i];
+    }
+  }
+  TEST_REAL_SIMILAR(max_value, 169.792);
+  TEST_REAL_SIMILAR(foundat, 3120.26);
+}
+END_SECTION
+
 ///////////////////////////////////////////////////////////////////////////
 /// Private functions
 ///////////////////////////////////////////////////////////////////////////
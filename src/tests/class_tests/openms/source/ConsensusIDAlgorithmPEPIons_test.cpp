@@ -38,6 +38,7 @@
 ///////////////////////////
 
 #include <OpenMS/ANALYSIS/ID/ConsensusIDAlgorithmPEPIons.h>
+#include <OpenMS/FORMAT/IdXMLFile.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -66,7 +67,49 @@ END_SECTION
 
 START_SECTION(void apply(std::vector<PeptideIdentification>& ids))
 {
-  NOT_TESTABLE // tested by ConsensusID TOPP tool tests
+  vector<ProteinIdentification> proteins;
+  vector<PeptideIdentification> ids;
+  IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("ConsensusIDAlgorithmSimilarity_input.idXML"), proteins, ids);
+
+  // consensus scores by sequence (same as in TOPP test "ConsensusID_5"):
+  map<String, double> expected;
+  expected["QRESTATDILQK"] = 0.271111111111111;
+  expected["EIEEDSLEGLKK"] = 0.37983379501385;
+  expected["EQSATEQDILKK"] = 0.453686195082581;
+  expected["GIEDDLMDLIKK"] = 0.453686195082581;
+  expected["EDNMAIQSIIKK"] = 0.484090906711649;
+  expected["NTNNHNGHILKK"] = 0.502857142857143;
+  expected["WSVEEEELLKK"] = 0.617031243373058;
+  expected["ELM(Oxidation)SNGPGSIIGAK"] = 0.633277837548919;
+  expected["AKGDASAQIAAMQK"] = 0.641636318483666;
+  expected["IFHDFNIDLQK"] = 0.674666660343276;
+  expected["CAACITPVELKK"] = 0.69374999390915;
+  expected["ISCAEGALEALKK"] = 0.711851793047398;
+  expected["AELASCVVGDLGAK"] = 0.7584;
+  expected["GSDKALIEVDSQK"] = 0.758620091542861;
+
+  ConsensusIDAlgorithmPEPIons consensus;
+
+  // run 0: new instance; run 1: same instance (similarities are cached);
+  // run 2: reversed order of ID runs (cached pairs are looked up swapped)
+  for (Size run = 0; run < 3; ++run)
+  {
+    vector<PeptideIdentification> f = ids;
+    if (run == 2) reverse(f.begin(), f.end());
+    consensus.apply(f);
+    ABORT_IF(f.size() != 1);
+    const vector<PeptideHit>& hits = f[0].getHits();
+    TEST_EQUAL(hits.size(), expected.size());
+    for (vector<PeptideHit>::const_iterator it = hits.begin(); it != hits.end(); ++it)
+    {
+      map<String, double>::const_iterator pos = expected.find(it->getSequence().toString());
+      TEST_EQUAL(pos != expected.end(), true);
+      if (pos != expected.end())
+      {
+        TEST_REAL_SIMILAR(it->getScore(), pos->second);
+      }
+    }
+  }
 }
 END_SECTION
 
@@ -38,6 +38,7 @@
 ///////////////////////////
 
 #include <OpenMS/ANALYSIS/ID/ConsensusIDAlgorithmPEPMatrix.h>
+#include <OpenMS/FORMAT/IdXMLFile.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -66,7 +67,52 @@ END_SECTION
 
 START_SECTION(void apply(std::vector<PeptideIdentification>& ids))
 {
-  NOT_TESTABLE // tested by ConsensusID TOPP tool tests
+  vector<ProteinIdentification> proteins;
+  vector<PeptideIdentification> ids;
+  IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("ConsensusIDAlgorithmSimilarity_input.idXML"), proteins, ids);
+
+  // consensus scores by sequence (same as in TOPP test "ConsensusID_1"):
+  map<String, double> expected;
+  expected["QRESTATDILQK"] = 0.271111111111111;
+  expected["EIEEDSLEGLKK"] = 0.485;
+  expected["EQSATEQDILKK"] = 0.537641938481099;
+  expected["EDNMAIQSIIKK"] = 0.65315968;
+  expected["GIEDDLMDLIKK"] = 0.729375;
+  expected["ISCAEGALEALKK"] = 0.738922314049587;
+  expected["WSVEEEELLKK"] = 0.767518144971251;
+  expected["AKGDASAQIAAMQK"] = 0.857387152777777;
+  expected["CAACITPVELKK"] = 0.888230417685195;
+  expected["NTNNHNGHILKK"] = 0.9099609375;
+  expected["AELASCVVGDLGAK"] = 0.94;
+  expected["ELM(Oxidation)SNGPGSIIGAK"] = 0.95;
+  expected["IFHDFNIDLQK"] = 0.957209302325582;
+  expected["GSDKALIEVDSQK"] = 0.97;
+
+  ConsensusIDAlgorithmPEPMatrix consensus;
+  Param param = consensus.getParameters();
+  param.setValue("matrix", "PAM30MS");
+  consensus.setParameters(param);
+
+  // run 0: new instance; run 1: same instance (similarities are cached);
+  // run 2: reversed order of ID runs (cached pairs are looked up swapped)
+  for (Size run = 0; run < 3; ++run)
+  {
+    vector<PeptideIdentification> f = ids;
+    if (run == 2) reverse(f.begin(), f.end());
+    consensus.apply(f);
+    ABORT_IF(f.size() != 1);
+    const vector<PeptideHit>& hits = f[0].getHits();
+    TEST_EQUAL(hits.size(), expected.size());
+    for (vector<PeptideHit>::const_iterator it = hits.begin(); it != hits.end(); ++it)
+    {
+      map<String, double>::const_iterator pos = expected.find(it->getSequence().toString());
+      TEST_EQUAL(pos != expected.end(), true);
+      if (pos != expected.end())
+      {
+        TEST_REAL_SIMILAR(it->getScore(), pos->second);
+      }
+    }
+  }
 }
 END_SECTION
 
@@ -135,6 +135,24 @@ START_SECTION(double eval(double x))
   }
 END_SECTION
 
+START_SECTION(void evalSorted(std::vector<double>::iterator first, std::vector<double>::iterator last) const)
+  std::vector<double> xs;
+  xs.push_back(486.784);
+  xs.push_back(486.785);
+  xs.push_back(486.790);
+  xs.push_back(486.794);
+  xs.push_back(486.792); // not ascending
+  xs.push_back(486.811);
+  std::vector<double> ys(xs);
+  sp1.evalSorted(ys.begin(), ys.end());
+  for (Size i = 0; i < xs.size(); ++i)
+  {
+    TEST_EQUAL(ys[i], sp1.eval(xs[i]));
+  }
+  xs.push_back(400.0);
+  TEST_EXCEPTION(Exception::IllegalArgument, sp1.evalSorted(xs.begin(), xs.end()));
+END_SECTION
+
 START_SECTION(double derivatives(double x, unsigned order))
   // near border of spline range
   TEST_REAL_SIMILAR(sp1.derivatives(486.785,1), 39270152.2996247)
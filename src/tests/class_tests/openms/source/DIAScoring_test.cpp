@@ -481,6 +481,50 @@ START_SECTION( void score_with_isotopes(SpectrumType spectrum, const std::vector
 }
 END_SECTION
 
+START_SECTION([EXTRA] theoretical values are reused for the same assay and recomputed for a new one)
+{
+  OpenSwath::LightTransition mock_tr1;
+  mock_tr1.product_mz = 500.;
+  mock_tr1.fragment_charge = 1;
+  mock_tr1.transition_name = "group1";
+  mock_tr1.library_intensity = 5.;
+
+  OpenSwath::LightTransition mock_tr2;
+  mock_tr2.product_mz = 600.;
+  mock_tr2.fragment_charge = 1;
+  mock_tr2.transition_name = "group2";
+  mock_tr2.library_intensity = 5.;
+
+  OpenSwath::SpectrumPtr sptr = prepareSpectrum();
+
+  std::vector<OpenSwath::LightTransition> transitions, other_transitions;
+  transitions.push_back(mock_tr1);
+  transitions.push_back(mock_tr2);
+  other_transitions.push_back(mock_tr2);
+
+  DIAScoring reference;
+  reference.setParameters(p_dia);
+  double ref_dotprod, ref_manhattan;
+  reference.score_with_isotopes(sptr, other_transitions, ref_dotprod, ref_manhattan);
+
+  DIAScoring diascoring;
+  diascoring.setParameters(p_dia);
+  double dotprod, manhattan;
+  diascoring.score_with_isotopes(sptr, transitions, dotprod, manhattan);
+  diascoring.score_with_isotopes(sptr, transitions, dotprod, manhattan);
+  TEST_REAL_SIMILAR (dotprod, 0.730836983200467);
+  TEST_REAL_SIMILAR (manhattan, 0.643072639809147);
+
+  diascoring.score_with_isotopes(sptr, other_transitions, dotprod, manhattan);
+  TEST_REAL_SIMILAR (dotprod, ref_dotprod);
+  TEST_REAL_SIMILAR (manhattan, ref_manhattan);
+
+  diascoring.score_with_isotopes(sptr, transitions, dotprod, manhattan);
+  TEST_REAL_SIMILAR (dotprod, 0.730836983200467);
+  TEST_REAL_SIMILAR (manhattan, 0.643072639809147);
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -0,0 +1,184 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/DigestionCacheFile.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
+#include <OpenMS/FORMAT/FASTAFile.h>
+
+#include <fstream>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(DigestionCacheFile, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+DigestionCacheFile* ptr = nullptr;
+DigestionCacheFile* null_ptr = nullptr;
+START_SECTION((DigestionCacheFile()))
+{
+  ptr = new DigestionCacheFile();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+}
+END_SECTION
+
+START_SECTION((virtual ~DigestionCacheFile()))
+{
+  delete ptr;
+}
+END_SECTION
+
+const String fasta = OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta");
+
+START_SECTION((static String computeKey(const String& fasta_file, const EnzymaticDigestion& digestion, Size min_length, Size max_length)))
+{
+  ProteaseDigestion digestion;
+  digestion.setEnzyme("Trypsin");
+  String key = DigestionCacheFile::computeKey(fasta, digestion, 7, 40);
+  TEST_EQUAL(key.hasPrefix("sha1="), true)
+  TEST_EQUAL(key.hasSuffix(";enzyme=Trypsin;missed_cleavages=0;specificity=full;min_length=7;max_length=40"), true)
+  TEST_EQUAL(key, DigestionCacheFile::computeKey(fasta, digestion, 7, 40))
+
+  // every digestion parameter changes the key
+  TEST_NOT_EQUAL(key, DigestionCacheFile::computeKey(fasta, digestion, 6, 40))
+  TEST_NOT_EQUAL(key, DigestionCacheFile::computeKey(fasta, digestion, 7, 41))
+  ProteaseDigestion digestion2(digestion);
+  digestion2.setMissedCleavages(1);
+  TEST_NOT_EQUAL(key, DigestionCacheFile::computeKey(fasta, digestion2, 7, 40))
+  digestion2 = digestion;
+  digestion2.setSpecificity(EnzymaticDigestion::SPEC_SEMI);
+  TEST_NOT_EQUAL(key, DigestionCacheFile::computeKey(fasta, digestion2, 7, 40))
+  digestion2 = digestion;
+  digestion2.setEnzyme("Lys-C");
+  TEST_NOT_EQUAL(key, DigestionCacheFile::computeKey(fasta, digestion2, 7, 40))
+
+  // ... and so does the database
+  TEST_NOT_EQUAL(key, DigestionCacheFile::computeKey(OPENMS_GET_TEST_DATA_PATH("FastaIterator_test.fasta"), digestion, 7, 40))
+
+  TEST_EXCEPTION(Exception::FileNotFound, DigestionCacheFile::computeKey("this_file_does_not_exist.fasta", digestion, 7, 40))
+}
+END_SECTION
+
+START_SECTION((static String getCacheFileName(const String& cache_dir, const String& key)))
+{
+  String name = DigestionCacheFile::getCacheFileName("cache_dir", "some key");
+  TEST_EQUAL(name.hasPrefix("cache_dir/"), true)
+  TEST_EQUAL(name.hasSuffix(".digest"), true)
+  TEST_EQUAL(name, DigestionCacheFile::getCacheFileName("cache_dir", "some key"))
+  TEST_NOT_EQUAL(name, DigestionCacheFile::getCacheFileName("cache_dir", "some other key"))
+}
+END_SECTION
+
+START_SECTION((void store(const String& filename, const String& key, const Digests& digests) const))
+{
+  // tested below
+  NOT_TESTABLE
+}
+END_SECTION
+
+START_SECTION((bool load(const String& filename, const String& key, Digests& digests) const))
+{
+  // digest the test database
+  vector<FASTAFile::FASTAEntry> proteins;
+  FASTAFile().load(fasta, proteins);
+  ProteaseDigestion digestion;
+  digestion.setEnzyme("Trypsin");
+  DigestionCacheFile::Digests digests(proteins.size());
+  for (Size i = 0; i < proteins.size(); ++i)
+  {
+    vector<StringView> products;
+    digestion.digestUnmodified(proteins[i].sequence, products, 1, 40);
+    for (Size j = 0; j < products.size(); ++j)
+    {
+      digests[i].push_back(products[j].getString());
+    }
+  }
+  digests.push_back(vector<String>()); // a protein without products
+
+  String key = DigestionCacheFile::computeKey(fasta, digestion, 1, 40);
+  String filename;
+  NEW_TMP_FILE(filename);
+  DigestionCacheFile cache;
+  cache.store(filename, key, digests);
+
+  DigestionCacheFile::Digests loaded;
+  TEST_EQUAL(cache.load(filename, key, loaded), true)
+  TEST_EQUAL(loaded == digests, true)
+  TEST_EQUAL(loaded.size(), proteins.size() + 1)
+  TEST_EQUAL(loaded[0].empty(), false)
+  TEST_EQUAL(loaded.back().empty(), true)
+
+  // overwriting an existing cache file
+  digests.pop_back();
+  cache.store(filename, key, digests);
+  TEST_EQUAL(cache.load(filename, key, loaded), true)
+  TEST_EQUAL(loaded == digests, true)
+
+  // different key
+  TEST_EQUAL(cache.load(filename, key + "x", loaded), false)
+  TEST_EQUAL(loaded.empty(), true)
+
+  // missing file
+  TEST_EQUAL(cache.load("this_file_does_not_exist.digest", key, loaded), false)
+
+  // damaged (truncated) file
+  String damaged;
+  NEW_TMP_FILE(damaged);
+  {
+    ifstream in(filename.c_str(), ios::binary);
+    string content((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    ofstream out(damaged.c_str(), ios::binary);
+    out.write(content.data(), content.size() - 3);
+  }
+  TEST_EQUAL(cache.load(damaged, key, loaded), false)
+  TEST_EQUAL(loaded.empty(), true)
+
+  // not a cache file
+  TEST_EQUAL(cache.load(fasta, key, loaded), false)
+
+  TEST_EXCEPTION(Exception::UnableToCreateFile, cache.store("this_dir_does_not_exist/cache.digest", key, digests))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -237,6 +237,31 @@ START_SECTION((void updateMinElement()))
 }
 END_SECTION
 
+START_SECTION((const ValueType* getRow(SizeType i) const))
+{
+	const double* row = dm.getRow(3);
+	TEST_EQUAL(row[0],dm(3,0))
+	TEST_EQUAL(row[1],dm(3,1))
+	TEST_EQUAL(row[2],dm(3,2))
+}
+END_SECTION
+
+START_SECTION((void setBackingFile(const std::string& filename)))
+{
+	String tmp_file;
+	NEW_TMP_FILE(tmp_file)
+	DistanceMatrix<double> mapped;
+	mapped.setBackingFile(tmp_file);
+	TEST_EQUAL(mapped.getBackingFile(),tmp_file)
+	mapped.resize(4,2.0);
+	mapped.setValue(3,1,0.5);
+	TEST_EQUAL(mapped(1,3),0.5)
+	mapped.updateMinElement();
+	TEST_EQUAL(mapped.getMinElementCoordinates().first,3)
+	TEST_EQUAL(mapped.getMinElementCoordinates().second,1)
+}
+END_SECTION
+
 DistanceMatrix<double> dm3(dm);
 
 START_SECTION(bool operator==(DistanceMatrix< ValueType > const &rhs) const)
@@ -110,14 +110,23 @@ START_SECTION(const String& getSymbol() const)
 END_SECTION
 
 START_SECTION(void setIsotopeDistribution(const IsotopeDistribution& isotopes))
+	Size version = Element::getIsotopeDistributionVersion();
 	e_ptr->setIsotopeDistribution(dist);
-	NOT_TESTABLE
+	TEST_EQUAL(Element::getIsotopeDistributionVersion(), version + 1)
 END_SECTION
 
 START_SECTION((const IsotopeDistribution& getIsotopeDistribution() const))
 	TEST_EQUAL(e_ptr->getIsotopeDistribution() == dist, true)
 END_SECTION
 
+START_SECTION(static Size getIsotopeDistributionVersion())
+	Size version = Element::getIsotopeDistributionVersion();
+	TEST_EQUAL(Element::getIsotopeDistributionVersion(), version)
+	Element e;
+	e.setIsotopeDistribution(dist);
+	TEST_EQUAL(Element::getIsotopeDistributionVersion() > version, true)
+END_SECTION
+
 START_SECTION(void setAverageWeight(double weight))
 	e_ptr->setAverageWeight(average_weight);
 	NOT_TESTABLE
@@ -495,6 +495,36 @@ START_SECTION([EXTRA] Size countMissedCleavages_(const std::vector<int>& cleavag
   TEST_EQUAL(ed.isValidProduct("KKKK", 0, 4, false), true);  // has 3 MC's, should be valid
 END_SECTION
 
+START_SECTION([EXTRA] compiled cleavage rules give the same result as the regular expressions)
+{
+  // reference: split with the enzyme's regular expression (as done before the rules were compiled)
+  const String seq = "MKPRKADEBZDPWKKRPPDEDHKPRPGFLWYAILVTASVNQCKRX";
+  EnzymaticDigestion ed;
+  ed.setMissedCleavages(2);
+  for (ProteaseDB::ConstEnzymeIterator it = ProteaseDB::getInstance()->beginEnzyme(); it != ProteaseDB::getInstance()->endEnzyme(); ++it)
+  {
+    const DigestionEnzyme* enzyme = *it;
+    if (enzyme->getName() == EnzymaticDigestion::UnspecificCleavage || enzyme->getRegEx() == "()") continue;
+    ed.setEnzyme(enzyme);
+
+    std::vector<int> sites;
+    boost::regex re(enzyme->getRegEx());
+    boost::sregex_token_iterator i(seq.begin(), seq.end(), re, -1), j;
+    for (int start = 0; i != j; start += (int)i->length(), ++i) sites.push_back(start);
+
+    std::vector<StringView> products;
+    ed.digestUnmodified(seq, products);
+    // products without missed cleavages come first
+    TEST_EQUAL(products.size() >= sites.size(), true)
+    for (Size k = 0; k < sites.size() && k < products.size(); ++k)
+    {
+      Size length = (k + 1 < sites.size() ? sites[k + 1] : seq.size()) - sites[k];
+      TEST_STRING_EQUAL(products[k].getString(), seq.substr(sites[k], length))
+    }
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
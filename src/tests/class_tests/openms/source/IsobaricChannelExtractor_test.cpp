@@ -751,6 +751,87 @@ START_SECTION(([EXTRA] TMT 10plex support))
 }
 END_SECTION
 
+START_SECTION(([EXTRA] purity computation with empty precursor scans))
+{
+  PeakMap exp_purity;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IsobaricChannelExtractor_6.mzML"), exp_purity);
+  // remove the peaks of all MS1 scans
+  for (PeakMap::Iterator it = exp_purity.begin(); it != exp_purity.end(); ++it)
+  {
+    if (it->getMSLevel() == 1) it->clear(false);
+  }
+
+  IsobaricChannelExtractor ice(q_method);
+  Param p = ice.getParameters();
+  p.setValue("select_activation", "");
+  p.setValue("min_precursor_purity", 0.75);
+  ice.setParameters(p);
+
+  // no purity can be computed, so no scan is filtered
+  ConsensusMap cm_out;
+  ice.extractChannels(exp_purity, cm_out);
+  TEST_EQUAL(cm_out.size(), 5)
+  for (Size i = 0; i < cm_out.size(); ++i)
+  {
+    TEST_EQUAL(cm_out[i].metaValueExists("precursor_purity"), false)
+  }
+}
+END_SECTION
+
+START_SECTION(([EXTRA] IsobaricChannelExtractionConsumer gives the same result as extractChannels))
+{
+  IsobaricChannelExtractor ice(q_method);
+  Param p = ice.getParameters();
+  p.setValue("select_activation", "");
+  ice.setParameters(p);
+
+  PeakMap exp;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IsobaricChannelExtractor_6.mzML"), exp);
+  ConsensusMap cm_in_memory;
+  ice.extractChannels(exp, cm_in_memory);
+
+  // stream the same file without keeping it in memory
+  ConsensusMap cm_streamed;
+  IsobaricChannelExtractionConsumer consumer(ice, cm_streamed);
+  MzMLFile().transform(OPENMS_GET_TEST_DATA_PATH("IsobaricChannelExtractor_6.mzML"), &consumer);
+  consumer.finish();
+
+  TEST_EQUAL(cm_streamed.size(), cm_in_memory.size())
+  ABORT_IF(cm_streamed.size() != cm_in_memory.size())
+  TEST_EQUAL(cm_streamed.getExperimentType(), "labeled_MS2")
+  TEST_EQUAL(cm_streamed.getFileDescriptions().size(), cm_in_memory.getFileDescriptions().size())
+  for (Size i = 0; i < cm_in_memory.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(cm_streamed[i].getRT(), cm_in_memory[i].getRT())
+    TEST_REAL_SIMILAR(cm_streamed[i].getMZ(), cm_in_memory[i].getMZ())
+    TEST_REAL_SIMILAR(cm_streamed[i].getIntensity(), cm_in_memory[i].getIntensity())
+    TEST_REAL_SIMILAR(cm_streamed[i].getMetaValue("precursor_purity"), cm_in_memory[i].getMetaValue("precursor_purity"))
+    TEST_EQUAL(cm_streamed[i].getMetaValue("scan_id"), cm_in_memory[i].getMetaValue("scan_id"))
+    TEST_EQUAL(cm_streamed[i].size(), cm_in_memory[i].size())
+    ConsensusFeature::const_iterator it_s = cm_streamed[i].begin();
+    for (ConsensusFeature::const_iterator it_m = cm_in_memory[i].begin(); it_m != cm_in_memory[i].end() && it_s != cm_streamed[i].end(); ++it_m, ++it_s)
+    {
+      TEST_EQUAL(it_s->getMapIndex(), it_m->getMapIndex())
+      TEST_REAL_SIMILAR(it_s->getIntensity(), it_m->getIntensity())
+    }
+  }
+
+  // spectra must be sorted by RT
+  MSSpectrum s1, s2;
+  s1.setRT(10.0);
+  s2.setRT(5.0);
+  ConsensusMap cm_unsorted;
+  IsobaricChannelExtractionConsumer unsorted_consumer(ice, cm_unsorted);
+  unsorted_consumer.consumeSpectrum(s1);
+  TEST_EXCEPTION(Exception::InvalidParameter, unsorted_consumer.consumeSpectrum(s2))
+
+  // nothing consumed
+  ConsensusMap cm_empty;
+  IsobaricChannelExtractionConsumer empty_consumer(ice, cm_empty);
+  TEST_EXCEPTION(Exception::MissingInformation, empty_consumer.finish())
+}
+END_SECTION
+
 delete q_method;
 
 /////////////////////////////////////////////////////////////
@@ -0,0 +1,221 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/IsotopePatternGenerator.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/Element.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(IsotopePatternGenerator, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+IsotopePatternGenerator* ptr = nullptr;
+IsotopePatternGenerator* null_ptr = nullptr;
+START_SECTION(IsotopePatternGenerator(double probability_threshold = 1e-6))
+{
+  ptr = new IsotopePatternGenerator();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_REAL_SIMILAR(ptr->getProbabilityThreshold(), 1e-6)
+}
+END_SECTION
+
+START_SECTION(virtual ~IsotopePatternGenerator())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(static IsotopePatternGenerator* getInstance())
+{
+  TEST_NOT_EQUAL(IsotopePatternGenerator::getInstance(), null_ptr)
+  TEST_EQUAL(IsotopePatternGenerator::getInstance(), IsotopePatternGenerator::getInstance())
+}
+END_SECTION
+
+START_SECTION(double getProbabilityThreshold() const)
+{
+  IsotopePatternGenerator gen(1e-3);
+  TEST_REAL_SIMILAR(gen.getProbabilityThreshold(), 1e-3)
+}
+END_SECTION
+
+START_SECTION(FineStructure getFineStructure(const EmpiricalFormula& formula, double resolution = 0.0) const)
+{
+  IsotopePatternGenerator gen;
+  EmpiricalFormula water("H2O");
+
+  // HH-16O, HH-17O, HD-16O, HH-18O (the other isotopologues are below 1e-6)
+  IsotopePatternGenerator::FineStructure fine = gen.getFineStructure(water);
+  TEST_EQUAL(fine.size(), 4)
+  TOLERANCE_ABSOLUTE(1e-6)
+  TEST_REAL_SIMILAR(fine[0].first, water.getMonoWeight())
+  TEST_REAL_SIMILAR(fine[0].second, 0.999885 * 0.999885 * 0.99757)
+  TEST_REAL_SIMILAR(fine[1].first, water.getMonoWeight() + 1.004217)
+  TEST_REAL_SIMILAR(fine[2].first, water.getMonoWeight() + 1.006277)
+  TEST_REAL_SIMILAR(fine[2].second, 2 * 0.999885 * 0.000115 * 0.99757)
+  for (Size i = 1; i < fine.size(); ++i)
+  {
+    TEST_EQUAL(fine[i - 1].first < fine[i].first, true)
+  }
+
+  // the 17O and D isotopologues are not resolved at 0.01 Da
+  IsotopePatternGenerator::FineStructure merged = gen.getFineStructure(water, 0.01);
+  TEST_EQUAL(merged.size(), 3)
+  TEST_REAL_SIMILAR(merged[1].second, fine[1].second + fine[2].second)
+  TEST_REAL_SIMILAR(merged[1].first, (fine[1].first * fine[1].second + fine[2].first * fine[2].second) / (fine[1].second + fine[2].second))
+
+  // probabilities of a larger molecule add up to (almost) one
+  IsotopePatternGenerator::FineStructure peptide = gen.getFineStructure(EmpiricalFormula("C100H160N30O30S2"));
+  double sum = 0.0;
+  for (Size i = 0; i < peptide.size(); ++i)
+  {
+    sum += peptide[i].second;
+  }
+  TOLERANCE_ABSOLUTE(1e-3)
+  TEST_REAL_SIMILAR(sum, 1.0)
+
+  TEST_EXCEPTION(Exception::IllegalArgument, gen.getFineStructure(EmpiricalFormula("H-2O")))
+}
+END_SECTION
+
+START_SECTION(IsotopeDistribution getCoarseDistribution(const EmpiricalFormula& formula, Size max_isotope) const)
+{
+  IsotopePatternGenerator gen;
+  EmpiricalFormula formula("C52H86N14O15S");
+  IsotopeDistribution expected = formula.getIsotopeDistribution(5);
+  TEST_EQUAL(gen.getCoarseDistribution(formula, 5) == expected, true)
+  // cached result
+  TEST_EQUAL(gen.getCoarseDistribution(formula, 5) == expected, true)
+  TEST_EQUAL(gen.getCoarseDistribution(formula, 3).size(), 3)
+}
+END_SECTION
+
+START_SECTION(IsotopeDistribution getAveragineDistribution(double average_weight, Size max_isotope, const String& type = "peptide") const)
+{
+  IsotopePatternGenerator gen;
+  IsotopeDistribution expected(4);
+  expected.estimateFromPeptideWeight(1234.5);
+  TEST_EQUAL(gen.getAveragineDistribution(1234.5, 4) == expected, true)
+  expected.estimateFromRNAWeight(2345.6);
+  TEST_EQUAL(gen.getAveragineDistribution(2345.6, 4, "RNA") == expected, true)
+  expected.estimateFromDNAWeight(2345.6);
+  TEST_EQUAL(gen.getAveragineDistribution(2345.6, 4, "DNA") == expected, true)
+  TEST_EXCEPTION(Exception::InvalidParameter, gen.getAveragineDistribution(1000.0, 4, "protein"))
+}
+END_SECTION
+
+START_SECTION(std::vector<IsotopeDistribution> getAveragineDistributions(const std::vector<double>& average_weights, Size max_isotope, const String& type = "peptide") const)
+{
+  IsotopePatternGenerator gen;
+  std::vector<double> weights;
+  weights.push_back(500.0);
+  weights.push_back(1500.0);
+  weights.push_back(3000.0);
+  std::vector<IsotopeDistribution> result = gen.getAveragineDistributions(weights, 6);
+  TEST_EQUAL(result.size(), 3)
+  for (Size i = 0; i < weights.size(); ++i)
+  {
+    IsotopeDistribution expected(6);
+    expected.estimateFromPeptideWeight(weights[i]);
+    TEST_EQUAL(result[i] == expected, true)
+  }
+  TEST_EXCEPTION(Exception::InvalidParameter, gen.getAveragineDistributions(weights, 6, "protein"))
+}
+END_SECTION
+
+START_SECTION(std::vector<IsotopeDistribution> getAveragineDistributions(double weight_min, double weight_max, double weight_step, Size max_isotope, const String& type = "peptide") const)
+{
+  IsotopePatternGenerator gen;
+  std::vector<IsotopeDistribution> result = gen.getAveragineDistributions(100.0, 5000.0, 10.0, 10);
+  TEST_EQUAL(result.size(), 491)
+  IsotopeDistribution expected(10);
+  expected.estimateFromPeptideWeight(2500.0);
+  TEST_EQUAL(result[240] == expected, true)
+  TEST_EXCEPTION(Exception::IllegalArgument, gen.getAveragineDistributions(100.0, 5000.0, 0.0, 10))
+}
+END_SECTION
+
+START_SECTION(static EmpiricalFormula getAveragineFormula(double average_weight, const String& type = "peptide"))
+{
+  EmpiricalFormula expected;
+  expected.estimateFromWeightAndComp(1234.5, 4.9384, 7.7583, 1.3577, 1.4773, 0.0417, 0);
+  TEST_EQUAL(IsotopePatternGenerator::getAveragineFormula(1234.5) == expected, true)
+  expected.estimateFromWeightAndComp(2345.6, 9.75, 12.25, 3.75, 7, 0, 1);
+  TEST_EQUAL(IsotopePatternGenerator::getAveragineFormula(2345.6, "RNA") == expected, true)
+  expected.estimateFromWeightAndComp(2345.6, 9.75, 12.25, 3.75, 6, 0, 1);
+  TEST_EQUAL(IsotopePatternGenerator::getAveragineFormula(2345.6, "DNA") == expected, true)
+  TEST_EXCEPTION(Exception::InvalidParameter, IsotopePatternGenerator::getAveragineFormula(1000.0, "protein"))
+}
+END_SECTION
+
+START_SECTION(Size getCacheSize() const)
+{
+  IsotopePatternGenerator gen;
+  TEST_EQUAL(gen.getCacheSize(), 0)
+  gen.getCoarseDistribution(EmpiricalFormula("C6H12O6"), 3);
+  gen.getCoarseDistribution(EmpiricalFormula("C6H12O6"), 3);
+  gen.getFineStructure(EmpiricalFormula("C6H12O6"));
+  TEST_EQUAL(gen.getCacheSize(), 2)
+}
+END_SECTION
+
+START_SECTION(void clearCache())
+{
+  IsotopePatternGenerator gen;
+  gen.getCoarseDistribution(EmpiricalFormula("C6H12O6"), 3);
+  TEST_EQUAL(gen.getCacheSize(), 1)
+  gen.clearCache();
+  TEST_EQUAL(gen.getCacheSize(), 0)
+
+  // changing the isotope abundances of any element invalidates cached patterns
+  gen.getCoarseDistribution(EmpiricalFormula("C6H12O6"), 3);
+  TEST_EQUAL(gen.getCacheSize(), 1)
+  Element e;
+  e.setIsotopeDistribution(e.getIsotopeDistribution());
+  TEST_EQUAL(gen.getCacheSize(), 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -33,11 +33,14 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
 
 ///////////////////////////
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
 ///////////////////////////
 
+#include <OpenMS/FORMAT/MzMLFile.h>
+
 using namespace OpenMS;
 using namespace std;
 
@@ -46,79 +49,176 @@ START_TEST(MSDataWritingConsumer, "$Id$")
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 
-MSDataWritingConsumer* ptr = 0;
-MSDataWritingConsumer* null_ptr = 0;
-START_SECTION(MSDataWritingConsumer())
-{
-	ptr = new MSDataWritingConsumer();
-	TEST_NOT_EQUAL(ptr, null_ptr)
-}
-END_SECTION
+// MSDataWritingConsumer is abstract, PlainMSDataWritingConsumer is the simplest implementation
 
-START_SECTION(~MSDataWritingConsumer())
-{
-	delete ptr;
-}
-END_SECTION
+PlainMSDataWritingConsumer* ptr = nullptr;
+PlainMSDataWritingConsumer* null_ptr = nullptr;
 
-START_SECTION((virtual void setExperimentalSettings(const ExperimentalSettings &exp)))
+START_SECTION((MSDataWritingConsumer(String filename)))
 {
-  // TODO
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  ptr = new PlainMSDataWritingConsumer(tmp_filename);
+  TEST_NOT_EQUAL(ptr, null_ptr)
 }
 END_SECTION
 
-START_SECTION((virtual void setExpectedSize(Size expectedSpectra, Size expectedChromatograms)))
+START_SECTION((virtual ~MSDataWritingConsumer()))
 {
-  // TODO
+  delete ptr;
 }
 END_SECTION
 
-START_SECTION((virtual void consumeSpectrum(SpectrumType &s)))
+MSSpectrum spectrum;
+spectrum.setRT(1.5);
+spectrum.setMSLevel(1);
+spectrum.setNativeID("spectrum=1");
+for (Size i = 0; i < 10; ++i)
 {
-  // TODO
+  Peak1D peak;
+  peak.setMZ(100.0 + i);
+  peak.setIntensity(10.0 * (i + 1));
+  spectrum.push_back(peak);
 }
-END_SECTION
 
-START_SECTION((virtual void consumeChromatogram(ChromatogramType &c)))
+MSChromatogram chromatogram;
+chromatogram.setNativeID("chromatogram=1");
+for (Size i = 0; i < 5; ++i)
 {
-  // TODO
+  ChromatogramPeak peak;
+  peak.setRT(10.0 + i);
+  peak.setIntensity(100.0 * (i + 1));
+  chromatogram.push_back(peak);
 }
-END_SECTION
 
-START_SECTION((MSDataWritingConsumer(String filename)))
+START_SECTION((virtual void consumeSpectrum(SpectrumType &s)))
 {
-  // TODO
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  {
+    PlainMSDataWritingConsumer consumer(tmp_filename);
+    consumer.setExpectedSize(3, 0);
+    for (Size i = 0; i < 3; ++i)
+    {
+      MSSpectrum s = spectrum;
+      s.setRT(spectrum.getRT() + i);
+      s.setNativeID("spectrum=" + String(i + 1));
+      consumer.consumeSpectrum(s);
+    }
+    consumer.close();
+  }
+
+  PeakMap exp;
+  MzMLFile().load(tmp_filename, exp);
+  TEST_EQUAL(exp.size(), 3)
+  ABORT_IF(exp.size() != 3)
+  TEST_REAL_SIMILAR(exp[2].getRT(), 3.5)
+  TEST_EQUAL(exp[2].getNativeID(), "spectrum=3")
+  TEST_EQUAL(exp[2].size(), 10)
 }
 END_SECTION
 
-START_SECTION((virtual ~MSDataWritingConsumer()))
+START_SECTION((virtual void consumeChromatogram(ChromatogramType &c)))
 {
-  // TODO
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  {
+    PlainMSDataWritingConsumer consumer(tmp_filename);
+    consumer.setExpectedSize(1, 1);
+    MSSpectrum s = spectrum;
+    consumer.consumeSpectrum(s);
+    MSChromatogram c = chromatogram;
+    consumer.consumeChromatogram(c);
+
+    // no spectra after chromatograms
+    TEST_EXCEPTION(Exception::IllegalArgument, consumer.consumeSpectrum(s))
+    consumer.close();
+  }
+
+  PeakMap exp;
+  MzMLFile().load(tmp_filename, exp);
+  TEST_EQUAL(exp.size(), 1)
+  TEST_EQUAL(exp.getChromatograms().size(), 1)
+  ABORT_IF(exp.getChromatograms().size() != 1)
+  TEST_EQUAL(exp.getChromatograms()[0].getNativeID(), "chromatogram=1")
+  TEST_EQUAL(exp.getChromatograms()[0].size(), 5)
 }
 END_SECTION
 
 START_SECTION((virtual void addDataProcessing(DataProcessing d)))
 {
-  // TODO
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  {
+    PlainMSDataWritingConsumer consumer(tmp_filename);
+    consumer.setExpectedSize(1, 0);
+    DataProcessing dp;
+    dp.getProcessingActions().insert(DataProcessing::SMOOTHING);
+    consumer.addDataProcessing(dp);
+    MSSpectrum s = spectrum;
+    consumer.consumeSpectrum(s);
+    // the consumed spectrum itself is not changed
+    TEST_EQUAL(s.getDataProcessing().size(), 0)
+    consumer.close();
+  }
+
+  PeakMap exp;
+  MzMLFile().load(tmp_filename, exp);
+  ABORT_IF(exp.size() != 1)
+  TEST_EQUAL(exp[0].getDataProcessing().empty(), false)
 }
 END_SECTION
 
 START_SECTION((virtual Size getNrSpectraWritten()))
 {
-  // TODO
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  PlainMSDataWritingConsumer consumer(tmp_filename);
+  TEST_EQUAL(consumer.getNrSpectraWritten(), 0)
+  MSSpectrum s = spectrum;
+  consumer.consumeSpectrum(s);
+  consumer.consumeSpectrum(s);
+  TEST_EQUAL(consumer.getNrSpectraWritten(), 2)
 }
 END_SECTION
 
 START_SECTION((virtual Size getNrChromatogramsWritten()))
 {
-  // TODO
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  PlainMSDataWritingConsumer consumer(tmp_filename);
+  TEST_EQUAL(consumer.getNrChromatogramsWritten(), 0)
+  MSChromatogram c = chromatogram;
+  consumer.consumeChromatogram(c);
+  TEST_EQUAL(consumer.getNrChromatogramsWritten(), 1)
 }
 END_SECTION
 
+START_SECTION((virtual void close()))
+{
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  PlainMSDataWritingConsumer consumer(tmp_filename);
+  MSSpectrum s = spectrum;
+  consumer.consumeSpectrum(s);
+  consumer.close();
+  // further calls have no effect
+  consumer.close();
+  // no data after closing
+  TEST_EXCEPTION(Exception::IllegalArgument, consumer.consumeSpectrum(s))
+  MSChromatogram c = chromatogram;
+  TEST_EXCEPTION(Exception::IllegalArgument, consumer.consumeChromatogram(c))
+
+  // write errors are reported
+  PlainMSDataWritingConsumer unwritable("/this/directory/does/not/exist/MSDataWritingConsumer.mzML");
+  unwritable.consumeSpectrum(s);
+  TEST_EXCEPTION(Exception::UnableToCreateFile, unwritable.close())
+
+  NoopMSDataWritingConsumer noop("");
+  noop.close();
+}
+END_SECTION
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
-
-
-
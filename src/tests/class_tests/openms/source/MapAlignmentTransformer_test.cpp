@@ -40,6 +40,8 @@
 #include <OpenMS/KERNEL/ConsensusFeature.h>
 #include <OpenMS/KERNEL/Feature.h>
 #include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
 
 ///////////////////////////
 #include <OpenMS/ANALYSIS/MAPMATCHING/MapAlignmentTransformer.h>
@@ -134,6 +136,60 @@ START_SECTION((static void transformRetentionTimes(PeakMap& msexp, const Transfo
 }
 END_SECTION
 
+START_SECTION((static void transformRetentionTimes(MSSpectrum& spectrum, const TransformationDescription& trafo, bool store_original_rt = false)))
+{
+  MSSpectrum spec;
+  spec.setRT(11.1);
+
+  MapAlignmentTransformer::transformRetentionTimes(spec, td);
+  TEST_REAL_SIMILAR(spec.getRT(), 23.2)
+  TEST_EQUAL(spec.metaValueExists("original_RT"), false)
+
+  MapAlignmentTransformer::transformRetentionTimes(spec, td, true);
+  TEST_REAL_SIMILAR(spec.getRT(), 47.4)
+  TEST_REAL_SIMILAR(spec.getMetaValue("original_RT"), 23.2)
+
+  // applying a transform again doesn't overwrite the original RT:
+  MapAlignmentTransformer::transformRetentionTimes(spec, td, true);
+  TEST_REAL_SIMILAR(spec.getRT(), 95.8)
+  TEST_REAL_SIMILAR(spec.getMetaValue("original_RT"), 23.2)
+}
+END_SECTION
+
+START_SECTION((static void transformRetentionTimes(MSChromatogram& chromatogram, const TransformationDescription& trafo, bool store_original_rt = false)))
+{
+  MSChromatogram chrom;
+  ChromatogramPeak peak;
+  peak.setRT(11.1);
+  chrom.push_back(peak);
+  peak.setRT(11.5);
+  chrom.push_back(peak);
+  peak.setRT(12.2);
+  chrom.push_back(peak);
+
+  MapAlignmentTransformer::transformRetentionTimes(chrom, td);
+  TEST_REAL_SIMILAR(chrom[0].getRT(), 23.2)
+  TEST_REAL_SIMILAR(chrom[1].getRT(), 24.0)
+  TEST_REAL_SIMILAR(chrom[2].getRT(), 25.4)
+  TEST_EQUAL(chrom.metaValueExists("original_rt"), false)
+
+  MapAlignmentTransformer::transformRetentionTimes(chrom, td, true);
+  TEST_REAL_SIMILAR(chrom[0].getRT(), 47.4)
+  TEST_REAL_SIMILAR(chrom[2].getRT(), 51.8)
+  DoubleList original_rts = chrom.getMetaValue("original_rt");
+  TEST_EQUAL(original_rts.size(), 3)
+  TEST_REAL_SIMILAR(original_rts[0], 23.2)
+  TEST_REAL_SIMILAR(original_rts[1], 24.0)
+  TEST_REAL_SIMILAR(original_rts[2], 25.4)
+
+  // applying a transform again doesn't overwrite the original RTs:
+  MapAlignmentTransformer::transformRetentionTimes(chrom, td, true);
+  original_rts = chrom.getMetaValue("original_rt");
+  TEST_REAL_SIMILAR(original_rts[0], 23.2)
+  TEST_REAL_SIMILAR(original_rts[2], 25.4)
+}
+END_SECTION
+
 START_SECTION((static void transformRetentionTimes(FeatureMap& fmap, const TransformationDescription& trafo, bool store_original_rt = false)))
 {
   Feature f;
@@ -277,7 +277,59 @@ START_SECTION((static void applyVariableModifications(const std::vector< Residue
 }
 END_SECTION
 
-
+START_SECTION(([ModifiedPeptideGenerator::VariantEnumerator] bool next(), double getMonoWeight() const, AASequence getSequence() const))
+{
+  vector<ResidueModification> var_mods;
+  var_mods.push_back(ModificationsDB::getInstance()->getModification("Oxidation (M)"));
+  var_mods.push_back(ModificationsDB::getInstance()->getModification("Phospho (S)"));
+  var_mods.push_back(ModificationsDB::getInstance()->getModification("Phospho (T)"));
+  var_mods.push_back(ModificationsDB::getInstance()->getModification("Acetyl (N-term)"));
+
+  AASequence seq = AASequence::fromString("SAMSTAMK");
+  for (Size max_mods = 0; max_mods <= 4; ++max_mods)
+  {
+    vector<AASequence> modified_peptides;
+    ModifiedPeptideGenerator::applyVariableModifications(var_mods.begin(), var_mods.end(), seq, max_mods, modified_peptides, true);
+
+    // same variants in the same order, masses without creating the sequence
+    ModifiedPeptideGenerator::VariantEnumerator variants(var_mods.begin(), var_mods.end(), seq, max_mods, true);
+    Size count(0);
+    while (variants.next())
+    {
+      TEST_EQUAL(count < modified_peptides.size(), true)
+      if (count >= modified_peptides.size()) break;
+      TEST_REAL_SIMILAR(variants.getMonoWeight(), modified_peptides[count].getMonoWeight())
+      TEST_EQUAL(variants.getSequence(), modified_peptides[count])
+      ++count;
+    }
+    TEST_EQUAL(count, modified_peptides.size())
+  }
+  
+  // all variants have been enumerated
+  ModifiedPeptideGenerator::VariantEnumerator variants(var_mods.begin(), var_mods.end(), seq, 2, false);
+  Size count(0);
+  while (variants.next())
+  {
+    TEST_EQUAL(variants.getNumberOfModifications() >= 1 && variants.getNumberOfModifications() <= 2, true)
+    ++count;
+  }
+  TEST_EQUAL(count, 6 + 15) // 6 sites (N-term, S, M, S, T, M): 6 single, 15 double modified
+  TEST_EQUAL(variants.next(), false)
+  TEST_EQUAL(variants.next(), false) // stays finished
+
+  // no modifiable sites: only the original peptide (if requested)
+  AASequence unmodifiable = AASequence::fromString("PEPAIDEK");
+  ModifiedPeptideGenerator::VariantEnumerator original_only(var_mods.begin() + 1, var_mods.begin() + 3, unmodifiable, 2, true);
+  TEST_EQUAL(original_only.next(), true)
+  TEST_EQUAL(original_only.getNumberOfModifications(), 0)
+  TEST_EQUAL(original_only.getSequence(), unmodifiable)
+  TEST_EQUAL(original_only.next(), false)
+  TEST_EQUAL(original_only.next(), false)
+  ModifiedPeptideGenerator::VariantEnumerator none(var_mods.begin() + 1, var_mods.begin() + 3, unmodifiable, 2, false);
+  TEST_EQUAL(none.next(), false)
+  TEST_EQUAL(none.next(), false)
+}
+END_SECTION
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
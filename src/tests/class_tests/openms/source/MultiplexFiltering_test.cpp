@@ -39,9 +39,19 @@
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFilterResultRaw.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFilterResultPeak.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFiltering.h>
+#include <OpenMS/CHEMISTRY/IsotopeDistribution.h>
+#include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
 using namespace OpenMS;
 
+class MultiplexFilteringTest :
+  public MultiplexFiltering
+{
+public:
+  using MultiplexFiltering::MultiplexFiltering;
+  using MultiplexFiltering::getAveragineSimilarity_;
+};
+
 START_TEST(MultiplexFiltering, "$Id$")
 
 // read data
@@ -103,4 +113,42 @@ START_SECTION(MultiplexFiltering(const PeakMap& exp_picked, const std::vector<Mu
     delete ptr;
 END_SECTION
 
+START_SECTION(double getAveragineSimilarity_(const std::vector<double>& pattern, double m) const)
+{
+  MultiplexFilteringTest filtering(exp_picked, patterns, peaks_per_peptide_min, peaks_per_peptide_max, missing_peaks, intensity_cutoff, mz_tolerance, mz_tolerance_unit, peptide_similarity, averagine_similarity, averagine_similarity_scaling);
+  std::vector<double> pattern;
+  pattern.push_back(1.0);
+  pattern.push_back(0.9);
+  pattern.push_back(0.5);
+  pattern.push_back(0.2);
+  pattern.push_back(0.1);
+  pattern.push_back(0.05);
+
+  // same result as an averagine pattern calculated at the exact mass (inside and outside the precomputed mass range)
+  Size mismatches = 0;
+  for (Size isotopes = 1; isotopes <= pattern.size(); ++isotopes)
+  {
+    std::vector<double> partial_pattern(pattern.begin(), pattern.begin() + isotopes);
+    for (double m = 500.0; m < 12000.0; m += 0.37)
+    {
+      IsotopeDistribution distribution;
+      distribution.setMaxIsotope(isotopes);
+      distribution.estimateFromPeptideWeight(m);
+      std::vector<double> averagine_pattern;
+      for (IsotopeDistribution::Iterator it = distribution.begin(); it != distribution.end(); ++it)
+      {
+        averagine_pattern.push_back(it->second);
+      }
+      double expected = Math::pearsonCorrelationCoefficient(partial_pattern.begin(), partial_pattern.end(), averagine_pattern.begin(), averagine_pattern.end());
+      double similarity = filtering.getAveragineSimilarity_(partial_pattern, m);
+      if (!(similarity == expected) && !(boost::math::isnan(similarity) && boost::math::isnan(expected)))
+      {
+        ++mismatches;
+      }
+    }
+  }
+  TEST_EQUAL(mismatches, 0)
+}
+END_SECTION
+
 END_TEST
@@ -114,6 +114,83 @@ START_SECTION((static Int solve(const Matrix< double > &A, const Matrix< double
 }
 END_SECTION
 
+START_SECTION((static Int solveBatch(const Matrix< double > &A, const Matrix< double > &B, Matrix< double > &X)))
+{
+	double A_2[4][4] = 
+		{
+			{0.9290,    0.0200,         0,         0},
+			{0.0590,    0.9230,    0.0300,    0.0010},
+			{0.0020,    0.0560,    0.9240,    0.0400},
+			{		  0,    0.0010,    0.0450,    0.9240}
+		};
+	// first column needs NNLS iterations, second column is solved by the unconstrained solution
+	double B_2[4][2] = {{5, 10},{45, 20},{4, 30},{31, 40}};
+	double X_2[4][2] = {{4.3395, 10.3336},{48.4364, 20.0063},{0, 29.4216},{33.4945, 41.8355}};
+
+	Matrix<double> A, B, X;
+	A.setMatrix<4,4>(A_2);
+	B.setMatrix<4,2>(B_2);
+
+	TOLERANCE_ABSOLUTE(0.0005);
+
+	TEST_EQUAL(NonNegativeLeastSquaresSolver::solveBatch(A, B, X), NonNegativeLeastSquaresSolver::SOLVED)
+	TEST_EQUAL(X.rows(), 4)
+	TEST_EQUAL(X.cols(), 2)
+	for (size_t i = 0; i < X.rows(); ++i)
+	{
+		TEST_REAL_SIMILAR(X(i, 0), X_2[i][0]);
+		TEST_REAL_SIMILAR(X(i, 1), X_2[i][1]);
+	}
+
+	// each column gives the same result as a single solve
+	Matrix<double> b(4, 1), x;
+	for (size_t col = 0; col < B.cols(); ++col)
+	{
+		for (size_t row = 0; row < B.rows(); ++row) b(row, 0) = B(row, col);
+		NonNegativeLeastSquaresSolver::solve(A, b, x);
+		for (size_t i = 0; i < x.rows(); ++i)
+		{
+			TEST_REAL_SIMILAR(X(i, col), x(i, 0));
+		}
+	}
+
+	// the least squares shortcut agrees with the NNLS iterations of solve() within rounding
+	// (relative difference below 1e-9), here for random isotope-correction-like matrices and non-negative solutions
+	srand(42);
+	Matrix<double> A_rand(6, 6), B_rand(6, 50), X_rand;
+	for (size_t row = 0; row < A_rand.rows(); ++row)
+	{
+		for (size_t col = 0; col < A_rand.cols(); ++col)
+		{
+			A_rand(row, col) = (row == col) ? 0.9 + 0.1 * rand() / RAND_MAX : 0.05 * rand() / RAND_MAX;
+		}
+	}
+	for (size_t col = 0; col < B_rand.cols(); ++col)
+	{
+		for (size_t row = 0; row < B_rand.rows(); ++row)
+		{
+			B_rand(row, col) = 1000.0 * rand() / RAND_MAX;
+		}
+	}
+	TEST_EQUAL(NonNegativeLeastSquaresSolver::solveBatch(A_rand, B_rand, X_rand), NonNegativeLeastSquaresSolver::SOLVED)
+	double max_rel_diff = 0.0;
+	b.resize(6, 1);
+	for (size_t col = 0; col < B_rand.cols(); ++col)
+	{
+		for (size_t row = 0; row < B_rand.rows(); ++row) b(row, 0) = B_rand(row, col);
+		NonNegativeLeastSquaresSolver::solve(A_rand, b, x);
+		for (size_t i = 0; i < x.rows(); ++i)
+		{
+			max_rel_diff = std::max(max_rel_diff, std::fabs(X_rand(i, col) - x(i, 0)) / std::max(std::fabs(x(i, 0)), 1.0));
+		}
+	}
+	TEST_EQUAL(max_rel_diff < 1e-9, true)
+
+	Matrix<double> B_wrong(3, 2);
+	TEST_EXCEPTION(Exception::InvalidParameter, NonNegativeLeastSquaresSolver::solveBatch(A, B_wrong, X))
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
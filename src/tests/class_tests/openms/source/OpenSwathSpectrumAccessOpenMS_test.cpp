@@ -142,6 +142,54 @@ START_SECTION ( OpenSwath::SpectrumPtr getSpectrumById(int id);)
     OpenSwath::SpectrumPtr sptr = spectrum_acc.getSpectrumById(0);
     TEST_REAL_SIMILAR (sptr->getMZArray()->data[0], 20.0);
   }
+
+  {
+    // converted data is kept and shared with light clones
+    PeakMap* new_exp = new PeakMap;
+    MSSpectrum s;
+    Peak1D p;
+    p.setMZ(20.0);
+    p.setIntensity(5.0);
+    s.push_back(p);
+    new_exp->addSpectrum(s);
+    new_exp->addSpectrum(s);
+    boost::shared_ptr< PeakMap > exp (new_exp);
+    SpectrumAccessOpenMS spectrum_acc = SpectrumAccessOpenMS(exp);
+    boost::shared_ptr<OpenSwath::ISpectrumAccess> sa_clone = spectrum_acc.lightClone();
+
+    OpenSwath::SpectrumPtr sptr = spectrum_acc.getSpectrumById(1);
+    TEST_EQUAL(sptr == spectrum_acc.getSpectrumById(1), true)
+    TEST_EQUAL(sptr == sa_clone->getSpectrumById(1), true)
+    TEST_EQUAL(sptr == spectrum_acc.getSpectrumById(0), false)
+    TEST_REAL_SIMILAR (sa_clone->getSpectrumById(0)->getIntensityArray()->data[0], 5.0);
+  }
+
+  {
+    // only MAX_CONVERTED_SCANS spectra are kept, the oldest one is dropped first
+    PeakMap* new_exp = new PeakMap;
+    MSSpectrum s;
+    Peak1D p;
+    p.setMZ(20.0);
+    p.setIntensity(5.0);
+    s.push_back(p);
+    for (Size i = 0; i < SpectrumAccessOpenMS::MAX_CONVERTED_SCANS + 1; ++i)
+    {
+      new_exp->addSpectrum(s);
+    }
+    boost::shared_ptr< PeakMap > exp (new_exp);
+    SpectrumAccessOpenMS spectrum_acc = SpectrumAccessOpenMS(exp);
+
+    OpenSwath::SpectrumPtr first = spectrum_acc.getSpectrumById(0);
+    OpenSwath::SpectrumPtr second = spectrum_acc.getSpectrumById(1);
+    for (Size i = 2; i < SpectrumAccessOpenMS::MAX_CONVERTED_SCANS + 1; ++i)
+    {
+      spectrum_acc.getSpectrumById(i);
+    }
+    TEST_EQUAL(first == spectrum_acc.getSpectrumById(0), false)
+    TEST_REAL_SIMILAR (spectrum_acc.getSpectrumById(0)->getMZArray()->data[0], 20.0);
+    // converting spectrum 0 again dropped spectrum 1
+    TEST_EQUAL(second == spectrum_acc.getSpectrumById(1), false)
+  }
 }
 END_SECTION
 
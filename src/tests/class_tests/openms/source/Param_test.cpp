@@ -1109,6 +1109,45 @@ START_SECTION((bool operator == (const Param& rhs) const))
 
 END_SECTION
 
+START_SECTION([EXTRA] key lookups stay consistent when the tree changes)
+	Param p1;
+	p1.setValue("a:x", 1);
+	p1.setValue("a:y", 2);
+	p1.setValue("b:z", 3);
+	TEST_EQUAL(p1.getValue("a:y"), 2) // builds the key index
+
+	// copies share the index until they change
+	Param p2(p1);
+	p2.setValue("a:w", 4);
+	TEST_EQUAL(p2.getValue("a:w"), 4)
+	TEST_EQUAL(p2.getValue("b:z"), 3)
+	TEST_EQUAL(p1.exists("a:w"), false)
+
+	// removal shifts the remaining entries
+	p2.remove("a:x");
+	TEST_EQUAL(p2.exists("a:x"), false)
+	TEST_EQUAL(p2.getValue("a:y"), 2)
+	TEST_EQUAL(p2.getValue("a:w"), 4)
+	p2.removeAll("a:");
+	TEST_EQUAL(p2.exists("a:y"), false)
+	TEST_EQUAL(p2.getValue("b:z"), 3)
+	TEST_EQUAL(p1.getValue("a:x"), 1)
+
+	// many insertions interleaved with lookups
+	for (Size i = 0; i < 200; ++i)
+	{
+		p2.setValue(String("c:") + i, (Int)i);
+		TEST_EQUAL(p2.getValue(String("c:") + i / 2), (Int)(i / 2))
+	}
+	p2 = p1;
+	TEST_EQUAL(p2.exists("c:1"), false)
+	TEST_EQUAL(p2.getValue("a:x"), 1)
+	p2.clear();
+	TEST_EQUAL(p2.exists("a:x"), false)
+	TEST_EQUAL(p2.exists("a:"), false)
+	TEST_EQUAL(p2.exists("a"), false)
+END_SECTION
+
 START_SECTION((void setDefaults(const Param& defaults, const String& prefix="", bool showMessage=false)))
 	Param defaults;
 	defaults.setValue("float",1.0f,"float");
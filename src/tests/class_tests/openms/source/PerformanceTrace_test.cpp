@@ -0,0 +1,174 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/SYSTEM/PerformanceTrace.h>
+
+#include <sstream>
+
+///////////////////////////
+
+using namespace OpenMS;
+
+START_TEST(PerformanceTrace, "$Id$")
+
+START_SECTION((static bool isEnabled()))
+{
+  TEST_EQUAL(PerformanceTrace::isEnabled(), false)
+  // disabled: annotations do not record anything
+  {
+    OPENMS_TRACE_SCOPE("disabled");
+    OPENMS_TRACE_COUNTER("disabled counter", 1);
+  }
+  TEST_EQUAL(PerformanceTrace::getEvents().size(), 0)
+}
+END_SECTION
+
+START_SECTION((static void setEnabled(bool enabled)))
+{
+  PerformanceTrace::setEnabled(true);
+  TEST_EQUAL(PerformanceTrace::isEnabled(), true)
+  {
+    OPENMS_TRACE_SCOPE("outer");
+    {
+      OPENMS_TRACE_SCOPE("inner");
+    }
+    OPENMS_TRACE_COUNTER("items", 42);
+  }
+  PerformanceTrace::setEnabled(false);
+  TEST_EQUAL(PerformanceTrace::isEnabled(), false)
+
+  std::vector<PerformanceTrace::Event> events = PerformanceTrace::getEvents();
+  ABORT_IF(events.size() != 3)
+  // scopes are recorded when they end
+  TEST_STRING_EQUAL(events[0].name, "inner")
+  TEST_EQUAL(events[0].type, PerformanceTrace::Event::SCOPE)
+  TEST_EQUAL(events[1].type, PerformanceTrace::Event::COUNTER)
+  TEST_REAL_SIMILAR(events[1].value, 42.0)
+  TEST_STRING_EQUAL(events[2].name, "outer")
+  TEST_EQUAL(events[2].start <= events[0].start, true)
+  TEST_EQUAL(events[2].start + events[2].duration >= events[0].start + events[0].duration, true)
+  TEST_EQUAL(events[1].memory, 0)
+}
+END_SECTION
+
+START_SECTION((static void write(std::ostream& os)))
+{
+  std::stringstream ss;
+  PerformanceTrace::write(ss);
+  String json = ss.str();
+  TEST_EQUAL(json.hasPrefix("{\"traceEvents\":["), true)
+  TEST_EQUAL(json.hasSubstring("\"name\":\"inner\""), true)
+  TEST_EQUAL(json.hasSubstring("\"ph\":\"X\""), true)
+  TEST_EQUAL(json.hasSubstring("\"name\":\"items\""), true)
+  TEST_EQUAL(json.hasSubstring("peak_memory_kb"), true)
+}
+END_SECTION
+
+START_SECTION((static void store(const String& filename)))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  PerformanceTrace::store(filename);
+  TEST_EXCEPTION(Exception::UnableToCreateFile, PerformanceTrace::store("/does/not/exist/trace.json"))
+}
+END_SECTION
+
+START_SECTION((static void clear()))
+{
+  PerformanceTrace::clear();
+  TEST_EQUAL(PerformanceTrace::getEvents().size(), 0)
+}
+END_SECTION
+
+START_SECTION((static void addScope(const String& name, const String& category, double start, double duration, bool sample_memory = false)))
+{
+  PerformanceTrace::clear();
+  PerformanceTrace::setEnabled(true);
+  {
+    OPENMS_TRACE_SCOPE("level 0");
+    {
+      OPENMS_TRACE_SCOPE("level 1");
+      {
+        OPENMS_TRACE_SCOPE("level 2");
+      }
+    }
+#ifdef _OPENMP
+#pragma omp parallel num_threads(2)
+#endif
+    {
+      OPENMS_TRACE_SCOPE("parallel");
+    }
+  }
+  PerformanceTrace::addScope("explicit", "OpenMS", 0.0, 1.0);
+  PerformanceTrace::setEnabled(false);
+
+  // the memory usage is only sampled at the end of top-level phases (if it is known on this platform)
+  std::vector<PerformanceTrace::Event> events = PerformanceTrace::getEvents();
+  Size unsampled = 0;
+  for (Size i = 0; i < events.size(); ++i)
+  {
+    if ((events[i].name == "level 2") || (events[i].name == "parallel") || (events[i].name == "explicit"))
+    {
+      TEST_EQUAL(events[i].memory, 0)
+      ++unsampled;
+    }
+  }
+  TEST_EQUAL(unsampled >= 3, true)
+
+  // the nesting depth was restored: a new outermost scope is a top-level phase again
+  PerformanceTrace::clear();
+  PerformanceTrace::setEnabled(true);
+  {
+    OPENMS_TRACE_SCOPE("outer");
+    {
+      OPENMS_TRACE_SCOPE("inner");
+    }
+  }
+  PerformanceTrace::setEnabled(false);
+  events = PerformanceTrace::getEvents();
+  PerformanceTrace::clear();
+  ABORT_IF(events.size() != 2)
+#ifdef __linux__
+  TEST_EQUAL(events[0].memory > 0, true)
+  TEST_EQUAL(events[1].memory > 0, true)
+#endif
+}
+END_SECTION
+
+END_TEST
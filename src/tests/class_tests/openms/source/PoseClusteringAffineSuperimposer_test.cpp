@@ -69,6 +69,42 @@ START_SECTION((virtual ~PoseClusteringAffineSuperimposer()))
 }
 END_SECTION
 
+START_SECTION((static void selectPoints(std::vector<Peak2D>& map, const Size num_used_points, const bool stratified)))
+{
+  std::vector<Peak2D> map;
+  for (Size i = 0; i < 10; ++i)
+  {
+    Peak2D p;
+    p.setRT(double(i));
+    p.setIntensity(double((i * 7) % 10 + 1)); // intensities 1-10 in shuffled order
+    map.push_back(p);
+  }
+
+  // too few elements: nothing is removed
+  std::vector<Peak2D> selected(map);
+  PoseClusteringAffineSuperimposer::selectPoints(selected, 10, true);
+  TEST_EQUAL(selected.size(), 10)
+
+  // top-N by intensity
+  selected = map;
+  PoseClusteringAffineSuperimposer::selectPoints(selected, 3, false);
+  TEST_EQUAL(selected.size(), 3)
+  std::sort(selected.begin(), selected.end(), Peak2D::IntensityLess());
+  TEST_REAL_SIMILAR(selected[0].getIntensity(), 8.0)
+  TEST_REAL_SIMILAR(selected[1].getIntensity(), 9.0)
+  TEST_REAL_SIMILAR(selected[2].getIntensity(), 10.0)
+
+  // spread over intensity ranks (every 10/3-th element, starting with the most abundant)
+  selected = map;
+  PoseClusteringAffineSuperimposer::selectPoints(selected, 3, true);
+  TEST_EQUAL(selected.size(), 3)
+  std::sort(selected.begin(), selected.end(), Peak2D::IntensityLess());
+  TEST_REAL_SIMILAR(selected[0].getIntensity(), 4.0)
+  TEST_REAL_SIMILAR(selected[1].getIntensity(), 7.0)
+  TEST_REAL_SIMILAR(selected[2].getIntensity(), 10.0)
+}
+END_SECTION
+
 START_SECTION((static BaseSuperimposer* create()))
 {
   BaseSuperimposer* base_ptr = nullptr;
@@ -234,6 +270,40 @@ START_SECTION(([EXTRA]virtual void run(const std::vector<Peak2D> & map_model, co
   TEST_EQUAL(parameters.size(), 2)
   TEST_REAL_SIMILAR(parameters.getValue("slope"), 1.0)
   TEST_REAL_SIMILAR(parameters.getValue("intercept"), -0.4)
+
+  // intensity-stratified selection on maps larger than 'num_used_points'
+  {
+    std::vector<Peak2D> large_model, large_scene;
+    for (Size i = 0; i < 20; ++i)
+    {
+      Peak2D p;
+      p.setRT(1.0 + i);
+      p.setMZ(100.0 + 10.0 * i);
+      p.setIntensity(100.0 * (i + 1));
+      large_model.push_back(p);
+      p.setRT(1.4 + i);
+      p.setMZ(100.02 + 10.0 * i);
+      large_scene.push_back(p);
+    }
+
+    Param parameters;
+    parameters.setValue(String("scaling_bucket_size"), 0.01);
+    parameters.setValue(String("shift_bucket_size"), 0.1);
+    parameters.setValue(String("num_used_points"), 5);
+    parameters.setValue(String("point_selection"), "intensity_stratified");
+
+    TransformationDescription transformation;
+    PoseClusteringAffineSuperimposer pcat;
+    pcat.setParameters(parameters);
+
+    pcat.run(large_model, large_scene, transformation);
+
+    TEST_STRING_EQUAL(transformation.getModelType(), "linear")
+    parameters = transformation.getModelParameters();
+    TEST_EQUAL(parameters.size(), 2)
+    TEST_REAL_SIMILAR(parameters.getValue("slope"), 1.0)
+    TEST_REAL_SIMILAR(parameters.getValue("intercept"), -0.4)
+  }
 }
 END_SECTION
 
@@ -0,0 +1,150 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/RNaseDigestion.h>
+///////////////////////////
+
+#include <vector>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(RNaseDigestion, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+RNaseDigestion* ptr = nullptr;
+RNaseDigestion* null_ptr = nullptr;
+START_SECTION(([EXTRA] RNaseDigestion()))
+{
+  ptr = new RNaseDigestion();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] ~RNaseDigestion()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void setEnzyme(const String& name)))
+{
+  RNaseDigestion rd;
+  rd.setEnzyme("RNase_T1");
+  TEST_EQUAL(rd.getEnzymeName(), "RNase_T1")
+
+  // only RNases are known
+  TEST_EXCEPTION(Exception::ElementNotFound, rd.setEnzyme("Trypsin"))
+  TEST_EXCEPTION(Exception::ElementNotFound, rd.setEnzyme("no such enzyme"))
+}
+END_SECTION
+
+START_SECTION((void digest(const String& rna, std::vector<String>& output, Size min_length, Size max_length) const))
+{
+  RNaseDigestion rd;
+  vector<String> out;
+
+  // RNase T1 cleaves after G and adds a 3' phosphate to the cleavage products
+  // (the sequence contains no K/R, so the trypsin rule would not cleave at all)
+  rd.setEnzyme("RNase_T1");
+  rd.digest("AUGCGUAG", out, 1, 100);
+  TEST_EQUAL(out.size(), 3)
+  ABORT_IF(out.size() != 3)
+  TEST_EQUAL(out[0], "AUGp")
+  TEST_EQUAL(out[1], "CGp")
+  TEST_EQUAL(out[2], "UAG")
+
+  // terminal phosphates of the original RNA are kept, but do not count as cleavage sites
+  rd.digest("pAUGCGUAGp", out, 1, 100);
+  TEST_EQUAL(out.size(), 3)
+  ABORT_IF(out.size() != 3)
+  TEST_EQUAL(out[0], "pAUGp")
+  TEST_EQUAL(out[1], "CGp")
+  TEST_EQUAL(out[2], "UAGp")
+
+  // a G at the 3' end is not a cleavage site
+  rd.digest("AUG", out, 1, 100);
+  TEST_EQUAL(out.size(), 1)
+  ABORT_IF(out.size() != 1)
+  TEST_EQUAL(out[0], "AUG")
+
+  // missed cleavages
+  rd.setMissedCleavages(1);
+  rd.digest("AUGCGUAG", out, 1, 100);
+  TEST_EQUAL(out.size(), 5)
+  ABORT_IF(out.size() != 5)
+  TEST_EQUAL(out[0], "AUGp")
+  TEST_EQUAL(out[1], "CGp")
+  TEST_EQUAL(out[2], "UAG")
+  TEST_EQUAL(out[3], "AUGCGp")
+  TEST_EQUAL(out[4], "CGUAG")
+
+  // length filter (phosphates do not count)
+  rd.digest("AUGCGUAG", out, 4, 100);
+  TEST_EQUAL(out.size(), 2)
+  ABORT_IF(out.size() != 2)
+  TEST_EQUAL(out[0], "AUGCGp")
+  TEST_EQUAL(out[1], "CGUAG")
+  rd.digest("AUGCGUAG", out, 1, 2);
+  TEST_EQUAL(out.size(), 1)
+  ABORT_IF(out.size() != 1)
+  TEST_EQUAL(out[0], "CGp")
+
+  // unspecific cleavage: every position
+  rd.setMissedCleavages(0);
+  rd.setEnzyme("unspecific cleavage");
+  rd.digest("AUG", out, 1, 100);
+  TEST_EQUAL(out.size(), 3)
+  ABORT_IF(out.size() != 3)
+  TEST_EQUAL(out[0], "A")
+  TEST_EQUAL(out[1], "U")
+  TEST_EQUAL(out[2], "G")
+
+  // empty input
+  rd.digest("", out, 1, 100);
+  TEST_EQUAL(out.empty(), true)
+  rd.digest("p", out, 1, 100);
+  TEST_EQUAL(out.empty(), true)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -39,6 +39,7 @@
 ///////////////////////////
 
 #include <OpenMS/CHEMISTRY/ResidueDB.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <OpenMS/CHEMISTRY/Residue.h>
 
 using namespace OpenMS;
@@ -178,6 +179,19 @@ START_SECTION(Size getNumberOfModifiedResidues() const)
 	TEST_EQUAL(ptr->getNumberOfModifiedResidues(), 2)
 END_SECTION
 
+START_SECTION(void registerModifications(const std::vector<String>& modifications))
+	Size before = ptr->getNumberOfModifiedResidues();
+	ptr->registerModifications(ListUtils::create<String>("Carbamidomethyl (C),Phospho (S),Phospho (T)"));
+	TEST_EQUAL(ptr->getNumberOfModifiedResidues(), before + 2)
+	// registered residues are returned without creating new ones
+	const Residue* phospho_s = ptr->getModifiedResidue(ptr->getResidue('S'), "Phospho (S)");
+	TEST_EQUAL(phospho_s->getOneLetterCode(), "S")
+	TEST_EQUAL(phospho_s->getModificationName(), "Phospho")
+	TEST_EQUAL(ptr->getModifiedResidue(ptr->getResidue('S'), "Phospho"), phospho_s)
+	TEST_EQUAL(ptr->getNumberOfModifiedResidues(), before + 2)
+	TEST_EXCEPTION(Exception::ElementNotFound, ptr->registerModifications(ListUtils::create<String>("NoSuchModification")))
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -132,6 +132,33 @@ START_SECTION(OpenSwath::SpectrumPtr getSpectrumById(int id))
     TEST_REAL_SIMILAR(spec1->getMZArray()->data[1], 10 + 500*5 + 500*500* 2)
   }
 
+  {
+    // the underlying access hands out the same (cached) spectrum on every
+    // call, the correction must be applied to a copy only once per call
+    boost::shared_ptr<PeakMap > exp2 = getData();
+    OpenSwath::SpectrumAccessPtr expptr2 = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp2);
+    boost::shared_ptr<SpectrumAccessQuadMZTransforming> ptr2(new SpectrumAccessQuadMZTransforming(expptr2, 10, 5, 2, false));
+    OpenSwath::SpectrumPtr spec1 = ptr2->getSpectrumById(0);
+    OpenSwath::SpectrumPtr spec2 = ptr2->getSpectrumById(0);
+    TEST_REAL_SIMILAR(spec1->getMZArray()->data[0], 10 + 100*5 + 100*100* 2)
+    TEST_REAL_SIMILAR(spec2->getMZArray()->data[0], 10 + 100*5 + 100*100* 2)
+    TEST_REAL_SIMILAR(spec2->getMZArray()->data[1], 10 + 500*5 + 500*500* 2)
+    TEST_REAL_SIMILAR(spec2->getIntensityArray()->data[1], 150)
+
+    // the original data is unchanged
+    OpenSwath::SpectrumPtr orig = expptr2->getSpectrumById(0);
+    TEST_REAL_SIMILAR(orig->getMZArray()->data[0], 100)
+    TEST_REAL_SIMILAR(orig->getMZArray()->data[1], 500)
+
+    // same for the ppm variant (10 ppm)
+    boost::shared_ptr<SpectrumAccessQuadMZTransforming> ptr3(new SpectrumAccessQuadMZTransforming(expptr2, 10, 0, 0, true));
+    ptr3->getSpectrumById(0);
+    OpenSwath::SpectrumPtr spec3 = ptr3->getSpectrumById(0);
+    TEST_REAL_SIMILAR(spec3->getMZArray()->data[0], 100 - 10 * 100 / 1e6)
+    TEST_REAL_SIMILAR(spec3->getMZArray()->data[1], 500 - 10 * 500 / 1e6)
+    TEST_REAL_SIMILAR(expptr2->getSpectrumById(0)->getMZArray()->data[1], 500)
+  }
+
 }
 END_SECTION
 
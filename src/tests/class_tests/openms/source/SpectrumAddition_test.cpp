@@ -48,7 +48,7 @@ START_TEST(SpectrumAddition, "$Id$")
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 
-START_SECTION((static OpenSwath::SpectrumPtr addUpSpectra(std::vector< OpenSwath::SpectrumPtr > all_spectra, double sampling_rate, double filter_zeros)) )
+START_SECTION((static OpenSwath::SpectrumPtr addUpSpectra(const std::vector< OpenSwath::SpectrumPtr >& all_spectra, double sampling_rate, bool filter_zeros)) )
 {
   OpenSwath::SpectrumPtr spec1(new OpenSwath::Spectrum());
   OpenSwath::BinaryDataArrayPtr mass1(new OpenSwath::BinaryDataArray);
@@ -127,7 +127,7 @@ START_SECTION((static OpenSwath::SpectrumPtr addUpSpectra(std::vector< OpenSwath
 }
 END_SECTION
 
-START_SECTION((static OpenMS::MSSpectrum addUpSpectra(std::vector< OpenMS::Spectrum<> all_spectra, double sampling_rate, bool filter_zeros) ))
+START_SECTION((static OpenMS::MSSpectrum addUpSpectra(const std::vector< OpenMS::MSSpectrum >& all_spectra, double sampling_rate, bool filter_zeros) ))
 {
   // Intensity
   static const double arr1[] = {
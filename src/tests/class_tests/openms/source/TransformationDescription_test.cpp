@@ -143,6 +143,41 @@ START_SECTION((double apply(double value) const))
 }
 END_SECTION
 
+START_SECTION((void apply(std::vector<double>& values) const))
+{
+	vector<double> values;
+	values.push_back(-0.5);
+	values.push_back(0.1);
+	values.push_back(0.25);
+	values.push_back(0.7);
+	values.push_back(0.3); // not ascending
+	values.push_back(1.0);
+	values.push_back(1.5);
+
+	TransformationDescription td(data_nonlinear);
+	Param params;
+	StringList models = ListUtils::create<String>("none,linear,b_spline,interpolated,lowess");
+	for (Size m = 0; m < models.size(); ++m)
+	{
+		td.fitModel(models[m], params);
+		vector<double> result(values);
+		td.apply(result);
+		for (Size i = 0; i < values.size(); ++i)
+		{
+			TEST_EQUAL(result[i], td.apply(values[i]));
+		}
+	}
+	params.setValue("interpolation_type", "cspline");
+	td.fitModel("interpolated", params);
+	vector<double> result(values);
+	td.apply(result);
+	for (Size i = 0; i < values.size(); ++i)
+	{
+		TEST_EQUAL(result[i], td.apply(values[i]));
+	}
+}
+END_SECTION
+
 START_SECTION((const String& getModelType() const))
 {
 	TransformationDescription td;
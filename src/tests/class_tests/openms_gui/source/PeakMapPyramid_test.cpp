@@ -0,0 +1,287 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+
+///////////////////////////
+
+#include <OpenMS/VISUAL/PeakMapPyramid.h>
+
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+// four MS1 scans (RT 0, 10, 20, 30) with peaks between m/z 100 and 500 and one MS2 scan
+boost::shared_ptr<PeakMap> getData()
+{
+  boost::shared_ptr<PeakMap> map(new PeakMap);
+  const double rts[] = {0.0, 10.0, 20.0, 30.0};
+  for (Size i = 0; i < 4; ++i)
+  {
+    MSSpectrum spec;
+    spec.setRT(rts[i]);
+    spec.setMSLevel(1);
+    map->addSpectrum(spec);
+  }
+  Peak1D p;
+  p.setMZ(100.0); p.setIntensity(1.0f); (*map)[0].push_back(p);
+  p.setMZ(500.0); p.setIntensity(2.0f); (*map)[0].push_back(p);
+  p.setMZ(150.0); p.setIntensity(3.0f); (*map)[1].push_back(p);
+  p.setMZ(160.0); p.setIntensity(4.0f); (*map)[1].push_back(p);
+  p.setMZ(350.0); p.setIntensity(5.0f); (*map)[2].push_back(p);
+  p.setMZ(500.0); p.setIntensity(6.0f); (*map)[3].push_back(p);
+
+  // ignored
+  MSSpectrum ms2;
+  ms2.setRT(15.0);
+  ms2.setMSLevel(2);
+  p.setMZ(300.0); p.setIntensity(100.0f); ms2.push_back(p);
+  map->addSpectrum(ms2);
+  map->sortSpectra(false);
+
+  map->updateRanges();
+  return map;
+}
+
+// three MS1 scans (RT 0, 15, 30) - not a power of two, so coarser levels extend beyond the data range
+boost::shared_ptr<PeakMap> getOddData()
+{
+  boost::shared_ptr<PeakMap> map(new PeakMap);
+  const double rts[] = {0.0, 15.0, 30.0};
+  const double mzs[] = {100.0, 300.0, 500.0};
+  for (Size i = 0; i < 3; ++i)
+  {
+    MSSpectrum spec;
+    spec.setRT(rts[i]);
+    spec.setMSLevel(1);
+    Peak1D p;
+    p.setMZ(mzs[i]);
+    p.setIntensity(float(i + 1));
+    spec.push_back(p);
+    map->addSpectrum(spec);
+  }
+  map->updateRanges();
+  return map;
+}
+
+START_TEST(PeakMapPyramid, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+boost::shared_ptr<PeakMap> map = getData();
+
+PeakMapPyramid* ptr = nullptr;
+PeakMapPyramid* null_ptr = nullptr;
+START_SECTION((PeakMapPyramid(const boost::shared_ptr<PeakMap>& map, Size max_bins = 2048, QObject* parent = 0)))
+{
+  ptr = new PeakMapPyramid(map, 4);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->isReady(), false)
+  TEST_EQUAL(ptr->getLevelCount(), 0)
+  TEST_EQUAL(ptr->isValidFor(*map), false)
+  TEST_EQUAL(ptr->selectLevel(1000.0, 1000.0), -1)
+  TEST_EXCEPTION(Exception::IndexOverflow, ptr->getLevel(0))
+}
+END_SECTION
+
+START_SECTION((~PeakMapPyramid()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void build()))
+{
+  PeakMapPyramid pyramid(map, 4);
+  pyramid.build();
+  TEST_EQUAL(pyramid.isReady(), true)
+  TEST_REAL_SIMILAR(pyramid.getMinRT(), 0.0)
+  TEST_REAL_SIMILAR(pyramid.getMinMZ(), 100.0)
+
+  // 4x4 -> 2x2 -> 1x1
+  ABORT_IF(pyramid.getLevelCount() != 3)
+
+  // level 0: RT tiles of 7.5 s, m/z tiles of 100 Th (the last tile includes the upper boundary)
+  const PeakMapPyramid::Level& l0 = pyramid.getLevel(0);
+  TEST_EQUAL(l0.rt_bins, 4)
+  TEST_EQUAL(l0.mz_bins, 4)
+  TEST_EQUAL(l0.max_intensity.size(), 16)
+  TEST_EQUAL(l0.sum_intensity.size(), 16)
+  TEST_REAL_SIMILAR(l0.max_intensity[0 * 4 + 0], 1.0)
+  TEST_REAL_SIMILAR(l0.max_intensity[0 * 4 + 3], 2.0)
+  TEST_REAL_SIMILAR(l0.max_intensity[1 * 4 + 0], 4.0)
+  TEST_REAL_SIMILAR(l0.sum_intensity[1 * 4 + 0], 7.0)
+  TEST_REAL_SIMILAR(l0.max_intensity[2 * 4 + 2], 5.0)
+  TEST_REAL_SIMILAR(l0.max_intensity[3 * 4 + 3], 6.0)
+  // empty tile (the MS2 peak at RT 15, m/z 300 is not counted)
+  TEST_REAL_SIMILAR(l0.max_intensity[1 * 4 + 2], -1.0)
+  TEST_REAL_SIMILAR(l0.sum_intensity[1 * 4 + 2], 0.0)
+
+  const PeakMapPyramid::Level& l1 = pyramid.getLevel(1);
+  TEST_EQUAL(l1.rt_bins, 2)
+  TEST_EQUAL(l1.mz_bins, 2)
+  TEST_REAL_SIMILAR(l1.max_intensity[0], 4.0)
+  TEST_REAL_SIMILAR(l1.sum_intensity[0], 8.0)
+  TEST_REAL_SIMILAR(l1.max_intensity[1], 2.0)
+  TEST_REAL_SIMILAR(l1.sum_intensity[1], 2.0)
+  TEST_REAL_SIMILAR(l1.max_intensity[2], -1.0)
+  TEST_REAL_SIMILAR(l1.sum_intensity[2], 0.0)
+  TEST_REAL_SIMILAR(l1.max_intensity[3], 6.0)
+  TEST_REAL_SIMILAR(l1.sum_intensity[3], 11.0)
+
+  const PeakMapPyramid::Level& l2 = pyramid.getLevel(2);
+  TEST_EQUAL(l2.rt_bins, 1)
+  TEST_EQUAL(l2.mz_bins, 1)
+  TEST_REAL_SIMILAR(l2.max_intensity[0], 6.0)
+  TEST_REAL_SIMILAR(l2.sum_intensity[0], 21.0)
+
+  TEST_EXCEPTION(Exception::IndexOverflow, pyramid.getLevel(3))
+
+  // the number of RT tiles is limited by the number of MS1 scans
+  PeakMapPyramid pyramid2(map, 16);
+  pyramid2.build();
+  TEST_EQUAL(pyramid2.getLevel(0).rt_bins, 4)
+  TEST_EQUAL(pyramid2.getLevel(0).mz_bins, 16)
+  TEST_EQUAL(pyramid2.getLevelCount(), 5)
+
+  // nothing to summarize
+  boost::shared_ptr<PeakMap> empty(new PeakMap);
+  PeakMapPyramid pyramid3(empty, 4);
+  pyramid3.build();
+  TEST_EQUAL(pyramid3.isReady(), false)
+  TEST_EQUAL(pyramid3.getLevelCount(), 0)
+}
+END_SECTION
+
+START_SECTION((double getTileRT(Size level) const))
+{
+  PeakMapPyramid pyramid(map, 4);
+  pyramid.build();
+  TEST_REAL_SIMILAR(pyramid.getTileRT(0), 7.5)
+  TEST_REAL_SIMILAR(pyramid.getTileRT(1), 15.0)
+  TEST_REAL_SIMILAR(pyramid.getTileRT(2), 30.0)
+}
+END_SECTION
+
+START_SECTION((double getTileMZ(Size level) const))
+{
+  PeakMapPyramid pyramid(map, 4);
+  pyramid.build();
+  TEST_REAL_SIMILAR(pyramid.getTileMZ(0), 100.0)
+  TEST_REAL_SIMILAR(pyramid.getTileMZ(1), 200.0)
+  TEST_REAL_SIMILAR(pyramid.getTileMZ(2), 400.0)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] tile sizes for a number of scans that is not a power of two))
+{
+  boost::shared_ptr<PeakMap> odd = getOddData();
+  PeakMapPyramid pyramid(odd, 8);
+  pyramid.build();
+
+  // RT: 3 -> 2 -> 1 -> 1 tiles, m/z: 8 -> 4 -> 2 -> 1 tiles
+  ABORT_IF(pyramid.getLevelCount() != 4)
+  const Size rt_bins[] = {3, 2, 1, 1};
+  const double tile_rt[] = {10.0, 20.0, 40.0, 40.0};
+  const double tile_mz[] = {50.0, 100.0, 200.0, 400.0};
+  for (Size i = 0; i < 4; ++i)
+  {
+    TEST_EQUAL(pyramid.getLevel(i).rt_bins, rt_bins[i])
+    TEST_REAL_SIMILAR(pyramid.getTileRT(i), tile_rt[i])
+    TEST_REAL_SIMILAR(pyramid.getTileMZ(i), tile_mz[i])
+  }
+
+  // every peak lies in the tile given by the tile sizes (as used for painting)
+  for (Size i = 0; i < pyramid.getLevelCount(); ++i)
+  {
+    const PeakMapPyramid::Level& level = pyramid.getLevel(i);
+    for (Size s = 0; s < odd->size(); ++s)
+    {
+      const Peak1D& p = (*odd)[s][0];
+      Size rt_tile = std::min(Size(((*odd)[s].getRT() - pyramid.getMinRT()) / pyramid.getTileRT(i)), level.rt_bins - 1);
+      Size mz_tile = std::min(Size((p.getMZ() - pyramid.getMinMZ()) / pyramid.getTileMZ(i)), level.mz_bins - 1);
+      TEST_EQUAL(level.max_intensity[rt_tile * level.mz_bins + mz_tile] >= p.getIntensity(), true)
+    }
+  }
+
+  // the coarser levels are not chosen before their tiles fit into a pixel
+  TEST_EQUAL(pyramid.selectLevel(15.0, 60.0), 0)
+  TEST_EQUAL(pyramid.selectLevel(30.0, 150.0), 1)
+  TEST_EQUAL(pyramid.selectLevel(40.0, 400.0), 3)
+}
+END_SECTION
+
+START_SECTION((Int selectLevel(double rt_per_pixel, double mz_per_pixel) const))
+{
+  PeakMapPyramid pyramid(map, 4);
+  pyramid.build();
+  TEST_EQUAL(pyramid.selectLevel(1.0, 1.0), -1)
+  TEST_EQUAL(pyramid.selectLevel(10.0, 1.0), -1)
+  TEST_EQUAL(pyramid.selectLevel(10.0, 150.0), 0)
+  TEST_EQUAL(pyramid.selectLevel(20.0, 150.0), 0)
+  TEST_EQUAL(pyramid.selectLevel(20.0, 250.0), 1)
+  TEST_EQUAL(pyramid.selectLevel(100.0, 1000.0), 2)
+}
+END_SECTION
+
+START_SECTION((bool isValidFor(const PeakMap& map) const))
+{
+  boost::shared_ptr<PeakMap> map2 = getData();
+  PeakMapPyramid pyramid(map2, 4);
+  pyramid.build();
+  TEST_EQUAL(pyramid.isValidFor(*map2), true)
+
+  // same content, different object
+  TEST_EQUAL(pyramid.isValidFor(*map), false)
+
+  // peaks were added
+  Peak1D p;
+  p.setMZ(200.0);
+  p.setIntensity(1.0f);
+  (*map2)[1].push_back(p);
+  map2->updateRanges();
+  TEST_EQUAL(pyramid.isValidFor(*map2), false)
+
+  // rebuilding makes it valid again
+  pyramid.build();
+  TEST_EQUAL(pyramid.isValidFor(*map2), true)
+  TEST_REAL_SIMILAR(pyramid.getLevel(0).sum_intensity[1 * 4 + 1], 1.0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
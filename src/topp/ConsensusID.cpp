@@ -49,6 +49,14 @@
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/FORMAT/FileTypes.h>
 
+#include <boost/shared_ptr.hpp>
+
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -118,6 +126,10 @@ using namespace std;
     @li @p min_support: This allows filtering of peptide hits based on agreement between search engines. Every peptide sequence in the analysis has been identified by at least one search run. This parameter defines which fraction (between 0 and 1) of the remaining search runs must "support" a peptide identification that should be kept. The meaning of "support" differs slightly between algorithms: For @p best, @p worst, @p average and @p rank, each search run supports peptides that it has also identified among its top @p considered_hits candidates. So @p min_support simply gives the fraction of additional search engines that must have identified a peptide. (For example, if there are three search runs, and only peptides identified by at least two of them should be kept, set @p min_support to 0.5.) For the similarity-based algorithms @p PEPMatrix and @p PEPIons, the "support" for a peptide is the average similarity of the most-similar peptide from each (other) search run. (In the context of the JPR publication, this is the average of the similarity scores used in the consensus score calculation for a peptide.)
     @li @p count_empty: Typically not all search engines will provide results for all searched MS2 spectra. This parameter determines whether search runs that provided no results should be counted in the "support" calculation; by default, they are ignored.
 
+    <B>Parallelization:</B>
+
+    The consensus for different spectra/features is computed in parallel if more than one thread is used (parameter @p threads). Every thread uses its own instance of the consensus algorithm (including caches of peptide similarities for @p PEPMatrix and @p PEPIons).
+
     <B>The command line parameters of this tool are:</B>
     @verbinclude TOPP_ConsensusID.cli
     <B>INI file documentation of this tool:</B>
@@ -141,6 +153,8 @@ protected:
 
   String algorithm_; // algorithm for consensus calculation (input parameter)
 
+  Param algo_params_; // parameters for consensus calculation
+
   void registerOptionsAndFlags_() override
   {
     registerInputFile_("in", "<file>", "", "input file");
@@ -231,9 +245,84 @@ protected:
   }
 
 
+  /// Creates an instance of the selected consensus algorithm
+  ConsensusIDAlgorithm* createAlgorithm_() const
+  {
+    ConsensusIDAlgorithm* consensus;
+    if (algorithm_ == "PEPMatrix")
+    {
+      consensus = new ConsensusIDAlgorithmPEPMatrix();
+    }
+    else if (algorithm_ == "PEPIons")
+    {
+      consensus = new ConsensusIDAlgorithmPEPIons();
+    }
+    else if (algorithm_ == "best")
+    {
+      consensus = new ConsensusIDAlgorithmBest();
+    }
+    else if (algorithm_ == "worst")
+    {
+      consensus = new ConsensusIDAlgorithmWorst();
+    }
+    else if (algorithm_ == "average")
+    {
+      consensus = new ConsensusIDAlgorithmAverage();
+    }
+    else // algorithm_ == "ranks"
+    {
+      consensus = new ConsensusIDAlgorithmRanks();
+    }
+    consensus->setParameters(algo_params_);
+    return consensus;
+  }
+
+
+  /// Computes the consensus for each group of IDs (in parallel, with one algorithm instance per thread)
+  void computeConsensus_(const vector<vector<PeptideIdentification>*>& groups,
+                         const vector<Size>& number_of_runs)
+  {
+    Size n_threads = 1;
+#ifdef _OPENMP
+    n_threads = omp_get_max_threads();
+#endif
+    // algorithms store intermediate results and caches, so they can't be shared between threads:
+    vector<boost::shared_ptr<ConsensusIDAlgorithm> > algorithms;
+    for (Size i = 0; i < n_threads; ++i)
+    {
+      algorithms.push_back(boost::shared_ptr<ConsensusIDAlgorithm>(createAlgorithm_()));
+    }
+
+    // exceptions must not leave the parallel region, so we rethrow the first one afterwards:
+    std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)groups.size(); ++i)
+    {
+      Size thread = 0;
+#ifdef _OPENMP
+      thread = omp_get_thread_num();
+#endif
+      try
+      {
+        algorithms[thread]->apply(*groups[i], number_of_runs[i]);
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (ConsensusID_error)
+#endif
+        if (!error) error = std::current_exception();
+      }
+    }
+
+    if (error) std::rethrow_exception(error);
+  }
+
+
   template <typename MapType>
-  void processFeatureOrConsensusMap_(MapType& input_map,
-                                     ConsensusIDAlgorithm* consensus)
+  void processFeatureOrConsensusMap_(MapType& input_map)
   {
     // Problem with feature data: IDs from multiple spectra may be attached to
     // a (consensus) feature, so we may have multiple IDs from the same search
@@ -250,7 +339,11 @@ protected:
       id_mapping[input_map.getProteinIdentifications()[i].getIdentifier()] = i;
     }
 
-    // compute consensus:
+    // collect groups of IDs:
+    vector<vector<PeptideIdentification>*> groups;
+    vector<Size> group_runs;
+    groups.reserve(input_map.size());
+    group_runs.reserve(input_map.size());
     for (typename MapType::Iterator map_it = input_map.begin();
          map_it != input_map.end(); ++map_it)
     {
@@ -263,9 +356,13 @@ protected:
       }
       Size n_repeats = *max_element(times_seen.begin(), times_seen.end());
 
-      consensus->apply(ids, number_of_runs * n_repeats);
+      groups.push_back(&ids);
+      group_runs.push_back(number_of_runs * n_repeats);
     }
 
+    // compute consensus:
+    computeConsensus_(groups, group_runs);
+
     // create new identification run:
     setProteinIdentifications_(input_map.getProteinIdentifications());
     // remove outdated information (protein references will be broken):
@@ -284,40 +381,15 @@ protected:
     //----------------------------------------------------------------
     // set up ConsensusID
     //----------------------------------------------------------------
-    ConsensusIDAlgorithm* consensus;
     // general algorithm parameters:
-    Param algo_params = ConsensusIDAlgorithmBest().getDefaults();
+    algo_params_ = ConsensusIDAlgorithmBest().getDefaults();
     algorithm_ = getStringOption_("algorithm");
-    if (algorithm_ == "PEPMatrix")
-    {
-      consensus = new ConsensusIDAlgorithmPEPMatrix();
-      // add algorithm-specific parameters:
-      algo_params.merge(getParam_().copy("PEPMatrix:", true));
-    }
-    else if (algorithm_ == "PEPIons")
+    if ((algorithm_ == "PEPMatrix") || (algorithm_ == "PEPIons"))
     {
-      consensus = new ConsensusIDAlgorithmPEPIons();
       // add algorithm-specific parameters:
-      algo_params.merge(getParam_().copy("PEPIons:", true));
+      algo_params_.merge(getParam_().copy(algorithm_ + ":", true));
     }
-    else if (algorithm_ == "best")
-    {
-      consensus = new ConsensusIDAlgorithmBest();
-    }
-    else if (algorithm_ == "worst")
-    {
-      consensus = new ConsensusIDAlgorithmWorst();
-    }
-    else if (algorithm_ == "average")
-    {
-      consensus = new ConsensusIDAlgorithmAverage();
-    }
-    else // algorithm_ == "ranks"
-    {
-      consensus = new ConsensusIDAlgorithmRanks();
-    }
-    algo_params.update(getParam_(), false, Log_debug); // update general params.
-    consensus->setParameters(algo_params);
+    algo_params_.update(getParam_(), false, Log_debug); // update general params.
 
     //----------------------------------------------------------------
     // idXML
@@ -376,11 +448,19 @@ protected:
       linker.group(maps, grouping);
 
       // compute consensus
+      vector<vector<PeptideIdentification>*> groups;
+      groups.reserve(grouping.size());
+      for (ConsensusMap::Iterator it = grouping.begin(); it != grouping.end();
+           ++it)
+      {
+        groups.push_back(&(it->getPeptideIdentifications()));
+      }
+      computeConsensus_(groups, vector<Size>(groups.size(), prot_ids.size()));
+
       pep_ids.clear();
       for (ConsensusMap::Iterator it = grouping.begin(); it != grouping.end();
            ++it)
       {
-        consensus->apply(it->getPeptideIdentifications(), prot_ids.size());
         if (!it->getPeptideIdentifications().empty())
         {
           PeptideIdentification& pep_id = it->getPeptideIdentifications()[0];
@@ -411,7 +491,7 @@ protected:
       FeatureMap map;
       FeatureXMLFile().load(in, map);
 
-      processFeatureOrConsensusMap_(map, consensus);
+      processFeatureOrConsensusMap_(map);
 
       FeatureXMLFile().store(out, map);
     }
@@ -424,13 +504,11 @@ protected:
       ConsensusMap map;
       ConsensusXMLFile().load(in, map);
 
-      processFeatureOrConsensusMap_(map, consensus);
+      processFeatureOrConsensusMap_(map);
 
       ConsensusXMLFile().store(out, map);
     }
 
-    delete consensus;
-
     return EXECUTION_OK;
   }
 
@@ -275,6 +275,7 @@ protected:
       consumer.getOptions().addMSLevel(2); // only load msLevel 2
       bool skip_full_count = true;
       mzml_file.transform(inputfile_name, &consumer, skip_full_count);
+      consumer.close();
     }
 
     //-------------------------------------------------------------
@@ -58,6 +58,13 @@ using namespace std;
   In order to really use this tool in batch-mode, you can provide a TOPPAS resource file (.trf) which specifies the
   input files for the input nodes in your pipeline.
 
+  <B> Scheduling </B>
+
+  Tools whose inputs are ready are started as long as the sum of their threads (the '-threads' setting of each tool) does not exceed @p num_jobs
+  and the sum of their estimated memory does not exceed @p max_memory. If several tools are waiting, the one with the longest chain of
+  downstream tools is started first. If it does not fit yet, its resources are reserved and other tools only use what it will
+  leave unused, so the critical path of the workflow is not delayed by side branches.
+
   <B> *.trf files </B>
 
  A TOPPAS resource file (<TT>*.trf</TT>) specifies the locations of input files for a pipeline.
@@ -108,8 +115,10 @@ protected:
     setValidFormats_("in", ListUtils::create<String>("toppas"));
     registerStringOption_("out_dir", "<directory>", "", "Directory for output files (default: user's home directory)", false);
     registerStringOption_("resource_file", "<file>", "", "A TOPPAS resource file (*.trf) specifying the files this workflow is to be applied to", false);
-    registerIntOption_("num_jobs", "<integer>", 1, "Maximum number of jobs running in parallel", false, false);
+    registerIntOption_("num_jobs", "<integer>", 1, "Maximum number of threads used by all jobs running in parallel (a tool configured with '-threads N' occupies N of them)", false, false);
     setMinInt_("num_jobs", 1);
+    registerDoubleOption_("max_memory", "<MB>", 0.0, "Maximum estimated memory (in MB) of all jobs running in parallel; the estimate of a job is the size of its input files. 0 = unlimited", false, true);
+    setMinFloat_("max_memory", 0.0);
   }
 
   ExitCodes main_(int argc, const char ** argv) override
@@ -118,6 +127,7 @@ protected:
     QString out_dir_name = getStringOption_("out_dir").toQString();
     QString resource_file = getStringOption_("resource_file").toQString();
     int num_jobs = getIntOption_("num_jobs");
+    double max_memory = getDoubleOption_("max_memory");
 
     QApplication a(argc, const_cast<char **>(argv), false);
 
@@ -137,6 +147,7 @@ protected:
 
     ts.load(toppas_file);
     ts.setAllowedThreads(num_jobs);
+    ts.setAllowedMemory(max_memory);
 
     if (resource_file != "")
     {
@@ -375,6 +375,7 @@ protected:
           MzMLFile mzmlfile;
           mzmlfile.setLogType(log_type_);
           mzmlfile.transform(in, &consumer, skip_full_count);
+          consumer.close();
           return EXECUTION_OK;
         }
         else if (in_type == FileTypes::MZXML)
@@ -382,6 +383,7 @@ protected:
           MzXMLFile mzxmlfile;
           mzxmlfile.setLogType(log_type_);
           mzxmlfile.transform(in, &consumer, skip_full_count);
+          consumer.close();
           return EXECUTION_OK;
         }
       }
@@ -262,15 +262,6 @@ protected:
     String in = getStringOption_("in");
     String out = getStringOption_("out");
 
-    //-------------------------------------------------------------
-    // loading input
-    //-------------------------------------------------------------
-
-    MzMLFile mz_data_file;
-    PeakMap exp;
-    mz_data_file.setLogType(log_type_);
-    mz_data_file.load(in, exp);
-
     //-------------------------------------------------------------
     // init quant method
     //-------------------------------------------------------------
@@ -288,8 +279,12 @@ protected:
 
     ConsensusMap consensus_map_raw, consensus_map_quant;
 
-    // extract channel information
-    channel_extractor.extractChannels(exp, consensus_map_raw);
+    // extract channel information while reading the input, keeping only the MS1 scans needed for purity computation in memory
+    IsobaricChannelExtractionConsumer extraction_consumer(channel_extractor, consensus_map_raw);
+    MzMLFile mz_data_file;
+    mz_data_file.setLogType(log_type_);
+    mz_data_file.transform(in, &extraction_consumer);
+    extraction_consumer.finish();
 
     IsobaricQuantifier quantifier(quant_method);
     Param quant_param(getParam_().copy("quantification:", true));
@@ -314,6 +309,8 @@ protected:
 
     consensus_map_quant.ensureUniqueId();
     StringList ms_runs;
+    PeakMap exp;
+    static_cast<ExperimentalSettings&>(exp) = extraction_consumer.getExperimentalSettings();
     exp.getPrimaryMSRunPath(ms_runs);
     consensus_map_quant.setPrimaryMSRunPath(ms_runs);
     ConsensusXMLFile().store(out, consensus_map_quant);
@@ -165,10 +165,32 @@ private:
     if (model_type != "none")
     {
       model_params = model_params.copy(model_type + ":", true);
-      for (vector<TransformationDescription>::iterator it =
-             transformations.begin(); it != transformations.end(); ++it)
+      // the models of different runs are independent - fit them concurrently:
+      bool fit_failed = false;
+      String fit_error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)transformations.size(); ++i)
       {
-        it->fitModel(model_type, model_params);
+        try
+        {
+          transformations[i].fitModel(model_type, model_params);
+        }
+        catch (Exception::BaseException& e)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MapAlignerIdentification_fit)
+#endif
+          {
+            if (!fit_failed) fit_error = String("sample ") + (i + 1) + ": " + e.what();
+            fit_failed = true;
+          }
+        }
+      }
+      if (fit_failed)
+      {
+        throw Exception::UnableToFit(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "MapAlignerIdentification", "Fitting the RT transformation model failed for " + fit_error);
       }
     }
   }
@@ -177,7 +199,10 @@ private:
   void applyTransformations_(vector<DataType>& data,
     const vector<TransformationDescription>& transformations)
   {
-    for (Size i = 0; i < data.size(); ++i)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)data.size(); ++i)
     {
       MapAlignmentTransformer::transformRetentionTimes(data[i],
         transformations[i]);
@@ -33,6 +33,10 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/APPLICATIONS/MapAlignerBase.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <exception>
 
 using namespace OpenMS;
 using namespace std;
@@ -64,6 +68,10 @@ using namespace std;
     The transformations might have been generated by a previous invocation of one of the MapAligner tools (linked below).
     However, the trafoXML file format is not very complicated, so it is relatively easy to write (or generate) your own files.
     Each input file will give rise to one output file.
+    mzML files are transformed while they are read, spectrum by spectrum, so the whole map never has to be held in memory (unless input and output are the same file).
+
+    Several files can be transformed in one invocation by passing lists to @p in and @p out. @p trafo_in then contains either one transformation per input file or a single transformation that is applied to all of them.
+    The files are processed in parallel (see parameter @p threads).
 
     @see @ref TOPP_MapAlignerIdentification @ref TOPP_MapAlignerPoseClustering @ref TOPP_MapAlignerSpectrum
 
@@ -79,7 +87,7 @@ using namespace std;
     The following parameters control the modeling of RT transformations (they can be set in the "model" section of the INI file):
     @htmlinclude OpenMS_MapRTTransformerModel.parameters @n
 
-    @note As output options, either @p out or @p trafo_out has to be provided. They can be used together.
+    @note As output options, either @p out or @p trafo_out has to be provided. They can be used together. @p trafo_out needs one file per transformation in @p trafo_in.
 
     @note Currently mzIdentML (mzid) is not directly supported as an input/output format of this tool. Convert mzid files to/from idXML using @ref TOPP_IDFileConverter if necessary.
 
@@ -93,6 +101,35 @@ using namespace std;
 // We do not want this class to show up in the docu:
 /// @cond TOPPCLASSES
 
+/// Consumer that transforms the retention times of spectra and chromatograms before writing them to mzML
+class RTTransformingMSDataWritingConsumer :
+  public MSDataWritingConsumer
+{
+public:
+  RTTransformingMSDataWritingConsumer(const String& filename,
+                                      const TransformationDescription& trafo,
+                                      bool store_original_rt) :
+    MSDataWritingConsumer(filename),
+    trafo_(trafo),
+    store_original_rt_(store_original_rt)
+  {
+  }
+
+protected:
+  void processSpectrum_(MapType::SpectrumType& s) override
+  {
+    MapAlignmentTransformer::transformRetentionTimes(s, trafo_, store_original_rt_);
+  }
+
+  void processChromatogram_(MapType::ChromatogramType& c) override
+  {
+    MapAlignmentTransformer::transformRetentionTimes(c, trafo_, store_original_rt_);
+  }
+
+  const TransformationDescription& trafo_;
+  bool store_original_rt_;
+};
+
 class TOPPMapRTTransformer :
   public TOPPBase
 {
@@ -108,13 +145,13 @@ protected:
   {
     String file_formats = "mzML,featureXML,consensusXML,idXML";
     // "in" is not required, in case we only want to invert a transformation:
-    registerInputFile_("in", "<file>", "", "Input file to transform (separated by blanks)", false);
+    registerInputFileList_("in", "<files>", StringList(), "Input files to transform (separated by blanks)", false);
     setValidFormats_("in", ListUtils::create<String>(file_formats));
-    registerOutputFile_("out", "<file>", "", "Output file (same file type as 'in'). Either this option or 'trafo_out' has to be provided; they can be used together.", false);
+    registerOutputFileList_("out", "<files>", StringList(), "Output files (same file types as 'in'). Either this option or 'trafo_out' has to be provided; they can be used together.", false);
     setValidFormats_("out", ListUtils::create<String>(file_formats));
-    registerInputFile_("trafo_in", "<file>", "", "Transformation to apply");
+    registerInputFileList_("trafo_in", "<files>", StringList(), "Transformations to apply (one per input file, or one for all input files)");
     setValidFormats_("trafo_in", ListUtils::create<String>("trafoXML"));
-    registerOutputFile_("trafo_out", "<file>", "", "Transformation output file. Either this option or 'out' has to be provided; they can be used together.", false);
+    registerOutputFileList_("trafo_out", "<files>", StringList(), "Transformation output files (one per file in 'trafo_in'). Either this option or 'out' has to be provided; they can be used together.", false);
     setValidFormats_("trafo_out", ListUtils::create<String>("trafoXML"));
     registerFlag_("invert", "Invert transformation (approximatively) before applying it");
     registerFlag_("store_original_rt", "Store the original retention times (before transformation) as meta data in the output file");
@@ -131,25 +168,74 @@ protected:
   template <class TFile, class TMap>
   void applyTransformation_(const String& in, const String& out, 
                             const TransformationDescription& trafo,
+                            bool store_original_rt, const DataProcessing& processing,
                             TFile& file, TMap& map)
   {
     file.load(in, map);
-    bool store_original_rt = getFlag_("store_original_rt");
     MapAlignmentTransformer::transformRetentionTimes(map, trafo,
                                                      store_original_rt);
-    addDataProcessing_(map, getProcessingInfo_(DataProcessing::ALIGNMENT));
+    addDataProcessing_(map, processing);
     file.store(out, map);
   }
 
+  /// transforms the data in file @p in and writes the result to @p out (thread-safe)
+  void transformFile_(const String& in, const String& out,
+                      const TransformationDescription& trafo,
+                      bool store_original_rt, const DataProcessing& processing,
+                      ProgressLogger::LogType log_type)
+  {
+    FileTypes::Type in_type = FileHandler::getType(in);
+    if (in_type == FileTypes::MZML && File::absolutePath(in) != File::absolutePath(out))
+    {
+      // stream the data: transform and write each spectrum/chromatogram as soon as it is read
+      RTTransformingMSDataWritingConsumer consumer(out, trafo, store_original_rt);
+      consumer.addDataProcessing(processing);
+      MzMLFile file;
+      file.setLogType(log_type);
+      file.transform(in, &consumer);
+      consumer.close();
+    }
+    else if (in_type == FileTypes::MZML) // in-place: the input has to be read completely first
+    {
+      MzMLFile file;
+      PeakMap map;
+      applyTransformation_(in, out, trafo, store_original_rt, processing, file, map);
+    }
+    else if (in_type == FileTypes::FEATUREXML)
+    {
+      FeatureXMLFile file;
+      FeatureMap map;
+      applyTransformation_(in, out, trafo, store_original_rt, processing, file, map);
+    }
+    else if (in_type == FileTypes::CONSENSUSXML)
+    {
+      ConsensusXMLFile file;
+      ConsensusMap map;
+      applyTransformation_(in, out, trafo, store_original_rt, processing, file, map);
+    }
+    else if (in_type == FileTypes::IDXML)
+    {
+      IdXMLFile file;
+      vector<ProteinIdentification> proteins;
+      vector<PeptideIdentification> peptides;
+      file.load(in, proteins, peptides);
+      MapAlignmentTransformer::transformRetentionTimes(peptides, trafo,
+                                                       store_original_rt);
+      // no "data processing" section in idXML
+      file.store(out, proteins, peptides);
+    }
+  }
+
   ExitCodes main_(int, const char**) override
   {
     //-------------------------------------------------------------
     // parameter handling
     //-------------------------------------------------------------
-    String in = getStringOption_("in");
-    String out = getStringOption_("out");
-    String trafo_in = getStringOption_("trafo_in");
-    String trafo_out = getStringOption_("trafo_out");
+    StringList in = getStringList_("in");
+    StringList out = getStringList_("out");
+    StringList trafo_in = getStringList_("trafo_in");
+    StringList trafo_out = getStringList_("trafo_out");
+    bool store_original_rt = getFlag_("store_original_rt");
     Param model_params = getParam_().copy("model:", true);
     String model_type = model_params.getValue("type");
     model_params = model_params.copy(model_type + ":", true);
@@ -165,64 +251,85 @@ protected:
       writeLog_("Error: Either a data or a transformation output file has to be provided (parameters 'out'/'trafo_out')");
       return ILLEGAL_PARAMETERS;
     }
-    if (in.empty() != out.empty())
+    if (in.size() != out.size())
     {
-      writeLog_("Error: Data input and output parameters ('in'/'out') must be used together");
+      writeLog_("Error: Data input and output parameters ('in'/'out') must be used together and contain the same number of files");
       return ILLEGAL_PARAMETERS;
     }
-
-    //-------------------------------------------------------------
-    // apply transformation
-    //-------------------------------------------------------------
-    TransformationXMLFile trafoxml;
-    TransformationDescription trafo;
-    trafoxml.load(trafo_in, trafo);
-    if (model_type != "none")
+    if (trafo_in.empty())
     {
-      trafo.fitModel(model_type, model_params);
+      writeLog_("Error: No transformation given (parameter 'trafo_in')");
+      return ILLEGAL_PARAMETERS;
     }
-    if (getFlag_("invert"))
+    if (!in.empty() && trafo_in.size() != 1 && trafo_in.size() != in.size())
     {
-      trafo.invert();
+      writeLog_("Error: Parameter 'trafo_in' must contain one transformation per input file or a single one for all input files");
+      return ILLEGAL_PARAMETERS;
     }
-    if (!trafo_out.empty())
+    if (!trafo_out.empty() && trafo_out.size() != trafo_in.size())
     {
-      trafoxml.store(trafo_out, trafo);
+      writeLog_("Error: Parameters 'trafo_in' and 'trafo_out' must contain the same number of files");
+      return ILLEGAL_PARAMETERS;
     }
-    if (!in.empty()) // load input
+
+    //-------------------------------------------------------------
+    // prepare transformations
+    //-------------------------------------------------------------
+    TransformationXMLFile trafoxml;
+    vector<TransformationDescription> trafos(trafo_in.size());
+    for (Size i = 0; i < trafo_in.size(); ++i)
     {
-      FileTypes::Type in_type = FileHandler::getType(in);
-      if (in_type == FileTypes::MZML)
+      trafoxml.load(trafo_in[i], trafos[i]);
+      if (model_type != "none")
+      {
+        trafos[i].fitModel(model_type, model_params);
+      }
+      if (getFlag_("invert"))
       {
-        MzMLFile file;
-        PeakMap map;
-        applyTransformation_(in, out, trafo, file, map);
+        trafos[i].invert();
       }
-      else if (in_type == FileTypes::FEATUREXML)
+      if (!trafo_out.empty())
       {
-        FeatureXMLFile file;
-        FeatureMap map;
-        applyTransformation_(in, out, trafo, file, map);
+        trafoxml.store(trafo_out[i], trafos[i]);
       }
-      else if (in_type == FileTypes::CONSENSUSXML)
+    }
+
+    //-------------------------------------------------------------
+    // apply transformations
+    //-------------------------------------------------------------
+    if (in.empty()) return EXECUTION_OK;
+
+    const DataProcessing processing = getProcessingInfo_(DataProcessing::ALIGNMENT);
+    // with several files, only the overall progress is reported
+    const ProgressLogger::LogType file_log_type = (in.size() == 1) ? log_type_ : ProgressLogger::NONE;
+
+    progresslogger.startProgress(0, in.size(), "applying RT transformations");
+    Size progress = 0;
+    std::exception_ptr error; // first exception thrown in the parallel loop
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)in.size(); ++i)
+    {
+      try
       {
-        ConsensusXMLFile file;
-        ConsensusMap map;
-        applyTransformation_(in, out, trafo, file, map);
+        const TransformationDescription& trafo = trafos[(trafos.size() == 1) ? 0 : i];
+        transformFile_(in[i], out[i], trafo, store_original_rt, processing, file_log_type);
       }
-      else if (in_type == FileTypes::IDXML)
+      catch (...)
       {
-        IdXMLFile file;
-        vector<ProteinIdentification> proteins;
-        vector<PeptideIdentification> peptides;
-        file.load(in, proteins, peptides);
-        bool store_original_rt = getFlag_("store_original_rt");
-        MapAlignmentTransformer::transformRetentionTimes(peptides, trafo,
-                                                         store_original_rt);
-        // no "data processing" section in idXML
-        file.store(out, proteins, peptides);
+#ifdef _OPENMP
+#pragma omp critical (MapRTTransformer_error)
+#endif
+        if (!error) error = std::current_exception();
       }
+#ifdef _OPENMP
+#pragma omp critical (MapRTTransformer_progress)
+#endif
+      progresslogger.setProgress(++progress);
     }
+    progresslogger.endProgress();
+    if (error) std::rethrow_exception(error);
 
     return EXECUTION_OK;
   }
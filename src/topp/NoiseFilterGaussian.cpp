@@ -160,6 +160,7 @@ public:
     MzMLFile mz_data_file;
     mz_data_file.setLogType(log_type_);
     mz_data_file.transform(in, &gaussConsumer);
+    gaussConsumer.close();
 
     return EXECUTION_OK;
   }
@@ -163,6 +163,7 @@ public:
     MzMLFile mz_data_file;
     mz_data_file.setLogType(log_type_);
     mz_data_file.transform(in, &sgolayConsumer);
+    sgolayConsumer.close();
 
     return EXECUTION_OK;
   }
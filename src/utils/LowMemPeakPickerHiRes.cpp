@@ -244,6 +244,7 @@ protected:
     ///////////////////////////////////
     MzMLFile mz_data_file;
     mz_data_file.transform(in, ppConsumer);
+    ppConsumer->close();
 
     delete ppConsumer;
 
@@ -197,6 +197,7 @@ class TOPPOpenSwathMzMLFileCacher
       consumer.getOptions().setWriteIndex(true);
       SqMassFile f;
       f.transform(in, &consumer, true, true);
+      consumer.close();
       return EXECUTION_OK;
     }
     else if (in_type == FileTypes::MZML && out_type == FileTypes::SQMASS)
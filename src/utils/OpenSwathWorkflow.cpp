@@ -1018,6 +1018,17 @@ protected:
       FeatureXMLFile().store(out, out_featureFile);
     }
 
+    // close the chromatogram file explicitly, so that write errors are reported
+    MSDataWritingConsumer* chromatogram_writer = dynamic_cast<MSDataWritingConsumer*>(chromatogramConsumer);
+    try
+    {
+      if (chromatogram_writer) chromatogram_writer->close();
+    }
+    catch (...)
+    {
+      delete chromatogramConsumer;
+      throw;
+    }
     delete chromatogramConsumer;
 
     return EXECUTION_OK;
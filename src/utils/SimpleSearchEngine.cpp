@@ -42,10 +42,12 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/FORMAT/DigestionCacheFile.h>
 #include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
 #include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
 #include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
 
@@ -164,6 +166,7 @@ class SimpleSearchEngine :
       registerIntOption_("peptide:min_size", "<num>", 7, "Minimum size a peptide must have after digestion to be considered in the search.", false, true);
       registerIntOption_("peptide:max_size", "<num>", 40, "Maximum size a peptide must have after digestion to be considered in the search (0 = disabled).", false, true);
       registerIntOption_("peptide:missed_cleavages", "<num>", 1, "Number of missed cleavages.", false, false);
+      registerStringOption_("peptide:digest_cache", "<directory>", "", "Directory for caching the digested database between runs. The cache is keyed by the checksum of the database and all digestion settings (empty = no cache).", false, true);
 
       registerTOPPSubsection_("report", "Reporting Options");
       registerIntOption_("report:top_hits", "<num>", 1, "Maximum number of top scoring hits per spectrum that are reported.", false, true);
@@ -516,6 +519,10 @@ class SimpleSearchEngine :
 
       progresslogger.startProgress(0, (Size)(fasta_db.end() - fasta_db.begin()), "Scoring peptide models against spectra...");
 
+      // create all modified residues up front, so ResidueDB is only read (without locking) in the parallel section
+      ResidueDB::getInstance()->registerModifications(fixedModNames);
+      ResidueDB::getInstance()->registerModifications(varModNames);
+
       // lookup for processed peptides. must be defined outside of omp section and synchronized
       set<StringView> processed_petides;
 
@@ -523,6 +530,45 @@ class SimpleSearchEngine :
       Size min_peptide_length = getIntOption_("peptide:min_size");
       Size max_peptide_length = getIntOption_("peptide:max_size");
 
+      // digestion products of all proteins, if the on-disk cache is used (otherwise digested on the fly)
+      DigestionCacheFile::Digests cached_digests;
+      const String digest_cache = getStringOption_("peptide:digest_cache");
+      if (!digest_cache.empty())
+      {
+        DigestionCacheFile cache_file;
+        const String key = DigestionCacheFile::computeKey(in_db, digestor, min_peptide_length, max_peptide_length);
+        const String cache_filename = DigestionCacheFile::getCacheFileName(digest_cache, key);
+        if (cache_file.load(cache_filename, key, cached_digests) && cached_digests.size() == fasta_db.size())
+        {
+          LOG_INFO << "Using digested database from cache file '" << cache_filename << "'." << endl;
+        }
+        else
+        {
+          cached_digests.assign(fasta_db.size(), vector<String>());
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+          for (SignedSize fasta_index = 0; fasta_index < (SignedSize)fasta_db.size(); ++fasta_index)
+          {
+            vector<StringView> current_digest;
+            digestor.digestUnmodified(fasta_db[fasta_index].sequence, current_digest, min_peptide_length, max_peptide_length);
+            cached_digests[fasta_index].reserve(current_digest.size());
+            for (vector<StringView>::const_iterator cit = current_digest.begin(); cit != current_digest.end(); ++cit)
+            {
+              cached_digests[fasta_index].push_back(cit->getString());
+            }
+          }
+          try
+          {
+            cache_file.store(cache_filename, key, cached_digests);
+          }
+          catch (Exception::UnableToCreateFile&)
+          {
+            LOG_WARN << "Could not write digest cache file '" << cache_filename << "', continuing without cache." << endl;
+          }
+        }
+      }
+
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
@@ -534,7 +580,14 @@ class SimpleSearchEngine :
         }
 
         vector<StringView> current_digest;
-        digestor.digestUnmodified(fasta_db[fasta_index].sequence, current_digest, min_peptide_length, max_peptide_length);
+        if (cached_digests.empty())
+        {
+          digestor.digestUnmodified(fasta_db[fasta_index].sequence, current_digest, min_peptide_length, max_peptide_length);
+        }
+        else
+        {
+          current_digest.assign(cached_digests[fasta_index].begin(), cached_digests[fasta_index].end());
+        }
 
         for (vector<StringView>::iterator cit = current_digest.begin(); cit != current_digest.end(); ++cit)
         {
@@ -564,22 +617,15 @@ class SimpleSearchEngine :
             processed_petides.insert(*cit);
           }
 
-          vector<AASequence> all_modified_peptides;
+          // no locking needed: all modified residues have been registered in ResidueDB before
+          AASequence aas = AASequence::fromString(cit->getString());
+          ModifiedPeptideGenerator::applyFixedModifications(fixedMods.begin(), fixedMods.end(), aas);
+          ModifiedPeptideGenerator::VariantEnumerator variants(varMods.begin(), varMods.end(), aas, max_variable_mods_per_peptide);
 
-          // this critial section is because ResidueDB is not thread safe and new residues are created based on the PTMs
-#ifdef _OPENMP
-#pragma omp critical (residuedb_access)
-#endif
+          // only variants matching a precursor are turned into AASequences
+          while (variants.next())
           {
-            AASequence aas = AASequence::fromString(cit->getString());
-            ModifiedPeptideGenerator::applyFixedModifications(fixedMods.begin(), fixedMods.end(), aas);
-            ModifiedPeptideGenerator::applyVariableModifications(varMods.begin(), varMods.end(), aas, max_variable_mods_per_peptide, all_modified_peptides);
-          }
-
-          for (SignedSize mod_pep_idx = 0; mod_pep_idx < (SignedSize)all_modified_peptides.size(); ++mod_pep_idx)
-          {
-            const AASequence& candidate = all_modified_peptides[mod_pep_idx];
-            double current_peptide_mass = candidate.getMonoWeight();
+            double current_peptide_mass = variants.getMonoWeight();
 
             // determine MS2 precursors that match to the current peptide mass
             multimap<double, Size>::const_iterator low_it;
@@ -601,6 +647,8 @@ class SimpleSearchEngine :
               continue;     // no matching precursor in data
             }
 
+            AASequence candidate = variants.getSequence();
+
             //create theoretical spectrum
             PeakSpectrum theo_spectrum;
 